@@ -0,0 +1,281 @@
+/**
+ * @file benchmark.cpp
+ * @brief Phase-by-phase benchmark of the simulation pipeline on generated circuits.
+ *
+ * Every case generates a netlist of one family (a Netlist_generator topology)
+ * at one size and times, over several repetitions:
+ * | Phase | Work |
+ * |-------|------|
+ * | `parse` | NetlistParser::parse_line over every line |
+ * | `build` | Node and component construction from the parsed descriptors |
+ * | `assemble` | Circuit::assemble_MNA_system |
+ * | `dc_solve` | Simulator::run_dc_analysis (fresh simulator: ordering + factorization + solve) |
+ * | `ac_point` | One AC frequency point (sweep time / points, CSV row included) |
+ * | `output` | DC solution and solver report written to a file |
+ *
+ * Results are printed as a table and optionally written as a JSON report and
+ * compared against a baseline report; the exit code is 2 when a phase
+ * regressed beyond the threshold.
+ *
+ * **Usage:**
+ * ```
+ * benchmark -sizes 1000,10000 -reps 5 -o bench.json
+ * benchmark -o new.json -baseline bench.json -threshold 0.10
+ * ```
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "benchmark.h"
+#include "circuit.h"
+#include "circuit_builder.h"
+#include "netlist_generator.h"
+#include "netlist_parser.h"
+#include "simulator.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Options {
+    std::vector<std::string> families = {"ladder", "grid", "tree", "random", "rlc"};
+    std::vector<size_t> sizes = {1000, 10000};
+    int repetitions = 5;
+    int ac_points = 10;
+    std::string solver = "lu";
+    int threads = 1;
+    uint64_t seed = 1;
+    std::string output_file;
+    std::string baseline_file;
+    double threshold = 0.10;
+};
+
+void print_usage(const char* program) {
+    std::cout << "Usage: " << program << " [options]\n"
+              << "  -families <list>    Comma-separated generator topologies, e.g. ladder,grid:3,tree:4,random,rlc (default: all)\n"
+              << "  -sizes <list>       Comma-separated circuit sizes in nodes (default: 1000,10000)\n"
+              << "  -reps <n>           Repetitions per case (default: 5)\n"
+              << "  -ac_points <n>      AC frequency points per repetition (default: 10)\n"
+              << "  -solver <gs|lu>     Linear solver (default: lu)\n"
+              << "  -threads <n>        Solver threads, 0 = all cores (default: 1)\n"
+              << "  -seed <n>           Generator seed (default: 1)\n"
+              << "  -o <file>           Write the JSON report\n"
+              << "  -baseline <file>    Compare medians against an earlier JSON report\n"
+              << "  -threshold <x>      Relative change flagged as regression (default: 0.10)\n"
+              << "  -h                  Show this help message\n";
+}
+
+std::vector<std::string> split(const std::string& list) {
+    std::vector<std::string> items;
+    std::stringstream ss(list);
+    std::string item;
+    while (std::getline(ss, item, ','))
+        if (!item.empty())
+            items.push_back(item);
+    return items;
+}
+
+bool parse_options(int argc, char* argv[], Options& options) {
+    try {
+        for (int i = 1; i < argc; i++) {
+            std::string arg = argv[i];
+            bool has_value = i + 1 < argc;
+            if (arg == "-families" && has_value) {
+                options.families = split(argv[++i]);
+                Netlist_generator::Spec spec;
+                for (const std::string& family : options.families)
+                    Netlist_generator::parse_topology(family, spec);
+            } else if (arg == "-sizes" && has_value) {
+                options.sizes.clear();
+                for (const std::string& size : split(argv[++i]))
+                    options.sizes.push_back(std::stoul(size));
+            } else if (arg == "-reps" && has_value) {
+                options.repetitions = std::stoi(argv[++i]);
+            } else if (arg == "-ac_points" && has_value) {
+                options.ac_points = std::stoi(argv[++i]);
+            } else if (arg == "-solver" && has_value) {
+                options.solver = argv[++i];
+                if (options.solver != "gs" && options.solver != "lu")
+                    throw std::invalid_argument("Unknown solver: " + options.solver);
+            } else if (arg == "-threads" && has_value) {
+                options.threads = std::stoi(argv[++i]);
+            } else if (arg == "-seed" && has_value) {
+                options.seed = std::stoull(argv[++i]);
+            } else if (arg == "-o" && has_value) {
+                options.output_file = argv[++i];
+            } else if (arg == "-baseline" && has_value) {
+                options.baseline_file = argv[++i];
+            } else if (arg == "-threshold" && has_value) {
+                options.threshold = std::stod(argv[++i]);
+            } else if (arg == "-h") {
+                print_usage(argv[0]);
+                return false;
+            } else {
+                throw std::invalid_argument("Unknown or incomplete argument: " + arg);
+            }
+        }
+        if (options.repetitions < 1 || options.ac_points < 1 || options.threads < 0 || options.threshold < 0 ||
+            options.sizes.empty() || options.families.empty())
+            throw std::invalid_argument("Repetitions, AC points, sizes and families must be positive.");
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        print_usage(argv[0]);
+        return false;
+    }
+    return true;
+}
+
+std::string generate(const std::string& family, size_t n, uint64_t seed) {
+    Netlist_generator::Spec spec;
+    Netlist_generator::parse_topology(family, spec);
+    spec.size = n;
+    spec.seed = seed;
+    std::ostringstream net;
+    Netlist_generator(spec).write(net);
+    return net.str();
+}
+
+double elapsed_us(Clock::time_point start, Clock::time_point end) {
+    return std::chrono::duration<double, std::micro>(end - start).count();
+}
+
+// ============================================================================
+// CASE RUNNER
+// ============================================================================
+
+void run_case(const Options& options, const std::string& family, size_t size, Benchmark_report& report) {
+    const std::string netlist = generate(family, size, options.seed);
+    const char* phases[] = {"parse", "build", "assemble", "dc_solve", "ac_point", "output"};
+    std::vector<std::vector<double>> samples(6);
+    size_t unknowns = 0, nonzeros = 0;
+    const std::string ac_file = "bench_ac.csv", output_file = "bench_output.log";
+
+    for (int rep = 0; rep < options.repetitions; rep++) {
+        // parse
+        auto t0 = Clock::now();
+        std::vector<ComponentDescriptor> descriptors;
+        std::string_view text(netlist);
+        std::string line;
+        for (size_t pos = 0; pos < text.size();) {
+            size_t end = text.find('\n', pos);
+            if (end == std::string_view::npos)
+                end = text.size();
+            line.assign(text.data() + pos, end - pos);
+            pos = end + 1;
+            ComponentDescriptor descriptor;
+            if (NetlistParser::parse_line(line, descriptor))
+                descriptors.push_back(std::move(descriptor));
+        }
+
+        // build
+        auto t1 = Clock::now();
+        Node::node_count = 0;
+        Node::valid = false;
+        Circuit circuit(family + "_" + std::to_string(size));
+        CircuitBuilder builder;
+        builder.reserve(circuit, size + 1, descriptors.size());
+        builder.add_components(circuit, descriptors);
+
+        // assemble
+        auto t2 = Clock::now();
+        circuit.assemble_MNA_system();
+
+        // dc_solve
+        auto t3 = Clock::now();
+        Simulator simulator(ac_file);
+        simulator.set_solver_method(options.solver == "lu" ? Solver::Method::sparse_lu : Solver::Method::gauss_seidel);
+        if (options.threads != 1)
+            simulator.set_num_threads(options.threads);
+        simulator.run_dc_analysis(circuit);
+
+        // ac_point
+        auto t4 = Clock::now();
+        simulator.run_ac_analysis(circuit, 1.0, static_cast<double>(options.ac_points), 1.0);
+
+        // output
+        auto t5 = Clock::now();
+        {
+            std::ofstream out(output_file);
+            circuit.print_solution(out);
+            out << simulator << std::endl;
+        }
+        auto t6 = Clock::now();
+
+        samples[0].push_back(elapsed_us(t0, t1));
+        samples[1].push_back(elapsed_us(t1, t2));
+        samples[2].push_back(elapsed_us(t2, t3));
+        samples[3].push_back(elapsed_us(t3, t4));
+        samples[4].push_back(elapsed_us(t4, t5) / options.ac_points);
+        samples[5].push_back(elapsed_us(t5, t6));
+
+        unknowns = simulator.get_solution().size() - 1;
+        nonzeros = 0;
+        for (const auto& [row, cols] : circuit.get_MNA_matrix())
+            nonzeros += cols.size();
+    }
+    std::remove(ac_file.c_str());
+    std::remove(output_file.c_str());
+
+    for (size_t p = 0; p < samples.size(); p++)
+        report.add({family, size, unknowns, nonzeros, phases[p], Benchmark_stats::from_samples(samples[p])});
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Options options;
+    if (!parse_options(argc, argv, options))
+        return 1;
+
+    Benchmark_report report;
+    report.set_metadata("solver", options.solver);
+    report.set_metadata("threads", std::to_string(options.threads));
+    report.set_metadata("repetitions", std::to_string(options.repetitions));
+    report.set_metadata("ac_points", std::to_string(options.ac_points));
+    report.set_metadata("seed", std::to_string(options.seed));
+#ifdef __VERSION__
+    report.set_metadata("compiler", __VERSION__);
+#endif
+
+    try {
+        for (const std::string& family : options.families) {
+            for (size_t size : options.sizes) {
+                std::cerr << "Running " << family << " " << size << "..." << std::endl;
+                run_case(options, family, size, report);
+            }
+        }
+        report.print_table(std::cout);
+        if (!options.output_file.empty()) {
+            report.write_json_file(options.output_file);
+            std::cout << "\nReport written to " << options.output_file << std::endl;
+        }
+
+        if (options.baseline_file.empty())
+            return 0;
+        Benchmark_report baseline = Benchmark_report::read_json_file(options.baseline_file);
+        int regressions = 0;
+        std::cout << "\nComparison with " << options.baseline_file << " (threshold "
+                  << options.threshold * 100 << "%):" << std::endl;
+        for (const Benchmark_change& change : report.compare(baseline, options.threshold)) {
+            if (!change.regression && !change.improvement)
+                continue;
+            regressions += change.regression ? 1 : 0;
+            std::cout << "  " << (change.regression ? "REGRESSION  " : "improvement ") << change.key << ": "
+                      << std::fixed << std::setprecision(1) << change.baseline << " us -> " << change.current
+                      << " us (x" << std::setprecision(2) << change.ratio << ")" << std::defaultfloat << std::endl;
+        }
+        std::cout << "  " << regressions << " regression(s)" << std::endl;
+        return regressions > 0 ? 2 : 0;
+    } catch (const std::exception& e) {
+        std::cerr << "Benchmark failed: " << e.what() << std::endl;
+        return 1;
+    }
+}
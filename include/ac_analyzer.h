@@ -11,10 +11,12 @@
 #define AC_ANALYZER_H
 
 #include <unordered_map>
+#include <vector>
 #include <map>
 #include <complex>
-#include <fstream>
+#include <string>
 #include "component.h"
+#include "output_writer.h"
 #include <chrono>
 
 /**
@@ -60,16 +62,20 @@ private:
 
     // Solution vector x (complex voltages and currents)
     std::vector<std::complex<double>> solution;
+
+    Output_writer& writer;      // Formats and writes the results on its own thread (not owned)
+    int sink;                   // Results file in the writer, opened by initialize() (-1 = not open)
     
-    void log_header() const;
+    void log_header();
 public:
     /**
      * @brief Constructs an AC analyzer with specified output file.
+     * @param writer Background writer that formats and writes the result rows.
      * @param output_file Path to write AC analysis results (default: "ac_analysis_results.csv").
      * 
      * Results are logged in CSV format: frequency, Re(V1), Im(V1), Re(V2), Im(V2), ..., duration_us
      */
-    Ac_analyzer(const std::string& output_file = "ac_analysis_results.csv");
+    Ac_analyzer(Output_writer& writer, const std::string& output_file = "ac_analysis_results.csv");
 
     /**
      * @brief Initializes the complex MNA system from DC analysis base.
@@ -114,13 +120,20 @@ public:
      * @param duration Time taken to solve at this frequency (default: 0).
      * @param converge_iters Number of iterations taken to converge (default: 0).
      * 
-     * Writes a CSV line containing: frequency, complex solution values, solve time.
+     * Queues a CSV line containing: frequency, complex solution values, solve time.
      * Format: freq, Re(x[0]), Im(x[0]), Re(x[1]), Im(x[1]), ..., duration_us
+     * The values are copied; formatting and writing happen on the writer thread.
      * 
-     * @throws std::runtime_error if output file cannot be opened.
+     * @throws std::runtime_error if initialize() could not open the output file.
      */
     void log_ac_inst_solution(double frequency, std::chrono::microseconds duration = std::chrono::microseconds(0), int converge_iters = 0);
 
+    /**
+     * @brief Waits until every queued result row is in the output file.
+     * @throws std::runtime_error if writing failed.
+     */
+    void flush();
+
     /**
      * @brief Prints AC analyzer information.
      * @param os Output stream (default: std::cout).
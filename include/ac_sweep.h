@@ -0,0 +1,147 @@
+/**
+ * @file ac_sweep.h
+ * @brief Lazy AC frequency sweep that solves one point per step.
+ *
+ * Compiled_circuit::solve_ac() and Simulator::run_ac_analysis() solve every
+ * point before returning anything. A sweep instead solves a point only when
+ * the consumer asks for it and hands out a view of that point's phasors,
+ * so results can be streamed into another pipeline without being stored,
+ * and a consumer that has found what it needs (a -3 dB corner, a
+ * resonance) stops the sweep without paying for the remaining points.
+ */
+
+#ifndef AC_SWEEP_H
+#define AC_SWEEP_H
+
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <vector>
+#include "analysis_result.h"
+#include "cancellation.h"
+#include "compiled_circuit.h"
+
+/**
+ * @class Ac_sweep
+ * @brief Pull-based generator of the frequency points of an AC sweep.
+ *
+ * **Usage:**
+ * ```cpp
+ * std::shared_ptr<const Compiled_circuit> compiled = Compiled_circuit::compile(circuit);
+ * Ac_sweep sweep(compiled, 10.0, 1e6, 1.05, true);
+ * const double corner = std::abs(compiled->solve_ac(10.0).voltage(0, "out")) / std::sqrt(2.0);
+ * for (const Ac_point& p : sweep) {
+ *     if (std::abs(p.voltage("out")) < corner) {
+ *         std::cout << "-3 dB at " << p.frequency() << " Hz\n";
+ *         break;                       // Later points are never solved
+ *     }
+ * }
+ * ```
+ *
+ * Equivalent generator style: `while (sweep.next()) use(sweep.current());`.
+ *
+ * Points follow the stepping of Compiled_circuit::solve_ac() and have the
+ * same values. The sweep owns one matrix copy, one set of numeric factors
+ * and one solution vector, reused by every point; each point's view is
+ * valid until the next step. The compiled circuit can be shared with other
+ * threads, but a sweep itself belongs to one thread.
+ *
+ * @see Compiled_circuit, Ac_point, Ac_result
+ */
+class Ac_sweep {
+private:
+    std::shared_ptr<const Compiled_circuit> circuit;    // Keeps the compiled circuit alive
+    std::vector<double> frequencies;                    // Hz, one per point
+    Cancellation_token token;
+    Compiled_circuit::Ac_workspace workspace;           // Factors and solution of the current point
+    size_t solved;                                      // Points solved so far
+
+public:
+    /**
+     * @class iterator
+     * @brief Single-pass input iterator; incrementing solves the next point.
+     */
+    class iterator {
+    private:
+        Ac_sweep* sweep;                // nullptr = end
+        Ac_point view;
+
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = Ac_point;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const Ac_point*;
+        using reference = const Ac_point&;
+
+        explicit iterator(Ac_sweep* sweep = nullptr)
+            : sweep(sweep), view(sweep ? sweep->current() : Ac_point(nullptr, 0.0, 0, nullptr)) {}
+
+        reference operator*() const { return view; }
+        pointer operator->() const { return &view; }
+
+        iterator& operator++() {
+            if (sweep->next())
+                view = sweep->current();
+            else
+                sweep = nullptr;
+            return *this;
+        }
+
+        bool operator==(const iterator& other) const { return sweep == other.sweep; }
+        bool operator!=(const iterator& other) const { return sweep != other.sweep; }
+    };
+
+    /**
+     * @brief Prepares a sweep without solving anything.
+     * @param circuit Compiled circuit (shared with the sweep).
+     * @param freq1 Start frequency in Hertz (> 0).
+     * @param freq2 End frequency in Hertz (>= freq1).
+     * @param step Increment in Hertz, or factor per point with log_scale.
+     * @param log_scale Multiply instead of add (step must then exceed 1).
+     * @param token Cancellation token polled per point and by the factorization.
+     * @throws std::invalid_argument for an invalid sweep.
+     */
+    Ac_sweep(std::shared_ptr<const Compiled_circuit> circuit, double freq1, double freq2, double step,
+             bool log_scale = false, const Cancellation_token& token = Cancellation_token());
+
+    Ac_sweep(const Ac_sweep&) = delete;
+    Ac_sweep& operator=(const Ac_sweep&) = delete;
+
+    /**
+     * @brief Solves the next point.
+     * @return false (solving nothing) once every point has been solved.
+     * @throws Analysis_cancelled if the token was cancelled.
+     *
+     * @par Time Complexity
+     * O(flops(LU)) per point; the symbolic analysis is shared
+     */
+    bool next();
+
+    /**
+     * @brief View of the last solved point (requires a successful next()).
+     */
+    Ac_point current() const {
+        return Ac_point(circuit.get(), frequencies[solved - 1], solved - 1, workspace.solution.data());
+    }
+
+    /**
+     * @brief Iterator at the current point, solving the first one if none was solved yet.
+     */
+    iterator begin();
+
+    iterator end() { return iterator(); }
+
+    /**
+     * @brief Points in the whole sweep, solved or not.
+     */
+    size_t points() const { return frequencies.size(); }
+
+    /**
+     * @brief Points solved so far.
+     */
+    size_t points_solved() const { return solved; }
+
+    const Compiled_circuit& get_circuit() const { return *circuit; }
+};
+
+#endif
@@ -0,0 +1,173 @@
+/**
+ * @file analysis_result.h
+ * @brief Per-analysis results of a Compiled_circuit.
+ *
+ * Results own their solution vectors and refer back to the (shared,
+ * immutable) compiled circuit for names and branch values. Looking up a
+ * node or component name is a hash lookup; code that reads many values can
+ * resolve indices once with Compiled_circuit::node_index() and use value().
+ */
+
+#ifndef ANALYSIS_RESULT_H
+#define ANALYSIS_RESULT_H
+
+#include <complex>
+#include <memory>
+#include <string>
+#include <vector>
+#include "I_printable.h"
+
+class Compiled_circuit;
+
+/**
+ * @class Dc_result
+ * @brief DC operating point: one value per MNA variable.
+ *
+ * **Usage:**
+ * ```cpp
+ * Dc_result op = compiled->solve_dc();
+ * double v_out = op.voltage("out");
+ * double i_v1 = op.current("V1");
+ * ```
+ */
+class Dc_result : public I_Printable {
+private:
+    std::shared_ptr<const Compiled_circuit> circuit;    // Keeps the compiled circuit alive
+    std::vector<double> solution;                       // Index 0 = ground
+
+public:
+    Dc_result(std::shared_ptr<const Compiled_circuit> circuit, std::vector<double> solution);
+
+    const Compiled_circuit& get_circuit() const { return *circuit; }
+    const std::vector<double>& get_solution() const { return solution; }
+
+    /**
+     * @brief Value of an MNA variable (node voltage or source/inductor current).
+     */
+    double value(int index) const { return solution[index]; }
+
+    /**
+     * @brief Voltage of a node.
+     * @throws std::invalid_argument if the node does not exist.
+     */
+    double voltage(const std::string& node) const;
+
+    /**
+     * @brief Current through a component, from its positive to its negative terminal.
+     * @throws std::invalid_argument if the component does not exist.
+     */
+    double current(const std::string& component) const;
+
+    /**
+     * @brief Prints every variable with its label.
+     * @param os Output stream (default: std::cout).
+     */
+    virtual void print(std::ostream& os = std::cout) const override;
+};
+
+/**
+ * @class Ac_point
+ * @brief View of the phasors of one frequency point; does not own them.
+ *
+ * Returned by Ac_result::point() and yielded by Ac_sweep. The view is valid
+ * while its source lives (for Ac_sweep: until the sweep advances), so copy
+ * the values that must outlive it.
+ */
+class Ac_point {
+private:
+    const Compiled_circuit* circuit;
+    double freq;                                        // Hz
+    size_t point;                                       // Index in the sweep
+    const std::complex<double>* values;                 // One phasor per MNA variable
+
+public:
+    Ac_point(const Compiled_circuit* circuit, double frequency, size_t index, const std::complex<double>* values)
+        : circuit(circuit), freq(frequency), point(index), values(values) {}
+
+    double frequency() const { return freq; }
+    size_t index() const { return point; }
+
+    /**
+     * @brief Phasors of all MNA variables (index 0 = ground), size() of them.
+     */
+    const std::complex<double>* data() const { return values; }
+    size_t size() const;
+
+    /**
+     * @brief Phasor of an MNA variable.
+     */
+    std::complex<double> value(int index) const { return values[index]; }
+
+    /**
+     * @brief Node voltage phasor.
+     * @throws std::invalid_argument if the node does not exist.
+     */
+    std::complex<double> voltage(const std::string& node) const;
+
+    /**
+     * @brief Branch current phasor, from the positive to the negative terminal.
+     * @throws std::invalid_argument if the component does not exist.
+     */
+    std::complex<double> current(const std::string& component) const;
+};
+
+/**
+ * @class Ac_result
+ * @brief Phasors of every MNA variable at every frequency of a sweep.
+ *
+ * Stored point-major: the variables of point k are contiguous.
+ *
+ * **Usage:**
+ * ```cpp
+ * Ac_result sweep = compiled->solve_ac(10.0, 1e5, 10.0, true);
+ * for (size_t k = 0; k < sweep.points(); k++)
+ *     std::cout << sweep.frequency(k) << " " << std::abs(sweep.voltage(k, "out")) << "\n";
+ * ```
+ */
+class Ac_result : public I_Printable {
+private:
+    std::shared_ptr<const Compiled_circuit> circuit;
+    std::vector<double> frequencies;                    // Hz, one per point
+    std::vector<std::complex<double>> phasors;          // points × variables
+    size_t stride;                                      // Variables per point
+
+public:
+    Ac_result(std::shared_ptr<const Compiled_circuit> circuit, std::vector<double> frequencies,
+              std::vector<std::complex<double>> phasors);
+
+    const Compiled_circuit& get_circuit() const { return *circuit; }
+    size_t points() const { return frequencies.size(); }
+    double frequency(size_t point) const { return frequencies[point]; }
+
+    /**
+     * @brief Phasor of an MNA variable at a frequency point.
+     */
+    std::complex<double> value(size_t point, int index) const { return phasors[point * stride + index]; }
+
+    /**
+     * @brief View of one frequency point.
+     */
+    Ac_point point(size_t point) const {
+        return Ac_point(circuit.get(), frequencies[point], point, phasors.data() + point * stride);
+    }
+
+    /**
+     * @brief Node voltage phasor.
+     * @throws std::invalid_argument if the node does not exist.
+     */
+    std::complex<double> voltage(size_t point, const std::string& node) const;
+
+    /**
+     * @brief Branch current phasor, from the positive to the negative terminal.
+     * @throws std::invalid_argument if the component does not exist.
+     */
+    std::complex<double> current(size_t point, const std::string& component) const;
+
+    /**
+     * @brief Writes the sweep in the CSV layout of Ac_analyzer (without the timing columns).
+     * @param os Output stream (default: std::cout).
+     */
+    virtual void print(std::ostream& os = std::cout) const override;
+};
+
+#endif
@@ -0,0 +1,135 @@
+/**
+ * @file batch_lu.h
+ * @brief Lane-batched direct solver for many small systems of one pattern.
+ *
+ * Monte Carlo samples and batch runs of a small netlist solve the same
+ * sparsity pattern over and over with different values. Solving them one at
+ * a time is dominated by per-solve overhead; laying W instances side by side
+ * (entry-major, lane-minor) turns every scalar operation of the elimination
+ * into a W-wide loop the compiler vectorizes.
+ */
+
+#ifndef BATCH_LU_H
+#define BATCH_LU_H
+
+#include <vector>
+#include "sparse_matrix.h"
+
+/**
+ * @class Batch_lu
+ * @brief LU factorization and solve of W same-pattern systems in SIMD lanes.
+ *
+ * **Algorithm:**
+ * 1. analyze(): columns ordered by minimum degree, rows chosen by threshold
+ *    partial pivoting on a representative instance (diagonal preferred).
+ *    A symbolic elimination with that pivot order yields, per pivot, the
+ *    rows of L and columns of U that are structurally non-zero; zeros are
+ *    never touched, so sparse systems cost their fill, not n^3.
+ * 2. factorize(): the shared elimination runs on all lanes at once over a
+ *    dense n x n x W array. Lanes whose pivot fails the threshold test (their
+ *    values differ too much from the representative) are refactored alone
+ *    with full partial pivoting.
+ * 3. solve(): permuted forward/back substitution across lanes.
+ *
+ * Storage is lane-minor: entry p of lane l lives at index p * W + l, for
+ * both matrix values and right-hand sides.
+ *
+ * **Usage:**
+ * ```cpp
+ * Batch_lu<8> batch;
+ * batch.analyze(A);                            // pattern + representative values
+ * std::vector<double> values(A.nnz() * 8), b(A.n * 8);
+ * // ... fill lane l of entry p at values[p * 8 + l], b[i * 8 + l] ...
+ * batch.factorize(values);
+ * batch.solve(b);                              // b now holds 8 solutions
+ * ```
+ *
+ * @note Intended for systems of up to a few hundred unknowns (dense
+ *       workspace of n^2 * W doubles). Singular systems (e.g. inductor loops
+ *       at DC) are not regularized; use Sparse_lu for those.
+ *
+ * @tparam W Number of lanes (4, 8 or 16)
+ *
+ * @see Sparse_lu, Monte_carlo, Simulator::run_batch
+ */
+template<int W>
+class Batch_lu {
+private:
+    int n;                                  // Dimension
+    double pivot_tolerance;                 // Threshold relative to the largest candidate in a column
+    std::vector<int> row_perm, col_perm;    // Pivot k -> original row / column
+    std::vector<int> entry_pos;             // Stored entry of the pattern -> dense position (pivot numbering)
+    std::vector<int> l_ptr, l_rows;         // Per pivot: rows below it in L (structurally non-zero)
+    std::vector<int> u_ptr, u_cols;         // Per pivot: columns right of it in U
+    std::vector<double> lu;                 // Dense factors, ((i * n + j) * W + lane)
+    bool lane_ok[W];                        // Lane factored with the shared pivots
+    std::vector<std::vector<double>> lane_lu;   // Fallback dense factors of rejected lanes
+    std::vector<std::vector<int>> lane_perm;    // Fallback row pivots of rejected lanes
+    mutable std::vector<double> work;       // Permuted right-hand sides
+    mutable std::vector<double> lane_work;  // One rejected lane's right-hand side during its fallback solve
+
+    /**
+     * @brief Factors one lane alone with partial pivoting (fallback).
+     * @param values Batched values in pattern order.
+     * @param lane Lane to factor.
+     * @throws std::runtime_error if the lane's matrix is singular.
+     */
+    void factorize_lane(const std::vector<double>& values, int lane);
+
+public:
+    /**
+     * @brief Constructs an empty batch solver.
+     * @param pivot_tolerance Pivot threshold relative to the column maximum (default: 0.001).
+     */
+    explicit Batch_lu(double pivot_tolerance = 0.001);
+
+    /**
+     * @brief Chooses the shared pivot order and elimination pattern.
+     * @param A Pattern and representative values (e.g. the nominal instance).
+     * @throws std::runtime_error if the representative is singular.
+     *
+     * @par Time Complexity
+     * O(n^3 / 3) worst case (dense symbolic elimination), far less for sparse patterns
+     */
+    void analyze(const Sparse_matrix<double>& A);
+
+    /**
+     * @brief Factors W instances.
+     * @param values Values of the analyzed pattern, entry p of lane l at p * W + l.
+     * @throws std::runtime_error if an instance is singular.
+     *
+     * @par Time Complexity
+     * O(Σ_k |L_k| × |U_k|) W-wide operations (the fill of the shared pivot order)
+     */
+    void factorize(const std::vector<double>& values);
+
+    /**
+     * @brief Solves the W factored systems in place.
+     * @param b Right-hand sides in compact numbering, row i of lane l at i * W + l;
+     *        overwritten with the solutions.
+     *
+     * @par Time Complexity
+     * O(nnz(L) + nnz(U)) W-wide operations
+     */
+    void solve(std::vector<double>& b) const;
+
+    /**
+     * @brief Dimension of the analyzed pattern (0 before analyze()).
+     */
+    int size() const { return n; }
+
+    /**
+     * @brief Number of lanes that needed the single-lane fallback in the last factorization.
+     */
+    int num_fallback_lanes() const;
+};
+
+constexpr int batch_lu_lanes = 8;          // Lanes of the batched callers (Monte_carlo, Simulator::run_batch)
+constexpr int batch_lu_max_size = 256;     // Largest system they solve in lanes (n^2 * W dense workspace)
+
+// Explicit template instantiation declarations
+extern template class Batch_lu<4>;
+extern template class Batch_lu<8>;
+extern template class Batch_lu<16>;
+
+#endif
@@ -0,0 +1,166 @@
+/**
+ * @file benchmark.h
+ * @brief Timing statistics and machine-readable benchmark reports.
+ *
+ * The benchmark executable (bench/benchmark.cpp) times every pipeline phase
+ * of generated circuits at several sizes. Its measurements are collected
+ * here, summarized over repetitions, written as JSON and compared against a
+ * saved baseline report so slowdowns are flagged instead of eyeballed.
+ */
+
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <cstddef>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+/**
+ * @struct Benchmark_stats
+ * @brief Summary of repeated timings of one phase, in microseconds.
+ */
+struct Benchmark_stats {
+    int repetitions = 0;    // Number of samples
+    double min = 0.0;       // Fastest sample
+    double median = 0.0;    // Median sample (compared against baselines)
+    double mean = 0.0;      // Arithmetic mean
+    double stddev = 0.0;    // Sample standard deviation
+    double max = 0.0;       // Slowest sample
+
+    /**
+     * @brief Summarizes samples.
+     * @param samples Timings in microseconds (at least one).
+     * @throws std::invalid_argument if there are no samples.
+     */
+    static Benchmark_stats from_samples(std::vector<double> samples);
+};
+
+/**
+ * @struct Benchmark_result
+ * @brief Timings of one phase of one benchmark case.
+ */
+struct Benchmark_result {
+    std::string family;     // Circuit family (e.g. "ladder")
+    size_t size = 0;        // Requested circuit size (elements)
+    size_t unknowns = 0;    // MNA unknowns of the generated circuit
+    size_t nonzeros = 0;    // Nonzeros of the assembled MNA matrix
+    std::string phase;      // Pipeline phase (e.g. "dc_solve")
+    Benchmark_stats stats;  // Timings of the phase
+
+    /**
+     * @brief Identifies the measurement across reports ("family/size/phase").
+     */
+    std::string key() const;
+};
+
+/**
+ * @struct Benchmark_change
+ * @brief Median timing of one measurement in a report and in its baseline.
+ */
+struct Benchmark_change {
+    std::string key;        // "family/size/phase"
+    double baseline = 0.0;  // Baseline median (us)
+    double current = 0.0;   // Current median (us)
+    double ratio = 1.0;     // current / baseline
+    bool regression = false;    // Slower beyond the threshold
+    bool improvement = false;   // Faster beyond the threshold
+};
+
+/**
+ * @class Benchmark_report
+ * @brief Collection of benchmark results with JSON serialization and baseline comparison.
+ *
+ * **JSON layout:**
+ * ```
+ * {
+ *   "format": "circuit_benchmark 1",
+ *   "metadata": { "solver": "lu", "repetitions": "5", ... },
+ *   "results": [
+ *     { "family": "ladder", "size": 1000, "unknowns": 1001, "nonzeros": 3001, "phase": "dc_solve",
+ *       "repetitions": 5, "min_us": ..., "median_us": ..., "mean_us": ..., "stddev_us": ..., "max_us": ... },
+ *     ...
+ *   ]
+ * }
+ * ```
+ *
+ * **Usage:**
+ * ```cpp
+ * Benchmark_report report;
+ * report.set_metadata("solver", "lu");
+ * report.add({"ladder", 1000, unknowns, nnz, "dc_solve", Benchmark_stats::from_samples(samples)});
+ * report.write_json_file("bench.json");
+ *
+ * Benchmark_report baseline = Benchmark_report::read_json_file("baseline.json");
+ * for (const Benchmark_change& change : report.compare(baseline, 0.10, 5.0))
+ *     if (change.regression) std::cout << change.key << " is slower\n";
+ * ```
+ */
+class Benchmark_report {
+private:
+    std::map<std::string, std::string> metadata;    // Run description (solver, threads, ...)
+    std::vector<Benchmark_result> results;  // Results in measurement order
+
+public:
+    /**
+     * @brief Sets a metadata entry (written to the report, ignored by comparisons).
+     */
+    void set_metadata(const std::string& key, const std::string& value) { metadata[key] = value; }
+
+    /**
+     * @brief Gets the metadata entries.
+     */
+    const std::map<std::string, std::string>& get_metadata() const { return metadata; }
+
+    /**
+     * @brief Appends a result.
+     */
+    void add(const Benchmark_result& result) { results.push_back(result); }
+
+    /**
+     * @brief Gets all results in measurement order.
+     */
+    const std::vector<Benchmark_result>& get_results() const { return results; }
+
+    /**
+     * @brief Writes the report as JSON.
+     */
+    void write_json(std::ostream& os) const;
+
+    /**
+     * @brief Writes the report as JSON to a file.
+     * @throws std::runtime_error if the file cannot be written.
+     */
+    void write_json_file(const std::string& filename) const;
+
+    /**
+     * @brief Reads a report written by write_json.
+     * @throws std::runtime_error on malformed JSON or a foreign format.
+     */
+    static Benchmark_report read_json(std::istream& is);
+
+    /**
+     * @brief Reads a report file written by write_json_file.
+     * @throws std::runtime_error if the file cannot be read or is malformed.
+     */
+    static Benchmark_report read_json_file(const std::string& filename);
+
+    /**
+     * @brief Compares medians against a baseline report.
+     * @param baseline Earlier report.
+     * @param threshold Relative change that counts (0.10 = 10%).
+     * @param min_delta_us Absolute change below which nothing is flagged
+     *        (keeps microsecond-scale phases from flagging timer noise).
+     * @return One change per measurement present in both reports, in this report's order.
+     */
+    std::vector<Benchmark_change> compare(const Benchmark_report& baseline, double threshold,
+                                          double min_delta_us = 5.0) const;
+
+    /**
+     * @brief Prints the results as an aligned table.
+     */
+    void print_table(std::ostream& os = std::cout) const;
+};
+
+#endif
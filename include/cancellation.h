@@ -0,0 +1,91 @@
+/**
+ * @file cancellation.h
+ * @brief Cooperative cancellation of running analyses.
+ *
+ * A token is a cheap, copyable handle to a shared flag. The thread that
+ * submitted an analysis keeps one copy and calls cancel(); the solver loops
+ * holding other copies poll it at safe points (between factorized columns,
+ * iterations and frequency points) and unwind with Analysis_cancelled.
+ */
+
+#ifndef CANCELLATION_H
+#define CANCELLATION_H
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+
+/**
+ * @class Analysis_cancelled
+ * @brief Thrown by a solver loop that observed a cancelled token.
+ */
+class Analysis_cancelled : public std::runtime_error {
+public:
+    Analysis_cancelled() : std::runtime_error("Analysis cancelled.") {}
+};
+
+/**
+ * @class Cancellation_token
+ * @brief Shared cancellation flag polled by solver loops.
+ *
+ * A default-constructed token is inert: it is never cancelled and costs no
+ * allocation, so solvers can hold one unconditionally. create() makes a
+ * token that can be cancelled; copies share its flag.
+ *
+ * **Usage:**
+ * ```cpp
+ * Cancellation_token token = Cancellation_token::create();
+ * std::future<Ac_result> sweep = simulator.run_ac_analysis_async(circuit, 1, 1e6, 1.01, true, token);
+ * token.cancel();                      // sweep.get() now throws Analysis_cancelled
+ * ```
+ */
+class Cancellation_token {
+private:
+    std::shared_ptr<std::atomic<bool>> flag;    // nullptr = inert
+
+public:
+    Cancellation_token() = default;
+
+    /**
+     * @brief Creates a token that can be cancelled.
+     */
+    static Cancellation_token create() {
+        Cancellation_token token;
+        token.flag = std::make_shared<std::atomic<bool>>(false);
+        return token;
+    }
+
+    /**
+     * @brief Requests cancellation (no effect on an inert token).
+     */
+    void cancel() const {
+        if (flag)
+            flag->store(true, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Whether cancellation was requested.
+     */
+    bool is_cancelled() const { return flag && flag->load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Whether this token can be cancelled at all.
+     */
+    bool cancellable() const { return static_cast<bool>(flag); }
+
+    /**
+     * @brief Throws Analysis_cancelled if cancellation was requested.
+     */
+    void throw_if_cancelled() const {
+        if (is_cancelled())
+            throw Analysis_cancelled();
+    }
+};
+
+/**
+ * @brief Progress of a sweep: called as progress(points_done, points_total) from the solving thread.
+ */
+using Progress_callback = std::function<void(size_t, size_t)>;
+
+#endif
@@ -44,7 +44,7 @@ public:
     
 protected:
     double capacitance;                 // Capacitance value in Farads (F)
-    std::complex<double> admittance;    // Admittance equivalent for AC analysis (jωC)
+    std::complex<double> admittance;    // Admittance currently stamped in the AC matrix (jωC)
     
 public:
     /**
@@ -75,6 +75,23 @@ public:
      */
     virtual Component_contribution<double> get_contribution() override;
 
+    /**
+     * @brief Changes the capacitance in place.
+     * @param value Capacitance in Farads.
+     * @throws std::runtime_error if value is not finite and positive (the capacitor is left unchanged).
+     */
+    virtual void set_value(double value) override;
+
+    /**
+     * @brief Gets the capacitance.
+     */
+    virtual double get_value() const override { return capacitance; }
+
+    /**
+     * @brief Creates a copy sharing the same nodes.
+     */
+    virtual Component* clone() const override { return new Capacitor(*this); }
+
     /**
      * @brief Generates AC MNA contributions for the capacitor.
      * @param frequency AC analysis frequency in Hertz.
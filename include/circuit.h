@@ -10,6 +10,7 @@
 #ifndef CIRCUIT_H
 #define CIRCUIT_H
 
+#include <cstdint>
 #include <unordered_map>
 #include <map>
 #include <sstream>
@@ -98,6 +99,12 @@ protected:
      * @throws std::runtime_error if the descriptor is invalid or contains unknown types.
      */
     void add_component(const ComponentDescriptor& descriptor);
+
+    /**
+     * @brief Takes ownership of a created component and registers its AC role and extra variable.
+     * @param component Component with a unique ID.
+     */
+    void register_component(Component* component);
     
 public:
     /**
@@ -135,7 +142,57 @@ public:
      * solution vector. Sets Node::valid = true after deployment.
      */
     void deploy_dc_solution(const std::vector<double>& solution);
+
+    /**
+     * @brief Changes a component value and patches the assembled MNA system.
+     * @param id Component ID (e.g. "R12").
+     * @param value New value in the component's base unit.
+     * @return The change of the component's stamps (new minus old contribution).
+     * @throws std::runtime_error if the component does not exist, has no adjustable
+     *         value, or (R, L, C) the value is not finite and positive; the MNA
+     *         system is then unchanged.
+     *
+     * Only the component's own stamps are touched, so the MNA system stays
+     * consistent without re-assembly. The returned delta lets a direct solver
+     * update its factorization instead of refactoring (see Simulator::update_component).
+     * Node voltages are invalidated until the next solve.
+     *
+     * @par Time Complexity
+     * O(S) where S = stamps of the component
+     */
+    Component_contribution<double> set_component_value(const std::string& id, double value);
     
+    /**
+     * @brief Canonical hash of the circuit's connectivity.
+     * @return FNV-1a hash of (component ID, terminal node names) over components
+     *         sorted by ID; independent of netlist line order and of values.
+     *
+     * Two circuits with equal topology hashes share the MNA sparsity pattern,
+     * and with it the ordering and symbolic analysis of a direct solver.
+     *
+     * @par Time Complexity
+     * O(C log C)
+     */
+    uint64_t topology_hash() const;
+
+    /**
+     * @brief Canonical hash of the component values.
+     * @return FNV-1a hash of (component ID, value, AC amplitude, tolerance) over
+     *         components sorted by ID.
+     *
+     * Together with topology_hash() this identifies the circuit's results:
+     * see Result_cache.
+     *
+     * @par Time Complexity
+     * O(C log C)
+     */
+    uint64_t values_hash() const;
+
+    /**
+     * @brief Gets the circuit name.
+     */
+    const std::string& get_name() const { return circuit_name; }
+
     /**
      * @brief Gets the MNA system matrix.
      * @return Const reference to the sparse matrix representation.
@@ -166,6 +223,12 @@ public:
      */
     const std::map<int, std::string>& get_extraVarId_map() const { return extraVarId_map; }
 
+    /**
+     * @brief Gets all components.
+     * @return Const reference to the component ID to component map.
+     */
+    const std::unordered_map<std::string, Component*>& get_components() const { return components; }
+
     /**
      * @brief Gets ac components.
      * @return Const reference to the components map.
@@ -215,6 +278,7 @@ public:
 
     friend class CircuitBuilder;
     friend class CircuitPrinter;
+    friend class Circuit_image;
 };
 
 #endif
\ No newline at end of file
@@ -2,13 +2,42 @@
 #define CIRCUIT_BUILDER_H
 
 #include "circuit.h"
+#include "component_descriptor.h"
+#include <cstddef>
+#include <istream>
 #include <string>
+#include <string_view>
+#include <vector>
 
 /**
  * @class CircuitBuilder
  * @brief Class responsible for building and orchestrating the parsed netlist into a Circuit structure.
+ *
+ * Netlists can come from a file, any input stream or an in-memory string;
+ * circuit generators can skip text altogether and add elements directly:
+ * ```cpp
+ * Circuit circuit("Ladder");
+ * CircuitBuilder builder;
+ * builder.reserve(circuit, n + 1, 2 * n + 1);
+ * builder.add_voltage_source(circuit, "V1", "1", "0", 10.0);
+ * for (int k = 1; k <= n; k++) {
+ *     builder.add_resistor(circuit, "Rs" + std::to_string(k), std::to_string(k), std::to_string(k + 1), 100.0);
+ *     builder.add_resistor(circuit, "Rp" + std::to_string(k), std::to_string(k + 1), "0", 1000.0);
+ * }
+ * circuit.assemble_MNA_system();
+ * ```
  */
 class CircuitBuilder {
+private:
+    /**
+     * @brief Parses the lines produced by next_line(line) in chunks and adds the elements they describe.
+     *
+     * Comments and blanks are skipped. Each chunk is parsed, then built, so the
+     * two phases show up as separate `parse` / `build` trace spans.
+     */
+    template<typename Next_line>
+    void add_lines(Circuit& circuit, Next_line&& next_line);
+
 public:
     /**
      * @brief Parses and builds a complete Circuit structure from the netlist file.
@@ -17,6 +46,90 @@ public:
      * @throws std::runtime_error if file cannot be opened.
      */
     void build(Circuit& circuit, const std::string& filename);
+
+    /**
+     * @brief Parses and builds a Circuit from a netlist stream.
+     * @param circuit The Circuit instance to be populated.
+     * @param in Netlist stream (e.g. std::cin or a std::istringstream).
+     * @throws std::runtime_error on malformed elements.
+     */
+    void build(Circuit& circuit, std::istream& in);
+
+    /**
+     * @brief Parses and builds a Circuit from netlist text in memory.
+     * @param circuit The Circuit instance to be populated.
+     * @param netlist Netlist text (lines separated by '\n'); not copied as a whole.
+     * @throws std::runtime_error on malformed elements.
+     */
+    void build_from_text(Circuit& circuit, std::string_view netlist);
+
+    /**
+     * @brief Pre-reserves node and component capacity for bulk construction.
+     * @param circuit The Circuit instance to be populated.
+     * @param num_nodes Expected number of nodes (including ground).
+     * @param num_components Expected number of components.
+     */
+    void reserve(Circuit& circuit, size_t num_nodes, size_t num_components);
+
+    /**
+     * @brief Gets a node by name, creating it if needed.
+     * @param circuit The Circuit instance to be populated.
+     * @param name Node name ("0" is ground).
+     * @return Node owned by the circuit.
+     */
+    Node* add_node(Circuit& circuit, const std::string& name);
+
+    /**
+     * @brief Adds the element a descriptor describes, creating its nodes.
+     * @param circuit The Circuit instance to be populated.
+     * @param descriptor Element (type, id, node names, values); node pointers are filled in.
+     * @throws std::runtime_error if the ID is taken or the values are invalid.
+     */
+    void add(Circuit& circuit, ComponentDescriptor& descriptor);
+
+    /**
+     * @brief Adds a batch of elements, reserving component capacity up front.
+     * @param circuit The Circuit instance to be populated.
+     * @param descriptors Elements in insertion order; node pointers are filled in.
+     * @throws std::runtime_error on the first duplicate ID or invalid value.
+     */
+    void add_components(Circuit& circuit, std::vector<ComponentDescriptor>& descriptors);
+
+    /**
+     * @brief Adds a resistor.
+     * @throws std::invalid_argument if the ID does not start with 'R'.
+     * @throws std::runtime_error if the ID is taken or the resistance is not positive.
+     */
+    void add_resistor(Circuit& circuit, const std::string& id, const std::string& node1, const std::string& node2, double resistance);
+
+    /**
+     * @brief Adds a capacitor.
+     * @throws std::invalid_argument if the ID does not start with 'C'.
+     * @throws std::runtime_error if the ID is taken or the capacitance is not positive.
+     */
+    void add_capacitor(Circuit& circuit, const std::string& id, const std::string& node1, const std::string& node2, double capacitance);
+
+    /**
+     * @brief Adds an inductor.
+     * @throws std::invalid_argument if the ID does not start with 'L'.
+     * @throws std::runtime_error if the ID is taken or the inductance is not positive.
+     */
+    void add_inductor(Circuit& circuit, const std::string& id, const std::string& node1, const std::string& node2, double inductance);
+
+    /**
+     * @brief Adds a current source (current flows from node1 through the source to node2).
+     * @throws std::invalid_argument if the ID does not start with 'I'.
+     * @throws std::runtime_error if the ID is taken.
+     */
+    void add_current_source(Circuit& circuit, const std::string& id, const std::string& node1, const std::string& node2, double current);
+
+    /**
+     * @brief Adds a voltage source with optional AC amplitude.
+     * @throws std::invalid_argument if the ID does not start with 'V'.
+     * @throws std::runtime_error if the ID is taken.
+     */
+    void add_voltage_source(Circuit& circuit, const std::string& id, const std::string& node1, const std::string& node2,
+                            double dc_voltage, double ac_voltage = 0.0);
 };
 
 #endif // CIRCUIT_BUILDER_H
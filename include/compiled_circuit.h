@@ -0,0 +1,209 @@
+/**
+ * @file compiled_circuit.h
+ * @brief Immutable, shareable form of an assembled circuit with thread-safe analyses.
+ *
+ * A Circuit is a mutable workspace: DC analysis writes node voltages and
+ * source currents into its Node and Component objects, sets the static
+ * Node::valid flag, and AC assembly keeps per-component admittance state.
+ * One Circuit therefore serves one analysis at a time. A Compiled_circuit
+ * captures everything the analyses need (the DC system in CSC form, the
+ * frequency-dependent AC terms, variable names and branch values) once,
+ * never changes afterwards, and returns its results as separate objects, so
+ * any number of threads can run DC and AC jobs on one shared copy.
+ */
+
+#ifndef COMPILED_CIRCUIT_H
+#define COMPILED_CIRCUIT_H
+
+#include <complex>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "I_printable.h"
+#include "analysis_result.h"
+#include "cancellation.h"
+#include "circuit.h"
+#include "sparse_lu.h"
+#include "sparse_matrix.h"
+
+/**
+ * @class Compiled_circuit
+ * @brief Read-only DC/AC systems of a circuit; every analysis is a const, thread-safe call.
+ *
+ * The symbolic LU analyses of the DC and AC patterns are computed at
+ * compile time and shared by every solve (see Sparse_lu::set_symbolic);
+ * each solve owns only its numeric factors and vectors. AC systems are
+ * evaluated directly from the branch table at each frequency, so the
+ * stateful Ac_component::get_ac_contribution() is never called.
+ *
+ * **Usage:**
+ * ```cpp
+ * circuit.assemble_MNA_system();
+ * std::shared_ptr<const Compiled_circuit> compiled = Compiled_circuit::compile(circuit);
+ * // Any number of threads:
+ * Dc_result op = compiled->solve_dc();
+ * Ac_result bode = compiled->solve_ac(10.0, 1e6, 1.1, true);
+ * double v = op.voltage("out");
+ * std::complex<double> h = bode.voltage(3, "out");
+ * ```
+ *
+ * @note The source Circuit can be edited or destroyed after compile(); the
+ *       compiled copy keeps the values it was compiled with.
+ *
+ * @see Dc_result, Ac_result, Ac_sweep, Circuit
+ */
+class Compiled_circuit : public I_Printable, public std::enable_shared_from_this<Compiled_circuit> {
+public:
+    /**
+     * @struct Branch
+     * @brief One component as the analyses see it.
+     */
+    struct Branch {
+        std::string id;                 // Component ID (e.g. "R1")
+        char type;                      // 'R', 'C', 'L', 'V' or 'I'
+        int i, j;                       // MNA indices of the terminals (0 = ground)
+        int var;                        // Current variable (V and L), -1 otherwise
+        double value;                   // R, C, L, V or I in base units
+        double signal;                  // AC amplitude (V sources)
+    };
+
+private:
+    // Frequency-dependent stamp: values[position] += sign × admittance of branch
+    struct Ac_term {
+        int position;
+        int branch;
+        double sign;
+    };
+
+    // Numeric state of one thread solving AC points (set up by the first point)
+    struct Ac_workspace {
+        bool ready = false;
+        Sparse_matrix<std::complex<double>> A;
+        Sparse_lu<std::complex<double>> lu;
+        std::vector<std::complex<double>> x;
+        std::vector<std::complex<double>> solution;     // Full solution of the last point
+    };
+
+    friend class Ac_sweep;
+
+    std::string circuit_name;
+    int num_variables;                              // Solution size including ground
+    std::vector<std::string> variable_names;        // "V(node)" or "I(source)" per MNA index
+    std::unordered_map<std::string, int> node_ids;  // Node name -> MNA index
+    std::vector<Branch> branches;
+    std::unordered_map<std::string, int> branch_ids;    // Component ID -> branch
+    uint64_t topology;                              // Circuit::topology_hash() at compile time
+    uint64_t values;                                // Circuit::values_hash() at compile time
+
+    Sparse_matrix<double> dc_matrix;                // DC system (CSC)
+    std::vector<double> dc_rhs;                     // DC right-hand side (compact)
+    std::shared_ptr<const Lu_symbolic> dc_symbolic; // Shared by every DC solve
+
+    Sparse_matrix<std::complex<double>> ac_matrix;  // AC pattern; values hold the frequency-independent part
+    std::vector<std::complex<double>> ac_rhs;       // AC phasor sources (compact)
+    std::vector<Ac_term> ac_terms;                  // Capacitor and inductor stamps
+    std::shared_ptr<const Lu_symbolic> ac_symbolic; // Shared by every AC solve
+
+    Compiled_circuit() = default;
+
+    void solve_ac_point(double frequency, const Cancellation_token& token, Ac_workspace& workspace) const;
+
+public:
+    /**
+     * @brief Compiles an assembled circuit.
+     * @param circuit Circuit with its MNA system assembled (not modified).
+     * @return Shared immutable copy.
+     * @throws std::runtime_error if the MNA system has not been assembled.
+     *
+     * @par Time Complexity
+     * O(C + NNZ log K) plus the symbolic LU analyses of the DC and AC patterns
+     */
+    static std::shared_ptr<const Compiled_circuit> compile(const Circuit& circuit);
+
+    /**
+     * @brief Solves the DC operating point.
+     * @param token Cancellation token polled by the factorization.
+     * @return Node voltages and branch currents (the circuit is not touched).
+     * @throws std::runtime_error if the system is singular and inconsistent.
+     * @throws Analysis_cancelled if the token was cancelled.
+     *
+     * @par Time Complexity
+     * O(flops(LU)); the symbolic analysis is shared
+     */
+    Dc_result solve_dc(const Cancellation_token& token = Cancellation_token()) const;
+
+    /**
+     * @brief Solves an AC frequency sweep.
+     * @param freq1 Start frequency in Hertz (> 0).
+     * @param freq2 End frequency in Hertz (>= freq1).
+     * @param step Increment in Hertz, or factor per point with log_scale.
+     * @param log_scale Multiply instead of add (step must then exceed 1 unless freq1 == freq2).
+     * @param token Cancellation token polled per frequency point and by the factorization.
+     * @param progress Called after every point as progress(done, total); calls are serialized
+     *        but may come from any thread of the sweep.
+     * @return Phasors of every variable at every frequency point.
+     * @throws std::invalid_argument for an invalid or non-finite sweep.
+     * @throws Analysis_cancelled if the token was cancelled.
+     *
+     * Frequencies follow the same stepping as Simulator::run_ac_analysis();
+     * equal bounds give exactly one point whatever the step.
+     * Points are independent and are solved in parallel on the global
+     * runtime (see Thread_pool), each thread with its own numeric factors.
+     * Inductor currents are computed from their terminal voltages. Ac_sweep
+     * solves the same points lazily, one per step, for consumers that stop early.
+     *
+     * @par Time Complexity
+     * O(F × flops(LU)) for F frequency points
+     */
+    Ac_result solve_ac(double freq1, double freq2, double step, bool log_scale = false,
+                       const Cancellation_token& token = Cancellation_token(),
+                       const Progress_callback& progress = nullptr) const;
+
+    /**
+     * @brief Solves the AC system at a single frequency.
+     */
+    Ac_result solve_ac(double frequency) const { return solve_ac(frequency, frequency, 1.0); }
+
+    const std::string& get_name() const { return circuit_name; }
+
+    /**
+     * @brief Size of a solution vector (index 0 = ground).
+     */
+    int get_num_variables() const { return num_variables; }
+
+    /**
+     * @brief Label of every solution index ("V(node)", "I(V1)"; "0" for ground).
+     */
+    const std::vector<std::string>& get_variable_names() const { return variable_names; }
+
+    /**
+     * @brief MNA index of a node.
+     * @throws std::invalid_argument if the node does not exist.
+     */
+    int node_index(const std::string& node) const;
+
+    /**
+     * @brief Branch of a component.
+     * @throws std::invalid_argument if the component does not exist.
+     */
+    const Branch& branch(const std::string& id) const;
+
+    const std::vector<Branch>& get_branches() const { return branches; }
+    uint64_t topology_hash() const { return topology; }
+    uint64_t values_hash() const { return values; }
+
+    /**
+     * @brief Gets the DC system matrix (CSC).
+     */
+    const Sparse_matrix<double>& get_dc_matrix() const { return dc_matrix; }
+
+    /**
+     * @brief Prints name, variables, branches and system sizes.
+     * @param os Output stream (default: std::cout).
+     */
+    virtual void print(std::ostream& os = std::cout) const override;
+};
+
+#endif
@@ -14,6 +14,19 @@
 #include "node.h"
 #include "component_contribution.h"
 
+/**
+ * @struct Tolerance
+ * @brief Manufacturing spread of a component value (Monte Carlo analysis).
+ *
+ * Netlist syntax: `TOL <fraction>` for a uniform spread of +/- fraction,
+ * `SIGMA <fraction>` for a Gaussian with the given relative standard deviation.
+ */
+struct Tolerance {
+    enum class Distribution { none, uniform, gaussian };
+    Distribution distribution = Distribution::none;
+    double spread = 0.0;    // Uniform: relative half-width; gaussian: relative standard deviation
+};
+
 /**
  * @class Component
  * @brief Abstract base class for two-terminal electrical components.
@@ -36,6 +49,7 @@ protected:
     Node* ni;                   // Pointer to the positive terminal node
     Node* nj;                   // Pointer to the negative terminal node
     std::string componentId;    // Unique identifier for the component (e.g., "R1", "V1")
+    Tolerance tolerance;        // Value spread for Monte Carlo analysis (none by default)
     
 public:
     /**
@@ -81,6 +95,59 @@ public:
      */
     virtual void set_current(double) {}
 
+    /**
+     * @brief Changes the component's primary value (R, V, I, L or C) in place.
+     * @param value New value in the component's base unit.
+     * @throws std::runtime_error if the component has no adjustable value.
+     * @note The MNA system must be updated afterwards (see Circuit::set_component_value).
+     */
+    virtual void set_value(double value);
+
+    /**
+     * @brief Gets the component's primary value (R, V, I, L or C).
+     * @return Value in the component's base unit.
+     * @throws std::runtime_error if the component has no adjustable value.
+     */
+    virtual double get_value() const;
+
+    /**
+     * @brief Creates a copy of the component sharing the same nodes.
+     * @return Newly allocated copy (owned by the caller).
+     * @note Used to evaluate stamps at other values without touching the circuit.
+     */
+    virtual Component* clone() const = 0;
+
+    /**
+     * @brief Sets the value spread used by Monte Carlo analysis.
+     * @param t Tolerance distribution and relative spread.
+     */
+    void set_tolerance(const Tolerance& t) { tolerance = t; }
+
+    /**
+     * @brief Gets the component ID (e.g. "R1").
+     */
+    const std::string& get_id() const { return componentId; }
+
+    /**
+     * @brief Gets the positive terminal node.
+     */
+    const Node* get_node_i() const { return ni; }
+
+    /**
+     * @brief Gets the negative terminal node.
+     */
+    const Node* get_node_j() const { return nj; }
+
+    /**
+     * @brief Gets the AC excitation amplitude (0 for components without one).
+     */
+    virtual double get_signal_value() const { return 0.0; }
+
+    /**
+     * @brief Gets the value spread used by Monte Carlo analysis.
+     */
+    const Tolerance& get_tolerance() const { return tolerance; }
+
     /**
      * @brief Custom type and constraint introspection methods.
      */
@@ -14,8 +14,10 @@
 #define COMPONENT_CONTRIBUTION_H
 
 #include <I_printable.h>
-#include <vector>
 #include <complex>
+#include <cstddef>
+#include <stdexcept>
+#include <utility>
 
 /**
  * @struct MatrixContribution
@@ -31,7 +33,9 @@ struct MatrixContribution {
     int row;        // Row index in the MNA matrix (corresponds to equation)
     int col;        // Column index in the MNA matrix (corresponds to variable)
     T value;        // Value to add at position (row, col)
-    
+
+    MatrixContribution() : row(0), col(0), value() {}
+
     /**
      * @brief Constructs a matrix contribution entry.
      * @param r Row index.
@@ -54,7 +58,9 @@ template<typename T = double>
 struct VectorContribution {
     int row;        // Row index in the RHS vector
     T value;        // Value to add at the given row
-    
+
+    VectorContribution() : row(0), value() {}
+
     /**
      * @brief Constructs a vector contribution entry.
      * @param r Row index.
@@ -63,6 +69,46 @@ struct VectorContribution {
     VectorContribution(int r, T v);
 };
 
+/**
+ * @class Stamp_list
+ * @brief Fixed-capacity stamp storage with the vector operations callers use.
+ *
+ * Contributions are created for every component on every assembly and AC
+ * frequency point; keeping the stamps inline makes that free of heap
+ * allocations.
+ *
+ * @tparam S Stamp type.
+ * @tparam N Capacity.
+ */
+template<typename S, size_t N>
+class Stamp_list {
+private:
+    S items[N];             // Stamps [0, count)
+    size_t count = 0;       // Number of stamps
+
+public:
+    /**
+     * @brief Appends a stamp.
+     * @throws std::length_error if the list is full.
+     */
+    template<typename... Args>
+    void emplace_back(Args&&... args) {
+        if (count == N)
+            throw std::length_error("Component contribution exceeds its stamp capacity.");
+        items[count++] = S(std::forward<Args>(args)...);
+    }
+
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    void clear() { count = 0; }
+    const S& operator[](size_t i) const { return items[i]; }
+    S& operator[](size_t i) { return items[i]; }
+    const S* begin() const { return items; }
+    const S* end() const { return items + count; }
+    S* begin() { return items; }
+    S* end() { return items + count; }
+};
+
 /**
  * @class Component_contribution
  * @brief Collects all MNA contributions from a single component.
@@ -92,14 +138,20 @@ struct VectorContribution {
 template<typename T = double>
 class Component_contribution : public I_Printable {
 public:
-    std::vector<MatrixContribution<T>> matrixStamps;   // Collection of matrix stamps
-    std::vector<VectorContribution<T>> vectorStamps;   // Collection of vector stamps
+    // Two-terminal elements stamp at most 4 matrix and 2 vector entries; a value
+    // change (Circuit::set_component_value) combines an old and a new contribution
+    static constexpr size_t max_matrix_stamps = 8;
+    static constexpr size_t max_vector_stamps = 4;
+
+    Stamp_list<MatrixContribution<T>, max_matrix_stamps> matrixStamps;   // Collection of matrix stamps
+    Stamp_list<VectorContribution<T>, max_vector_stamps> vectorStamps;   // Collection of vector stamps
     
     /**
      * @brief Adds a contribution to the MNA system matrix.
      * @param row Row index (equation number).
      * @param col Column index (variable number).
      * @param value Value to add at (row, col).
+     * @throws std::length_error beyond max_matrix_stamps.
      */
     void stampMatrix(int row, int col, T value);
     
@@ -107,6 +159,7 @@ public:
      * @brief Adds a contribution to the MNA excitation vector.
      * @param row Row index.
      * @param value Value to add.
+     * @throws std::length_error beyond max_vector_stamps.
      */
     void stampVector(int row, T value);
     
@@ -85,6 +85,22 @@ public:
      * @return Component_contribution with current stamps to RHS vector.
      */
     virtual Component_contribution<double> get_contribution() override;
+
+    /**
+     * @brief Changes the current in place.
+     * @param value Source current in Amperes.
+     */
+    virtual void set_value(double value) override { current = value; }
+
+    /**
+     * @brief Gets the current.
+     */
+    virtual double get_value() const override { return current; }
+
+    /**
+     * @brief Creates a copy sharing the same nodes.
+     */
+    virtual Component* clone() const override { return new Current_source(*this); }
     
     /**
      * @brief Prints current source information.
@@ -0,0 +1,230 @@
+/**
+ * @file executor.h
+ * @brief Process-wide work-stealing runtime shared by every parallel stage.
+ *
+ * All parallelism in the simulator draws from one set of worker threads so
+ * that nested stages (an AC sweep submitted asynchronously whose points run
+ * in parallel, each factorizing with a parallel elimination tree) never
+ * oversubscribe the machine. Two kinds of work share the workers:
+ *
+ * - Jobs: independent, coarse-grained callables (whole analyses). Each
+ *   worker keeps a deque: jobs submitted from outside are spread
+ *   round-robin, jobs a worker submits go onto its own deque, and idle
+ *   workers steal from the opposite end of other deques (as in Task_tree).
+ * - Regions: fork-join kernels run by Thread_pool. The caller runs thread 0
+ *   and leases only workers that are idle right now, so a region started
+ *   while the runtime is busy simply runs on fewer threads (down to the
+ *   caller alone) instead of queueing behind other work or adding threads.
+ *
+ * The thread budget counts the thread that starts a region: a budget of n
+ * runs n - 1 workers, and no region ever uses more than n threads.
+ */
+
+#ifndef EXECUTOR_H
+#define EXECUTOR_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+/**
+ * @class Executor
+ * @brief Worker threads running submitted jobs and leased to parallel regions.
+ *
+ * **Usage:**
+ * ```cpp
+ * Executor::Options options;
+ * options.threads = 8;                             // Budget including the caller
+ * options.affinity = Executor::Affinity::compact;
+ * Executor::configure_global(options);             // Once, at startup
+ *
+ * std::shared_ptr<Executor> runtime = Executor::global();
+ * std::future<double> f = runtime->submit([&] { return expensive(); });
+ * double value = runtime->wait(f);                 // Runs other jobs meanwhile
+ * ```
+ *
+ * Parallel kernels should use Thread_pool, which runs its regions through
+ * run_region() on the global runtime.
+ *
+ * @note The destructor runs every job already submitted, then joins the
+ *       workers; cancel long jobs first if they should not complete.
+ * @note A job that blocks on a nested future with get() holds its worker;
+ *       wait() keeps the worker busy with other jobs instead.
+ *
+ * @see Thread_pool, Simulator::run_dc_analysis_async, Task_tree
+ */
+class Executor {
+public:
+    /**
+     * @brief Placement of the worker threads on logical CPUs.
+     */
+    enum class Affinity {
+        none,       // Leave placement to the OS scheduler
+        compact,    // Worker w on CPU w + 1: neighbouring cores, shared caches
+        scatter     // Even CPUs first, then odd: one worker per physical core while they last
+    };
+
+    /**
+     * @brief Runtime configuration.
+     */
+    struct Options {
+        int threads = 0;                        // Thread budget including the caller (0 = all cores)
+        Affinity affinity = Affinity::none;     // Worker placement
+    };
+
+private:
+    struct Job_deque {
+        std::mutex mutex;
+        std::deque<std::function<void()>> jobs;
+    };
+
+    // Parallel region open for workers; lives on the stack of run_region()
+    struct Region {
+        const std::function<void(int, int)>* body;
+        int num_threads;                        // Caller + leased workers
+        int next_id;                            // Next thread_id handed to a worker
+        int pending;                            // Leased workers not yet finished
+        Region* next;                           // Next region with open slots
+        std::exception_ptr error;               // First exception thrown by a leased worker
+        std::condition_variable done_cv;
+    };
+
+    std::vector<std::thread> workers;
+    std::unique_ptr<Job_deque[]> deques;        // One per worker
+    Options options;
+    std::mutex sleep_mutex;                     // Guards everything below
+    std::condition_variable wake_cv;            // Signals a new job, region or shutdown
+    std::condition_variable parked_cv;          // Signals a worker going idle
+    int queued;                                 // Jobs submitted but not yet taken
+    int idle;                                   // Workers waiting for work
+    int region_slots;                           // Leased but unclaimed worker slots
+    Region* open_regions;                       // Regions with unclaimed slots
+    bool stopping;
+    std::atomic<unsigned> next;                 // Round-robin target of outside submissions
+
+    void worker_loop(int worker_id);
+    bool take(int worker_id, std::function<void()>& job);
+    void run_job(std::unique_lock<std::mutex>& lock, int worker_id);
+    void run_region_slot(std::unique_lock<std::mutex>& lock);
+
+public:
+    /**
+     * @brief Starts the worker threads and waits until they are idle.
+     * @param options Thread budget and affinity; the runtime starts
+     *        max(1, threads - 1) workers.
+     */
+    explicit Executor(const Options& options);
+
+    /**
+     * @brief Starts a runtime with a thread budget and no affinity.
+     * @param num_threads Thread budget including the caller (0 = all cores).
+     */
+    explicit Executor(int num_threads = 0);
+
+    /**
+     * @brief Finishes the submitted jobs and joins the workers.
+     */
+    ~Executor();
+
+    Executor(const Executor&) = delete;
+    Executor& operator=(const Executor&) = delete;
+
+    /**
+     * @brief The process-wide runtime, started with default options on first use.
+     *
+     * Hold the returned pointer for as long as the runtime is used (a region,
+     * a job and its wait()); a later configure_global() does not pull it away.
+     */
+    static std::shared_ptr<Executor> global();
+
+    /**
+     * @brief Replaces the process-wide runtime.
+     * @param options New thread budget and affinity.
+     *
+     * Later calls to global() return the new runtime. The previous one is
+     * shut down, finishing its jobs, once nobody holds it any more: here if
+     * it is unused, otherwise when its last holder lets go.
+     */
+    static void configure_global(const Options& options);
+
+    /**
+     * @brief Queues a job without a result.
+     * @param job Job to run on some worker; exceptions escaping it terminate the program.
+     */
+    void post(std::function<void()> job);
+
+    /**
+     * @brief Queues a job and returns the future of its result.
+     * @param job Callable taking no arguments.
+     * @return Future holding the result or the exception thrown by the job.
+     */
+    template<typename F>
+    std::future<std::invoke_result_t<F>> submit(F&& job) {
+        using R = std::invoke_result_t<F>;
+        auto task = std::make_shared<std::packaged_task<R()>>(std::forward<F>(job));
+        std::future<R> result = task->get_future();
+        post([task]() { (*task)(); });
+        return result;
+    }
+
+    /**
+     * @brief Runs queued jobs until a future is ready, then returns its result.
+     * @param result Future of a job submitted to this runtime.
+     * @return result.get(), rethrowing the job's exception.
+     *
+     * Lets a job wait for jobs it submitted without idling its worker.
+     */
+    template<typename T>
+    T wait(std::future<T>& result) {
+        while (result.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+            if (!run_pending_job())
+                result.wait_for(std::chrono::microseconds(100));
+        return result.get();
+    }
+
+    /**
+     * @brief Runs one queued job on the calling thread.
+     * @return false if no job was queued.
+     */
+    bool run_pending_job();
+
+    /**
+     * @brief Runs body(thread_id, num_threads) on the caller and idle workers.
+     * @param max_threads Upper bound on the threads of the region, caller included.
+     * @param body Region body; the caller runs thread_id 0.
+     * @param prepare Called with num_threads before any thread starts (e.g. to size a barrier).
+     * @return Threads the region ran on, between 1 and max_threads.
+     *
+     * Every leased worker is running when it is granted, so bodies may
+     * synchronize with spin barriers. Regions nest: a region started from
+     * inside another leases from the workers still idle.
+     */
+    int run_region(int max_threads, const std::function<void(int, int)>& body,
+                   const std::function<void(int)>& prepare = nullptr);
+
+    /**
+     * @brief Number of worker threads.
+     */
+    int size() const { return static_cast<int>(workers.size()); }
+
+    /**
+     * @brief Thread budget: the most threads a region can run on.
+     */
+    int budget() const { return options.threads; }
+
+    /**
+     * @brief Worker placement.
+     */
+    Affinity get_affinity() const { return options.affinity; }
+};
+
+#endif
@@ -0,0 +1,85 @@
+/**
+ * @file fingerprint.h
+ * @brief Incremental 64-bit FNV-1a hash for circuit fingerprints.
+ *
+ * Used to key cached results by circuit content (see Circuit::topology_hash,
+ * Circuit::values_hash and Result_cache). FNV-1a is not cryptographic; it is
+ * stable across platforms and runs, which is what an on-disk key needs.
+ */
+
+#ifndef FINGERPRINT_H
+#define FINGERPRINT_H
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+/**
+ * @class Fingerprint
+ * @brief Accumulates values into a 64-bit FNV-1a hash.
+ *
+ * Every field is length- or type-delimited, so ("ab", "c") and ("a", "bc")
+ * hash differently.
+ *
+ * **Usage:**
+ * ```cpp
+ * Fingerprint fp;
+ * fp.add(std::string("R1"));
+ * fp.add(1000.0);
+ * uint64_t key = fp.value();
+ * ```
+ */
+class Fingerprint {
+private:
+    uint64_t hash;                          // Running hash state
+
+public:
+    Fingerprint() : hash(14695981039346656037ULL) {}
+
+    /**
+     * @brief Adds raw bytes.
+     */
+    void add_bytes(const void* data, size_t size) {
+        const unsigned char* bytes = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < size; i++) {
+            hash ^= bytes[i];
+            hash *= 1099511628211ULL;
+        }
+    }
+
+    /**
+     * @brief Adds a string, prefixed with its length.
+     */
+    void add(const std::string& s) {
+        add(static_cast<uint64_t>(s.size()));
+        add_bytes(s.data(), s.size());
+    }
+
+    /**
+     * @brief Adds an integer as 8 little-endian bytes.
+     */
+    void add(uint64_t v) {
+        unsigned char bytes[8];
+        for (int i = 0; i < 8; i++)
+            bytes[i] = static_cast<unsigned char>(v >> (8 * i));
+        add_bytes(bytes, 8);
+    }
+
+    /**
+     * @brief Adds a double by bit pattern (-0.0 folded into 0.0).
+     */
+    void add(double v) {
+        if (v == 0.0)
+            v = 0.0;
+        uint64_t bits;
+        std::memcpy(&bits, &v, sizeof(bits));
+        add(bits);
+    }
+
+    /**
+     * @brief Current hash value.
+     */
+    uint64_t value() const { return hash; }
+};
+
+#endif
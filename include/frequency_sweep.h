@@ -0,0 +1,73 @@
+/**
+ * @file frequency_sweep.h
+ * @brief Validated frequency points of an AC sweep.
+ *
+ * Every AC entry point (Simulator, Solver, Compiled_circuit, Ac_sweep and the
+ * server) steps through its frequencies with this class, so a sweep that is
+ * rejected by one is rejected by all, and an accepted sweep always ends.
+ */
+
+#ifndef FREQUENCY_SWEEP_H
+#define FREQUENCY_SWEEP_H
+
+#include <cmath>
+#include <vector>
+
+/**
+ * @class Frequency_sweep
+ * @brief Start, end and step of a linear or logarithmic sweep, checked to terminate.
+ *
+ * **Usage:**
+ * ```cpp
+ * Frequency_sweep sweep(10.0, 1e6, 1.05, true);
+ * for (double freq = sweep.first(); sweep.contains(freq); freq = sweep.next(freq))
+ *     solve_point(freq);
+ * ```
+ *
+ * Equal bounds are one point whatever the step. Stepping allocates nothing,
+ * so the loop above can run inside allocation-free solver paths.
+ */
+class Frequency_sweep {
+private:
+    double freq1;       // Start frequency (Hz)
+    double freq2;       // End frequency (Hz)
+    double step;        // Increment (Hz), or factor per point on a log scale
+    bool log_scale;
+
+public:
+    /**
+     * @brief Validates a sweep.
+     * @param freq1 Start frequency in Hertz (> 0).
+     * @param freq2 End frequency in Hertz (>= freq1).
+     * @param step Increment in Hertz, or factor per point with log_scale.
+     * @param log_scale Multiply instead of add (step must then exceed 1).
+     * @throws std::invalid_argument for non-finite values, 0 < freq1 <= freq2
+     *         violated, or (unless freq1 == freq2) a step that cannot advance.
+     */
+    Frequency_sweep(double freq1, double freq2, double step, bool log_scale = false);
+
+    double first() const { return freq1; }
+
+    bool contains(double freq) const { return freq <= freq2; }
+
+    /**
+     * @brief Frequency after freq; past the end for a single-point sweep.
+     */
+    double next(double freq) const {
+        if (freq1 == freq2)
+            return HUGE_VAL;
+        return log_scale ? freq * step : freq + step;
+    }
+
+    /**
+     * @brief Number of points, estimated without stepping (for request limits).
+     */
+    double estimated_points() const;
+
+    /**
+     * @brief Every frequency of the sweep, in order.
+     */
+    std::vector<double> frequencies() const;
+};
+
+#endif
@@ -14,10 +14,11 @@
 
 #include <unordered_map>
 #include <vector>
-#include <set>
 #include <complex>
 #include <cmath>
 #include "I_Printable.h"
+#include "cancellation.h"
+#include "solver_telemetry.h"
 
 /**
  * @class Gauss_seidel
@@ -75,7 +76,9 @@ private:
     std::vector<T> lhs_values;                  // Stored LHS coefficients for zero-diagonal rows
     std::vector<int> targets;                   // Target variable indices for each row
     std::vector<int> var_to_target;             // Map variable index to row index
-    std::set<int> independent_targets;          // Variables that need special handling
+    std::vector<char> independent_targets;      // Flag per variable already claimed as an independent target
+    Solver_telemetry* telemetry;                // Convergence recorder (nullptr = off, not owned)
+    Cancellation_token cancellation;            // Polled once per sweep
 
     /**
      * @brief Initializes internal data structures.
@@ -116,6 +119,13 @@ private:
     bool check_convergence(const std::unordered_map<int, T>& mna_vector,
                            size_t size);
 
+    /**
+     * @brief Largest row residual |(Ax)_i - b_i| of the last sweep.
+     * @param mna_vector Right-hand side vector.
+     * @param size System dimension.
+     */
+    double residual_norm(const std::unordered_map<int, T>& mna_vector, size_t size) const;
+
 public:
     /**
      * @brief Constructs a Gauss-Seidel solver with specified parameters.
@@ -124,6 +134,24 @@ public:
      * @param damping_factor Under-relaxation factor (default: 0.1).
      */
     Gauss_seidel(int max_iter = 1000, double tolerance = 1e-9, double damping_factor = 0.1);
+
+    /**
+     * @brief Changes the iteration limit, tolerance and damping of later solves.
+     * @throws std::invalid_argument if max_iter < 2, tolerance <= 0 or damping_factor is not in (0, 1].
+     */
+    void configure(int max_iter, double tolerance, double damping_factor);
+
+    /**
+     * @brief Attaches a convergence recorder to later solves.
+     * @param telemetry Recorder (not owned), or nullptr to stop recording.
+     */
+    void set_telemetry(Solver_telemetry* telemetry) { this->telemetry = telemetry; }
+
+    /**
+     * @brief Makes later solves poll a cancellation token once per sweep.
+     * @param token Token to poll; a cancelled solve throws Analysis_cancelled.
+     */
+    void set_cancellation(const Cancellation_token& token) { cancellation = token; }
     
     /**
      * @brief Solves the DC linear system using Gauss-Seidel iteration.
@@ -56,7 +56,7 @@ public:
 protected:
     int vc_id;                          // Index for the inductor current variable in MNA system
     double inductance;                  // Inductance value in Henries (H)
-    std::complex<double> admittance;    // Admittance equivalent for AC analysis (1/jωL)
+    std::complex<double> admittance;    // Admittance currently stamped in the AC matrix (1/jωL)
     double current;                     // Computed current through the inductor in Amperes
     
 public:
@@ -89,6 +89,23 @@ public:
      */
     virtual Component_contribution<double> get_contribution() override;
 
+    /**
+     * @brief Changes the inductance in place.
+     * @param value Inductance in Henries.
+     * @throws std::runtime_error if value is not finite and positive (the inductor is left unchanged).
+     */
+    virtual void set_value(double value) override;
+
+    /**
+     * @brief Gets the inductance.
+     */
+    virtual double get_value() const override { return inductance; }
+
+    /**
+     * @brief Creates a copy sharing the same nodes.
+     */
+    virtual Component* clone() const override { return new Inductor(*this); }
+
     /**
      * @brief Generates AC MNA contributions for the inductor.
      * @param frequency AC analysis frequency in Hertz.
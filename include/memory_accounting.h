@@ -0,0 +1,168 @@
+/**
+ * @file memory_accounting.h
+ * @brief Heap accounting per subsystem and process peak RSS.
+ *
+ * Binaries that link src/hooks/memory_hooks.cpp replace the global operator
+ * new/delete by counting versions. Each allocation is charged to the
+ * subsystem tag of the allocating thread (set by Memory_scope), and the tag is
+ * stored in front of the block so that its release is credited back to the
+ * same subsystem. This shows how much the MNA hash maps, Component objects,
+ * Node names, the complex AC copy and the solver factors each hold, and how
+ * many simulations fit in a memory-limited slot.
+ */
+
+#ifndef MEMORY_ACCOUNTING_H
+#define MEMORY_ACCOUNTING_H
+
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+
+/**
+ * @brief Subsystems heap usage is charged to.
+ */
+enum class Memory_tag : uint8_t {
+    other,          // Untagged code (I/O, strings, temporaries)
+    parse,          // Netlist text and component descriptors
+    nodes,          // Node objects, names and node maps
+    components,     // Component objects and the component maps
+    mna,            // Real MNA matrix and vector (nested unordered_map)
+    ac,             // Complex AC system and its per-frequency assembly
+    solver,         // Sparse matrices, LU factors, Gauss-Seidel and dense workspaces
+    count
+};
+
+/**
+ * @class Memory_accounting
+ * @brief Process-wide allocation counters.
+ *
+ * Allocations made while accounting is disabled are not counted, and neither
+ * are their releases. The counting operators are linked only into the test
+ * suites and `make MEMORY=1` builds, because every block they allocate
+ * carries a 16-byte header whether or not accounting is on. Other binaries
+ * allocate through the standard operators and report RSS only.
+ *
+ * **Usage:**
+ * ```cpp
+ * Memory_accounting::enable();
+ * {
+ *     Memory_scope scope(Memory_tag::mna);
+ *     // allocations here are charged to mna
+ * }
+ * Memory_accounting::print(std::cout);
+ * ```
+ */
+class Memory_accounting {
+public:
+    /**
+     * @struct Usage
+     * @brief Counters of one subsystem (or of all of them).
+     */
+    struct Usage {
+        int64_t current = 0;        // Bytes allocated and not yet released
+        int64_t peak = 0;           // Highest current since enable() / reset_peaks()
+        uint64_t allocations = 0;   // Allocations counted
+        uint64_t releases = 0;      // Releases of counted allocations
+    };
+
+    /**
+     * @brief Starts counting new allocations (peaks restart from the current usage).
+     * @throws std::runtime_error if the counting operators are not linked in.
+     */
+    static void enable();
+
+    /**
+     * @brief Stops counting new allocations (releases of counted blocks are still credited).
+     */
+    static void disable();
+
+    /**
+     * @brief Whether new allocations are counted.
+     */
+    static bool is_enabled();
+
+    /**
+     * @brief Whether the counting operator new/delete are linked into this binary.
+     */
+    static bool is_available();
+
+    static constexpr uint8_t untracked = 0xff;  // Tag of blocks allocated while disabled
+
+    /**
+     * @brief Charges an allocation to the calling thread's tag (called by the counting operator new).
+     * @return Tag to store with the block, or untracked while accounting is off.
+     */
+    static uint8_t charge_allocation(size_t bytes);
+
+    /**
+     * @brief Credits a release back to the tag stored with the block (called by the counting operator delete).
+     */
+    static void credit_release(uint8_t tag, size_t bytes);
+
+    /**
+     * @brief Marks the counting operators as linked in (called once by memory_hooks.cpp).
+     */
+    static void register_hooks();
+
+    /**
+     * @brief Restarts every peak from the current usage.
+     */
+    static void reset_peaks();
+
+    /**
+     * @brief Counters of one subsystem.
+     */
+    static Usage usage(Memory_tag tag);
+
+    /**
+     * @brief Counters over all subsystems (its peak is the peak of the sum).
+     */
+    static Usage total();
+
+    /**
+     * @brief Subsystem new allocations of the calling thread are charged to.
+     */
+    static Memory_tag current_tag();
+
+    /**
+     * @brief Short name of a subsystem ("mna", "components", ...).
+     */
+    static const char* tag_name(Memory_tag tag);
+
+    /**
+     * @brief Peak resident set size of the process in bytes (0 if unknown).
+     */
+    static size_t peak_rss();
+
+    /**
+     * @brief Current resident set size of the process in bytes (0 if unknown).
+     */
+    static size_t current_rss();
+
+    /**
+     * @brief Prints current and peak bytes and allocation counts per subsystem, and the process RSS.
+     *
+     * Without the counting operators only the RSS is printed.
+     */
+    static void print(std::ostream& os = std::cout);
+};
+
+/**
+ * @class Memory_scope
+ * @brief RAII: charges the calling thread's allocations to a subsystem until the scope ends.
+ *
+ * Scopes nest; the previous tag is restored on exit.
+ */
+class Memory_scope {
+private:
+    Memory_tag previous;        // Tag restored on destruction
+
+public:
+    explicit Memory_scope(Memory_tag tag);
+    ~Memory_scope();
+
+    Memory_scope(const Memory_scope&) = delete;
+    Memory_scope& operator=(const Memory_scope&) = delete;
+};
+
+#endif
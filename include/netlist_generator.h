@@ -0,0 +1,117 @@
+/**
+ * @file netlist_generator.h
+ * @brief Parametric synthetic circuits for scaling studies.
+ *
+ * Large test inputs are generated on demand instead of checked in: every
+ * topology is a pure function of its size, shape parameters and seed, and is
+ * either streamed as netlist text (constant memory, any size) or added
+ * straight into a Circuit without any text at all.
+ */
+
+#ifndef NETLIST_GENERATOR_H
+#define NETLIST_GENERATOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include "circuit.h"
+
+/**
+ * @class Netlist_generator
+ * @brief Generates ladders, N-D grids, k-ary trees, random geometric graphs and RLC meshes.
+ *
+ * Every circuit is driven by `V1 1 0 DC 10 AC <ac>` and has a DC path to
+ * ground from every node. Node names are numbers (0 = ground).
+ *
+ * | Topology | `size` means | Structure |
+ * |----------|--------------|-----------|
+ * | `ladder` | nodes | Series R (every 16th an L) with shunt R, shunt C on every 4th node |
+ * | `grid` | nodes (rounded down to side^dimensions) | Resistor mesh in `dimensions` dimensions, C to ground on every 8th node, grounded far corner |
+ * | `tree` | nodes | `branching`-ary tree of R from the root, leaves grounded through R, C on every 5th node |
+ * | `random` | nodes | Points uniform in the unit square, R between points closer than the radius giving `degree` neighbours on average, weak leak to ground, C on every 7th node |
+ * | `rlc` | mesh nodes | 2-D mesh: horizontal R, vertical R + L in series (one internal node), C to ground on every node |
+ *
+ * With `reactive = false` no L or C is emitted (pure resistive circuits).
+ *
+ * **Usage:**
+ * ```cpp
+ * Netlist_generator::Spec spec;
+ * spec.topology = Netlist_generator::Topology::grid;
+ * spec.size = 1000000;
+ * spec.dimensions = 3;
+ * Netlist_generator generator(spec);
+ *
+ * std::ofstream file("grid3d.net");
+ * generator.write(file);           // streamed, O(1) memory for ladder/grid/tree/rlc
+ *
+ * Circuit circuit;
+ * generator.build(circuit);        // no text round trip
+ * circuit.assemble_MNA_system();
+ * ```
+ *
+ * @see CircuitBuilder
+ */
+class Netlist_generator {
+public:
+    enum class Topology { ladder, grid, tree, random, rlc };
+
+    /**
+     * @struct Spec
+     * @brief Generator parameters.
+     */
+    struct Spec {
+        Topology topology = Topology::ladder;
+        size_t size = 1000;         // Target node count (see the topology table)
+        int dimensions = 2;         // Grid dimensions
+        int branching = 3;          // Tree branching factor
+        double degree = 6.0;        // Mean neighbour count of random geometric graphs
+        uint64_t seed = 1;          // Seed of random values and positions
+        bool reactive = true;       // Emit inductors and capacitors
+        double ac = 1.0;            // AC amplitude of V1 (0 = DC only)
+    };
+
+    /**
+     * @brief Constructs a generator.
+     * @throws std::invalid_argument for a size below 2 or invalid shape parameters.
+     */
+    explicit Netlist_generator(const Spec& spec);
+
+    /**
+     * @brief Streams the netlist text (with a "* <name>" header line).
+     * @param os Output stream.
+     * @return Number of elements written.
+     */
+    size_t write(std::ostream& os) const;
+
+    /**
+     * @brief Adds the circuit's nodes and components directly.
+     * @param circuit Circuit to populate (normally empty).
+     * @return Number of elements added.
+     */
+    size_t build(Circuit& circuit) const;
+
+    /**
+     * @brief Descriptive name, e.g. "grid_3d_1000000_seed1".
+     */
+    std::string name() const;
+
+    /**
+     * @brief Parses a topology name, optionally with its shape parameter ("grid:3", "tree:4", "random:8").
+     * @param text Topology specification.
+     * @param spec Receives the topology and shape parameter.
+     * @throws std::invalid_argument for unknown names or parameters.
+     */
+    static void parse_topology(const std::string& text, Spec& spec);
+
+private:
+    Spec spec;                      // Generator parameters
+
+    /**
+     * @brief Calls emit(type, prefix, index, node1, node2, value) for every element, in netlist order.
+     */
+    template<typename Emit>
+    void generate(Emit&& emit) const;
+};
+
+#endif
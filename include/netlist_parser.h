@@ -2,7 +2,7 @@
 #define NETLIST_PARSER_H
 
 #include <string>
-#include <fstream>
+#include <istream>
 #include <sstream>
 #include "component_descriptor.h"
 
@@ -17,10 +17,21 @@ class NetlistParser {
 public:
     /**
      * @brief Parses the first line/header comment if it starts with '*'
-     * @param file Reference to an open input file stream.
+     * @param file Reference to an open input stream (file, string or std::cin).
      * @return The parsed circuit name or empty string if not a name comment.
+     *
+     * A first line that is not a header is pushed back when the stream is
+     * seekable; otherwise it is returned through @p rest for the caller to parse.
      */
-    static std::string parse_header(std::ifstream& file);
+    static std::string parse_header(std::istream& file, std::string* rest = nullptr);
+
+    /**
+     * @brief Extracts the circuit name from a header line.
+     * @param line First line of a netlist.
+     * @param is_header Set to whether the line is a '*' header.
+     * @return The title text, empty if there is none.
+     */
+    static std::string parse_title(const std::string& line, bool& is_header);
 
     /**
      * @brief Parses a single netlist line into a ComponentDescriptor.
@@ -40,6 +40,34 @@ public:
     static int node_count;  // Global counter for automatic ID assignment
     static bool valid;      // Flag indicating if node voltages have been computed
 
+    /**
+     * @class Numbering_scope
+     * @brief Gives one circuit build its own MNA numbering (ground = 0).
+     *
+     * Saves node_count and valid, resets them for the circuit built inside
+     * the scope, and restores both when the scope ends, so building a circuit
+     * does not disturb the numbering or validity seen by the caller.
+     *
+     * @code
+     * {
+     *     Node::Numbering_scope numbering;
+     *     CircuitBuilder().build(circuit, path);
+     * }
+     * @endcode
+     */
+    class Numbering_scope {
+    private:
+        int saved_count;
+        bool saved_valid;
+
+    public:
+        Numbering_scope();
+        ~Numbering_scope();
+
+        Numbering_scope(const Numbering_scope&) = delete;
+        Numbering_scope& operator=(const Numbering_scope&) = delete;
+    };
+
     /**
      * @brief Constructs a new Node with the given identifier.
      * @param nodeId String identifier for the node (e.g., "0", "N1", "VCC").
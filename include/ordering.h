@@ -0,0 +1,150 @@
+/**
+ * @file ordering.h
+ * @brief Fill-reducing orderings for sparse direct factorization.
+ *
+ * The order in which unknowns are eliminated decides how much fill-in the
+ * LU factors receive. Circuit graphs eliminated in netlist order can fill
+ * catastrophically (e.g. a tree numbered root-first), so every diagonal
+ * block is symmetrically permuted before factoring.
+ */
+
+#ifndef ORDERING_H
+#define ORDERING_H
+
+#include <vector>
+
+/**
+ * @struct Dissection_tree
+ * @brief Separator tree produced by nested dissection.
+ *
+ * Node i eliminates positions [own_begin[i], own_end[i]): its separator, or
+ * every vertex of a leaf. The positions of a node's descendants precede its
+ * own, and subtrees of different children share no edges, so with a
+ * diagonal (static) pivot order sibling subtrees can be factored in parallel.
+ */
+struct Dissection_tree {
+    std::vector<int> own_begin;     // First position eliminated by the node itself
+    std::vector<int> own_end;       // One past the last such position
+    std::vector<int> parent;        // Parent node (-1 for roots)
+
+    /**
+     * @brief Number of tree nodes.
+     */
+    int num_nodes() const { return static_cast<int>(parent.size()); }
+};
+
+/**
+ * @class Ordering
+ * @brief Stateless utility computing symmetric fill-reducing permutations.
+ *
+ * Orderings operate on the pattern of A + A^T, so applying the permutation
+ * symmetrically (rows and columns) keeps a zero-free diagonal on the diagonal.
+ *
+ * **Usage:**
+ * ```cpp
+ * std::vector<int> perm = Ordering::minimum_degree(n, col_ptr, row_idx);
+ * // perm[k] = original index eliminated k-th
+ *
+ * Dissection_tree tree;
+ * perm = Ordering::nested_dissection(n, col_ptr, row_idx, &tree);
+ * ```
+ *
+ * @see Sparse_lu
+ */
+class Ordering {
+public:
+    /**
+     * @brief Ordering selection for direct factorization.
+     */
+    enum class Method {
+        automatic,          // Nested dissection for large blocks factored in parallel unless it fills more, else minimum degree
+        minimum_degree,
+        nested_dissection
+    };
+
+    /**
+     * @brief Minimum degree ordering on the pattern of A + A^T.
+     * @param n Matrix dimension.
+     * @param col_ptr Column start offsets (size n + 1).
+     * @param row_idx Row indices of the stored entries.
+     * @return Permutation: position -> original index.
+     *
+     * Eliminates the vertex of least current degree first, merging its
+     * neighbours into a clique in the explicit elimination graph. Ties are
+     * broken by index so the result is deterministic.
+     *
+     * @par Time Complexity
+     * O(Σ d_k²) where d_k = degree of the k-th eliminated vertex;
+     * near-linear for the low-fill graphs typical of circuits.
+     *
+     * @par Space Complexity
+     * O(NNZ + fill)
+     */
+    static std::vector<int> minimum_degree(int n, const std::vector<int>& col_ptr, const std::vector<int>& row_idx);
+
+    /**
+     * @brief Nested dissection ordering on the pattern of A + A^T.
+     * @param n Matrix dimension.
+     * @param col_ptr Column start offsets (size n + 1).
+     * @param row_idx Row indices of the stored entries.
+     * @param tree Optional output: separator tree over the returned positions.
+     * @param leaf_size Subgraphs up to this size are ordered by minimum degree (default: 64).
+     * @return Permutation: position -> original index.
+     *
+     * Recursively bisects the graph with a BFS level-set separator grown from
+     * a pseudo-peripheral vertex (the smallest level near the median, thinned
+     * to the vertices adjacent to the far half), orders both halves first and
+     * the separator last. Disconnected
+     * subgraphs become independent children. On 2-D grids the separators are
+     * O(√n), so the elimination tree is short and bushy, unlike the long
+     * critical path minimum degree tends to leave.
+     *
+     * @par Time Complexity
+     * O(NNZ × log n) plus minimum degree on the leaves
+     *
+     * @par Space Complexity
+     * O(n + NNZ)
+     */
+    static std::vector<int> nested_dissection(int n, const std::vector<int>& col_ptr, const std::vector<int>& row_idx,
+                                              Dissection_tree* tree = nullptr, int leaf_size = 64);
+
+    /**
+     * @brief Elimination tree of A + A^T in the given (already permuted) numbering.
+     * @param n Matrix dimension.
+     * @param col_ptr Column start offsets (size n + 1).
+     * @param row_idx Row indices of the stored entries.
+     * @return Parent of each column (-1 for roots). With diagonal pivots, column k
+     *         of L and U depends only on columns in its subtree.
+     *
+     * @par Time Complexity
+     * O(NNZ × α(n))
+     */
+    static std::vector<int> elimination_tree(int n, const std::vector<int>& col_ptr, const std::vector<int>& row_idx);
+
+    /**
+     * @brief Counts the entries of the Cholesky factor of P (A + A^T) P^T.
+     * @param n Matrix dimension.
+     * @param col_ptr Column start offsets (size n + 1).
+     * @param row_idx Row indices of the stored entries.
+     * @param perm Ordering to evaluate (position -> original index).
+     * @param cap Counting stops once this many entries are exceeded.
+     * @return nnz(L) including the diagonal (an upper bound on nnz(L) of an LU
+     *         with diagonal pivots), or a value above cap.
+     *
+     * @par Time Complexity
+     * O(NNZ + min(nnz(L), cap))
+     */
+    static long long factor_nnz(int n, const std::vector<int>& col_ptr, const std::vector<int>& row_idx,
+                                const std::vector<int>& perm, long long cap);
+
+    /**
+     * @brief Builds the symmetric adjacency lists of A + A^T without self loops.
+     * @param n Matrix dimension.
+     * @param col_ptr Column start offsets (size n + 1).
+     * @param row_idx Row indices of the stored entries.
+     * @return Sorted, duplicate-free neighbour list per vertex.
+     */
+    static std::vector<std::vector<int>> symmetric_adjacency(int n, const std::vector<int>& col_ptr, const std::vector<int>& row_idx);
+};
+
+#endif
@@ -0,0 +1,158 @@
+/**
+ * @file output_writer.h
+ * @brief Background thread that formats and writes result files.
+ *
+ * Writing an AC sweep row by row on the solving thread makes every
+ * frequency point wait for number formatting and the filesystem. The
+ * writer moves both onto a dedicated thread: the solver copies raw values
+ * into a pre-allocated record of a single-producer/single-consumer ring
+ * and continues, and the writer thread formats and writes the records in
+ * order. The solver only waits when the ring is full (the disk is slower
+ * than the solver on average) or when it asks for the file to be complete.
+ */
+
+#ifndef OUTPUT_WRITER_H
+#define OUTPUT_WRITER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @class Output_writer
+ * @brief Lock-free SPSC queue of result records drained by one writer thread.
+ *
+ * Records are either text, written verbatim, or rows of numbers, written
+ * as "key, value, ..., count, ...\n" with the stream's default formatting
+ * (the layout of the AC CSV, and of any other sweep or time series). The
+ * ring's records keep their buffers, so a steady stream of rows of the same
+ * width allocates nothing after the first pass through the ring.
+ *
+ * **Usage:**
+ * ```cpp
+ * Output_writer writer;
+ * int sink = writer.open("sweep.csv");
+ * writer.write_text(sink, "Frequency(Hz), V(out)\n");
+ * for (double f : frequencies) {
+ *     Output_writer::Record& row = writer.acquire(sink);
+ *     row.key = f;
+ *     row.values.push_back(solve(f));
+ *     writer.commit();                 // The writer thread formats it
+ * }
+ * writer.close(sink);                  // Waits until the file is complete
+ * ```
+ *
+ * @note One producer thread at a time: open(), acquire()/commit(),
+ *       write_text(), flush() and close() must not be called concurrently.
+ *
+ * @see Ac_analyzer, UI::output_results
+ */
+class Output_writer {
+public:
+    /**
+     * @struct Record
+     * @brief One queued write; filled by the producer between acquire() and commit().
+     */
+    struct Record {
+        enum class Kind { row, text };
+        Kind kind = Kind::row;
+        std::ofstream* stream = nullptr;        // Destination (set by acquire())
+        double key = 0.0;                       // First column of a row (frequency, time, ...)
+        std::vector<double> values;             // Further columns of a row
+        std::vector<long long> counts;          // Integer columns after the values
+        std::string text;                       // Text written verbatim
+    };
+
+private:
+    std::vector<Record> ring;                   // Power-of-two number of records
+    size_t mask;
+    alignas(64) std::atomic<size_t> head;       // Next record the writer thread reads
+    alignas(64) std::atomic<size_t> tail;       // Next record the producer fills
+    std::vector<std::unique_ptr<std::ofstream>> streams;    // Indexed by sink
+    std::vector<std::string> paths;
+    std::thread thread;                         // Started by the first open()
+    std::atomic<bool> sleeping;                 // Writer thread is (about to be) waiting for records
+    std::mutex mutex;                           // Guards stopping and error; pairs with wake_cv
+    std::condition_variable wake_cv;
+    bool stopping;
+    std::vector<std::string> errors;            // Per sink: first write failure, reported once
+
+    void writer_loop();
+    void write(const Record& record);
+    void drain();
+    void note_failures();                       // Moves failed stream states into errors; needs mutex
+
+public:
+    /**
+     * @brief Creates a writer; its thread starts with the first open().
+     * @param capacity Records queued before the producer waits (rounded up to a power of two).
+     */
+    explicit Output_writer(size_t capacity = 16);
+
+    /**
+     * @brief Writes every queued record, then stops the thread and closes the files.
+     */
+    ~Output_writer();
+
+    Output_writer(const Output_writer&) = delete;
+    Output_writer& operator=(const Output_writer&) = delete;
+
+    /**
+     * @brief Opens (truncates) a file for queued writes.
+     * @param path File path.
+     * @return Sink handle, or -1 if the file cannot be opened.
+     */
+    int open(const std::string& path);
+
+    /**
+     * @brief Returns the next free record, waiting while the ring is full.
+     * @param sink Handle returned by open().
+     * @return Row record with empty values and counts; publish it with commit().
+     */
+    Record& acquire(int sink);
+
+    /**
+     * @brief Publishes the record returned by the last acquire().
+     */
+    void commit();
+
+    /**
+     * @brief Queues text written verbatim.
+     */
+    void write_text(int sink, const std::string& text);
+
+    /**
+     * @brief Sizes the buffers of every record for rows of a known width.
+     * @param num_values Values per row.
+     * @param num_counts Integer columns per row.
+     *
+     * Afterwards, rows up to that width allocate nothing, even on the
+     * first pass through the ring. Waits for the queued records first.
+     */
+    void reserve(size_t num_values, size_t num_counts);
+
+    /**
+     * @brief Waits until every queued record is written and the files are flushed.
+     * @throws std::runtime_error for a write failure not reported yet (one per call).
+     */
+    void flush();
+
+    /**
+     * @brief Waits for the queued records, then closes one file.
+     * @throws std::runtime_error if a write to this file failed and was not reported yet.
+     */
+    void close(int sink);
+
+    /**
+     * @brief Records queued before the producer waits.
+     */
+    size_t capacity() const { return ring.size(); }
+};
+
+#endif
@@ -0,0 +1,233 @@
+/**
+ * @file perf_counters.h
+ * @brief Hardware performance counters (Linux perf_event_open) per solver and assembly phase.
+ *
+ * Wall-clock time does not say whether a kernel is limited by memory or by
+ * arithmetic. The phases below read the cycle, instruction, cache and branch
+ * counters of the calling thread around their work. Their kernels also report
+ * a model of the floating-point operations and bytes they touch, so the
+ * report shows IPC, flop rate and bandwidth side by side.
+ */
+
+#ifndef PERF_COUNTERS_H
+#define PERF_COUNTERS_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * @struct Perf_counts
+ * @brief Accumulated measurements of one phase.
+ */
+struct Perf_counts {
+    enum Event { cycles, instructions, cache_references, cache_misses, branch_misses, num_events };
+
+    uint64_t calls = 0;                 // Measured executions
+    double seconds = 0.0;               // Wall time
+    double events[num_events] = {};     // Hardware event counts (scaled when the kernel multiplexed them)
+    bool measured[num_events] = {};     // Whether each event was counted
+    double flops = 0.0;                 // Modelled floating-point operations
+    double bytes = 0.0;                 // Modelled bytes read and written by the kernel
+
+    /**
+     * @brief Instructions per cycle (NaN if not measured).
+     */
+    double ipc() const;
+
+    /**
+     * @brief Modelled GFLOP/s (NaN if the phase reports no flops).
+     */
+    double gflops() const;
+
+    /**
+     * @brief Modelled data bandwidth in GB/s (NaN if the phase reports no bytes).
+     */
+    double bandwidth() const;
+
+    /**
+     * @brief Memory traffic implied by last-level cache misses (64-byte lines) in GB/s (NaN if not measured).
+     */
+    double miss_bandwidth() const;
+
+    /**
+     * @brief Adds another measurement of the same phase.
+     */
+    void merge(const Perf_counts& other);
+};
+
+/**
+ * @class Perf_counters
+ * @brief Counter group of the calling thread.
+ *
+ * Opens cycles, instructions, cache references, cache misses and branch
+ * misses (user space only) as one perf event group, so all of them are read
+ * at once. Events the CPU or kernel refuses are left out. Without
+ * perf_event_open (non-Linux, containers, perf_event_paranoid > 2) only wall
+ * time is measured.
+ */
+class Perf_counters {
+private:
+    int fds[Perf_counts::num_events];   // Event file descriptors (-1 = not counted)
+    int order[Perf_counts::num_events]; // Events in group read order
+    int num_open;                       // Events in the group
+    int leader;                         // Group leader descriptor (-1 = no hardware counters)
+    std::string status;                 // Why counters are unavailable (empty when available)
+
+public:
+    /**
+     * @struct Reading
+     * @brief Raw counter values at one point in time.
+     */
+    struct Reading {
+        double seconds = 0.0;
+        uint64_t values[Perf_counts::num_events] = {};
+        uint64_t time_enabled = 0;      // Kernel time the group was enabled
+        uint64_t time_running = 0;      // Kernel time the group was on the PMU
+    };
+
+    /**
+     * @brief Opens and starts the counter group for the calling thread.
+     */
+    Perf_counters();
+    ~Perf_counters();
+
+    Perf_counters(const Perf_counters&) = delete;
+    Perf_counters& operator=(const Perf_counters&) = delete;
+
+    /**
+     * @brief Whether any hardware event is counted.
+     */
+    bool available() const { return leader >= 0; }
+
+    /**
+     * @brief Reason the hardware counters are unavailable (empty if available).
+     */
+    const std::string& get_status() const { return status; }
+
+    /**
+     * @brief Reads the current values (must be called from the owning thread).
+     */
+    Reading read() const;
+
+    /**
+     * @brief Measurement between two readings (one call, no flops or bytes).
+     */
+    Perf_counts elapsed(const Reading& begin, const Reading& end) const;
+
+    /**
+     * @brief Counter group of the calling thread, opened on first use.
+     */
+    static Perf_counters& local();
+};
+
+/**
+ * @class Perf_profile
+ * @brief Process-wide per-phase totals, filled by Perf_scope.
+ *
+ * **Instrumented phases:**
+ * | Phase | Where | Work model |
+ * |-------|-------|------------|
+ * | `assemble` | Circuit::assemble_MNA_system | none |
+ * | `ac_assemble` | Ac_analyzer assembly per frequency | none |
+ * | `lu_factor` | Sparse_lu numeric factorization | multiply-adds over the L/U pattern |
+ * | `lu_solve` | Sparse_lu triangular solves | one multiply-add per stored L/U entry |
+ * | `gauss_seidel` | Gauss-Seidel DC and AC solves | row updates and residual per iteration, hash-map nodes read |
+ *
+ * Complex multiply-adds count as 8 real flops.
+ *
+ * **Usage:**
+ * ```cpp
+ * Perf_profile::enable();
+ * simulator.run_dc_analysis(circuit);
+ * Perf_profile::print(std::cout);
+ * ```
+ *
+ * @note Counters cover the thread that entered the phase. Work a phase hands
+ *       to pool threads is included in its wall time and work model, but not
+ *       in its hardware counts.
+ */
+class Perf_profile {
+private:
+    static std::atomic<bool> enabled;   // Collection switch checked by every Perf_scope
+
+public:
+    /**
+     * @brief Starts collecting; clears earlier totals.
+     */
+    static void enable();
+
+    /**
+     * @brief Stops collecting (totals are kept).
+     */
+    static void disable();
+
+    /**
+     * @brief Whether phases are measured.
+     */
+    static bool is_enabled() { return enabled.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Adds a measurement to a phase's totals (thread-safe).
+     */
+    static void add(const std::string& phase, const Perf_counts& counts);
+
+    /**
+     * @brief Totals of every measured phase, in order of first measurement.
+     */
+    static std::vector<std::pair<std::string, Perf_counts>> phases();
+
+    /**
+     * @brief Totals of one phase (zero calls if never measured).
+     */
+    static Perf_counts get(const std::string& phase);
+
+    /**
+     * @brief Prints per-phase time, IPC, cache and branch miss rates, GFLOP/s and GB/s.
+     */
+    static void print(std::ostream& os = std::cout);
+};
+
+/**
+ * @class Perf_scope
+ * @brief RAII measurement of the enclosing scope as one call of a phase (no-op while the profile is off).
+ *
+ * **Usage:**
+ * ```cpp
+ * Perf_scope perf("lu_solve");
+ * // ... kernel ...
+ * if (perf.active())
+ *     perf.set_work(flops, bytes);
+ * ```
+ */
+class Perf_scope {
+private:
+    const char* phase;                  // Phase name (string literal)
+    Perf_counters* counters;            // nullptr while the profile is off
+    Perf_counters::Reading begin;       // Reading at construction
+    double flops;                       // Work reported by the kernel
+    double bytes;
+
+public:
+    explicit Perf_scope(const char* phase);
+    ~Perf_scope();
+
+    Perf_scope(const Perf_scope&) = delete;
+    Perf_scope& operator=(const Perf_scope&) = delete;
+
+    /**
+     * @brief Whether this scope is measuring (compute work models only then).
+     */
+    bool active() const { return counters != nullptr; }
+
+    /**
+     * @brief Sets the modelled work of this call.
+     */
+    void set_work(double flops, double bytes) { this->flops = flops; this->bytes = bytes; }
+};
+
+#endif
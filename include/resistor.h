@@ -85,6 +85,23 @@ public:
      * @return Component_contribution with conductance stamp pattern.
      */
     virtual Component_contribution<double> get_contribution() override;
+
+    /**
+     * @brief Changes the resistance in place.
+     * @param value Resistance in Ohms.
+     * @throws std::runtime_error if value is not finite and positive (the resistor is left unchanged).
+     */
+    virtual void set_value(double value) override;
+
+    /**
+     * @brief Gets the resistance.
+     */
+    virtual double get_value() const override { return resistance; }
+
+    /**
+     * @brief Creates a copy sharing the same nodes.
+     */
+    virtual Component* clone() const override { return new Resistor(*this); }
     
     /**
      * @brief Prints resistor information.
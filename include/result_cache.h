@@ -0,0 +1,157 @@
+/**
+ * @file result_cache.h
+ * @brief On-disk memoization of DC and AC results keyed by circuit fingerprints.
+ *
+ * Batch and regression jobs solve the same netlists over and over. Results
+ * are stored under the circuit's topology and values hashes (see
+ * Circuit::topology_hash) and the solver settings they were computed with
+ * (see Solver::configuration_key), so an unchanged circuit is answered from
+ * disk without assembling a factorization or running a single iteration.
+ */
+
+#ifndef RESULT_CACHE_H
+#define RESULT_CACHE_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "I_printable.h"
+#include "circuit.h"
+
+/**
+ * @class Result_cache
+ * @brief Directory of cached DC solutions and AC sweep results.
+ *
+ * **Entries:**
+ * - `<topology>_<values>_<solver>.dc`: DC solution, one "variable value"
+ *   line per node voltage and extra variable, restored by name so a
+ *   reordered netlist still hits.
+ * - `<topology>_<values>_<solver>_<sweep>.ac`: AC results CSV for one sweep,
+ *   preceded by the variable layout of its columns; reused only if the
+ *   layout matches.
+ *
+ * Only converged results should be stored: an entry is replayed as is by
+ * every later run with the same key.
+ *
+ * Entries are written to a temporary file and renamed into place, so
+ * concurrent jobs sharing a directory never read half-written results.
+ * Unreadable or mismatching entries count as misses.
+ *
+ * **Usage:**
+ * ```cpp
+ * Result_cache cache(".circuit_cache");
+ * std::vector<double> solution;
+ * if (!cache.load_dc(circuit, solver.configuration_key(), solution)) {
+ *     solver.solve_MNA_system(circuit.get_MNA_matrix(), circuit.get_MNA_vector(), solution);
+ *     if (solver.is_converged())
+ *         cache.store_dc(circuit, solver.configuration_key(), solution);
+ * }
+ * ```
+ *
+ * @see Circuit::topology_hash, Circuit::values_hash, Simulator::set_result_cache
+ */
+class Result_cache : public I_Printable {
+private:
+    std::string directory;                  // Cache directory (empty = disabled)
+    int hits;                               // Lookups answered from disk
+    int misses;                             // Lookups that had to be solved
+
+    /**
+     * @brief Entry path for the circuit's current fingerprints and a solver configuration.
+     */
+    std::string entry_path(const Circuit& circuit, uint64_t solver, const std::string& suffix) const;
+
+    /**
+     * @brief Name of every solution index ("" for unused indices).
+     */
+    static std::vector<std::string> variable_names(const Circuit& circuit);
+
+    /**
+     * @brief Writes an entry atomically (temporary file, then rename).
+     * @throws std::runtime_error if the entry cannot be written.
+     */
+    static void write_entry(const std::string& path, const std::string& content);
+
+public:
+    /**
+     * @brief Constructs a cache.
+     * @param directory Cache directory, created if missing (empty = disabled).
+     * @throws std::runtime_error if the directory cannot be created.
+     */
+    explicit Result_cache(const std::string& directory = "");
+
+    /**
+     * @brief Changes the cache directory (empty disables caching).
+     * @throws std::runtime_error if the directory cannot be created.
+     */
+    void set_directory(const std::string& directory);
+
+    /**
+     * @brief Whether a cache directory is configured.
+     */
+    bool enabled() const { return !directory.empty(); }
+
+    /**
+     * @brief Looks up the DC solution of the circuit.
+     * @param circuit Circuit (its MNA system need not be assembled).
+     * @param solver Key of the solver settings (see Solver::configuration_key).
+     * @param solution Filled with the cached solution vector on a hit.
+     * @return true on a hit.
+     *
+     * @par Time Complexity
+     * O(C log C + N) (fingerprints and restore)
+     */
+    bool load_dc(const Circuit& circuit, uint64_t solver, std::vector<double>& solution);
+
+    /**
+     * @brief Stores the DC solution of the circuit.
+     * @param circuit Circuit the solution belongs to.
+     * @param solver Key of the solver settings the solution was computed with.
+     * @param solution Solution vector (index 0 = ground).
+     * @throws std::runtime_error if the entry cannot be written.
+     */
+    void store_dc(const Circuit& circuit, uint64_t solver, const std::vector<double>& solution);
+
+    /**
+     * @brief Key of an AC sweep.
+     */
+    static uint64_t sweep_key(double freq1, double freq2, double step, bool log_scale);
+
+    /**
+     * @brief Looks up an AC sweep and copies its CSV to output_file on a hit.
+     * @param circuit Circuit the sweep was run on.
+     * @param solver Key of the solver settings (see Solver::configuration_key).
+     * @param sweep Key from sweep_key().
+     * @param output_file Destination of the AC results CSV.
+     * @return true on a hit.
+     */
+    bool load_ac(const Circuit& circuit, uint64_t solver, uint64_t sweep, const std::string& output_file);
+
+    /**
+     * @brief Stores the AC results CSV of a finished sweep.
+     * @param circuit Circuit the sweep was run on.
+     * @param solver Key of the solver settings the sweep was computed with.
+     * @param sweep Key from sweep_key().
+     * @param output_file AC results CSV written by the sweep.
+     * @throws std::runtime_error if the CSV cannot be read or the entry cannot be written.
+     */
+    void store_ac(const Circuit& circuit, uint64_t solver, uint64_t sweep, const std::string& output_file);
+
+    /**
+     * @brief Number of lookups answered from disk.
+     */
+    int get_hits() const { return hits; }
+
+    /**
+     * @brief Number of lookups that missed.
+     */
+    int get_misses() const { return misses; }
+
+    /**
+     * @brief Prints the cache directory and hit statistics.
+     * @param os Output stream (default: std::cout).
+     */
+    virtual void print(std::ostream& os = std::cout) const override;
+};
+
+#endif
@@ -0,0 +1,137 @@
+/**
+ * @file server.h
+ * @brief Long-running simulation server with resident circuits.
+ *
+ * A one-shot run pays process startup, parsing and assembly for every query.
+ * Optimization loops issue thousands of small edits against the same
+ * circuit; the server keeps each circuit, its simulator and its sparse
+ * factorization in memory and answers line-oriented commands on stdin/stdout
+ * or a local UNIX socket.
+ */
+
+#ifndef SERVER_H
+#define SERVER_H
+
+#include <iostream>
+#include <map>
+#include <memory>
+#include <string>
+#include "circuit.h"
+#include "simulator.h"
+
+/**
+ * @class Server
+ * @brief Line protocol front end over named resident circuits.
+ *
+ * Every request is one line of whitespace-separated tokens; every response
+ * is one line, "OK [payload]" or "ERR message".
+ *
+ * | Command | Effect | Payload |
+ * |---------|--------|---------|
+ * | `load <name> <file>` | Builds a netlist or circuit image and assembles it (name: letters, digits, `_`, `-`) | nodes, components |
+ * | `set <name> <component> <value>` | Changes a value and re-solves DC (low-rank update of the resident factors) | - |
+ * | `dc <name>` | DC operating point (skipped if nothing changed since the last solve) | - |
+ * | `ac <name> <f1> <f2> <step> [log]` | AC sweep (at most max_ac_points; one point if f1 = f2), CSV written to `<name>_ac.csv` | CSV path |
+ * | `probe <name> <V(node)\|I(comp)>...` | Values of the last DC solution | one value per probe |
+ * | `unload <name>` | Frees the circuit | - |
+ * | `list` | Resident circuits | names |
+ * | `quit` | Ends the session (stdin) or the connection (socket) | - |
+ * | `shutdown` | Stops the socket server | - |
+ *
+ * **Usage:**
+ * ```cpp
+ * Server server;
+ * server.serve(std::cin, std::cout);       // or server.serve_socket("/tmp/sim.sock");
+ * ```
+ * ```
+ * > load amp tests/test_netlists/voltage_divider.net
+ * OK 2 3
+ * > set amp R2 2200
+ * OK
+ * > probe amp V(2) I(V1)
+ * OK 6.875 -0.003125
+ * ```
+ *
+ * @note Circuits use the direct solver, so repeated solves of the same
+ *       pattern reuse the symbolic analysis and value edits reuse the numeric
+ *       factors.
+ *
+ * @see Simulator::update_component, Circuit_image
+ */
+class Server {
+private:
+    struct Session {
+        std::unique_ptr<Circuit> circuit;   // Resident circuit (assembled)
+        std::unique_ptr<Simulator> simulator;   // Its simulator and factorization
+        bool solved = false;                // DC solution is current
+    };
+
+    std::map<std::string, Session> sessions;    // Resident circuits by name
+    bool stopping;                          // Set by "shutdown"
+
+    /**
+     * @brief Finds a resident circuit.
+     * @throws std::runtime_error if no circuit has this name.
+     */
+    Session& session(const std::string& name);
+
+    /**
+     * @brief Solves DC if the resident solution is stale.
+     */
+    void ensure_solved(Session& s);
+
+    /**
+     * @brief Validates a client AC sweep before it reaches the simulator.
+     * @throws std::invalid_argument for a sweep Frequency_sweep rejects or one
+     *         of more than max_ac_points.
+     */
+    static void check_sweep(double freq1, double freq2, double step, bool log_scale);
+
+    /**
+     * @brief Whether a circuit name is safe to use in output file names ([A-Za-z0-9_-]+).
+     */
+    static bool valid_name(const std::string& name);
+
+public:
+    static constexpr size_t max_ac_points = 100000;    // Longest AC sweep one request may ask for
+
+    Server();
+
+    /**
+     * @brief Executes one request line.
+     * @param line Request (see the command table).
+     * @return Response line without the trailing newline; empty for a blank request.
+     *
+     * Errors of a command are reported as "ERR ..." and leave other circuits untouched.
+     */
+    std::string handle(const std::string& line);
+
+    /**
+     * @brief Serves requests from a stream until "quit", "shutdown" or end of input.
+     * @param in Request stream (e.g. std::cin).
+     * @param out Response stream, flushed after every response.
+     */
+    void serve(std::istream& in, std::ostream& out);
+
+    /**
+     * @brief Serves connections on a UNIX domain socket until "shutdown".
+     * @param path Socket path (an existing file at this path is replaced);
+     *        the socket is created with mode 0600, so only its owner can connect.
+     * @throws std::runtime_error if the socket cannot be created, if
+     *         accept() fails with a non-recoverable error, or on platforms
+     *         without UNIX domain sockets.
+     *
+     * Connections are served one at a time; resident circuits persist
+     * across connections. A client that disconnects before reading its
+     * reply only ends its own connection (no SIGPIPE), and running out of
+     * descriptors backs off instead of spinning.
+     */
+    void serve_socket(const std::string& path);
+
+    /**
+     * @brief Whether "shutdown" was received.
+     */
+    bool is_stopping() const { return stopping; }
+};
+
+#endif
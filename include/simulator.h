@@ -11,6 +11,14 @@
 
 #include "solver.h"
 #include "circuit.h"
+#include "monte_carlo.h"
+#include "result_cache.h"
+#include "solver_tuner.h"
+#include "compiled_circuit.h"
+#include "executor.h"
+#include <future>
+#include <memory>
+#include <vector>
 
 /**
  * @class Simulator
@@ -43,6 +51,17 @@
  * circuit.print_solution();
  * std::cout << sim;  // Print solver info
  * ```
+ *
+ * **Asynchronous analyses** run on a compiled snapshot of the circuit (see
+ * Compiled_circuit) as jobs of the global runtime (see Executor), so
+ * several can overlap and the circuit stays free for editing:
+ * ```cpp
+ * Cancellation_token token = Cancellation_token::create();
+ * std::future<Ac_result> sweep = sim.run_ac_analysis_async(circuit, 1.0, 1e6, 1.01, true, token,
+ *     [](size_t done, size_t total) { report(done, total); });
+ * std::future<Dc_result> op = sim.run_dc_analysis_async(circuit);
+ * token.cancel();                      // sweep.get() throws Analysis_cancelled
+ * ```
  * 
  * @see Circuit, Solver
  */
@@ -50,6 +69,10 @@ class Simulator : public I_Printable {
 private:
     Solver solver;                  // Linear system solver
     std::vector<double> solution;   // Last computed solution vector
+    Monte_carlo monte_carlo;        // Last Monte Carlo tolerance analysis
+    Result_cache result_cache;      // On-disk results of earlier runs (disabled by default)
+    Solver_tuner tuner;             // On-disk tuned solver configurations (disabled by default)
+    bool dc_cached;                 // Last DC solution came from the result cache
     
 public:
     /**
@@ -57,6 +80,101 @@ public:
      * @param ac_output_file Path for AC analysis results (default: "ac_analysis_results.csv").
      */
     Simulator(const std::string& ac_output_file = "ac_analysis_results.csv");
+
+    /**
+     * @brief Selects the linear solver backend used by subsequent analyses.
+     * @param method Solver::Method::automatic (default: chosen from the system structure),
+     *        gauss_seidel, sparse_lu or pcg.
+     */
+    void set_solver_method(Solver::Method method) { solver.set_method(method); }
+
+    /**
+     * @brief Gets the backend selected for the last DC system and the reason (see Solver::analyze).
+     */
+    const Solver::Selection& get_solver_selection() const { return solver.get_selection(); }
+
+    /**
+     * @brief Gets the background writer of the AC results, for other result files of the run.
+     */
+    Output_writer& get_output_writer() { return solver.get_output_writer(); }
+
+    /**
+     * @brief Sets the threads used by parallel triangular solves (direct backend).
+     * @param num_threads Threads including the caller (1 = sequential, 0 = all cores).
+     */
+    void set_num_threads(int num_threads) { solver.set_num_threads(num_threads); }
+
+    /**
+     * @brief Selects the fill-reducing ordering of the direct backend.
+     * @param ordering Ordering::Method::automatic (default), minimum_degree or nested_dissection.
+     */
+    void set_ordering(Ordering::Method ordering) { solver.set_ordering(ordering); }
+
+    /**
+     * @brief Sets the largest system solved by the dense fast path ahead of the automatically selected backend.
+     * @param size Dimension limit (0 disables the fast path, at most 32; default 32).
+     */
+    void set_dense_max_size(int size) { solver.set_dense_max_size(size); }
+
+    /**
+     * @brief Sets the Gauss-Seidel iteration limit, tolerance and damping (see Solver::set_gauss_seidel).
+     */
+    void set_gauss_seidel(int max_iter, double tolerance, double damping_factor) {
+        solver.set_gauss_seidel(max_iter, tolerance, damping_factor);
+    }
+
+    /**
+     * @brief Records Gauss-Seidel convergence of later solves (see Solver_telemetry).
+     * @param telemetry Recorder (not owned), or nullptr to stop recording.
+     */
+    void set_telemetry(Solver_telemetry* telemetry) { solver.set_telemetry(telemetry); }
+
+    /**
+     * @brief Makes later synchronous analyses poll a cancellation token (see Solver::set_cancellation).
+     * @param token Token another thread may cancel; an inert token turns polling off.
+     */
+    void set_cancellation(const Cancellation_token& token) { solver.set_cancellation(token); }
+
+    /**
+     * @brief Enables memoization of DC and AC results across runs.
+     * @param directory Cache directory, created if missing (empty disables).
+     * @throws std::runtime_error if the directory cannot be created.
+     *
+     * Analyses of a circuit whose topology and values hashes and solver
+     * settings match a stored entry return the stored results without
+     * solving (see Result_cache). Only converged results are stored.
+     */
+    void set_result_cache(const std::string& directory) { result_cache.set_directory(directory); }
+
+    /**
+     * @brief Enables tuned solver configurations for later DC analyses.
+     * @param directory Tuning directory, created if missing (empty disables).
+     * @param tune_on_miss Trial-run the candidates when the directory has no entry for the
+     *        circuit (false: apply stored entries only).
+     * @throws std::runtime_error if the directory cannot be created.
+     *
+     * A configuration found or tuned for the circuit replaces the solver
+     * method, ordering, threads, damping and preconditioner (see Solver_tuner).
+     */
+    void set_tuning(const std::string& directory, bool tune_on_miss = true) {
+        tuner.set_directory(directory, tune_on_miss);
+    }
+
+    /**
+     * @brief Gets the solver tuner (source of the applied configuration, trials).
+     */
+    const Solver_tuner& get_tuner() const { return tuner; }
+
+    /**
+     * @brief Gets the result cache (hit statistics).
+     */
+    const Result_cache& get_result_cache() const { return result_cache; }
+
+    /**
+     * @brief Gets the last computed DC solution vector.
+     * @return Const reference to x (index 0 = ground, then node voltages and extra variables).
+     */
+    const std::vector<double>& get_solution() const { return solution; }
     /**
      * @brief Performs DC operating point analysis.
      * @param circuit The circuit to analyze (must have MNA system assembled).
@@ -67,7 +185,9 @@ public:
      * 3. Deploys the solution back to the circuit's nodes and components
      * 
      * After this call, node voltages and source currents are available
-     * through the circuit's accessor methods.
+     * through the circuit's accessor methods. With a result cache, a stored
+     * solution of an identical circuit replaces steps 1-2. With tuning
+     * enabled, the tuned configuration is applied before step 2.
      * 
      * @par Time Complexity
      * O(I × N × K) dominated by the iterative solver, where:
@@ -80,6 +200,72 @@ public:
      */
     void run_dc_analysis(Circuit& circuit);
 
+    /**
+     * @brief Performs DC analysis of many small circuits, solving same-pattern ones together.
+     * @param circuits Circuits with their MNA systems assembled (e.g. one netlist with different values).
+     * @return Number of circuits solved in SIMD lanes; the others went through run_dc_analysis().
+     *
+     * Circuits of up to batch_lu_max_size unknowns whose assembled systems
+     * have an identical sparsity pattern (Sparse_matrix::same_pattern) are
+     * factored batch_lu_lanes at a time by Batch_lu. A pattern with a single
+     * circuit, a singular representative or a singular lane falls back to a
+     * scalar solve, as do larger circuits. Every solution is deployed to its
+     * circuit; the result cache and tuning apply to the scalar solves only.
+     *
+     * **Usage:**
+     * ```cpp
+     * std::vector<Circuit*> dividers = ...;   // voltage_divider.net with swept R2
+     * int lanes = sim.run_batch(dividers);
+     * double v = dividers[3]->get_nodes().at("2")->voltage;
+     * ```
+     *
+     * @par Time Complexity
+     * O(C / W × fill(LU)) W-wide operations for C circuits of one pattern
+     */
+    int run_batch(const std::vector<Circuit*>& circuits);
+
+    /**
+     * @brief Changes one component value and re-solves the DC operating point.
+     * @param circuit The circuit last passed to run_dc_analysis().
+     * @param id Component ID (e.g. "R12").
+     * @param value New value in the component's base unit.
+     * @throws std::runtime_error if the component does not exist or has no adjustable value.
+     *
+     * Intended for interactive what-if edits: with the sparse LU backend the
+     * change is applied as a low-rank update of the existing factorization
+     * instead of re-assembling and refactoring (see Solver::update_MNA_system).
+     *
+     * **Usage:**
+     * ```cpp
+     * sim.set_solver_method(Solver::Method::sparse_lu);
+     * sim.run_dc_analysis(circuit);
+     * sim.update_component(circuit, "R7", 2200.0);   // node voltages updated
+     * ```
+     *
+     * @par Time Complexity
+     * O(nnz(L) + nnz(U)) per edit until the accumulated rank forces a refactorization
+     */
+    void update_component(Circuit& circuit, const std::string& id, double value);
+
+    /**
+     * @brief Performs Monte Carlo tolerance analysis of the DC operating point.
+     * @param circuit The circuit to analyze (must have MNA system assembled; not modified).
+     * @param num_samples Number of samples.
+     * @param seed Base seed of the per-sample random streams (default: 1).
+     *
+     * Samples run on the thread pool configured by set_num_threads(); the
+     * results do not depend on the thread count. See Monte_carlo.
+     *
+     * @par Time Complexity
+     * O(S × flops(LU)) for S samples, divided across threads
+     */
+    void run_monte_carlo(Circuit& circuit, int num_samples, uint64_t seed = 1);
+
+    /**
+     * @brief Gets the last Monte Carlo analysis.
+     */
+    const Monte_carlo& get_monte_carlo() const { return monte_carlo; }
+
     /**
      * @brief Performs AC frequency sweep analysis.
      * @param circuit The circuit to analyze (must have MNA system assembled).
@@ -103,6 +289,9 @@ public:
      * 
      * @note DC analysis should typically be run first to establish operating point.
      * 
+     * @throws std::invalid_argument for a sweep Frequency_sweep rejects (non-finite,
+     *         out of order, or a step that cannot advance).
+     * 
      * @par Time Complexity
      * O(F × I × N × K) where F = (freq2-freq1)/step frequency points
      * 
@@ -131,6 +320,53 @@ public:
      * @see run_dc_analysis(), run_ac_analysis()
      */
     void run_ac_analysis(Circuit& circuit, double frequency);
+
+    /**
+     * @brief Submits a DC analysis of a compiled circuit.
+     * @param circuit Compiled circuit (shared with the job).
+     * @param token Cancellation token polled by the job (default: not cancellable).
+     * @return Future of the result; get() rethrows solver errors and Analysis_cancelled.
+     *
+     * Asynchronous analyses bypass the result cache and tuning, and leave
+     * get_solution() and the circuit's node voltages untouched.
+     */
+    std::future<Dc_result> run_dc_analysis_async(std::shared_ptr<const Compiled_circuit> circuit,
+                                                 const Cancellation_token& token = Cancellation_token());
+
+    /**
+     * @brief Compiles an assembled circuit and submits its DC analysis.
+     * @throws std::runtime_error if the MNA system has not been assembled (thrown here, not by the future).
+     *
+     * The circuit is compiled on the calling thread and may be edited as
+     * soon as this returns.
+     */
+    std::future<Dc_result> run_dc_analysis_async(const Circuit& circuit,
+                                                 const Cancellation_token& token = Cancellation_token());
+
+    /**
+     * @brief Submits an AC sweep of a compiled circuit.
+     * @param circuit Compiled circuit (shared with the job).
+     * @param freq1 Start frequency in Hertz.
+     * @param freq2 End frequency in Hertz.
+     * @param step Frequency step (factor with log_scale).
+     * @param log_scale Logarithmic stepping.
+     * @param token Cancellation token polled per frequency point.
+     * @param progress Called after every point as progress(done, total), on a worker thread.
+     * @return Future of the sweep; get() rethrows invalid arguments, solver errors and Analysis_cancelled.
+     */
+    std::future<Ac_result> run_ac_analysis_async(std::shared_ptr<const Compiled_circuit> circuit,
+                                                 double freq1, double freq2, double step, bool log_scale = false,
+                                                 const Cancellation_token& token = Cancellation_token(),
+                                                 Progress_callback progress = nullptr);
+
+    /**
+     * @brief Compiles an assembled circuit and submits its AC sweep.
+     * @throws std::runtime_error if the MNA system has not been assembled (thrown here, not by the future).
+     */
+    std::future<Ac_result> run_ac_analysis_async(const Circuit& circuit,
+                                                 double freq1, double freq2, double step, bool log_scale = false,
+                                                 const Cancellation_token& token = Cancellation_token(),
+                                                 Progress_callback progress = nullptr);
     
     /**
      * @brief Prints simulation results and solver statistics.
@@ -11,18 +11,54 @@
 #define SOLVER_H
 
 #include <complex>
+#include <cstdint>
+#include <memory>
+#include <string>
 #include "I_Printable.h"
 #include "component.h"
 #include "gauss_seidel.h"
+#include "sparse_matrix.h"
+#include "sparse_lu.h"
+#include "dense_lu.h"
+#include "pcg.h"
+#include "system_structure.h"
 #include "ac_analyzer.h"
+#include "cancellation.h"
 
 /**
  * @class Solver
  * @brief High-level interface for solving MNA linear systems.
  * 
- * The Solver class wraps the underlying iterative solver (Gauss-Seidel)
- * and provides additional functionality such as timing measurements
- * and a simplified interface for the Simulator class.
+ * The Solver class wraps the underlying linear solver and provides
+ * additional functionality such as timing measurements and a simplified
+ * interface for the Simulator class. Three backends are available:
+ * - Method::gauss_seidel: Modified Gauss-Seidel iteration
+ * - Method::sparse_lu: BTF-ordered sparse direct LU (see Sparse_lu)
+ * - Method::pcg: Jacobi-preconditioned conjugate gradient, DC only (see Pcg)
+ *
+ * Method::automatic (default) picks one of them from the structure of the
+ * assembled DC system (see System_structure), together with the ordering
+ * and thread count of the direct backend:
+ * | Structure | Choice |
+ * |-----------|--------|
+ * | At most dense_max_size unknowns | Dense fast path, sparse LU if singular |
+ * | Tree-shaped | Sparse LU, minimum degree (factors without fill) |
+ * | Zero diagonals (voltage sources, inductors) | Sparse LU |
+ * | SPD, ≥ pcg_min_size unknowns, ≥ pcg_min_degree neighbours per row | Conjugate gradient |
+ * | Every row dominant by a factor ≥ 2 | Gauss-Seidel |
+ * | Otherwise | Sparse LU |
+ *
+ * Sparse LU of at least parallel_min_size unknowns also gets up to 8
+ * threads. Explicit set_num_threads() and set_ordering() calls are never
+ * overridden. The analysis is redone only when the dimension or number of
+ * stored entries of the system changes, and the choice and its reason are
+ * reported by get_selection() and print(). AC analysis uses Gauss-Seidel
+ * when it was selected for DC and sparse LU otherwise.
+ *
+ * Under automatic selection, systems of at most dense_max_size (default 32)
+ * unknowns are first tried on the stack-allocated dense LU (see
+ * Dense_solver); only singular ones reach the selected backend. An explicit
+ * method always runs its own backend.
  * 
  * **Usage:**
  * ```cpp
@@ -34,12 +70,83 @@
  * @note The solver automatically resizes the solution vector to match
  *       the system size.
  * 
- * @see Gauss_seidel, Simulator
+ * @see Gauss_seidel, Sparse_lu, Simulator
  */
 class Solver : public I_Printable {
+public:
+    /**
+     * @brief Linear system backends available to DC and AC analysis.
+     */
+    enum class Method { gauss_seidel, sparse_lu, pcg, automatic };
+
+    /**
+     * @struct Selection
+     * @brief Backend chosen for the current DC system and why.
+     */
+    struct Selection {
+        bool valid = false;                 // An analysis has been made
+        Method method = Method::sparse_lu;  // Backend used (never automatic)
+        Ordering::Method ordering = Ordering::Method::automatic;    // Ordering of the direct backend
+        int threads = 1;                    // Threads of the direct backend
+        std::string reason;                 // Human-readable rationale
+        System_structure structure;         // Statistics the choice was made from
+        size_t rows = 0;                    // Signature of the analyzed system: MNA rows
+        size_t entries = 0;                 // and stored entries
+    };
+
+    /**
+     * @struct Configuration
+     * @brief Complete backend setup, as tried and stored by Solver_tuner.
+     */
+    struct Configuration {
+        Method method = Method::sparse_lu;  // Backend (not automatic)
+        Ordering::Method ordering = Ordering::Method::automatic;    // Ordering of the direct backend
+        int threads = 1;                    // Threads of the direct backend
+        double damping = 0.5;               // Gauss-Seidel under-relaxation factor
+        Pcg::Preconditioner preconditioner = Pcg::Preconditioner::jacobi;  // Conjugate gradient preconditioner
+    };
+
+    /**
+     * @struct Settings
+     * @brief Backend settings as the caller left them, including automatic choices (see settings()).
+     */
+    struct Settings {
+        Configuration config;               // Backend (may be automatic), ordering, threads, damping, preconditioner
+        Ordering::Method ac_ordering = Ordering::Method::automatic;  // Ordering of the AC direct backend
+        bool threads_set = false;           // Thread count explicit rather than from selection
+        bool ordering_set = false;          // Ordering explicit rather than from selection
+    };
+
+    static constexpr int pcg_min_size = 2000;           // Smallest SPD system given to conjugate gradient
+    static constexpr double pcg_min_degree = 5.0;       // Neighbours per row from which LU fill outgrows CG (3-D meshes)
+    static constexpr int parallel_min_size = 50000;     // Smallest system factored on several threads
+
 private:
+    Method method;                          // Requested backend (automatic = from structure)
+    Selection selection;                    // Outcome of the last structural analysis
+    Method dc_method;                       // Backend of the last DC solve (automatic = none yet)
+    bool threads_set;                       // set_num_threads() was called explicitly
+    bool ordering_set;                      // set_ordering() was called explicitly
     Gauss_seidel<double> gauss_seidel;      // DC solver (real-valued)
     Gauss_seidel<std::complex<double>> gauss_seidel_ac;  // AC solver (complex-valued)
+    Sparse_matrix<double> dc_matrix;        // CSC copy of the DC system (direct backend)
+    Sparse_lu<double> sparse_lu;            // DC direct solver
+    Sparse_matrix<std::complex<double>> ac_matrix;       // CSC copy of the AC system (direct backend)
+    Sparse_lu<std::complex<double>> sparse_lu_ac;        // AC direct solver (symbolic reused across frequencies)
+    std::vector<double> dc_rhs;             // Compact RHS/solution workspace (direct backend)
+    std::vector<std::complex<double>> ac_rhs;            // Compact RHS/solution workspace (direct backend)
+    Pcg pcg;                                // DC iterative solver for SPD systems
+    std::vector<double> dc_x;               // Compact initial guess/solution (conjugate gradient)
+    std::vector<int> update_positions, update_rows, update_cols;    // update_MNA_system() workspaces
+    std::vector<double> update_values;
+    Dense_solver<double> dense;             // Fast path for tiny DC systems
+    Dense_solver<std::complex<double>> dense_ac;         // Fast path for tiny AC systems
+    bool dc_dense;                          // Last DC system was solved by the fast path
+    bool ac_converged;                      // Every point of the last AC sweep met its tolerance
+    std::unique_ptr<Thread_pool> thread_pool;            // Workers for parallel triangular solves (nullptr = sequential)
+    Solver_telemetry* telemetry;            // Gauss-Seidel convergence recorder (nullptr = off, not owned)
+    Cancellation_token cancellation;        // Polled between AC frequency points (and by every backend)
+    Output_writer output_writer;            // Background thread writing the AC results (and the report)
     Ac_analyzer ac_analyzer;                // AC analysis handler
     std::chrono::microseconds duration;     // Time taken for DC solve operation
     std::chrono::microseconds ac_duration;  // Time taken for AC solve operation
@@ -54,6 +161,16 @@ private:
      * and logs the solution for one frequency point.
      */
     void get_ac_response(const std::unordered_map<std::string, Component*>& ac_components, double frequency);
+
+    /**
+     * @brief Backend that serves DC solves: the requested one, or the selection when automatic.
+     */
+    Method active_method() const { return method == Method::automatic ? selection.method : method; }
+
+    /**
+     * @brief Sets the pool size without marking the thread count as explicit.
+     */
+    void apply_num_threads(int num_threads);
     
 public:
     /**
@@ -70,6 +187,146 @@ public:
      * @param path Path for AC analysis results CSV.
      */
     void set_ac_output_file(const std::string& path);
+
+    /**
+     * @brief Gets the AC output file path.
+     */
+    const std::string& get_ac_output_file() const { return ac_analyzer.output_file; }
+
+    /**
+     * @brief Gets the background writer of the AC results, shared with other result files.
+     */
+    Output_writer& get_output_writer() { return output_writer; }
+
+    /**
+     * @brief Selects the linear system backend.
+     * @param m Backend used by subsequent DC and AC solves (automatic: from the system structure).
+     */
+    void set_method(Method m) {
+        method = m;
+        selection.valid = false;
+    }
+
+    /**
+     * @brief Gets the selected linear system backend.
+     */
+    Method get_method() const { return method; }
+
+    /**
+     * @brief Gets the outcome of the last structural analysis (valid after a DC solve or analyze()).
+     */
+    const Selection& get_selection() const { return selection; }
+
+    /**
+     * @brief Whether the last DC solve met its tolerance.
+     *
+     * Gauss-Seidel stops at its iteration limit without failing; the direct
+     * backends (and conjugate gradient, which falls back to sparse LU) always
+     * count as converged.
+     */
+    bool is_converged() const { return dc_method != Method::gauss_seidel || dc_dense || gauss_seidel.converged; }
+
+    /**
+     * @brief Whether every frequency point of the last AC sweep met its tolerance.
+     */
+    bool is_ac_converged() const { return ac_converged; }
+
+    /**
+     * @brief Fingerprint of the settings a solution depends on.
+     *
+     * Covers the requested method and the Gauss-Seidel iteration limit,
+     * tolerance and damping, so results stored by Result_cache are only
+     * reused by a solver configured the same way.
+     */
+    uint64_t configuration_key() const;
+
+    /**
+     * @brief Analyzes the structure of a DC system and selects the backend for it.
+     * @param mna_matrix Sparse system matrix A (row -> col -> value).
+     * @return The selection. With an explicit method it records the structure only.
+     *
+     * Called by solve_MNA_system() whenever the system's signature changes;
+     * an explicit call forces a new analysis.
+     *
+     * @par Time Complexity
+     * O(NNZ log K), one CSC assembly plus a pass over it
+     */
+    const Selection& analyze(const std::unordered_map<int,std::unordered_map<int,double>>& mna_matrix);
+
+    /**
+     * @brief Display name of a backend ("Gauss-Seidel", "Sparse LU", ...).
+     */
+    static const char* method_name(Method m);
+
+    /**
+     * @brief Sets the largest system solved by the dense fast path.
+     * @param size Dimension limit (0 disables the fast path, at most 32).
+     * @throws std::invalid_argument if size is out of range.
+     */
+    void set_dense_max_size(int size);
+    int get_dense_max_size() const { return dense.get_max_size(); }
+
+    /**
+     * @brief Sets the number of threads used by the direct backend's triangular solves.
+     * @param num_threads Threads including the caller (1 = sequential, 0 = all cores).
+     *
+     * Overrides the thread count chosen by automatic selection.
+     */
+    void set_num_threads(int num_threads);
+
+    /**
+     * @brief Gets the worker pool configured by set_num_threads().
+     * @return Pool (not owned by the caller), or nullptr when sequential.
+     */
+    Thread_pool* get_thread_pool() const { return thread_pool.get(); }
+
+    /**
+     * @brief Selects the fill-reducing ordering of the direct backend.
+     * @param ordering Ordering::Method (automatic: nested dissection when factoring in parallel).
+     *
+     * Overrides the ordering chosen by automatic selection.
+     */
+    void set_ordering(Ordering::Method ordering);
+
+    /**
+     * @brief Sets the Gauss-Seidel iteration limit, tolerance and damping of the DC and AC solves.
+     * @throws std::invalid_argument for out-of-range values (see Gauss_seidel::configure).
+     */
+    void set_gauss_seidel(int max_iter, double tolerance, double damping_factor);
+
+    /**
+     * @brief Applies a complete configuration as explicit settings.
+     * @param config Backend, ordering, threads, damping and preconditioner.
+     *
+     * The Gauss-Seidel iteration limit and tolerance are kept; the thread
+     * count is capped at the cores of this machine.
+     * @throws std::invalid_argument for an automatic method or out-of-range damping.
+     */
+    void configure(const Configuration& config);
+
+    /**
+     * @brief Captures the current backend settings.
+     */
+    Settings settings() const;
+
+    /**
+     * @brief Reinstates settings captured by settings(), including automatic selection.
+     */
+    void restore(const Settings& saved);
+
+    /**
+     * @brief Records Gauss-Seidel convergence of later DC and AC solves.
+     * @param telemetry Recorder (not owned), or nullptr to stop recording.
+     */
+    void set_telemetry(Solver_telemetry* telemetry);
+
+    /**
+     * @brief Makes later DC and AC solves poll a cancellation token.
+     * @param token Token polled by the sparse LU, Gauss-Seidel and conjugate
+     *        gradient loops and between AC frequency points; a cancelled solve
+     *        throws Analysis_cancelled. An inert token turns polling off.
+     */
+    void set_cancellation(const Cancellation_token& token);
     
     /**
      * @brief Solves the MNA linear system Ax = b.
@@ -77,6 +334,11 @@ public:
      * @param mna_vector Right-hand side vector b (row -> value).
      * @param solution Output solution vector x (resized automatically).
      * 
+     * The backend is the requested method, or with Method::automatic the
+     * one selected by analyze() (redone if the system's dimension or number
+     * of stored entries changed). If conjugate gradient does not converge,
+     * the system is solved by sparse LU and the selection switches to it.
+     *
      * The solution vector contains:
      * - Index 0: Ground (always 0)
      * - Indices 1 to N: Node voltages
@@ -95,6 +357,30 @@ public:
                           const std::unordered_map<int, double>& mna_vector,
                           std::vector<double>& solution);
     
+    /**
+     * @brief Re-solves the DC system after a small in-place change.
+     * @param mna_matrix Updated system matrix A' (row -> col -> value).
+     * @param mna_vector Updated right-hand side b'.
+     * @param delta Stamps that turned the previously solved system into A', b'
+     *        (see Circuit::set_component_value).
+     * @param solution Solution vector, overwritten with x'.
+     *
+     * With the direct backend and a factorization of the previous system, the
+     * matrix change is absorbed as a low-rank update of the existing factors
+     * (see Sparse_lu::update); the factors are refreshed by a numeric
+     * refactorization once the accumulated rank grows too large. Changes
+     * outside the factored pattern, and the iterative backend, fall back to
+     * solve_MNA_system().
+     *
+     * @par Time Complexity
+     * O(r × (nnz(L) + nnz(U))) for a rank-r change, plus O(n × k) per solve for
+     * k absorbed update terms
+     */
+    void update_MNA_system(const std::unordered_map<int,std::unordered_map<int,double>>& mna_matrix,
+                           const std::unordered_map<int, double>& mna_vector,
+                           const Component_contribution<double>& delta,
+                           std::vector<double>& solution);
+
     /**
      * @brief Initializes the AC analysis system from DC MNA matrix.
      * @param mna_matrix Sparse DC system matrix A (real-valued).
@@ -140,8 +426,8 @@ public:
      * @brief Prints solver configuration and timing information.
      * @param os Output stream (default: std::cout).
      * 
-     * Includes Gauss-Seidel parameters, convergence status,
-     * iterations taken, and execution time.
+     * Includes the automatic selection and its reason, the backend's
+     * parameters, convergence status, iterations taken, and execution time.
      */
     virtual void print(std::ostream& os = std::cout) const override;
 };
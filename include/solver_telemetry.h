@@ -0,0 +1,175 @@
+/**
+ * @file solver_telemetry.h
+ * @brief Convergence telemetry of the Gauss-Seidel solver, exported as CSV or JSON.
+ *
+ * Gauss_seidel reports only the iteration count and whether it converged.
+ * Choosing a damping factor or tolerance for a production circuit needs
+ * more: how the residual falls from sweep to sweep, where the solver had to
+ * re-pivot around zero diagonals, and what one sweep costs. A telemetry
+ * object attached to the solver records these at run time, so no debug
+ * build is needed.
+ */
+
+#ifndef SOLVER_TELEMETRY_H
+#define SOLVER_TELEMETRY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+/**
+ * @class Solver_telemetry
+ * @brief Per-solve, per-sweep and pivot records of iterative solves.
+ *
+ * Every solve gets a record with its system (`dc` or `ac`), frequency,
+ * dimension, parameters, outcome and wall time. Sweeps are sampled. The first
+ * sweep, every `sample_every`-th sweep and the last sweep are recorded with
+ * the residual max_i |(Ax)_i - b_i| and their wall time. Other sweeps only
+ * read the clock and skip the O(N) residual pass. Pivot events (a row switching the
+ * variable it solves for in Gauss_seidel's zero-diagonal handling) are rare
+ * and are all kept. Iteration and pivot records beyond `capacity` are
+ * counted as dropped rather than stored.
+ *
+ * **Usage:**
+ * ```cpp
+ * Solver_telemetry telemetry(10);         // residual every 10 sweeps
+ * simulator.set_telemetry(&telemetry);
+ * simulator.run_dc_analysis(circuit);
+ * telemetry.write_file("gs.json");        // ".json" = JSON, otherwise CSV
+ * ```
+ *
+ * @note Not thread-safe: attach one telemetry object to one Solver.
+ */
+class Solver_telemetry {
+public:
+    /**
+     * @struct Solve
+     * @brief One call of an iterative solver.
+     */
+    struct Solve {
+        const char* system = "dc";      // "dc" or "ac"
+        double frequency = 0.0;         // Hz (0 for DC)
+        size_t size = 0;                // Unknowns including ground
+        double damping = 0.0;           // Under-relaxation factor used
+        double tolerance = 0.0;         // Convergence tolerance used
+        int iterations = 0;             // Sweeps performed
+        bool converged = false;
+        double seconds = 0.0;           // Wall time of the solve
+    };
+
+    /**
+     * @struct Iteration
+     * @brief Sampled sweep.
+     */
+    struct Iteration {
+        int solve;                      // Index into solves()
+        int iteration;                  // Sweep number (1-based)
+        double residual;                // max_i |(Ax)_i - b_i| after the sweep
+        double seconds;                 // Wall time of the sweep
+    };
+
+    /**
+     * @struct Pivot
+     * @brief Row re-targeted to another variable because of a zero diagonal.
+     */
+    struct Pivot {
+        int solve;                      // Index into solves()
+        int iteration;                  // Sweep in which it happened
+        int row;                        // MNA row
+        int from;                       // Variable the row solved for before
+        int to;                         // Variable it solves for now
+        bool independent;               // The new variable appears in no other candidate column
+    };
+
+private:
+    int sample_every;                   // Residual sampling period in sweeps
+    size_t capacity;                    // Iteration and pivot records kept (each)
+    double frequency;                   // Frequency tagged on the next solves
+    std::vector<Solve> solve_records;
+    std::vector<Iteration> iteration_records;
+    std::vector<Pivot> pivot_records;
+    uint64_t dropped;                   // Iteration and pivot records not kept
+
+public:
+    /**
+     * @brief Constructs an empty telemetry recorder.
+     * @param sample_every Residual sampling period in sweeps (1 = every sweep).
+     * @param capacity Maximum iteration records and pivot records kept (each).
+     * @throws std::invalid_argument if sample_every < 1.
+     */
+    explicit Solver_telemetry(int sample_every = 1, size_t capacity = 1 << 20);
+
+    /**
+     * @brief Sets the frequency recorded with the following solves (0 = DC).
+     */
+    void set_frequency(double hz) { frequency = hz; }
+
+    /**
+     * @brief Whether a sweep should be sampled (first, every sample_every-th).
+     */
+    bool sample(int iteration) const { return iteration == 1 || iteration % sample_every == 0; }
+
+    /**
+     * @brief Opens the record of a new solve.
+     * @return Index of the solve.
+     */
+    int begin_solve(const char* system, size_t size, double damping, double tolerance);
+
+    /**
+     * @brief Closes the record of the last solve.
+     */
+    void end_solve(int iterations, bool converged, double seconds);
+
+    /**
+     * @brief Records a sampled sweep of the last solve.
+     */
+    void record_iteration(int iteration, double residual, double seconds);
+
+    /**
+     * @brief Records a pivot event of the last solve.
+     */
+    void record_pivot(int iteration, int row, int from, int to, bool independent);
+
+    /**
+     * @brief Whether the latest iteration record is the given sweep of the last solve.
+     */
+    bool has_iteration(int iteration) const;
+
+    const std::vector<Solve>& solves() const { return solve_records; }
+    const std::vector<Iteration>& iterations() const { return iteration_records; }
+    const std::vector<Pivot>& pivots() const { return pivot_records; }
+
+    /**
+     * @brief Iteration and pivot records dropped because the capacity was reached.
+     */
+    uint64_t dropped_count() const { return dropped; }
+
+    /**
+     * @brief Removes all records.
+     */
+    void clear();
+
+    /**
+     * @brief Writes one row per record: `record,solve,system,frequency,...`.
+     *
+     * `record` is `solve`, `iteration` or `pivot`; columns that do not apply
+     * to a record are left empty.
+     */
+    void write_csv(std::ostream& os) const;
+
+    /**
+     * @brief Writes `{"solves": [...], "dropped": n}`; each solve holds its
+     *        `residuals` ([iteration, residual, seconds] triples) and `pivots`.
+     */
+    void write_json(std::ostream& os) const;
+
+    /**
+     * @brief Writes JSON if filename ends in ".json", CSV otherwise.
+     * @throws std::runtime_error if the file cannot be written.
+     */
+    void write_file(const std::string& filename) const;
+};
+
+#endif
@@ -0,0 +1,169 @@
+/**
+ * @file solver_tuner.h
+ * @brief Trial-based solver tuning with an on-disk cache of the winners.
+ *
+ * The structural heuristics of automatic selection (see Solver::analyze)
+ * cannot see the machine or the numerical values: whether nested dissection
+ * beats minimum degree on this mesh, whether 8 threads pay for themselves,
+ * or which damping lets Gauss-Seidel converge fastest. Nightly runs of the
+ * same large designs can afford to find out once. The tuner times every
+ * candidate configuration on the actual circuit, keeps the fastest one
+ * whose solution satisfies the system, and stores it for later runs.
+ */
+
+#ifndef SOLVER_TUNER_H
+#define SOLVER_TUNER_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "I_printable.h"
+#include "circuit.h"
+#include "solver.h"
+
+/**
+ * @class Solver_tuner
+ * @brief Directory of tuned solver configurations keyed by circuit fingerprints.
+ *
+ * **Entries:**
+ * - `<topology>.tune`: winner for the circuit's topology hash (see
+ *   Circuit::topology_hash), so value edits keep their tuning.
+ * - `similar_<class>.tune`: the same winner under a key of the system's
+ *   structure class (dimension within a factor of 2, mean degree, tree-ness,
+ *   symmetry, zero diagonals), used for circuits never tuned themselves.
+ *
+ * **Candidates:**
+ * - Sparse LU with minimum degree and nested dissection, on one thread and
+ *   on up to 8 threads
+ * - Gauss-Seidel with damping 0.5, 0.8 and 1.0
+ * - Conjugate gradient with and without the Jacobi preconditioner (SPD systems only)
+ *
+ * Each candidate solves the DC system from scratch up to `repeats` times on
+ * a fresh Solver, and its best time counts; a candidate already slower than the best accepted one is not
+ * repeated. Candidates whose solution leaves a residual above
+ * 1e-6 × max(1, ||b||_inf) are rejected. Entries are written atomically like
+ * Result_cache entries.
+ *
+ * Systems small enough for the dense fast path of automatic selection (see
+ * Solver::set_dense_max_size) are never tuned: they keep the dense LU, which
+ * an explicit configuration would bypass.
+ *
+ * **Usage:**
+ * ```cpp
+ * Solver_tuner tuner(".circuit_tuning");
+ * Solver solver;
+ * tuner.prepare(circuit, solver);      // cached, similar or freshly tuned configuration
+ * solver.solve_MNA_system(circuit.get_MNA_matrix(), circuit.get_MNA_vector(), solution);
+ * ```
+ *
+ * @see Simulator::set_tuning, Solver::configure
+ */
+class Solver_tuner : public I_Printable {
+public:
+    /**
+     * @struct Trial
+     * @brief Outcome of one candidate configuration.
+     */
+    struct Trial {
+        Solver::Configuration config;
+        double seconds = 0.0;               // Best wall time of the repeats
+        double residual = 0.0;              // ||Ax - b||_inf of the candidate's solution
+        bool accepted = false;              // Residual within the limit
+    };
+
+    /**
+     * @brief Where the configuration applied by the last prepare() came from.
+     */
+    enum class Source { none, exact, similar, tuned };
+
+private:
+    std::string directory;                  // Tuning directory (empty = disabled)
+    bool tune_on_miss;                      // Run trials when no entry matches
+    int repeats;                            // Timed solves per candidate
+    int hits;                               // Lookups answered by an entry (exact or similar)
+    int misses;                             // Lookups without an entry
+    uint64_t prepared_topology;             // Topology of the last prepare() (skips repeat lookups)
+    Source source;
+    Solver::Configuration applied;          // Configuration applied by the last prepare()
+    std::vector<Trial> trials;              // Candidates of the last tuning run
+    bool overriding;                        // The solver runs an applied configuration
+    Solver::Settings saved;                 // Solver settings from before the first applied configuration
+
+    std::string entry_path(const std::string& key) const;
+    bool load(const std::string& path, Solver::Configuration& config) const;
+    void store(const std::string& path, const Solver::Configuration& config, double seconds) const;
+    bool verify(const Circuit& circuit, const Solver::Configuration& config) const;
+    void release(Solver& solver);           // Gives the solver back its saved settings
+
+public:
+    /**
+     * @brief Constructs a tuner.
+     * @param directory Tuning directory, created if missing (empty = disabled).
+     * @param tune_on_miss Run the trials when no entry matches (false: use entries only).
+     * @param repeats Timed solves per candidate (at least 1).
+     * @throws std::runtime_error if the directory cannot be created.
+     * @throws std::invalid_argument if repeats < 1.
+     */
+    explicit Solver_tuner(const std::string& directory = "", bool tune_on_miss = true, int repeats = 2);
+
+    /**
+     * @brief Changes the tuning directory (empty disables tuning).
+     * @throws std::runtime_error if the directory cannot be created.
+     */
+    void set_directory(const std::string& directory, bool tune_on_miss = true);
+
+    /**
+     * @brief Whether a tuning directory is configured.
+     */
+    bool enabled() const { return !directory.empty(); }
+
+    /**
+     * @brief Key of the structure class a system belongs to.
+     */
+    static uint64_t similarity_key(const System_structure& structure);
+
+    /**
+     * @brief Times every candidate configuration on the circuit's DC system.
+     * @param circuit Circuit with its MNA system assembled.
+     * @return The trials, fastest accepted first, rejected ones last.
+     *
+     * @par Time Complexity
+     * O(candidates × repeats × solve)
+     */
+    std::vector<Trial> tune(const Circuit& circuit) const;
+
+    /**
+     * @brief Configures a solver for the circuit from the directory, tuning on a miss.
+     * @param circuit Circuit with its MNA system assembled.
+     * @param solver Solver to configure (see Solver::configure).
+     * @return true if a configuration was applied (false: the solver runs with
+     *         the settings it had before any configuration was applied).
+     * @throws std::runtime_error if a new entry cannot be written.
+     *
+     * Looks up the topology entry, then the structure-class entry. An entry
+     * is applied only if one solve with it passes the residual check of the
+     * trials; otherwise the lookup counts as a miss. A circuit with the
+     * topology of the previous call is not looked up again, and systems taken
+     * by the dense fast path are left alone.
+     */
+    bool prepare(const Circuit& circuit, Solver& solver);
+
+    Source get_source() const { return source; }
+    const Solver::Configuration& get_applied() const { return applied; }
+    const std::vector<Trial>& get_trials() const { return trials; }
+    int get_hits() const { return hits; }
+    int get_misses() const { return misses; }
+
+    /**
+     * @brief Short description of a configuration, e.g. "Sparse LU, nested dissection, 4 threads".
+     */
+    static std::string describe(const Solver::Configuration& config);
+
+    /**
+     * @brief Prints the directory, hit statistics, the applied configuration and the trials.
+     * @param os Output stream (default: std::cout).
+     */
+    virtual void print(std::ostream& os = std::cout) const override;
+};
+
+#endif
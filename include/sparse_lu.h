@@ -0,0 +1,397 @@
+/**
+ * @file sparse_lu.h
+ * @brief Sparse direct LU solver with block triangular pre-ordering.
+ *
+ * Factors the assembled MNA system by first permuting it to block upper
+ * triangular form (see Btf), then factoring only the diagonal blocks with a
+ * left-looking Gilbert-Peierls LU with threshold partial pivoting. 1x1
+ * blocks need no factorization at all. Off-diagonal blocks are kept as-is
+ * and applied during block back substitution.
+ *
+ * @tparam T Numeric type for matrix/vector elements (double or std::complex<double>)
+ */
+
+#ifndef SPARSE_LU_H
+#define SPARSE_LU_H
+
+#include <vector>
+#include <memory>
+#include <complex>
+#include <utility>
+#include "I_printable.h"
+#include "sparse_matrix.h"
+#include "btf.h"
+#include "cancellation.h"
+#include "ordering.h"
+#include "thread_pool.h"
+#include "triangular_schedule.h"
+
+/**
+ * @struct Factor_tasks
+ * @brief Column groups of one diagonal block for parallel factorization.
+ *
+ * Derived from the elimination tree of B_kk + B_kk^T: small subtrees become
+ * one task each, chains of large nodes are merged, and a task may run once
+ * its child tasks are done. Column positions are block-local and ascending
+ * within a task.
+ */
+struct Factor_tasks {
+    std::vector<int> parent;            // Parent task (-1 for roots)
+    std::vector<int> col_ptr;           // Task t factors cols[col_ptr[t] .. col_ptr[t+1])
+    std::vector<int> cols;
+
+    /**
+     * @brief Number of tasks.
+     */
+    int num_tasks() const { return static_cast<int>(parent.size()); }
+};
+
+/**
+ * @struct Lu_symbolic
+ * @brief Pattern-only analysis shared by every factorization of one pattern.
+ *
+ * Holds the BTF permutations (already composed with a minimum degree ordering
+ * of each diagonal block) and a precomputed gather map from the source matrix
+ * to the permuted matrix B = A(row_perm, col_perm). Numeric factorization only
+ * has to copy values through the map.
+ *
+ * Structurally singular MNA systems are usually consistent: a loop of
+ * inductors (DC shorts) or voltage sources leaves one loop current free and
+ * one KVL equation redundant. Such systems are regularized by replacing each
+ * redundant equation with "free variable = 0", which picks one valid solution.
+ */
+struct Lu_symbolic {
+    int n = 0;                          // Dimension
+    std::vector<int> var_index;         // Compact -> MNA numbering of the analyzed matrix
+    std::vector<int> src_col_ptr;       // Pattern of the analyzed matrix (for reuse checks)
+    std::vector<int> src_row_idx;
+    Btf_decomposition btf;              // Block structure (permutations include block orderings)
+    std::vector<int> perm_col_ptr;      // Pattern of B, column-wise
+    std::vector<int> perm_row_idx;      // Row position in B of each entry
+    std::vector<int> perm_src;          // Entry index in the source matrix of each B entry (-1 = unit regularization entry)
+    std::vector<int> dropped_rows;      // Redundant equations replaced by "free variable = 0"
+    std::vector<int> diag_end;          // Per column: end of the in-block entries of B (off-block entries follow)
+    std::vector<Factor_tasks> tasks;    // Per block (empty unless the block is factored in parallel)
+    int nested_min_block = 0;           // Settings the analysis was built with (for reuse checks)
+    int task_min_block = 0;
+
+    /**
+     * @brief Checks whether a matrix has the pattern this analysis was built for.
+     * @param A Matrix to check (values are ignored).
+     */
+    template<typename T>
+    bool matches(const Sparse_matrix<T>& A) const {
+        return n == A.n && var_index == A.var_index && src_col_ptr == A.col_ptr && src_row_idx == A.row_idx;
+    }
+};
+
+/**
+ * @class Sparse_lu
+ * @brief Direct solver for sparse MNA systems (KLU-style).
+ *
+ * **Algorithm:**
+ * 1. analyze(): BTF decomposition, minimum degree (or nested dissection)
+ *    ordering of each diagonal block on the pattern of B_kk + B_kk^T.
+ *    Reused while the pattern is unchanged.
+ *    Structurally redundant equations are regularized (see Lu_symbolic).
+ * 2. factorize(): per block, left-looking LU with sparse triangular solves
+ *    (Gilbert-Peierls). Pivots prefer the diagonal unless it is smaller than
+ *    pivot_tolerance times the largest candidate in the column. A column with
+ *    no usable pivot (e.g. parallel inductors at DC) is linearly dependent on
+ *    earlier ones; its variable is fixed to 0, which solves consistent systems.
+ *    Such matrices are refactored as a single block, since a block-local
+ *    dependency does not imply a globally free variable.
+ *    With a thread pool, large blocks are first factored with static diagonal
+ *    pivots, independent elimination-tree subtrees in parallel (see
+ *    Task_tree); a pivot failing the threshold test falls back to the
+ *    sequential pivoting factorization. Nested dissection keeps the tree
+ *    short on grid-like blocks.
+ * 3. solve(): block back substitution from the last block to the first.
+ *    With a thread pool, large blocks use level-scheduled triangular solves
+ *    (see Triangular_schedule) whose schedules are built once per factor.
+ * 4. update(): small value changes A' = A + W V^T (e.g. one resistor edited)
+ *    are absorbed without refactoring via the Sherman-Morrison-Woodbury
+ *    identity: each rank-1 term costs one solve with the existing factors,
+ *    and later solves add an O(n * rank) correction. Once the accumulated
+ *    rank exceeds max_update_rank the caller refactors.
+ *
+ * **Usage:**
+ * ```cpp
+ * Sparse_matrix<double> A;
+ * A.assemble(mna_matrix);
+ * Sparse_lu<double> lu;
+ * lu.factorize(A);                 // Analyzes on first call
+ * std::vector<double> b;
+ * A.gather(mna_vector, b);
+ * lu.solve(b);                     // b now holds x
+ * ```
+ *
+ * @note Solving a new frequency point or set of values with the same pattern
+ *       only repeats step 2; the symbolic analysis is kept.
+ *
+ * @tparam T Numeric type (default: double, std::complex<double> for AC analysis)
+ *
+ * @see Btf, Ordering, Sparse_matrix, Solver
+ */
+template<typename T = double>
+class Sparse_lu : public I_Printable {
+    friend class Solver;
+
+private:
+    double pivot_tolerance;                     // Diagonal preference threshold (0, 1]
+    double dependency_tolerance;                // Relative pivot size below which a column counts as dependent
+    Ordering::Method ordering;                  // Fill-reducing ordering of the diagonal blocks
+    std::shared_ptr<const Lu_symbolic> symbolic;// Pattern analysis (shared, immutable)
+    bool factored;                              // Whether numeric factors are valid
+
+    // Numeric factors of all diagonal blocks, indexed by B positions.
+    // L is unit lower triangular (diagonal stored first), U stores its diagonal last.
+    std::vector<int> l_col_ptr, l_row_idx;
+    std::vector<T> l_values;
+    std::vector<int> u_col_ptr, u_row_idx;
+    std::vector<T> u_values;
+    std::vector<int> pivot_row;                 // B position -> B row position chosen as its pivot
+    std::vector<T> perm_values;                 // Values of B (off-diagonal-block entries are used by solve)
+    std::vector<char> free_column;              // B position -> column was numerically dependent (x = 0)
+    int num_free;                               // Number of dependent columns
+
+    // Level-scheduled triangular solves of large blocks (built per factor, reused by every solve)
+    Thread_pool* pool;                          // Not owned; nullptr = sequential solves
+    Cancellation_token cancellation;            // Polled between blocks and every 256 columns
+    int parallel_min_block;                     // Smallest block solved with a schedule
+    std::vector<Triangular_schedule<T>> l_schedule, u_schedule;   // Per block (unbuilt for small blocks)
+
+    // Low-rank updates since the last factorization: A' = A + sum_j w_j v_j^T
+    int max_update_rank;                        // Largest rank absorbed before refactoring is required
+    std::vector<std::vector<T>> update_z;       // z_j = A^{-1} w_j (dense)
+    std::vector<std::vector<std::pair<int, T>>> update_v;          // Sparse v_j
+    std::vector<T> update_lu;                   // LU of the capacitance matrix S = I + V^T Z (row-major)
+    std::vector<int> update_pivot;              // Row pivots of update_lu
+
+    // Workspaces (kept to avoid re-allocation between factorizations)
+    std::vector<T> work_x;
+    std::vector<int> work_stack, work_mark, work_pinv;
+    mutable std::vector<T> work_solve, work_update;
+
+    /**
+     * @brief Factors one diagonal block of B with threshold partial pivoting.
+     * @param block Block number.
+     * @throws std::runtime_error if the block is numerically singular.
+     */
+    void factorize_block(int block);
+
+    /**
+     * @brief Builds the symbolic analysis of A's pattern.
+     * @param A Matrix whose pattern is analyzed.
+     * @param single_block Keep the matching but treat the whole matrix as one block.
+     */
+    void analyze_pattern(const Sparse_matrix<T>& A, bool single_block);
+
+    /**
+     * @brief Numeric factorization with the current symbolic analysis.
+     * @param A Matrix to factor (pattern must match the analysis).
+     */
+    void factorize_numeric(const Sparse_matrix<T>& A);
+
+    /**
+     * @brief Builds or refreshes the triangular solve schedules of large blocks.
+     */
+    void update_schedules();
+
+    /**
+     * @brief Smallest block the current settings order by nested dissection (INT_MAX = none).
+     */
+    int nested_dissection_min_block() const;
+
+    /**
+     * @brief Smallest block the current settings factor in parallel (INT_MAX = none).
+     */
+    int parallel_factor_min_block() const;
+
+    /**
+     * @brief Groups the columns of an ordered block into elimination-tree tasks.
+     * @param size Block dimension.
+     * @param col_ptr Block-local pattern (column start offsets), already ordered.
+     * @param row_idx Block-local row indices.
+     */
+    static Factor_tasks build_tasks(int size, const std::vector<int>& col_ptr, const std::vector<int>& row_idx);
+
+    /**
+     * @brief Factors one block with static diagonal pivots, running independent
+     *        subtrees of its elimination tree in parallel.
+     * @param block Block number.
+     * @return false if a diagonal pivot fails the threshold test (nothing is stored;
+     *         the caller falls back to factorize_block()).
+     */
+    bool factorize_block_parallel(int block);
+
+    /**
+     * @brief Records column k as dependent: unit U column, x_k fixed to 0.
+     *        Its pivot row is one of the rows left unpivoted at the end of the block.
+     * @param k Column (B position).
+     * @param size Block size.
+     * @param top Start of the column's reach in work_stack (cleared from work_x).
+     */
+    void mark_free_column(int k, int size, int top);
+
+    /**
+     * @brief Depth-first reach of column k's in-block pattern through the partial L.
+     * @param k0 First position of the block.
+     * @param size Block size.
+     * @param k Column (B position) being factored.
+     * @return Start of the topologically ordered reach in work_stack[top, size).
+     */
+    int reach(int k0, int size, int k);
+
+    /**
+     * @brief Solves with the factors alone, ignoring low-rank updates.
+     * @param b Right-hand side in compact numbering; overwritten with x.
+     */
+    void solve_factored(std::vector<T>& b) const;
+
+    /**
+     * @brief Factors the capacitance matrix S = I + V^T Z of the current updates.
+     * @return false if S is numerically singular.
+     */
+    bool factor_capacitance();
+
+public:
+    /**
+     * @brief Constructs a sparse LU solver.
+     * @param pivot_tolerance Diagonal preference threshold (default: 0.001).
+     * @param dependency_tolerance Relative threshold for numerically dependent columns (default: 1e-12).
+     */
+    Sparse_lu(double pivot_tolerance = 0.001, double dependency_tolerance = 1e-12);
+
+    /**
+     * @brief Computes (or reuses) the symbolic analysis for a matrix pattern.
+     * @param A Matrix whose pattern is analyzed.
+     * @return true if a previous analysis was reused.
+     *
+     * @par Time Complexity
+     * O(BTF + Σ ordering cost per block), see Btf::decompose and Ordering::minimum_degree
+     */
+    bool analyze(const Sparse_matrix<T>& A);
+
+    /**
+     * @brief Numerically factors a matrix, analyzing its pattern first if needed.
+     * @param A Matrix to factor.
+     * @throws std::runtime_error if a dependent column cannot be resolved.
+     *
+     * @par Time Complexity
+     * O(flops(LU of diagonal blocks)) + O(NNZ) to gather values
+     *
+     * @par Space Complexity
+     * O(nnz(L) + nnz(U) + NNZ)
+     */
+    void factorize(const Sparse_matrix<T>& A);
+
+    /**
+     * @brief Solves A x = b in place using the current factors.
+     * @param b Right-hand side in compact numbering; overwritten with x.
+     * @throws std::runtime_error if no valid factorization exists.
+     *
+     * @par Time Complexity
+     * O(nnz(L) + nnz(U) + nnz(off-diagonal blocks)) + O(n × k) for k absorbed update terms
+     */
+    void solve(std::vector<T>& b) const;
+
+    /**
+     * @brief Absorbs a small change of the factored matrix without refactoring.
+     * @param rows Row of each changed entry (compact numbering).
+     * @param cols Column of each changed entry (compact numbering).
+     * @param values Amount added to each entry (duplicates are summed).
+     * @return false if the change cannot be absorbed (accumulated rank would exceed
+     *         max_update_rank, the factors are regularized, or the updated matrix is
+     *         singular); nothing is changed and the caller should refactor.
+     * @throws std::runtime_error if no valid factorization exists.
+     *
+     * The change is split into rank-1 terms w v^T by grouping proportional
+     * rows, so a two-terminal conductance change (rows i and j of the stamp
+     * are negatives of each other) costs a single term.
+     *
+     * @par Time Complexity
+     * O(r × (nnz(L) + nnz(U))) for r new rank-1 terms, plus O(k^3) for the
+     * k × k capacitance matrix
+     */
+    bool update(const std::vector<int>& rows, const std::vector<int>& cols, const std::vector<T>& values);
+
+    /**
+     * @brief Sets the largest accumulated update rank absorbed before refactoring.
+     * @param rank Maximum rank (default: 16; 0 disables low-rank updates).
+     */
+    void set_max_update_rank(int rank) { max_update_rank = rank; }
+
+    /**
+     * @brief Rank of the updates absorbed since the last factorization.
+     */
+    int get_update_rank() const { return static_cast<int>(update_v.size()); }
+
+    /**
+     * @brief Enables parallel factorization and level-scheduled triangular solves.
+     * @param thread_pool Pool to run on (not owned; nullptr disables).
+     * @param min_block_size Smallest diagonal block handled in parallel (default: 2000).
+     */
+    void set_thread_pool(Thread_pool* thread_pool, int min_block_size = 2000);
+
+    /**
+     * @brief Makes later factorizations poll a cancellation token.
+     * @param token Token checked between blocks and every 256 columns; a
+     *        cancelled factorization throws Analysis_cancelled and leaves no valid factors.
+     */
+    void set_cancellation(const Cancellation_token& token) { cancellation = token; }
+
+    /**
+     * @brief Selects the fill-reducing ordering (takes effect at the next analysis).
+     * @param method Ordering::Method::automatic uses nested dissection for blocks
+     *        solved in parallel and minimum degree otherwise.
+     */
+    void set_ordering(Ordering::Method method) { ordering = method; }
+
+    /**
+     * @brief Gets the selected fill-reducing ordering.
+     */
+    Ordering::Method get_ordering() const { return ordering; }
+
+    /**
+     * @brief Whether valid numeric factors are available.
+     */
+    bool is_factored() const { return factored; }
+
+    /**
+     * @brief Gets the shared symbolic analysis (nullptr before analyze()).
+     */
+    std::shared_ptr<const Lu_symbolic> get_symbolic() const { return symbolic; }
+
+    /**
+     * @brief Adopts a symbolic analysis computed by another solver.
+     * @param shared Analysis of the pattern this solver will factor.
+     *
+     * Lets several solvers (e.g. one per thread) factor matrices of one
+     * pattern without repeating the analysis. It is reused by factorize()
+     * only if the pattern and this solver's parallel settings match.
+     */
+    void set_symbolic(std::shared_ptr<const Lu_symbolic> shared);
+
+    /**
+     * @brief Number of stored entries in L (including unit diagonal).
+     */
+    int nnz_l() const { return l_col_ptr.empty() ? 0 : l_col_ptr.back(); }
+
+    /**
+     * @brief Number of stored entries in U (including diagonal).
+     */
+    int nnz_u() const { return u_col_ptr.empty() ? 0 : u_col_ptr.back(); }
+
+    /**
+     * @brief Prints block structure and factor fill statistics.
+     * @param os Output stream (default: std::cout).
+     */
+    virtual void print(std::ostream& os = std::cout) const override;
+};
+
+// Explicit template instantiation declarations
+extern template class Sparse_lu<double>;
+extern template class Sparse_lu<std::complex<double>>;
+
+#endif
@@ -0,0 +1,128 @@
+/**
+ * @file sparse_matrix.h
+ * @brief Compressed sparse column (CSC) matrix used by the direct solvers.
+ *
+ * The MNA system is assembled into nested hash maps, which are convenient
+ * for stamping but slow to traverse. Direct factorization needs a compact,
+ * index-ordered layout, so the assembled system is converted once per solve
+ * into CSC form over the active MNA variables.
+ *
+ * @tparam T Numeric type for values (double or std::complex<double>)
+ */
+
+#ifndef SPARSE_MATRIX_H
+#define SPARSE_MATRIX_H
+
+#include <unordered_map>
+#include <vector>
+#include <complex>
+#include "I_printable.h"
+
+/**
+ * @class Sparse_matrix
+ * @brief Square CSC matrix over the active variables of an MNA system.
+ *
+ * MNA variable indices are sparse: index 0 is ground and never stored, and
+ * in AC mode inductor current variables are dropped entirely. The matrix
+ * therefore keeps a compact numbering 0..n-1 of the variables that appear
+ * in the system, plus the mapping back to MNA indices.
+ *
+ * Explicit zeros are dropped during assembly, so the stored pattern is the
+ * numerical non-zero pattern of the system.
+ *
+ * **Usage:**
+ * ```cpp
+ * Sparse_matrix<double> A;
+ * A.assemble(circuit.get_MNA_matrix());
+ * std::vector<double> b;
+ * A.gather(circuit.get_MNA_vector(), b);   // RHS in compact numbering
+ * // ... factor and solve ...
+ * A.scatter(b, solution);                  // Back to MNA numbering
+ * ```
+ *
+ * @tparam T Numeric type (default: double, std::complex<double> for AC analysis)
+ *
+ * @see Sparse_lu, Btf
+ */
+template<typename T = double>
+class Sparse_matrix : public I_Printable {
+public:
+    int n;                              // Dimension (number of active variables)
+    std::vector<int> col_ptr;           // Column start offsets (size n + 1)
+    std::vector<int> row_idx;           // Row index of each stored entry
+    std::vector<T> values;              // Value of each stored entry
+    std::vector<int> var_index;         // Compact index -> MNA variable index
+    std::vector<int> compact_index;     // MNA variable index -> compact index (-1 if inactive)
+
+    /**
+     * @brief Constructs an empty 0x0 matrix.
+     */
+    Sparse_matrix();
+
+    /**
+     * @brief Builds the CSC representation from the nested-map MNA matrix.
+     * @param mna_matrix Sparse system matrix A (row -> col -> value).
+     *
+     * Active variables are all row and column indices carrying at least one
+     * non-zero value. Rows inside each column are sorted ascending.
+     *
+     * @par Time Complexity
+     * O(NNZ log K) where K = average non-zeros per column
+     *
+     * @par Space Complexity
+     * O(NNZ + M)
+     */
+    void assemble(const std::unordered_map<int, std::unordered_map<int, T>>& mna_matrix);
+
+    /**
+     * @brief Number of stored entries.
+     */
+    int nnz() const { return col_ptr.empty() ? 0 : col_ptr[n]; }
+
+    /**
+     * @brief Checks whether another matrix has the identical sparsity pattern.
+     * @param other Matrix to compare with.
+     * @return true if variable numbering, column pointers and row indices match.
+     */
+    bool same_pattern(const Sparse_matrix& other) const;
+
+    /**
+     * @brief Locates a stored entry by MNA indices.
+     * @param row MNA row (equation) index.
+     * @param col MNA column (variable) index.
+     * @return Index into row_idx/values, or -1 if the entry is not stored.
+     *
+     * @par Time Complexity
+     * O(log K) where K = non-zeros in the column
+     */
+    int find(int row, int col) const;
+
+    /**
+     * @brief Extracts the RHS vector in compact numbering.
+     * @param mna_vector Right-hand side vector b (row -> value).
+     * @param b Output dense vector of size n.
+     */
+    void gather(const std::unordered_map<int, T>& mna_vector, std::vector<T>& b) const;
+
+    /**
+     * @brief Writes a compact solution back into an MNA-indexed solution vector.
+     * @param x Solution in compact numbering (size n).
+     * @param solution MNA solution vector (grown if too small; inactive entries untouched).
+     */
+    void scatter(const std::vector<T>& x, std::vector<T>& solution) const;
+
+    /**
+     * @brief Prints dimension and fill statistics.
+     * @param os Output stream (default: std::cout).
+     */
+    virtual void print(std::ostream& os = std::cout) const override;
+
+private:
+    std::vector<int> fill_next;         // assemble() workspace: next free slot per column (reused across calls)
+};
+
+// Explicit template instantiation declarations
+extern template class Sparse_matrix<double>;
+extern template class Sparse_matrix<std::complex<double>>;
+
+#endif
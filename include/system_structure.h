@@ -0,0 +1,64 @@
+/**
+ * @file system_structure.h
+ * @brief Cheap structural statistics of an assembled MNA system.
+ *
+ * The right backend depends on the shape of the system: a tree factors
+ * without fill, a grounded resistive mesh is symmetric positive definite,
+ * and voltage sources and inductors put zeros on the diagonal that
+ * Gauss-Seidel can only work around by pivoting. These statistics take one
+ * pass over the CSC matrix and drive Solver's automatic backend selection.
+ */
+
+#ifndef SYSTEM_STRUCTURE_H
+#define SYSTEM_STRUCTURE_H
+
+#include "I_printable.h"
+#include "sparse_matrix.h"
+
+/**
+ * @struct System_structure
+ * @brief Dimension, sparsity, symmetry, diagonal dominance, tree-ness and bandwidth of a real system.
+ *
+ * **Usage:**
+ * ```cpp
+ * Sparse_matrix<double> A;
+ * A.assemble(circuit.get_MNA_matrix());
+ * System_structure s = System_structure::analyze(A);
+ * if (s.spd())
+ *     // conjugate gradient applies
+ * ```
+ */
+struct System_structure : public I_Printable {
+    int dimension = 0;              // Active unknowns (ground excluded)
+    int nnz = 0;                    // Stored non-zeros
+    double symmetry = 1.0;          // Fraction of off-diagonal entries whose transpose is stored
+    bool symmetric = true;          // Numerically symmetric (relative 1e-12)
+    int zero_diagonals = 0;         // Rows without a non-zero diagonal (sources, inductors)
+    bool positive_diagonal = true;  // Every diagonal entry is positive
+    double dominance = 1.0;         // Fraction of rows with |a_ii| >= sum_j |a_ij|
+    int strict_rows = 0;            // Rows with |a_ii| > sum_j |a_ij| (e.g. grounded nodes)
+    double dominance_margin = 0.0;  // min_i |a_ii| / sum_j |a_ij| (row-wise, infinity if no off-diagonals)
+    bool forest = true;             // The off-diagonal graph has no cycle (tree-shaped circuit)
+    int bandwidth = 0;              // max |i - j| over stored entries in MNA order
+    double mean_degree = 0.0;       // Off-diagonal entries per row
+
+    /**
+     * @brief Computes the statistics of a matrix.
+     *
+     * @par Time Complexity
+     * O(NNZ log K) where K = average non-zeros per column (transpose lookups)
+     */
+    static System_structure analyze(const Sparse_matrix<double>& A);
+
+    /**
+     * @brief Symmetric, positive diagonal, weakly diagonally dominant with a strictly dominant row.
+     *
+     * Such a matrix (e.g. conductances of a resistor network tied to ground)
+     * is positive definite when every connected part reaches a strict row.
+     */
+    bool spd() const;
+
+    virtual void print(std::ostream& os = std::cout) const override;
+};
+
+#endif
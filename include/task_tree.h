@@ -0,0 +1,51 @@
+/**
+ * @file task_tree.h
+ * @brief Work-stealing execution of tree-shaped task dependencies.
+ *
+ * Elimination trees and separator trees have the same dependency shape: a
+ * node may run once all of its children have finished. Leaves are spread
+ * over per-thread deques; a thread that finishes the last child of a node
+ * pushes the node onto its own deque (keeping the child's data in cache),
+ * and idle threads steal from the opposite end of other deques.
+ */
+
+#ifndef TASK_TREE_H
+#define TASK_TREE_H
+
+#include <functional>
+#include <vector>
+#include "thread_pool.h"
+
+/**
+ * @class Task_tree
+ * @brief Stateless executor for task forests given by parent links.
+ *
+ * **Usage:**
+ * ```cpp
+ * // parent[i] = task that depends on i, -1 for roots
+ * Task_tree::run(&pool, parent, [&](int task, int thread_id) {
+ *     factor_columns(task, workspace[thread_id]);
+ * });
+ * ```
+ *
+ * @note The first exception thrown by a task is rethrown by run() after
+ *       all threads stop; tasks that have not started yet are skipped.
+ *
+ * @see Thread_pool, Dissection_tree, Sparse_lu
+ */
+class Task_tree {
+public:
+    /**
+     * @brief Runs every task after all of its children, in parallel where possible.
+     * @param pool Thread pool (nullptr or single-threaded = sequential postorder).
+     * @param parent Parent task of each task (-1 for roots); must form a forest.
+     * @param body Task body, called as body(task, thread_id).
+     *
+     * @par Time Complexity
+     * O(num_tasks) scheduling overhead plus the task bodies
+     */
+    static void run(Thread_pool* pool, const std::vector<int>& parent,
+                    const std::function<void(int, int)>& body);
+};
+
+#endif
@@ -0,0 +1,106 @@
+/**
+ * @file thread_pool.h
+ * @brief Fork-join parallel regions for fine-grained kernels.
+ *
+ * Kernels such as level-scheduled triangular solves synchronize many times
+ * per call, so every call runs one parallel region (the caller included),
+ * separated by spin barriers. The threads are borrowed from the process-wide
+ * runtime (see Executor), so pools never add threads of their own and
+ * regions nested in jobs or other regions stay within the thread budget.
+ */
+
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <atomic>
+#include <functional>
+#include <thread>
+
+/**
+ * @class Spin_barrier
+ * @brief Reusable sense-reversing barrier for the threads of one parallel region.
+ *
+ * Waiting threads spin briefly, then yield, so the barrier stays cheap when
+ * every thread has a core and does not livelock when cores are oversubscribed.
+ */
+class Spin_barrier {
+private:
+    int num_threads;                    // Threads taking part
+    std::atomic<int> waiting;           // Threads arrived in the current phase
+    std::atomic<int> phase;             // Incremented each time the barrier opens
+
+public:
+    /**
+     * @brief Constructs a barrier for a fixed number of threads.
+     * @param num_threads Number of threads that must arrive before it opens.
+     */
+    explicit Spin_barrier(int num_threads);
+
+    /**
+     * @brief Resizes the barrier; only while no thread is waiting.
+     * @param num_threads Number of threads that must arrive before it opens.
+     */
+    void reset(int num_threads);
+
+    /**
+     * @brief Blocks until all num_threads threads have called wait().
+     */
+    void wait();
+};
+
+/**
+ * @class Thread_pool
+ * @brief Handle running parallel regions on the global runtime with a thread cap.
+ *
+ * **Usage:**
+ * ```cpp
+ * Thread_pool pool(4);
+ * pool.run([&](int thread_id, int num_threads) {
+ *     for (int i = thread_id; i < n; i += num_threads)
+ *         y[i] = f(i);
+ * });
+ * ```
+ *
+ * A region runs on the caller plus the runtime workers idle at that moment,
+ * at most size() threads in all: bodies must split work by the num_threads
+ * they are given, which may be smaller than size() (down to 1).
+ *
+ * @note run() is not re-entrant: a region must not call run() on the same pool.
+ *
+ * @see Executor, Triangular_schedule, Sparse_lu
+ */
+class Thread_pool {
+private:
+    int num_threads;                    // Most threads per region, caller included
+    Spin_barrier region_barrier;        // Sized to the threads of the running region
+
+public:
+    /**
+     * @brief Creates a pool on the global runtime.
+     * @param num_threads Most threads per region including the caller
+     *        (0 = the whole thread budget; capped by the budget).
+     */
+    explicit Thread_pool(int num_threads = 0);
+
+    Thread_pool(const Thread_pool&) = delete;
+    Thread_pool& operator=(const Thread_pool&) = delete;
+
+    /**
+     * @brief Runs body(thread_id, num_threads) on the region's threads and waits for all.
+     * @param body Region body; the calling thread executes thread_id 0.
+     * @return Threads the region ran on.
+     */
+    int run(const std::function<void(int, int)>& body);
+
+    /**
+     * @brief Barrier for the threads of the running region.
+     */
+    Spin_barrier& barrier() { return region_barrier; }
+
+    /**
+     * @brief Most threads per region (leased workers + caller).
+     */
+    int size() const { return num_threads; }
+};
+
+#endif
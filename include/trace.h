@@ -0,0 +1,159 @@
+/**
+ * @file trace.h
+ * @brief Scoped hot-path tracing with Chrome trace (Perfetto) JSON export.
+ *
+ * Timer prints one total and the solvers keep a couple of durations; neither
+ * shows where a run spends its time, nor what the worker threads do. Spans
+ * placed around the pipeline phases are recorded into per-thread ring
+ * buffers and exported as a Chrome trace, viewable in chrome://tracing or
+ * ui.perfetto.dev.
+ */
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <string>
+
+/**
+ * @class Trace
+ * @brief Process-wide trace recorder.
+ *
+ * Every thread that records gets its own fixed-capacity ring buffer on its
+ * first event, so recording takes no lock; when a buffer is full the oldest
+ * events are overwritten (and counted as dropped). Disabled tracing costs one
+ * relaxed atomic load per span.
+ *
+ * **Instrumented spans:**
+ * | Span | Where |
+ * |------|-------|
+ * | `parse`, `build` | CircuitBuilder, per chunk of netlist lines |
+ * | `assemble` | Circuit::assemble_MNA_system |
+ * | `dc_solve`, `dc_update` | Solver::solve_MNA_system, Solver::update_MNA_system |
+ * | `reorder`, `factor`, `solve` | Sparse_lu symbolic analysis, numeric factorization, triangular solves |
+ * | `gauss_seidel`, `dense_lu` | Iterative and tiny-system solves |
+ * | `ac_sweep`, `ac_point` (arg: frequency), `ac_assemble`, `ac_write` | AC analysis |
+ * | `parallel_region`, `tree_task` (arg: task) | Thread_pool parallel regions and Task_tree tasks run by the pool |
+ * | `monte_carlo`, `output` | Monte Carlo analysis and result output |
+ * | `output_write` | Output_writer thread, per record formatted and written |
+ *
+ * **Usage:**
+ * ```cpp
+ * Trace::enable();
+ * Trace::set_thread_name("main");
+ * {
+ *     TRACE_SCOPE("my_phase");
+ *     TRACE_SCOPE_ARG("my_step", "size", n);
+ *     // ...
+ * }
+ * Trace::write_chrome_json_file("trace.json");
+ * ```
+ *
+ * @note Export reads the buffers of every thread: call it when no traced work
+ *       is running (e.g. at the end of a run).
+ * @note Defining CIRCUIT_NO_TRACE compiles every TRACE_SCOPE out.
+ */
+class Trace {
+private:
+    static std::atomic<bool> enabled;   // Recording switch checked by every span
+
+public:
+    /**
+     * @brief Starts recording; clears previously recorded events.
+     * @param capacity_per_thread Ring buffer size (events) of each thread.
+     */
+    static void enable(size_t capacity_per_thread = 1 << 16);
+
+    /**
+     * @brief Stops recording (recorded events are kept for export).
+     */
+    static void disable();
+
+    /**
+     * @brief Whether spans are being recorded.
+     */
+    static bool is_enabled() { return enabled.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Names the calling thread in the exported trace.
+     */
+    static void set_thread_name(const std::string& name);
+
+    /**
+     * @brief Nanoseconds since the trace was enabled (monotonic clock).
+     */
+    static int64_t now_ns();
+
+    /**
+     * @brief Records a completed span of the calling thread.
+     * @param name Span name (string literal: stored by pointer).
+     * @param start_ns Start, from now_ns().
+     * @param end_ns End, from now_ns().
+     * @param arg_name Optional argument name (string literal or nullptr).
+     * @param arg Argument value.
+     */
+    static void record(const char* name, int64_t start_ns, int64_t end_ns, const char* arg_name = nullptr,
+                       double arg = 0.0);
+
+    /**
+     * @brief Number of events currently held in the ring buffers.
+     */
+    static size_t event_count();
+
+    /**
+     * @brief Number of events overwritten because a ring buffer was full.
+     */
+    static size_t dropped_count();
+
+    /**
+     * @brief Writes the recorded events in Chrome trace event format.
+     */
+    static void write_chrome_json(std::ostream& os);
+
+    /**
+     * @brief Writes the Chrome trace JSON to a file.
+     * @throws std::runtime_error if the file cannot be written.
+     */
+    static void write_chrome_json_file(const std::string& filename);
+};
+
+/**
+ * @class Trace_span
+ * @brief RAII span: records [construction, destruction) of the enclosing scope if tracing is on.
+ */
+class Trace_span {
+private:
+    const char* name;       // Span name (string literal)
+    const char* arg_name;   // Optional argument name
+    double arg;             // Argument value
+    int64_t start;          // Start time, -1 if tracing was off at construction
+
+public:
+    explicit Trace_span(const char* name, const char* arg_name = nullptr, double arg = 0.0)
+        : name(name), arg_name(arg_name), arg(arg), start(Trace::is_enabled() ? Trace::now_ns() : -1) {}
+
+    ~Trace_span() {
+        if (start >= 0)
+            Trace::record(name, start, Trace::now_ns(), arg_name, arg);
+    }
+
+    Trace_span(const Trace_span&) = delete;
+    Trace_span& operator=(const Trace_span&) = delete;
+};
+
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+
+#ifdef CIRCUIT_NO_TRACE
+#define TRACE_SCOPE(name) ((void)0)
+#define TRACE_SCOPE_ARG(name, arg_name, arg) ((void)0)
+#else
+#define TRACE_SCOPE(name) Trace_span TRACE_CONCAT(trace_span_, __LINE__)(name)
+#define TRACE_SCOPE_ARG(name, arg_name, arg) \
+    Trace_span TRACE_CONCAT(trace_span_, __LINE__)(name, arg_name, static_cast<double>(arg))
+#endif
+
+#endif
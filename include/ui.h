@@ -9,10 +9,13 @@
 #ifndef UI_H
 #define UI_H
 
+#include <cstdint>
 #include <iostream>
 #include <fstream>
 #include <string>
 
+class Output_writer;
+
 /**
  * @class UI
  * @brief Manages user interface operations for the circuit simulator.
@@ -27,6 +30,18 @@
  * - `-i <file>`: Input netlist file (required)
  * - `-o <file>`: Output results file (default: output.log)
  * - `-ac_csv <file>`: AC analysis results CSV file (default: ac_analysis_results.csv)
+ * - `-solver <auto|gs|lu|pcg>`: Linear solver backend, auto = chosen from the system structure (default: auto)
+ * - `-threads <n>`: Threads for sparse LU triangular solves, 0 = all cores (default: 1)
+ * - `-mc <samples>`: Monte Carlo tolerance analysis sample count (default: 0 = off)
+ * - `-seed <n>`: Monte Carlo base seed and generator seed (default: 1)
+ * - `-generate <topology> <size>`: Simulate a generated circuit instead of `-i`
+ * - `-write_netlist <file>`: Write the generated netlist to file and exit
+ * - `-trace <file>`: Record phase spans and write them as Chrome trace JSON
+ * - `-perf`: Report hardware counters, IPC, GFLOP/s and bandwidth per solver and assembly phase
+ * - `-mem`: Report heap usage per subsystem and the process peak RSS
+ * - `-telemetry <file>`: Write Gauss-Seidel residuals, sweep times and pivot events (CSV, or JSON for *.json)
+ * - `-telemetry_every <n>`: Residual sampling period in sweeps (default: 1)
+ * - `-gs_iter <n>`, `-gs_tol <t>`, `-gs_damping <w>`: Gauss-Seidel limits (default: 1000, 1e-9, 0.5)
  * - `-v`: Verbose mode (print results to console)
  * - `-p`: Pause before exit (wait for Enter key)
  * - `-h`: Show help message
@@ -61,6 +76,28 @@ private:
     std::string input_file;     // Path to input netlist file
     std::string output_file;    // Path to output results file
     std::string ac_output_file; // Path to AC analysis results CSV file
+    std::string solver_method;  // Linear solver backend name ("auto", "gs", "lu" or "pcg")
+    int num_threads;            // Threads for parallel triangular solves (0 = all cores)
+    int thread_budget;          // Threads of the global runtime including the main thread (0 = all cores)
+    std::string affinity;       // Runtime worker placement ("none", "compact" or "scatter")
+    int mc_samples;             // Monte Carlo samples (0 = no Monte Carlo analysis)
+    uint64_t mc_seed;           // Monte Carlo base seed
+    std::string cache_dir;      // Result cache directory (empty = no caching)
+    std::string tune_dir;       // Solver tuning directory (empty = no tuning)
+    std::string image_file;     // Compile the input into this circuit image and exit (empty = simulate)
+    bool server;                // Serve requests on stdin/stdout instead of a one-shot run
+    std::string socket_path;    // Serve requests on this UNIX socket (empty = not a socket server)
+    std::string generate_topology;  // Generated input topology, e.g. "grid:3" (empty = read -i)
+    size_t generate_size;       // Node count of the generated input
+    std::string netlist_output; // Write the generated netlist to this file and exit (empty = simulate)
+    std::string trace_file;     // Chrome trace JSON output (empty = tracing off)
+    bool perf;                  // Report per-phase performance counters
+    bool memory;                // Report heap usage per subsystem
+    std::string telemetry_file; // Gauss-Seidel telemetry output (empty = off)
+    int telemetry_every;        // Telemetry residual sampling period in sweeps
+    int gs_max_iter;            // Gauss-Seidel iteration limit
+    double gs_tolerance;        // Gauss-Seidel convergence tolerance
+    double gs_damping;          // Gauss-Seidel under-relaxation factor
     bool verbose;               // Whether to print results to console
     bool pause;                 // Whether to pause before exit
     std::string program_name;   // Name of the executable (from argv[0])
@@ -105,11 +142,12 @@ public:
     /**
      * @brief Writes analysis results to output file.
      * @param circuit_output String containing the formatted results.
+     * @param writer Background writer to queue the file write on (nullptr = write it here).
      * 
      * Writes banner and results to the output file.
      * If verbose mode is enabled, also prints to console.
      */
-    void output_results(const std::string& circuit_output);
+    void output_results(const std::string& circuit_output, Output_writer* writer = nullptr);
     
     /**
      * @brief Gets the input file path.
@@ -122,6 +160,122 @@ public:
      * @return Const reference to the AC analysis output file path string.
      */
     const std::string& get_ac_output_file() const { return ac_output_file; }
+
+    /**
+     * @brief Gets the requested linear solver backend.
+     * @return "auto" (from the system structure), "gs" (Gauss-Seidel), "lu" (sparse direct LU)
+     *         or "pcg" (conjugate gradient).
+     */
+    const std::string& get_solver_method() const { return solver_method; }
+
+    /**
+     * @brief Gets the requested thread count for parallel triangular solves.
+     * @return Threads including the main thread (1 = sequential, 0 = all cores).
+     */
+    int get_num_threads() const { return num_threads; }
+
+    /**
+     * @brief Gets the thread budget shared by all parallel stages (see Executor).
+     * @return Threads including the main thread (0 = all cores).
+     */
+    int get_thread_budget() const { return thread_budget; }
+
+    /**
+     * @brief Gets the worker placement of the runtime.
+     * @return "none", "compact" or "scatter".
+     */
+    const std::string& get_affinity() const { return affinity; }
+
+    /**
+     * @brief Gets the requested Monte Carlo sample count.
+     * @return Number of samples (0 = no Monte Carlo analysis).
+     */
+    int get_mc_samples() const { return mc_samples; }
+
+    /**
+     * @brief Gets the Monte Carlo base seed.
+     */
+    uint64_t get_mc_seed() const { return mc_seed; }
+
+    /**
+     * @brief Gets the result cache directory (empty if caching is off).
+     */
+    const std::string& get_cache_dir() const { return cache_dir; }
+
+    /**
+     * @brief Gets the solver tuning directory (empty if tuning is off).
+     */
+    const std::string& get_tune_dir() const { return tune_dir; }
+
+    /**
+     * @brief Gets the circuit image to compile to (empty when simulating).
+     */
+    const std::string& get_image_file() const { return image_file; }
+
+    /**
+     * @brief Whether to run as a server on stdin/stdout.
+     */
+    bool is_server() const { return server; }
+
+    /**
+     * @brief Gets the UNIX socket path of the server (empty if not serving on a socket).
+     */
+    const std::string& get_socket_path() const { return socket_path; }
+
+    /**
+     * @brief Gets the topology of the generated input (empty when reading -i).
+     */
+    const std::string& get_generate_topology() const { return generate_topology; }
+
+    /**
+     * @brief Gets the node count of the generated input.
+     */
+    size_t get_generate_size() const { return generate_size; }
+
+    /**
+     * @brief Gets the file the generated netlist is written to (empty when simulating).
+     */
+    const std::string& get_netlist_output() const { return netlist_output; }
+
+    /**
+     * @brief Gets the Chrome trace output file (empty when tracing is off).
+     */
+    const std::string& get_trace_file() const { return trace_file; }
+
+    /**
+     * @brief Checks if per-phase performance counters are reported.
+     */
+    bool is_perf() const { return perf; }
+
+    /**
+     * @brief Checks if heap usage per subsystem is reported.
+     */
+    bool is_memory() const { return memory; }
+
+    /**
+     * @brief Gets the Gauss-Seidel telemetry output file (empty when telemetry is off).
+     */
+    const std::string& get_telemetry_file() const { return telemetry_file; }
+
+    /**
+     * @brief Gets the telemetry residual sampling period in sweeps.
+     */
+    int get_telemetry_every() const { return telemetry_every; }
+
+    /**
+     * @brief Gets the Gauss-Seidel iteration limit.
+     */
+    int get_gs_max_iter() const { return gs_max_iter; }
+
+    /**
+     * @brief Gets the Gauss-Seidel convergence tolerance.
+     */
+    double get_gs_tolerance() const { return gs_tolerance; }
+
+    /**
+     * @brief Gets the Gauss-Seidel damping factor.
+     */
+    double get_gs_damping() const { return gs_damping; }
     
     /**
      * @brief Destructor - handles pause-before-exit if enabled.
@@ -98,6 +98,27 @@ public:
      * @return Component_contribution with standard voltage source stamps.
      */
     virtual Component_contribution<double> get_contribution() override;
+
+    /**
+     * @brief Changes the voltage in place.
+     * @param value DC source voltage in Volts (the AC signal amplitude is unchanged).
+     */
+    virtual void set_value(double value) override { voltage = value; }
+
+    /**
+     * @brief Gets the voltage.
+     */
+    virtual double get_value() const override { return voltage; }
+
+    /**
+     * @brief Gets the AC signal amplitude.
+     */
+    virtual double get_signal_value() const override { return signal_voltage; }
+
+    /**
+     * @brief Creates a copy sharing the same nodes.
+     */
+    virtual Component* clone() const override { return new Voltage_source(*this); }
     
     /**
      * @brief Generates AC MNA contributions for the voltage source.
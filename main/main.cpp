@@ -1,8 +1,16 @@
 #include "ui.h"
 #include "circuit.h"
 #include "circuit_builder.h"
+#include "circuit_image.h"
 #include "circuit_printer.h"
+#include "executor.h"
+#include "netlist_generator.h"
 #include "simulator.h"
+#include "server.h"
+#include "memory_accounting.h"
+#include "perf_counters.h"
+#include "solver_telemetry.h"
+#include "trace.h"
 #include "Timer.h"
 
 using namespace std;
@@ -14,29 +22,117 @@ int main(int argc, char* argv[]) {
     if(!ui.parse_arguments(argc, argv)) {
         return 1;
     }
+
+    // One runtime for every parallel stage, sized before any of them starts
+    if(ui.get_thread_budget() != 0 || ui.get_affinity() != "none") {
+        Executor::Options runtime;
+        runtime.threads = ui.get_thread_budget();
+        if(ui.get_affinity() == "compact")
+            runtime.affinity = Executor::Affinity::compact;
+        else if(ui.get_affinity() == "scatter")
+            runtime.affinity = Executor::Affinity::scatter;
+        Executor::configure_global(runtime);
+    }
     
+    // Server mode: circuits are loaded and solved on request
+    if(ui.is_server() || !ui.get_socket_path().empty()) {
+        Server server;
+        if(ui.get_socket_path().empty())
+            server.serve(cin, cout);
+        else
+            server.serve_socket(ui.get_socket_path());
+        return 0;
+    }
+
     // Start timer
     Timer timer;
+    if(!ui.get_trace_file().empty()) {
+        Trace::enable();
+        Trace::set_thread_name("main");
+    }
+    if(ui.is_perf())
+        Perf_profile::enable();
+    if(ui.is_memory() && Memory_accounting::is_available())
+        Memory_accounting::enable();        // Otherwise the report shows RSS only
 
-    // Parse and assemble circuit
-    CircuitBuilder builder;
+    // Generated input: written out as a netlist or built in memory
     Circuit circuit;
-    builder.build(circuit, ui.get_input_file());
-    circuit.assemble_MNA_system();
+    if(!ui.get_generate_topology().empty()) {
+        Netlist_generator::Spec spec;
+        Netlist_generator::parse_topology(ui.get_generate_topology(), spec);
+        spec.size = ui.get_generate_size();
+        spec.seed = ui.get_mc_seed();
+        Netlist_generator generator(spec);
+        if(!ui.get_netlist_output().empty()) {
+            ofstream netlist(ui.get_netlist_output());
+            size_t elements = generator.write(netlist);
+            cout << elements << " elements written to " << ui.get_netlist_output() << endl;
+            return 0;
+        }
+        generator.build(circuit);
+        circuit.assemble_MNA_system();
+    }
+    // Parse and assemble circuit (compiled images are loaded assembled)
+    else if(Circuit_image::is_image(ui.get_input_file())) {
+        Circuit_image::load(circuit, ui.get_input_file());
+    } else {
+        CircuitBuilder builder;
+        builder.build(circuit, ui.get_input_file());
+        circuit.assemble_MNA_system();
+    }
+    if(!ui.get_image_file().empty()) {
+        Circuit_image::write(circuit, ui.get_image_file());
+        cout << "Circuit image written to " << ui.get_image_file() << endl;
+        if(!ui.get_trace_file().empty())
+            Trace::write_chrome_json_file(ui.get_trace_file());
+        return 0;
+    }
     
     // Run simulation
     Simulator simulator(ui.get_ac_output_file());
+    if(ui.get_solver_method() == "gs")
+        simulator.set_solver_method(Solver::Method::gauss_seidel);
+    else if(ui.get_solver_method() == "lu")
+        simulator.set_solver_method(Solver::Method::sparse_lu);
+    else if(ui.get_solver_method() == "pcg")
+        simulator.set_solver_method(Solver::Method::pcg);
+    if(ui.get_num_threads() != 1)
+        simulator.set_num_threads(ui.get_num_threads());
+    if(!ui.get_cache_dir().empty())
+        simulator.set_result_cache(ui.get_cache_dir());
+    if(!ui.get_tune_dir().empty())
+        simulator.set_tuning(ui.get_tune_dir());
+    simulator.set_gauss_seidel(ui.get_gs_max_iter(), ui.get_gs_tolerance(), ui.get_gs_damping());
+    Solver_telemetry telemetry(ui.get_telemetry_every());
+    if(!ui.get_telemetry_file().empty())
+        simulator.set_telemetry(&telemetry);
     simulator.run_dc_analysis(circuit);
     simulator.run_ac_analysis(circuit, 1, 100000, 10, true); // 1Hz to 100kHz, log scale
+    if(ui.get_mc_samples() > 0)
+        simulator.run_monte_carlo(circuit, ui.get_mc_samples(), ui.get_mc_seed());
     
-    // Generate output
-    stringstream ss;
-    ss << circuit << endl;
-    ss << simulator << endl;
-    string circuit_output = ss.str();
-    
-    // Output results
-    ui.output_results(circuit_output);
-    
+    // Generate and output results
+    {
+        TRACE_SCOPE("output");
+        stringstream ss;
+        ss << circuit << endl;
+        ss << simulator << endl;
+        if(ui.is_perf())
+            Perf_profile::print(ss);
+        if(ui.is_memory())
+            Memory_accounting::print(ss);
+        string circuit_output = ss.str();
+        ui.output_results(circuit_output, &simulator.get_output_writer());
+    }
+
+    if(!ui.get_telemetry_file().empty()) {
+        telemetry.write_file(ui.get_telemetry_file());
+        cout << "Solver telemetry written to " << ui.get_telemetry_file() << endl;
+    }
+    if(!ui.get_trace_file().empty()) {
+        Trace::disable();
+        Trace::write_chrome_json_file(ui.get_trace_file());
+        cout << "Trace written to " << ui.get_trace_file() << endl;
+    }
     return 0;
 }
\ No newline at end of file
@@ -1,10 +1,14 @@
 #include "ac_analyzer.h"
+#include "memory_accounting.h"
+#include "perf_counters.h"
 
-Ac_analyzer::Ac_analyzer(const std::string& output_file) : output_file(output_file) {}
+Ac_analyzer::Ac_analyzer(Output_writer& writer, const std::string& output_file)
+    : output_file(output_file), writer(writer), sink(-1) {}
 
 void Ac_analyzer::initialize(const std::unordered_map<int,std::unordered_map<int,double>>& mna_matrix,
                              const std::map<int, std::string>& extra_vars,
                              const std::vector<double>& initial_solution) {
+    Memory_scope memory(Memory_tag::ac);
 
     // Convert real-valued MNA matrix and vector to complex
     this->mna_matrix.clear();
@@ -12,11 +16,14 @@ void Ac_analyzer::initialize(const std::unordered_map<int,std::unordered_map<int
     this->solution.clear();
     this->solution.resize(initial_solution.size(), std::complex<double>(0.0, 0.0));
 
-    std::ofstream out(output_file, std::ios::trunc);
-    if (!out.is_open())
+    // The previous sweep may still be queued for the same file: finish it first
+    if (sink >= 0)
+        writer.close(sink);
+    sink = writer.open(output_file);
+    if (sink < 0)
         throw std::runtime_error("Failed to open AC analysis output file: " + output_file);
+    writer.reserve(2 * initial_solution.size(), 2);      // So frequency points queue rows without allocating
     log_header();
-    out.close();
 
     for (size_t row = 1; row < initial_solution.size(); row++)
         this->solution[row] = std::complex<double>(initial_solution[row], 0.0);
@@ -44,6 +51,8 @@ void Ac_analyzer::initialize(const std::unordered_map<int,std::unordered_map<int
 }
 
 void Ac_analyzer::assemble_ac_mna_system(const std::unordered_map<std::string, Component*>& ac_components, double frequency) {
+    Perf_scope perf("ac_assemble");
+    Memory_scope memory(Memory_tag::ac);
     // Assemble AC contributions from components
     for (const auto& [id, component] : ac_components) {
         Component_contribution<std::complex<double>> contrib = static_cast<Ac_component*>(component)->get_ac_contribution(frequency);
@@ -56,34 +65,39 @@ void Ac_analyzer::assemble_ac_mna_system(const std::unordered_map<std::string, C
     }
 }
 
-void Ac_analyzer::log_header() const {
-    std::ofstream out(output_file, std::ios::app);
+void Ac_analyzer::log_header() {
     // Frequency(Hz), Re(x[0]), Im(x[0]), Re(x[1]), Im(x[1]), Re(x[2]), Im(x[2]), Re(x[3]), Im(x[3]), Converge_Iters, Duration_us
     // 0, (0,0), (12,0), (-0.004,0), (8,0), 0, 0
     // 1, (0,0), (4.0117e-06,0), (-0.004,0), (3.48423e-06,0), 120, 93
     // 2, (0,0), (2.16316e-06,0), (-0.004,0), (1.87874e-06,0), 5, 9
     // ...
-    if (!out.is_open())
+    if (sink < 0)
         throw std::runtime_error("Failed to open AC analysis output file: " + output_file);
     
-    out << "Frequency(Hz), ";
-    for (size_t i = 0; i < solution.size(); i++) {
-        out << "R(x[" << i << "]), I(x[" << i << "]), ";
-    }
-    out << "Converge_Iters, Duration_us" << std::endl;
-    out.close();
+    std::string header = "Frequency(Hz), ";
+    for (size_t i = 0; i < solution.size(); i++)
+        header += "R(x[" + std::to_string(i) + "]), I(x[" + std::to_string(i) + "]), ";
+    header += "Converge_Iters, Duration_us\n";
+    writer.write_text(sink, header);
 }
 
 void Ac_analyzer::log_ac_inst_solution(double frequency, std::chrono::microseconds duration, int converge_iters) {
-    std::ofstream out(output_file, std::ios::app);
-    if (!out.is_open())
+    if (sink < 0)
         throw std::runtime_error("Failed to open AC analysis output file: " + output_file);
-    out << frequency<< ", ";
-    for(auto& sol : solution) {
-        out << sol.real() <<  ", " << sol.imag() << ", ";
+    Output_writer::Record& row = writer.acquire(sink);
+    row.key = frequency;
+    for (const auto& sol : solution) {
+        row.values.push_back(sol.real());
+        row.values.push_back(sol.imag());
     }
-    out << converge_iters << ", " << duration.count() << std::endl;
-    out.close();
+    row.counts.push_back(converge_iters);
+    row.counts.push_back(static_cast<long long>(duration.count()));
+    writer.commit();
+}
+
+void Ac_analyzer::flush() {
+    if (sink >= 0)
+        writer.flush();
 }
 
 void Ac_analyzer::print(std::ostream& os) const {
@@ -0,0 +1,25 @@
+#include "ac_sweep.h"
+#include "frequency_sweep.h"
+#include "trace.h"
+
+Ac_sweep::Ac_sweep(std::shared_ptr<const Compiled_circuit> circuit, double freq1, double freq2, double step,
+                   bool log_scale, const Cancellation_token& token)
+    : circuit(std::move(circuit)),
+      frequencies(Frequency_sweep(freq1, freq2, step, log_scale).frequencies()),
+      token(token),
+      solved(0) {}
+
+bool Ac_sweep::next() {
+    if (solved == frequencies.size())
+        return false;
+    TRACE_SCOPE_ARG("ac_point", "frequency", frequencies[solved]);
+    circuit->solve_ac_point(frequencies[solved], token, workspace);
+    solved++;
+    return true;
+}
+
+Ac_sweep::iterator Ac_sweep::begin() {
+    if (solved == 0 && !next())
+        return end();
+    return iterator(this);
+}
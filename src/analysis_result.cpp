@@ -0,0 +1,89 @@
+#include "analysis_result.h"
+#include "compiled_circuit.h"
+#include <iomanip>
+
+// ============================================================
+//  DC
+// ============================================================
+
+Dc_result::Dc_result(std::shared_ptr<const Compiled_circuit> circuit, std::vector<double> solution)
+    : circuit(std::move(circuit)), solution(std::move(solution)) {}
+
+double Dc_result::voltage(const std::string& node) const {
+    return solution[circuit->node_index(node)];
+}
+
+double Dc_result::current(const std::string& component) const {
+    const Compiled_circuit::Branch& b = circuit->branch(component);
+    switch (b.type) {
+        case 'R': return (solution[b.i] - solution[b.j]) / b.value;
+        case 'V':
+        case 'L': return solution[b.var];
+        case 'I': return b.value;
+        default: return 0.0;                // Capacitors are open at DC
+    }
+}
+
+void Dc_result::print(std::ostream& os) const {
+    os << "DC Result: " << circuit->get_name() << std::endl;
+    os << std::string(40, '-') << std::endl;
+    const std::vector<std::string>& names = circuit->get_variable_names();
+    for (size_t k = 1; k < solution.size(); k++) {
+        if (names[k].empty())
+            continue;
+        os << "  " << std::left << std::setw(16) << names[k] << std::right
+           << std::setw(14) << solution[k] << (names[k][0] == 'V' ? " V" : " A") << std::endl;
+    }
+}
+
+// ============================================================
+//  AC
+// ============================================================
+
+size_t Ac_point::size() const {
+    return static_cast<size_t>(circuit->get_num_variables());
+}
+
+std::complex<double> Ac_point::voltage(const std::string& node) const {
+    return values[circuit->node_index(node)];
+}
+
+std::complex<double> Ac_point::current(const std::string& component) const {
+    const Compiled_circuit::Branch& b = circuit->branch(component);
+    const double omega = 2.0 * 3.14159265358979323846 * freq;
+    switch (b.type) {
+        case 'R': return (values[b.i] - values[b.j]) / b.value;
+        case 'C': return (values[b.i] - values[b.j]) * std::complex<double>(0.0, omega * b.value);
+        case 'V':
+        case 'L': return values[b.var];
+        default: return 0.0;                // Current sources carry no AC signal
+    }
+}
+
+Ac_result::Ac_result(std::shared_ptr<const Compiled_circuit> circuit, std::vector<double> frequencies,
+                     std::vector<std::complex<double>> phasors)
+    : circuit(std::move(circuit)), frequencies(std::move(frequencies)), phasors(std::move(phasors)),
+      stride(static_cast<size_t>(this->circuit->get_num_variables())) {}
+
+std::complex<double> Ac_result::voltage(size_t point, const std::string& node) const {
+    return value(point, circuit->node_index(node));
+}
+
+std::complex<double> Ac_result::current(size_t point, const std::string& component) const {
+    return this->point(point).current(component);
+}
+
+void Ac_result::print(std::ostream& os) const {
+    os << "Frequency(Hz), ";
+    for (size_t i = 0; i < stride; i++)
+        os << "R(x[" << i << "]), I(x[" << i << "])" << (i + 1 < stride ? ", " : "");
+    os << std::endl;
+    for (size_t point = 0; point < frequencies.size(); point++) {
+        os << frequencies[point];
+        for (size_t i = 0; i < stride; i++) {
+            std::complex<double> v = value(point, static_cast<int>(i));
+            os << ", " << v.real() << ", " << v.imag();
+        }
+        os << '\n';
+    }
+}
@@ -0,0 +1,253 @@
+#include "batch_lu.h"
+#include "ordering.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+template<int W>
+Batch_lu<W>::Batch_lu(double pivot_tolerance) : n(0), pivot_tolerance(pivot_tolerance) {
+    std::fill(lane_ok, lane_ok + W, true);
+}
+
+// ============================================================
+//  Analysis
+// ============================================================
+
+template<int W>
+void Batch_lu<W>::analyze(const Sparse_matrix<double>& A) {
+    n = A.n;
+    col_perm = Ordering::minimum_degree(n, A.col_ptr, A.row_idx);
+
+    // Right-looking elimination of the representative (original numbering), tracking fill
+    std::vector<double> dense(static_cast<size_t>(n) * n, 0.0);
+    std::vector<char> pattern(static_cast<size_t>(n) * n, 0);
+    for (int j = 0; j < n; j++)
+        for (int p = A.col_ptr[j]; p < A.col_ptr[j + 1]; p++) {
+            dense[static_cast<size_t>(A.row_idx[p]) * n + j] = A.values[p];
+            pattern[static_cast<size_t>(A.row_idx[p]) * n + j] = 1;
+        }
+
+    double scale = 0.0;
+    for (double v : A.values)
+        scale = std::max(scale, std::abs(v));
+
+    row_perm.assign(n, -1);
+    std::vector<char> row_used(n, 0);
+    for (int k = 0; k < n; k++) {
+        int c = col_perm[k];
+        int best = -1;
+        double max_abs = 0.0;
+        for (int i = 0; i < n; i++)
+            if (!row_used[i] && std::abs(dense[static_cast<size_t>(i) * n + c]) > max_abs) {
+                max_abs = std::abs(dense[static_cast<size_t>(i) * n + c]);
+                best = i;
+            }
+        if (best < 0 || max_abs <= 1e-13 * scale)
+            throw std::runtime_error("Batch LU: representative matrix is singular.");
+        // Prefer the diagonal, as Sparse_lu does
+        int r = (!row_used[c] && std::abs(dense[static_cast<size_t>(c) * n + c]) >= pivot_tolerance * max_abs) ? c : best;
+        row_perm[k] = r;
+        row_used[r] = 1;
+
+        double pivot = dense[static_cast<size_t>(r) * n + c];
+        for (int i = 0; i < n; i++) {
+            if (row_used[i] || !pattern[static_cast<size_t>(i) * n + c])
+                continue;
+            double m = dense[static_cast<size_t>(i) * n + c] / pivot;
+            for (int q = k + 1; q < n; q++) {
+                int c2 = col_perm[q];
+                if (!pattern[static_cast<size_t>(r) * n + c2])
+                    continue;
+                pattern[static_cast<size_t>(i) * n + c2] = 1;
+                dense[static_cast<size_t>(i) * n + c2] -= m * dense[static_cast<size_t>(r) * n + c2];
+            }
+        }
+    }
+
+    // Elimination lists in pivot numbering
+    l_ptr.assign(1, 0);
+    u_ptr.assign(1, 0);
+    l_rows.clear();
+    u_cols.clear();
+    for (int k = 0; k < n; k++) {
+        for (int i = k + 1; i < n; i++)
+            if (pattern[static_cast<size_t>(row_perm[i]) * n + col_perm[k]])
+                l_rows.push_back(i);
+        for (int j = k + 1; j < n; j++)
+            if (pattern[static_cast<size_t>(row_perm[k]) * n + col_perm[j]])
+                u_cols.push_back(j);
+        l_ptr.push_back(static_cast<int>(l_rows.size()));
+        u_ptr.push_back(static_cast<int>(u_cols.size()));
+    }
+
+    std::vector<int> row_inv(n), col_inv(n);
+    for (int k = 0; k < n; k++) {
+        row_inv[row_perm[k]] = k;
+        col_inv[col_perm[k]] = k;
+    }
+    entry_pos.resize(A.nnz());
+    for (int j = 0; j < n; j++)
+        for (int p = A.col_ptr[j]; p < A.col_ptr[j + 1]; p++)
+            entry_pos[p] = row_inv[A.row_idx[p]] * n + col_inv[j];
+
+    lane_lu.assign(W, std::vector<double>());
+    lane_perm.assign(W, std::vector<int>());
+    // Solve scratch is sized once per pattern, so warm solves do not allocate
+    work.assign(static_cast<size_t>(n) * W, 0.0);
+    lane_work.assign(n, 0.0);
+}
+
+// ============================================================
+//  Factorization
+// ============================================================
+
+template<int W>
+void Batch_lu<W>::factorize(const std::vector<double>& values) {
+    lu.assign(static_cast<size_t>(n) * n * W, 0.0);
+    for (size_t p = 0; p < entry_pos.size(); p++)
+        for (int l = 0; l < W; l++)
+            lu[static_cast<size_t>(entry_pos[p]) * W + l] = values[p * W + l];
+    std::fill(lane_ok, lane_ok + W, true);
+
+    for (int k = 0; k < n; k++) {
+        double* pivot = &lu[(static_cast<size_t>(k) * n + k) * W];
+        double col_max[W] = {};
+        for (int q = l_ptr[k]; q < l_ptr[k + 1]; q++) {
+            const double* a = &lu[(static_cast<size_t>(l_rows[q]) * n + k) * W];
+            for (int l = 0; l < W; l++)
+                col_max[l] = std::max(col_max[l], std::abs(a[l]));
+        }
+        // A lane whose shared pivot is too small is redone alone; keep its arithmetic finite
+        for (int l = 0; l < W; l++)
+            if (pivot[l] == 0.0 || std::abs(pivot[l]) < pivot_tolerance * col_max[l]) {
+                lane_ok[l] = false;
+                pivot[l] = 1.0;
+            }
+
+        for (int q = l_ptr[k]; q < l_ptr[k + 1]; q++) {
+            size_t i = static_cast<size_t>(l_rows[q]);
+            double* a_ik = &lu[(i * n + k) * W];
+            for (int l = 0; l < W; l++)
+                a_ik[l] /= pivot[l];
+            for (int s = u_ptr[k]; s < u_ptr[k + 1]; s++) {
+                double* a_ij = &lu[(i * n + u_cols[s]) * W];
+                const double* a_kj = &lu[(static_cast<size_t>(k) * n + u_cols[s]) * W];
+                for (int l = 0; l < W; l++)
+                    a_ij[l] -= a_ik[l] * a_kj[l];
+            }
+        }
+    }
+
+    for (int l = 0; l < W; l++) {
+        if (lane_ok[l]) {
+            lane_lu[l].clear();
+            lane_perm[l].clear();
+        } else {
+            factorize_lane(values, l);
+        }
+    }
+}
+
+template<int W>
+void Batch_lu<W>::factorize_lane(const std::vector<double>& values, int lane) {
+    // Dense row-major copy in pivot numbering; the shared column order is kept
+    std::vector<double>& a = lane_lu[lane];
+    std::vector<int>& perm = lane_perm[lane];
+    a.assign(static_cast<size_t>(n) * n, 0.0);
+    for (size_t p = 0; p < entry_pos.size(); p++)
+        a[entry_pos[p]] = values[p * W + lane];
+    perm.resize(n);
+
+    for (int k = 0; k < n; k++) {
+        int best = k;
+        for (int i = k + 1; i < n; i++)
+            if (std::abs(a[static_cast<size_t>(i) * n + k]) > std::abs(a[static_cast<size_t>(best) * n + k]))
+                best = i;
+        if (a[static_cast<size_t>(best) * n + k] == 0.0)
+            throw std::runtime_error("Batch LU: matrix of lane " + std::to_string(lane) + " is singular.");
+        perm[k] = best;
+        if (best != k)
+            std::swap_ranges(a.begin() + static_cast<size_t>(k) * n, a.begin() + static_cast<size_t>(k + 1) * n,
+                             a.begin() + static_cast<size_t>(best) * n);
+        for (int i = k + 1; i < n; i++) {
+            double m = a[static_cast<size_t>(i) * n + k] /= a[static_cast<size_t>(k) * n + k];
+            if (m == 0.0)
+                continue;
+            for (int j = k + 1; j < n; j++)
+                a[static_cast<size_t>(i) * n + j] -= m * a[static_cast<size_t>(k) * n + j];
+        }
+    }
+}
+
+template<int W>
+int Batch_lu<W>::num_fallback_lanes() const {
+    return static_cast<int>(std::count(lane_ok, lane_ok + W, false));
+}
+
+// ============================================================
+//  Solve
+// ============================================================
+
+template<int W>
+void Batch_lu<W>::solve(std::vector<double>& b) const {
+    for (int k = 0; k < n; k++)
+        for (int l = 0; l < W; l++)
+            work[static_cast<size_t>(k) * W + l] = b[static_cast<size_t>(row_perm[k]) * W + l];
+
+    // Forward substitution with unit lower L (column-oriented)
+    for (int k = 0; k < n; k++) {
+        const double* y_k = &work[static_cast<size_t>(k) * W];
+        for (int q = l_ptr[k]; q < l_ptr[k + 1]; q++) {
+            size_t i = static_cast<size_t>(l_rows[q]);
+            const double* a_ik = &lu[(i * n + k) * W];
+            double* y_i = &work[i * W];
+            for (int l = 0; l < W; l++)
+                y_i[l] -= a_ik[l] * y_k[l];
+        }
+    }
+    // Back substitution with U (row-oriented)
+    for (int k = n - 1; k >= 0; k--) {
+        double* y_k = &work[static_cast<size_t>(k) * W];
+        for (int s = u_ptr[k]; s < u_ptr[k + 1]; s++) {
+            const double* a_kj = &lu[(static_cast<size_t>(k) * n + u_cols[s]) * W];
+            const double* y_j = &work[static_cast<size_t>(u_cols[s]) * W];
+            for (int l = 0; l < W; l++)
+                y_k[l] -= a_kj[l] * y_j[l];
+        }
+        const double* pivot = &lu[(static_cast<size_t>(k) * n + k) * W];
+        for (int l = 0; l < W; l++)
+            y_k[l] /= pivot[l];
+    }
+
+    // Rejected lanes: dense partial-pivoting solve (row numbering of the shared pivots, then own swaps)
+    for (int l = 0; l < W; l++) {
+        if (lane_ok[l])
+            continue;
+        const std::vector<double>& a = lane_lu[l];
+        const std::vector<int>& perm = lane_perm[l];
+        std::vector<double>& y = lane_work;
+        for (int k = 0; k < n; k++)
+            y[k] = b[static_cast<size_t>(row_perm[k]) * W + l];
+        for (int k = 0; k < n; k++)
+            std::swap(y[k], y[perm[k]]);
+        for (int i = 0; i < n; i++)
+            for (int k = 0; k < i; k++)
+                y[i] -= a[static_cast<size_t>(i) * n + k] * y[k];
+        for (int i = n - 1; i >= 0; i--) {
+            for (int j = i + 1; j < n; j++)
+                y[i] -= a[static_cast<size_t>(i) * n + j] * y[j];
+            y[i] /= a[static_cast<size_t>(i) * n + i];
+        }
+        for (int k = 0; k < n; k++)
+            work[static_cast<size_t>(k) * W + l] = y[k];
+    }
+
+    for (int k = 0; k < n; k++)
+        for (int l = 0; l < W; l++)
+            b[static_cast<size_t>(col_perm[k]) * W + l] = work[static_cast<size_t>(k) * W + l];
+}
+
+// Explicit template instantiations
+template class Batch_lu<4>;
+template class Batch_lu<8>;
+template class Batch_lu<16>;
@@ -0,0 +1,329 @@
+#include "benchmark.h"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace {
+
+constexpr const char* report_format = "circuit_benchmark 1";
+
+std::string escape(const std::string& text) {
+    std::string out;
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            out += '\\';
+            out += c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            std::ostringstream oss;
+            oss << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(c);
+            out += oss.str();
+        } else {
+            out += c;
+        }
+    }
+    return out;
+}
+
+// Parsed JSON value (only what reports contain: objects, arrays, strings, numbers, literals)
+struct Json_value {
+    enum class Kind { null, boolean, number, string, array, object } kind = Kind::null;
+    double number = 0.0;
+    std::string text;
+    std::vector<Json_value> items;
+    std::vector<std::pair<std::string, Json_value>> members;
+
+    const Json_value* find(const std::string& key) const {
+        for (const auto& [name, value] : members)
+            if (name == key)
+                return &value;
+        return nullptr;
+    }
+};
+
+class Json_parser {
+private:
+    const std::string& input;
+    size_t pos;
+
+    [[noreturn]] void fail(const std::string& message) const {
+        throw std::runtime_error("Malformed benchmark report at offset " + std::to_string(pos) + ": " + message);
+    }
+
+    void skip_space() {
+        while (pos < input.size() && std::isspace(static_cast<unsigned char>(input[pos])))
+            pos++;
+    }
+
+    void expect(char c) {
+        skip_space();
+        if (pos >= input.size() || input[pos] != c)
+            fail(std::string("expected '") + c + "'");
+        pos++;
+    }
+
+    std::string parse_string() {
+        expect('"');
+        std::string out;
+        while (pos < input.size() && input[pos] != '"') {
+            char c = input[pos++];
+            if (c != '\\') {
+                out += c;
+                continue;
+            }
+            if (pos >= input.size())
+                fail("unterminated escape");
+            char e = input[pos++];
+            switch (e) {
+                case 'n': out += '\n'; break;
+                case 't': out += '\t'; break;
+                case 'r': out += '\r'; break;
+                case 'b': out += '\b'; break;
+                case 'f': out += '\f'; break;
+                case 'u':
+                    if (pos + 4 > input.size())
+                        fail("truncated \\u escape");
+                    out += static_cast<char>(std::stoi(input.substr(pos, 4), nullptr, 16) & 0x7f);
+                    pos += 4;
+                    break;
+                default: out += e; break;
+            }
+        }
+        if (pos >= input.size())
+            fail("unterminated string");
+        pos++;
+        return out;
+    }
+
+public:
+    explicit Json_parser(const std::string& input) : input(input), pos(0) {}
+
+    Json_value parse_value() {
+        skip_space();
+        if (pos >= input.size())
+            fail("unexpected end of input");
+        Json_value value;
+        char c = input[pos];
+        if (c == '{') {
+            value.kind = Json_value::Kind::object;
+            pos++;
+            skip_space();
+            if (pos < input.size() && input[pos] == '}') {
+                pos++;
+                return value;
+            }
+            do {
+                std::string key = parse_string();
+                expect(':');
+                value.members.emplace_back(key, parse_value());
+                skip_space();
+            } while (pos < input.size() && input[pos] == ',' && ++pos);
+            expect('}');
+        } else if (c == '[') {
+            value.kind = Json_value::Kind::array;
+            pos++;
+            skip_space();
+            if (pos < input.size() && input[pos] == ']') {
+                pos++;
+                return value;
+            }
+            do {
+                value.items.push_back(parse_value());
+                skip_space();
+            } while (pos < input.size() && input[pos] == ',' && ++pos);
+            expect(']');
+        } else if (c == '"') {
+            value.kind = Json_value::Kind::string;
+            value.text = parse_string();
+        } else if (input.compare(pos, 4, "true") == 0 || input.compare(pos, 5, "false") == 0) {
+            value.kind = Json_value::Kind::boolean;
+            value.number = input[pos] == 't' ? 1.0 : 0.0;
+            pos += input[pos] == 't' ? 4 : 5;
+        } else if (input.compare(pos, 4, "null") == 0) {
+            pos += 4;
+        } else {
+            value.kind = Json_value::Kind::number;
+            size_t used = 0;
+            try {
+                value.number = std::stod(input.substr(pos, 32), &used);
+            } catch (const std::exception&) {
+                fail("expected a value");
+            }
+            pos += used;
+        }
+        return value;
+    }
+
+    void finish() {
+        skip_space();
+        if (pos != input.size())
+            fail("trailing characters");
+    }
+};
+
+double number_field(const Json_value& object, const std::string& key) {
+    const Json_value* value = object.find(key);
+    if (!value || value->kind != Json_value::Kind::number)
+        throw std::runtime_error("Benchmark result is missing numeric field \"" + key + "\".");
+    return value->number;
+}
+
+std::string string_field(const Json_value& object, const std::string& key) {
+    const Json_value* value = object.find(key);
+    if (!value || value->kind != Json_value::Kind::string)
+        throw std::runtime_error("Benchmark result is missing string field \"" + key + "\".");
+    return value->text;
+}
+
+} // namespace
+
+Benchmark_stats Benchmark_stats::from_samples(std::vector<double> samples) {
+    if (samples.empty())
+        throw std::invalid_argument("Benchmark statistics need at least one sample.");
+    std::sort(samples.begin(), samples.end());
+    Benchmark_stats stats;
+    size_t n = samples.size();
+    stats.repetitions = static_cast<int>(n);
+    stats.min = samples.front();
+    stats.max = samples.back();
+    stats.median = (n % 2 == 1) ? samples[n / 2] : 0.5 * (samples[n / 2 - 1] + samples[n / 2]);
+    double sum = 0.0;
+    for (double s : samples)
+        sum += s;
+    stats.mean = sum / static_cast<double>(n);
+    double squares = 0.0;
+    for (double s : samples)
+        squares += (s - stats.mean) * (s - stats.mean);
+    stats.stddev = n > 1 ? std::sqrt(squares / static_cast<double>(n - 1)) : 0.0;
+    return stats;
+}
+
+std::string Benchmark_result::key() const {
+    return family + "/" + std::to_string(size) + "/" + phase;
+}
+
+void Benchmark_report::write_json(std::ostream& os) const {
+    std::ostringstream out;
+    out << std::setprecision(9);
+    out << "{\n  \"format\": \"" << report_format << "\",\n  \"metadata\": {";
+    bool first = true;
+    for (const auto& [key, value] : metadata) {
+        out << (first ? "\n" : ",\n") << "    \"" << escape(key) << "\": \"" << escape(value) << "\"";
+        first = false;
+    }
+    out << (metadata.empty() ? "},\n" : "\n  },\n") << "  \"results\": [";
+    for (size_t k = 0; k < results.size(); k++) {
+        const Benchmark_result& r = results[k];
+        out << (k == 0 ? "\n" : ",\n")
+            << "    {\"family\": \"" << escape(r.family) << "\", \"size\": " << r.size
+            << ", \"unknowns\": " << r.unknowns << ", \"nonzeros\": " << r.nonzeros
+            << ", \"phase\": \"" << escape(r.phase) << "\", \"repetitions\": " << r.stats.repetitions
+            << ", \"min_us\": " << r.stats.min << ", \"median_us\": " << r.stats.median
+            << ", \"mean_us\": " << r.stats.mean << ", \"stddev_us\": " << r.stats.stddev
+            << ", \"max_us\": " << r.stats.max << "}";
+    }
+    out << (results.empty() ? "]\n}\n" : "\n  ]\n}\n");
+    os << out.str();
+}
+
+void Benchmark_report::write_json_file(const std::string& filename) const {
+    std::ofstream file(filename);
+    if (!file.is_open())
+        throw std::runtime_error("Could not write benchmark report: " + filename);
+    write_json(file);
+    if (!file)
+        throw std::runtime_error("Could not write benchmark report: " + filename);
+}
+
+Benchmark_report Benchmark_report::read_json(std::istream& is) {
+    std::string input((std::istreambuf_iterator<char>(is)), std::istreambuf_iterator<char>());
+    Json_parser parser(input);
+    Json_value root = parser.parse_value();
+    parser.finish();
+    if (root.kind != Json_value::Kind::object)
+        throw std::runtime_error("Benchmark report is not a JSON object.");
+    const Json_value* format = root.find("format");
+    if (!format || format->text != report_format)
+        throw std::runtime_error("Not a benchmark report (expected format \"" + std::string(report_format) + "\").");
+
+    Benchmark_report report;
+    if (const Json_value* metadata = root.find("metadata"))
+        for (const auto& [key, value] : metadata->members)
+            report.metadata[key] = value.text;
+
+    const Json_value* results = root.find("results");
+    if (!results || results->kind != Json_value::Kind::array)
+        throw std::runtime_error("Benchmark report has no results array.");
+    for (const Json_value& item : results->items) {
+        Benchmark_result r;
+        r.family = string_field(item, "family");
+        r.size = static_cast<size_t>(number_field(item, "size"));
+        r.unknowns = static_cast<size_t>(number_field(item, "unknowns"));
+        r.nonzeros = static_cast<size_t>(number_field(item, "nonzeros"));
+        r.phase = string_field(item, "phase");
+        r.stats.repetitions = static_cast<int>(number_field(item, "repetitions"));
+        r.stats.min = number_field(item, "min_us");
+        r.stats.median = number_field(item, "median_us");
+        r.stats.mean = number_field(item, "mean_us");
+        r.stats.stddev = number_field(item, "stddev_us");
+        r.stats.max = number_field(item, "max_us");
+        report.results.push_back(r);
+    }
+    return report;
+}
+
+Benchmark_report Benchmark_report::read_json_file(const std::string& filename) {
+    std::ifstream file(filename);
+    if (!file.is_open())
+        throw std::runtime_error("Could not open benchmark report: " + filename);
+    return read_json(file);
+}
+
+std::vector<Benchmark_change> Benchmark_report::compare(const Benchmark_report& baseline, double threshold,
+                                                        double min_delta_us) const {
+    std::unordered_map<std::string, const Benchmark_result*> previous;
+    for (const Benchmark_result& r : baseline.results)
+        previous[r.key()] = &r;
+
+    std::vector<Benchmark_change> changes;
+    for (const Benchmark_result& r : results) {
+        auto it = previous.find(r.key());
+        if (it == previous.end())
+            continue;
+        Benchmark_change change;
+        change.key = r.key();
+        change.baseline = it->second->stats.median;
+        change.current = r.stats.median;
+        change.ratio = change.baseline > 0.0 ? change.current / change.baseline : 1.0;
+        double delta = change.current - change.baseline;
+        if (std::abs(delta) >= min_delta_us) {
+            change.regression = change.ratio > 1.0 + threshold;
+            change.improvement = change.ratio < 1.0 / (1.0 + threshold);
+        }
+        changes.push_back(change);
+    }
+    return changes;
+}
+
+void Benchmark_report::print_table(std::ostream& os) const {
+    os << std::left << std::setw(10) << "Family" << std::right << std::setw(10) << "Size"
+       << std::setw(10) << "Unknowns" << "  " << std::left << std::setw(12) << "Phase" << std::right
+       << std::setw(14) << "Median (us)" << std::setw(14) << "Min (us)" << std::setw(14) << "Stddev (us)"
+       << std::endl;
+    os << std::string(84, '-') << std::endl;
+    std::ios_base::fmtflags flags = os.flags();
+    std::streamsize precision = os.precision();
+    os << std::fixed << std::setprecision(1);
+    for (const Benchmark_result& r : results) {
+        os << std::left << std::setw(10) << r.family << std::right << std::setw(10) << r.size
+           << std::setw(10) << r.unknowns << "  " << std::left << std::setw(12) << r.phase << std::right
+           << std::setw(14) << r.stats.median << std::setw(14) << r.stats.min << std::setw(14) << r.stats.stddev
+           << std::endl;
+    }
+    os.flags(flags);
+    os.precision(precision);
+}
@@ -0,0 +1,172 @@
+#include "btf.h"
+#include <algorithm>
+
+// ============================================================
+//  Maximum transversal (augmenting paths, depth-first)
+// ============================================================
+
+int Btf::maximum_transversal(int n, const std::vector<int>& col_ptr,
+                             const std::vector<int>& row_idx, std::vector<int>& row_match) {
+    row_match.assign(n, -1);
+    std::vector<int> cheap(col_ptr.begin(), col_ptr.end() - 1);  // Next unscanned entry per column
+    std::vector<int> visited(n, -1);                              // Column -> last search that visited it
+    std::vector<int> col_stack(n), row_stack(n), ptr_stack(n);
+    int rank = 0;
+
+    for (int k = 0; k < n; k++) {
+        bool found = false;
+        int head = 0;
+        int row = -1;
+        col_stack[0] = k;
+
+        while (head >= 0) {
+            int j = col_stack[head];
+            if (visited[j] != k) {
+                // First visit: look for a free row directly (cheap assignment)
+                visited[j] = k;
+                int p = cheap[j];
+                for (; p < col_ptr[j + 1] && !found; p++) {
+                    row = row_idx[p];
+                    found = (row_match[row] == -1);
+                }
+                cheap[j] = p;
+                if (found) {
+                    row_stack[head] = row;
+                    break;
+                }
+                ptr_stack[head] = col_ptr[j];
+            }
+
+            // Depth-first: continue through a matched row to its column
+            int p = ptr_stack[head];
+            for (; p < col_ptr[j + 1]; p++) {
+                int i = row_idx[p];
+                if (visited[row_match[i]] == k)
+                    continue;
+                ptr_stack[head] = p + 1;
+                row_stack[head] = i;
+                col_stack[++head] = row_match[i];
+                break;
+            }
+            if (p == col_ptr[j + 1])
+                head--;
+        }
+
+        if (!found)
+            continue;
+
+        // Flip the augmenting path
+        for (int p = head; p >= 0; p--)
+            row_match[row_stack[p]] = col_stack[p];
+        rank++;
+    }
+    return rank;
+}
+
+// ============================================================
+//  Tarjan's strongly connected components
+// ============================================================
+
+void Btf::strongly_connected_components(int n, const std::vector<int>& col_ptr,
+                                        const std::vector<int>& row_idx,
+                                        const std::vector<int>& row_match,
+                                        const std::vector<int>& col_match,
+                                        Btf_decomposition& btf) {
+    // Graph on columns: j -> row_match[i] for every entry A(i, j).
+    // Components are emitted sinks-first, which yields upper block triangular order.
+    std::vector<int> index(n, -1), low(n, 0);
+    std::vector<char> on_stack(n, 0);
+    std::vector<int> scc_stack, call_node, call_ptr;
+    scc_stack.reserve(n);
+    int counter = 0;
+
+    btf.col_perm.clear();
+    btf.row_perm.clear();
+    btf.block_ptr.assign(1, 0);
+
+    for (int root = 0; root < n; root++) {
+        if (index[root] != -1)
+            continue;
+
+        index[root] = low[root] = counter++;
+        scc_stack.push_back(root);
+        on_stack[root] = 1;
+        call_node.push_back(root);
+        call_ptr.push_back(col_ptr[root]);
+
+        while (!call_node.empty()) {
+            int v = call_node.back();
+            int& p = call_ptr.back();
+
+            if (p < col_ptr[v + 1]) {
+                int w = row_match[row_idx[p++]];
+                if (index[w] == -1) {
+                    index[w] = low[w] = counter++;
+                    scc_stack.push_back(w);
+                    on_stack[w] = 1;
+                    call_node.push_back(w);
+                    call_ptr.push_back(col_ptr[w]);
+                } else if (on_stack[w]) {
+                    low[v] = std::min(low[v], index[w]);
+                }
+                continue;
+            }
+
+            call_node.pop_back();
+            call_ptr.pop_back();
+            if (!call_node.empty())
+                low[call_node.back()] = std::min(low[call_node.back()], low[v]);
+
+            if (low[v] != index[v])
+                continue;
+
+            // v is the root of a component: pop it as one diagonal block
+            int w;
+            do {
+                w = scc_stack.back();
+                scc_stack.pop_back();
+                on_stack[w] = 0;
+                btf.col_perm.push_back(w);
+                btf.row_perm.push_back(col_match[w]);
+            } while (w != v);
+            btf.block_ptr.push_back(static_cast<int>(btf.col_perm.size()));
+        }
+    }
+}
+
+// ============================================================
+//  Public entry point
+// ============================================================
+
+Btf_decomposition Btf::decompose(int n, const std::vector<int>& col_ptr, const std::vector<int>& row_idx) {
+    Btf_decomposition btf;
+    std::vector<int> row_match;
+    btf.structural_rank = maximum_transversal(n, col_ptr, row_idx, row_match);
+
+    // Pair any unmatched rows with unmatched columns so the permutation is complete
+    std::vector<int> col_match(n, -1);
+    for (int i = 0; i < n; i++)
+        if (row_match[i] >= 0)
+            col_match[row_match[i]] = i;
+    int free_col = 0;
+    for (int i = 0; i < n; i++) {
+        if (row_match[i] >= 0)
+            continue;
+        while (col_match[free_col] >= 0)
+            free_col++;
+        col_match[free_col] = i;
+        row_match[i] = free_col;
+        btf.unmatched_rows.push_back(i);
+        btf.unmatched_cols.push_back(free_col);
+    }
+
+    strongly_connected_components(n, col_ptr, row_idx, row_match, col_match, btf);
+
+    for (int b = 0; b < btf.num_blocks(); b++) {
+        int size = btf.block_ptr[b + 1] - btf.block_ptr[b];
+        btf.max_block_size = std::max(btf.max_block_size, size);
+        if (size == 1)
+            btf.num_singletons++;
+    }
+    return btf;
+}
@@ -1,4 +1,6 @@
 #include "capacitor.h"
+#include <cmath>
+#include <stdexcept>
 #include <math.h>
 
 Capacitor::Capacitor(const std::string& id, Node* ni, Node* nj, double c): Ac_component(id, ni, nj), capacitance(c), admittance(0) {}
@@ -20,18 +22,24 @@ Component_contribution<double> Capacitor::get_contribution(){
 Component_contribution<std::complex<double>> Capacitor::get_ac_contribution(double frequency){
     Component_contribution<std::complex<double>> contribution;
 
-    if (frequency == 0.0)
+    // Frequency 0 starts a sweep on a freshly initialized AC matrix
+    if (frequency == 0.0) {
+        admittance = 0.0;
         return contribution;
+    }
 
-    admittance = std::complex<double>(0, 2.0 * PI * frequency * capacitance) - admittance; // jωC
+    // Stamp the change since the previous frequency; the matrix keeps the sum
+    std::complex<double> current_admittance = std::complex<double>(0, 2.0 * PI * frequency * capacitance); // jωC
+    std::complex<double> delta = current_admittance - admittance;
+    admittance = current_admittance;
     if(ni->id != 0)
-        contribution.stampMatrix(ni->id, ni->id, admittance);
+        contribution.stampMatrix(ni->id, ni->id, delta);
     if(nj->id != 0)
-        contribution.stampMatrix(nj->id, nj->id, admittance);
+        contribution.stampMatrix(nj->id, nj->id, delta);
     if (ni->id != 0 && nj->id != 0)
     {
-        contribution.stampMatrix(ni->id, nj->id, -admittance);
-        contribution.stampMatrix(nj->id, ni->id, -admittance);
+        contribution.stampMatrix(ni->id, nj->id, -delta);
+        contribution.stampMatrix(nj->id, ni->id, -delta);
     }
     return contribution;
 }
@@ -42,4 +50,9 @@ void Capacitor::print(std::ostream& os) const {
        << std::setw(6) << ni->name 
        << std::setw(6) << nj->name 
        << std::right << std::fixed << std::setprecision(4) << std::setw(12) << displayValue << " nF" << std::endl;
-}
\ No newline at end of file
+}
+void Capacitor::set_value(double value) {
+    if (!(value > 0) || !std::isfinite(value))
+        throw std::runtime_error("Capacitor with ID " + componentId + " has non-positive or non-finite capacitance.");
+    capacitance = value;
+}
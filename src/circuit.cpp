@@ -3,6 +3,11 @@
 #include "netlist_parser.h"
 #include "componentFactory.h"
 #include "circuit_printer.h"
+#include "fingerprint.h"
+#include "memory_accounting.h"
+#include "perf_counters.h"
+#include "trace.h"
+#include <algorithm>
 
 Circuit::Circuit(std::string name) : circuit_name(name) {
     nodes.clear();
@@ -26,6 +31,7 @@ Circuit::~Circuit() {
 // Helper functions
 
 void Circuit::add_node(std::string& nodeId) {
+    Memory_scope memory(Memory_tag::nodes);
     if (nodes.find(nodeId) == nodes.end()) {
         Node* newNode = new Node(nodeId);
         nodes[nodeId] = newNode;
@@ -34,6 +40,7 @@ void Circuit::add_node(std::string& nodeId) {
 }
 
 void Circuit::add_component(const ComponentDescriptor& descriptor) {
+    Memory_scope memory(Memory_tag::components);
     if(descriptor.is_directive) {
         throw std::runtime_error("Directives cannot be added as components to the circuit.");
     }
@@ -42,12 +49,34 @@ void Circuit::add_component(const ComponentDescriptor& descriptor) {
         throw std::runtime_error("Component with ID " + descriptor.id + " already exists in the circuit.");
     }
 
+    // Monte Carlo samples the DC operating point, which capacitors and inductors do not affect
+    auto tol = descriptor.keyed.find("TOL");
+    auto sigma = descriptor.keyed.find("SIGMA");
+    bool toleranced = tol != descriptor.keyed.end() || sigma != descriptor.keyed.end();
+    if (toleranced && (descriptor.type == 'C' || descriptor.type == 'L')) {
+        throw std::runtime_error("Component with ID " + descriptor.id +
+                                 " cannot have a tolerance: capacitors and inductors do not affect the DC operating point.");
+    }
+
     ComponentFactory componentFactory;
     Component* component = componentFactory.create_component(descriptor);
-    components[descriptor.id] = component;
+    register_component(component);
+
+    if (toleranced) {
+        Tolerance tolerance;
+        tolerance.distribution = (tol != descriptor.keyed.end()) ? Tolerance::Distribution::uniform
+                                                                 : Tolerance::Distribution::gaussian;
+        tolerance.spread = (tol != descriptor.keyed.end()) ? tol->second : sigma->second;
+        if (tolerance.spread < 0 || (tolerance.distribution == Tolerance::Distribution::uniform && tolerance.spread >= 1))
+            throw std::runtime_error("Component with ID " + descriptor.id + " has an invalid tolerance.");
+        component->set_tolerance(tolerance);
+    }
+}
 
+void Circuit::register_component(Component* component) {
+    components[component->get_id()] = component;
     if(component->is_ac()) {
-        ac_components[descriptor.id] = component;
+        ac_components[component->get_id()] = component;
         if(component->has_extra_var()) {
             extraVarId_map[component->get_vc_id()] = component->get_stamping_label();
         }
@@ -57,7 +86,16 @@ void Circuit::add_component(const ComponentDescriptor& descriptor) {
 // Core functions
 
 void Circuit::assemble_MNA_system() {
-    mna_matrix.clear();
+    TRACE_SCOPE("assemble");
+    Perf_scope perf("assemble");
+    Memory_scope memory(Memory_tag::mna);
+    // Re-assembly zeroes the stored entries instead of clearing the maps, so an
+    // unchanged pattern is refilled without allocating hash nodes
+    for(auto& [row, col_map] : mna_matrix)
+        for(auto& [col, value] : col_map)
+            value = 0.0;
+    for(auto& [row, value] : mna_vector)
+        value = 0.0;
     for(const auto& component : components) {
         Component_contribution<double> contrib = component.second->get_contribution();
 
@@ -70,21 +108,89 @@ void Circuit::assemble_MNA_system() {
 }
 
 void Circuit::deploy_dc_solution(const std::vector<double>& solution) {
-    for (size_t i = 1; i < solution.size(); i++)
-    {
-        if (nodeId_map.find(i) != nodeId_map.end()) {
-            std::string node_name = nodeId_map.at(i);
-            nodes[node_name]->voltage = solution[i];
-        } else if (extraVarId_map.find(i) != extraVarId_map.end()) {
-            std::string component_name = extraVarId_map.at(i).substr(1);
-            components[component_name]->set_current(solution[i]);
-        }else {
-            throw std::runtime_error("Solution index " + std::to_string(i) + " does not correspond to any node or source.");
+    // Walk the objects instead of looking them up by name: no string copies per solve
+    size_t deployed = 0;
+    for (const auto& [name, node] : nodes) {
+        if (node->id > 0 && static_cast<size_t>(node->id) < solution.size()) {
+            node->voltage = solution[node->id];
+            deployed++;
+        }
+    }
+    for (const auto& [id, component] : ac_components) {
+        int var = component->get_vc_id();
+        if (component->has_extra_var() && var > 0 && static_cast<size_t>(var) < solution.size()) {
+            component->set_current(solution[var]);
+            deployed++;
         }
     }
+    if (deployed + 1 < solution.size()) {
+        for (size_t i = 1; i < solution.size(); i++)
+            if (nodeId_map.find(i) == nodeId_map.end() && extraVarId_map.find(i) == extraVarId_map.end())
+                throw std::runtime_error("Solution index " + std::to_string(i) + " does not correspond to any node or source.");
+    }
     Node::valid = true;
 }
 
+Component_contribution<double> Circuit::set_component_value(const std::string& id, double value) {
+    auto it = components.find(id);
+    if (it == components.end())
+        throw std::runtime_error("Component with ID " + id + " does not exist in the circuit.");
+
+    Component_contribution<double> old_contrib = it->second->get_contribution();
+    it->second->set_value(value);
+    Component_contribution<double> delta = it->second->get_contribution();
+    for (const auto& mc : old_contrib.matrixStamps)
+        delta.stampMatrix(mc.row, mc.col, -mc.value);
+    for (const auto& vc : old_contrib.vectorStamps)
+        delta.stampVector(vc.row, -vc.value);
+
+    for (const auto& mc : delta.matrixStamps)
+        mna_matrix[mc.row][mc.col] += mc.value;
+    for (const auto& vc : delta.vectorStamps)
+        mna_vector[vc.row] += vc.value;
+    Node::valid = false;
+    return delta;
+}
+
+// Fingerprints
+
+namespace {
+
+std::vector<const Component*> sorted_components(const std::unordered_map<std::string, Component*>& components) {
+    std::vector<const Component*> sorted;
+    sorted.reserve(components.size());
+    for (const auto& [id, component] : components)
+        sorted.push_back(component);
+    std::sort(sorted.begin(), sorted.end(),
+              [](const Component* a, const Component* b) { return a->get_id() < b->get_id(); });
+    return sorted;
+}
+
+} // namespace
+
+uint64_t Circuit::topology_hash() const {
+    Fingerprint fp;
+    fp.add(static_cast<uint64_t>(components.size()));
+    for (const Component* component : sorted_components(components)) {
+        fp.add(component->get_id());
+        fp.add(component->get_node_i()->name);
+        fp.add(component->get_node_j()->name);
+    }
+    return fp.value();
+}
+
+uint64_t Circuit::values_hash() const {
+    Fingerprint fp;
+    for (const Component* component : sorted_components(components)) {
+        fp.add(component->get_id());
+        fp.add(component->get_value());
+        fp.add(component->get_signal_value());
+        fp.add(static_cast<uint64_t>(component->get_tolerance().distribution));
+        fp.add(component->get_tolerance().spread);
+    }
+    return fp.value();
+}
+
 // Print functions
 
 void Circuit::print_nodes(std::ostream& os) const {
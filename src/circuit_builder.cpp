@@ -1,35 +1,165 @@
 #include "circuit_builder.h"
+#include "memory_accounting.h"
 #include "netlist_parser.h"
+#include "trace.h"
+#include <cctype>
 #include <fstream>
 #include <stdexcept>
 
+namespace {
+
+constexpr size_t chunk_lines = 4096;   // Netlist lines parsed per chunk
+
+// Descriptor for a two-terminal element with one positional value, checked against its ID
+ComponentDescriptor make_descriptor(char type, const std::string& id, const std::string& node1,
+                                    const std::string& node2, double value) {
+    if (id.empty() || std::toupper(static_cast<unsigned char>(id[0])) != type)
+        throw std::invalid_argument("Component ID '" + id + "' must start with '" + std::string(1, type) + "'.");
+    ComponentDescriptor descriptor;
+    descriptor.type = type;
+    descriptor.id = id;
+    descriptor.node1 = node1;
+    descriptor.node2 = node2;
+    descriptor.positional.push_back(value);
+    return descriptor;
+}
+
+} // namespace
+
 void CircuitBuilder::build(Circuit& circuit, const std::string& filename) {
     std::ifstream file(filename);
     if (!file.is_open()) {
         throw std::runtime_error("Could not open netlist file: " + filename);
     }
+    build(circuit, file);
+}
 
-    std::string header_name = NetlistParser::parse_header(file);
+void CircuitBuilder::build(Circuit& circuit, std::istream& in) {
+    std::string first_line;
+    std::string header_name = NetlistParser::parse_header(in, &first_line);
     if (!header_name.empty() && circuit.circuit_name == Circuit::default_name) {
         circuit.circuit_name = header_name;
     }
 
-    std::string line;
-    while (std::getline(file, line)) {
-        ComponentDescriptor descriptor;
-        if (!NetlistParser::parse_line(line, descriptor)) {
-            continue;
+    // First line of an unseekable stream that turned out not to be a header
+    bool pending = !first_line.empty();
+    add_lines(circuit, [&](std::string& line) {
+        if (pending) {
+            pending = false;
+            line = std::move(first_line);
+            return true;
         }
+        return static_cast<bool>(std::getline(in, line));
+    });
+}
 
-        // Add nodes to the circuit
-        circuit.add_node(descriptor.node1);
-        circuit.add_node(descriptor.node2);
+void CircuitBuilder::build_from_text(Circuit& circuit, std::string_view netlist) {
+    bool first = true;
+    size_t pos = 0;
+    add_lines(circuit, [&](std::string& line) {
+        while (pos < netlist.size()) {
+            size_t end = netlist.find('\n', pos);
+            if (end == std::string_view::npos)
+                end = netlist.size();
+            line.assign(netlist.data() + pos, end - pos);
+            pos = end + 1;
 
-        // Resolve node pointers inside descriptor before creation
-        descriptor.ni = circuit.nodes[descriptor.node1];
-        descriptor.nj = circuit.nodes[descriptor.node2];
+            if (first) {
+                first = false;
+                bool is_header = false;
+                std::string header_name = NetlistParser::parse_title(line, is_header);
+                if (is_header) {
+                    if (!header_name.empty() && circuit.circuit_name == Circuit::default_name)
+                        circuit.circuit_name = header_name;
+                    continue;
+                }
+            }
+            return true;
+        }
+        return false;
+    });
+}
 
-        // Add component to the circuit
-        circuit.add_component(descriptor);
+template<typename Next_line>
+void CircuitBuilder::add_lines(Circuit& circuit, Next_line&& next_line) {
+    std::string line;
+    std::vector<ComponentDescriptor> descriptors;
+    bool more = true;
+    while (more) {
+        descriptors.clear();
+        {
+            TRACE_SCOPE("parse");
+            Memory_scope memory(Memory_tag::parse);
+            size_t lines = 0;
+            while (lines < chunk_lines && (more = next_line(line))) {
+                lines++;
+                descriptors.emplace_back();
+                if (!NetlistParser::parse_line(line, descriptors.back()))
+                    descriptors.pop_back();
+            }
+        }
+        TRACE_SCOPE("build");
+        add_components(circuit, descriptors);
     }
 }
+
+void CircuitBuilder::reserve(Circuit& circuit, size_t num_nodes, size_t num_components) {
+    circuit.nodes.reserve(num_nodes);
+    circuit.components.reserve(num_components);
+}
+
+Node* CircuitBuilder::add_node(Circuit& circuit, const std::string& name) {
+    auto it = circuit.nodes.find(name);
+    if (it != circuit.nodes.end())
+        return it->second;
+    std::string node_name = name;
+    circuit.add_node(node_name);
+    return circuit.nodes[node_name];
+}
+
+void CircuitBuilder::add(Circuit& circuit, ComponentDescriptor& descriptor) {
+    // Resolve node pointers inside descriptor before creation (nodes are added if new)
+    descriptor.ni = add_node(circuit, descriptor.node1);
+    descriptor.nj = add_node(circuit, descriptor.node2);
+
+    // Add component to the circuit
+    circuit.add_component(descriptor);
+}
+
+void CircuitBuilder::add_components(Circuit& circuit, std::vector<ComponentDescriptor>& descriptors) {
+    circuit.components.reserve(circuit.components.size() + descriptors.size());
+    for (ComponentDescriptor& descriptor : descriptors)
+        add(circuit, descriptor);
+}
+
+void CircuitBuilder::add_resistor(Circuit& circuit, const std::string& id, const std::string& node1,
+                                  const std::string& node2, double resistance) {
+    ComponentDescriptor descriptor = make_descriptor('R', id, node1, node2, resistance);
+    add(circuit, descriptor);
+}
+
+void CircuitBuilder::add_capacitor(Circuit& circuit, const std::string& id, const std::string& node1,
+                                   const std::string& node2, double capacitance) {
+    ComponentDescriptor descriptor = make_descriptor('C', id, node1, node2, capacitance);
+    add(circuit, descriptor);
+}
+
+void CircuitBuilder::add_inductor(Circuit& circuit, const std::string& id, const std::string& node1,
+                                  const std::string& node2, double inductance) {
+    ComponentDescriptor descriptor = make_descriptor('L', id, node1, node2, inductance);
+    add(circuit, descriptor);
+}
+
+void CircuitBuilder::add_current_source(Circuit& circuit, const std::string& id, const std::string& node1,
+                                        const std::string& node2, double current) {
+    ComponentDescriptor descriptor = make_descriptor('I', id, node1, node2, current);
+    add(circuit, descriptor);
+}
+
+void CircuitBuilder::add_voltage_source(Circuit& circuit, const std::string& id, const std::string& node1,
+                                        const std::string& node2, double dc_voltage, double ac_voltage) {
+    ComponentDescriptor descriptor = make_descriptor('V', id, node1, node2, dc_voltage);
+    if (ac_voltage != 0.0)
+        descriptor.keyed["AC"] = ac_voltage;
+    add(circuit, descriptor);
+}
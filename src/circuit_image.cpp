@@ -0,0 +1,384 @@
+#include "circuit_image.h"
+#include "resistor.h"
+#include "capacitor.h"
+#include "inductor.h"
+#include "current_source.h"
+#include "voltage_source.h"
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+#ifdef _WIN32
+#include <iterator>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+// ============================================================
+//  On-disk records (fixed size, 8-byte aligned)
+// ============================================================
+
+constexpr char magic[8] = {'C', 'K', 'T', 'I', 'M', 'A', 'G', 'E'};
+constexpr uint32_t byte_order_mark = 0x01020304;
+constexpr char component_types[] = {'R', 'C', 'L', 'I', 'V'};
+
+enum Section_id { strings_section, nodes_section, first_component_section,
+                  matrix_section = first_component_section + 5, vector_section, num_sections };
+
+struct Section {
+    uint64_t offset;                        // Byte offset from the start of the file
+    uint64_t count;                         // Records (bytes for the strings section)
+};
+
+struct Header {
+    char magic[8];
+    uint32_t version;
+    uint32_t byte_order;                    // byte_order_mark as written by the producer
+    uint32_t name_offset, name_length;      // Circuit name in the strings section
+    Section sections[num_sections];
+};
+
+struct Node_record {
+    uint32_t name_offset, name_length;
+    int32_t id;                             // MNA index
+    uint32_t reserved;
+};
+
+struct Component_record {
+    uint32_t id_offset, id_length;
+    uint32_t node_i, node_j;                // Indices into the node table
+    double value;                           // Value in base units (DC value for sources)
+    double signal;                          // AC amplitude (voltage sources)
+    int32_t vc_id;                          // Extra variable index (-1 if none)
+    uint32_t distribution;                  // Tolerance::Distribution
+    double spread;                          // Tolerance spread
+};
+
+struct Matrix_record {
+    int32_t row, col;
+    double value;
+};
+
+struct Vector_record {
+    int32_t row;
+    uint32_t reserved;
+    double value;
+};
+
+static_assert(sizeof(Node_record) == 16 && sizeof(Component_record) == 48 &&
+              sizeof(Matrix_record) == 16 && sizeof(Vector_record) == 16, "Image records must be packed");
+
+size_t align8(size_t size) { return (size + 7) & ~size_t(7); }
+
+template<typename Record>
+void append(std::string& image, const std::vector<Record>& records, Section& section) {
+    section.offset = image.size();
+    section.count = records.size();
+    image.append(reinterpret_cast<const char*>(records.data()), records.size() * sizeof(Record));
+}
+
+// Read-only view of a whole file (memory-mapped where available)
+class Mapped_file {
+private:
+    const char* data_ptr = nullptr;
+    size_t length = 0;
+#ifdef _WIN32
+    std::vector<char> buffer;
+#endif
+
+public:
+    explicit Mapped_file(const std::string& filename) {
+#ifdef _WIN32
+        std::ifstream in(filename, std::ios::binary);
+        if (!in.is_open())
+            throw std::runtime_error("Could not open circuit image: " + filename);
+        buffer.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+        data_ptr = buffer.data();
+        length = buffer.size();
+#else
+        int fd = ::open(filename.c_str(), O_RDONLY);
+        if (fd < 0)
+            throw std::runtime_error("Could not open circuit image: " + filename);
+        struct stat st;
+        if (::fstat(fd, &st) != 0) {
+            ::close(fd);
+            throw std::runtime_error("Could not open circuit image: " + filename);
+        }
+        length = static_cast<size_t>(st.st_size);
+        if (length > 0) {
+            void* p = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (p == MAP_FAILED) {
+                ::close(fd);
+                throw std::runtime_error("Could not map circuit image: " + filename);
+            }
+            data_ptr = static_cast<const char*>(p);
+        }
+        ::close(fd);
+#endif
+    }
+
+    ~Mapped_file() {
+#ifndef _WIN32
+        if (data_ptr)
+            ::munmap(const_cast<char*>(data_ptr), length);
+#endif
+    }
+
+    Mapped_file(const Mapped_file&) = delete;
+    Mapped_file& operator=(const Mapped_file&) = delete;
+
+    const char* data() const { return data_ptr; }
+    size_t size() const { return length; }
+};
+
+} // namespace
+
+// ============================================================
+//  Writer
+// ============================================================
+
+void Circuit_image::write(const Circuit& circuit, const std::string& filename) {
+    Header header{};
+    std::memcpy(header.magic, magic, sizeof(magic));
+    header.version = version;
+    header.byte_order = byte_order_mark;
+
+    std::string strings;
+    auto intern = [&strings](const std::string& s, uint32_t& offset, uint32_t& length) {
+        offset = static_cast<uint32_t>(strings.size());
+        length = static_cast<uint32_t>(s.size());
+        strings += s;
+    };
+    intern(circuit.circuit_name, header.name_offset, header.name_length);
+
+    // Node table in MNA index order
+    std::vector<const Node*> nodes;
+    nodes.reserve(circuit.nodes.size());
+    for (const auto& [name, node] : circuit.nodes)
+        nodes.push_back(node);
+    std::sort(nodes.begin(), nodes.end(), [](const Node* a, const Node* b) { return a->id < b->id; });
+    std::unordered_map<const Node*, uint32_t> node_index;
+    std::vector<Node_record> node_records(nodes.size());
+    for (size_t k = 0; k < nodes.size(); k++) {
+        intern(nodes[k]->name, node_records[k].name_offset, node_records[k].name_length);
+        node_records[k].id = nodes[k]->id;
+        node_index[nodes[k]] = static_cast<uint32_t>(k);
+    }
+
+    // Per-type component arrays, each sorted by ID
+    std::vector<Component_record> type_records[5];
+    std::vector<const Component*> sorted;
+    for (const auto& [id, component] : circuit.components)
+        sorted.push_back(component);
+    std::sort(sorted.begin(), sorted.end(),
+              [](const Component* a, const Component* b) { return a->get_id() < b->get_id(); });
+    for (const Component* component : sorted) {
+        char type = static_cast<char>(std::toupper(static_cast<unsigned char>(component->get_id()[0])));
+        const char* slot = std::find(component_types, component_types + 5, type);
+        if (slot == component_types + 5)
+            throw std::runtime_error("Component " + component->get_id() + " has no circuit image representation.");
+        Component_record record{};
+        intern(component->get_id(), record.id_offset, record.id_length);
+        record.node_i = node_index.at(component->get_node_i());
+        record.node_j = node_index.at(component->get_node_j());
+        record.value = component->get_value();
+        record.signal = component->get_signal_value();
+        record.vc_id = component->has_extra_var() ? component->get_vc_id() : -1;
+        record.distribution = static_cast<uint32_t>(component->get_tolerance().distribution);
+        record.spread = component->get_tolerance().spread;
+        type_records[slot - component_types].push_back(record);
+    }
+
+    // Assembled MNA system, rows then columns ascending
+    std::vector<Matrix_record> matrix;
+    for (const auto& [row, col_map] : circuit.mna_matrix)
+        for (const auto& [col, value] : col_map)
+            matrix.push_back({row, col, value});
+    std::sort(matrix.begin(), matrix.end(), [](const Matrix_record& a, const Matrix_record& b) {
+        return a.row != b.row ? a.row < b.row : a.col < b.col;
+    });
+    std::vector<Vector_record> vector;
+    for (const auto& [row, value] : circuit.mna_vector)
+        vector.push_back({row, 0, value});
+    std::sort(vector.begin(), vector.end(), [](const Vector_record& a, const Vector_record& b) { return a.row < b.row; });
+
+    std::string image(align8(sizeof(Header)), '\0');
+    header.sections[strings_section] = {image.size(), strings.size()};
+    image += strings;
+    image.resize(align8(image.size()), '\0');
+    append(image, node_records, header.sections[nodes_section]);
+    for (int t = 0; t < 5; t++)
+        append(image, type_records[t], header.sections[first_component_section + t]);
+    append(image, matrix, header.sections[matrix_section]);
+    append(image, vector, header.sections[vector_section]);
+    std::memcpy(&image[0], &header, sizeof(header));
+
+    std::ofstream out(filename, std::ios::binary | std::ios::trunc);
+    if (!out.is_open())
+        throw std::runtime_error("Could not write circuit image: " + filename);
+    out.write(image.data(), static_cast<std::streamsize>(image.size()));
+    if (!out)
+        throw std::runtime_error("Could not write circuit image: " + filename);
+}
+
+// ============================================================
+//  Loader
+// ============================================================
+
+bool Circuit_image::is_image(const std::string& filename) {
+    std::ifstream in(filename, std::ios::binary);
+    char head[sizeof(magic)];
+    return in.read(head, sizeof(head)) && std::memcmp(head, magic, sizeof(magic)) == 0;
+}
+
+void Circuit_image::load(Circuit& circuit, const std::string& filename) {
+    if (!circuit.components.empty() || circuit.nodes.size() != 1)
+        throw std::runtime_error("Circuit image must be loaded into an empty circuit.");
+
+    Mapped_file file(filename);
+    const char* base = file.data();
+    auto invalid = [&filename](const std::string& reason) {
+        return std::runtime_error("Invalid circuit image " + filename + ": " + reason + ".");
+    };
+    if (file.size() < sizeof(Header) || std::memcmp(base, magic, sizeof(magic)) != 0)
+        throw invalid("not a circuit image");
+    Header header;
+    std::memcpy(&header, base, sizeof(header));
+    if (header.byte_order != byte_order_mark)
+        throw invalid("written with another byte order");
+    if (header.version != version)
+        throw invalid("format version " + std::to_string(header.version) + ", expected " + std::to_string(version));
+
+    auto section = [&](int s, size_t record_size) {
+        const Section& sec = header.sections[s];
+        if (sec.offset % 8 != 0 || sec.offset > file.size() || sec.count > (file.size() - sec.offset) / record_size)
+            throw invalid("section " + std::to_string(s) + " out of bounds");
+        return base + sec.offset;
+    };
+    const char* strings = section(strings_section, 1);
+    uint64_t strings_size = header.sections[strings_section].count;
+    auto text = [&](uint32_t offset, uint32_t length) {
+        if (static_cast<uint64_t>(offset) + length > strings_size)
+            throw invalid("string out of bounds");
+        return std::string(strings + offset, length);
+    };
+
+    int max_index = 0;
+    circuit.circuit_name = text(header.name_offset, header.name_length);
+
+    // Interned node table; MNA indices are taken from the image
+    const Node_record* node_records = reinterpret_cast<const Node_record*>(section(nodes_section, sizeof(Node_record)));
+    size_t num_nodes = header.sections[nodes_section].count;
+    std::vector<Node*> nodes(num_nodes);
+    circuit.nodes.reserve(num_nodes);
+    bool ground_seen = false;
+    for (size_t k = 0; k < num_nodes; k++) {
+        std::string name = text(node_records[k].name_offset, node_records[k].name_length);
+        int32_t id = node_records[k].id;
+        Node* node;
+        if (name == "0") {
+            if (ground_seen || id < 0)
+                throw invalid("invalid ground node record");
+            ground_seen = true;
+            node = circuit.nodes.at("0");
+        } else {
+            if (id < 1)
+                throw invalid("node " + name + " has MNA index " + std::to_string(id));
+            if (circuit.nodes.count(name) || circuit.nodeId_map.count(id))
+                throw invalid("duplicate node " + name);
+            node = new Node(name);
+            circuit.nodes[name] = node;
+            circuit.nodeId_map[id] = name;
+        }
+        node->id = id;
+        nodes[k] = node;
+        max_index = std::max(max_index, node->id);
+    }
+
+    // Per-type component arrays
+    size_t num_components = 0;
+    for (int t = 0; t < 5; t++)
+        num_components += header.sections[first_component_section + t].count;
+    circuit.components.reserve(num_components);
+    for (int t = 0; t < 5; t++) {
+        const Component_record* records = reinterpret_cast<const Component_record*>(
+            section(first_component_section + t, sizeof(Component_record)));
+        size_t count = header.sections[first_component_section + t].count;
+        for (size_t k = 0; k < count; k++) {
+            const Component_record& r = records[k];
+            if (r.node_i >= num_nodes || r.node_j >= num_nodes)
+                throw invalid("node index out of range");
+            std::string id = text(r.id_offset, r.id_length);
+            if (circuit.components.count(id))
+                throw invalid("duplicate component " + id);
+            if (r.distribution > static_cast<uint32_t>(Tolerance::Distribution::gaussian))
+                throw invalid("component " + id + " has an unknown tolerance distribution");
+            if (r.distribution != static_cast<uint32_t>(Tolerance::Distribution::none) &&
+                (component_types[t] == 'C' || component_types[t] == 'L'))
+                throw invalid("component " + id + " is a capacitor or inductor with a tolerance");
+            if (r.vc_id != -1 && r.vc_id < 1)
+                throw invalid("component " + id + " has extra variable index " + std::to_string(r.vc_id));
+            Node* ni = nodes[r.node_i];
+            Node* nj = nodes[r.node_j];
+            // Sources and inductors draw their extra variable index from the global counter
+            if (r.vc_id >= 0) {
+                Node::node_count = r.vc_id;
+                max_index = std::max(max_index, static_cast<int>(r.vc_id));
+            }
+            Component* component;
+            switch (component_types[t]) {
+                case 'R': component = new Resistor(id, ni, nj, r.value); break;
+                case 'C': component = new Capacitor(id, ni, nj, r.value); break;
+                case 'L': component = new Inductor(id, ni, nj, r.value); break;
+                case 'I': component = new Current_source(id, ni, nj, r.value); break;
+                default:  component = new Voltage_source(id, ni, nj, r.value, r.signal); break;
+            }
+            Tolerance tolerance;
+            tolerance.distribution = static_cast<Tolerance::Distribution>(r.distribution);
+            tolerance.spread = r.spread;
+            component->set_tolerance(tolerance);
+            circuit.register_component(component);
+        }
+    }
+    Node::node_count = max_index + 1;
+
+    // Assembled MNA system: one reservation per row, no rehashing. Solvers index their
+    // solution vector (of size max_index + 1) by row and column without further checks.
+    auto check_index = [&](int32_t index) {
+        if (index < 1 || index > max_index)
+            throw invalid("MNA index " + std::to_string(index) + " outside [1, " + std::to_string(max_index) + "]");
+    };
+    const Matrix_record* matrix = reinterpret_cast<const Matrix_record*>(section(matrix_section, sizeof(Matrix_record)));
+    size_t nnz = header.sections[matrix_section].count;
+    size_t num_rows = 0;
+    for (size_t p = 0; p < nnz; p++) {
+        check_index(matrix[p].row);
+        check_index(matrix[p].col);
+        if (p == 0 || matrix[p].row != matrix[p - 1].row)
+            num_rows++;
+    }
+    circuit.mna_matrix.reserve(num_rows);
+    for (size_t p = 0; p < nnz;) {
+        size_t end = p;
+        while (end < nnz && matrix[end].row == matrix[p].row)
+            end++;
+        auto& row = circuit.mna_matrix[matrix[p].row];
+        row.reserve(end - p);
+        for (; p < end; p++)
+            row[matrix[p].col] = matrix[p].value;
+    }
+    const Vector_record* vector = reinterpret_cast<const Vector_record*>(section(vector_section, sizeof(Vector_record)));
+    size_t num_vector = header.sections[vector_section].count;
+    for (size_t p = 0; p < num_vector; p++)
+        check_index(vector[p].row);
+    circuit.mna_vector.reserve(num_vector);
+    for (size_t p = 0; p < num_vector; p++)
+        circuit.mna_vector[vector[p].row] = vector[p].value;
+}
@@ -0,0 +1,278 @@
+#include "compiled_circuit.h"
+#include "capacitor.h"
+#include "current_source.h"
+#include "executor.h"
+#include "frequency_sweep.h"
+#include "inductor.h"
+#include "memory_accounting.h"
+#include "resistor.h"
+#include "thread_pool.h"
+#include "trace.h"
+#include "voltage_source.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <exception>
+#include <iomanip>
+#include <mutex>
+#include <stdexcept>
+
+namespace {
+
+constexpr double PI = 3.14159265358979323846;
+
+char branch_type(const Component* component) {
+    if (dynamic_cast<const Resistor*>(component))
+        return 'R';
+    if (dynamic_cast<const Capacitor*>(component))
+        return 'C';
+    if (dynamic_cast<const Inductor*>(component))
+        return 'L';
+    if (dynamic_cast<const Voltage_source*>(component))
+        return 'V';
+    if (dynamic_cast<const Current_source*>(component))
+        return 'I';
+    throw std::runtime_error("Cannot compile component " + component->get_id() + ": unknown type.");
+}
+
+} // namespace
+
+std::shared_ptr<const Compiled_circuit> Compiled_circuit::compile(const Circuit& circuit) {
+    TRACE_SCOPE("compile");
+    Memory_scope memory(Memory_tag::mna);
+    const auto& mna_matrix = circuit.get_MNA_matrix();
+    if (mna_matrix.empty())
+        throw std::runtime_error("Cannot compile a circuit whose MNA system has not been assembled.");
+
+    std::shared_ptr<Compiled_circuit> compiled(new Compiled_circuit());
+    Compiled_circuit& c = *compiled;
+    c.circuit_name = circuit.get_name();
+    c.topology = circuit.topology_hash();
+    c.values = circuit.values_hash();
+
+    // Variables: nodes, then the current of every voltage source and inductor
+    const auto& node_map = circuit.get_nodeId_map();
+    const auto& extra_map = circuit.get_extraVarId_map();
+    int max_var = 0;
+    if (!node_map.empty())
+        max_var = std::max(max_var, node_map.rbegin()->first);
+    if (!extra_map.empty())
+        max_var = std::max(max_var, extra_map.rbegin()->first);
+    c.num_variables = max_var + 1;
+    c.variable_names.assign(c.num_variables, "");
+    for (const auto& [id, name] : node_map)
+        c.variable_names[id] = id == 0 ? "0" : "V(" + name + ")";
+    for (const auto& [name, node] : circuit.get_nodes())
+        c.node_ids[name] = node->id;
+    for (const auto& [id, label] : extra_map)
+        c.variable_names[id] = "I(" + label.substr(1) + ")";
+
+    // Branches in ID order, so printing and iteration do not depend on hashing
+    std::vector<const Component*> components;
+    for (const auto& [id, component] : circuit.get_components())
+        components.push_back(component);
+    std::sort(components.begin(), components.end(),
+              [](const Component* a, const Component* b) { return a->get_id() < b->get_id(); });
+    for (const Component* component : components) {
+        Branch branch;
+        branch.id = component->get_id();
+        branch.type = branch_type(component);
+        branch.i = component->get_node_i()->id;
+        branch.j = component->get_node_j()->id;
+        branch.var = component->has_extra_var() ? component->get_vc_id() : -1;
+        branch.value = component->get_value();
+        branch.signal = component->get_signal_value();
+        c.branch_ids[branch.id] = static_cast<int>(c.branches.size());
+        c.branches.push_back(branch);
+    }
+
+    // DC system and its shared symbolic analysis
+    c.dc_matrix.assemble(mna_matrix);
+    c.dc_matrix.gather(circuit.get_MNA_vector(), c.dc_rhs);
+    {
+        Sparse_lu<double> lu;
+        lu.analyze(c.dc_matrix);
+        c.dc_symbolic = lu.get_symbolic();
+    }
+
+    // AC pattern: resistive part of the DC system (current variables excluded, as in
+    // Ac_analyzer::initialize), voltage source incidence and the reactive stamps
+    std::unordered_map<int, std::unordered_map<int, std::complex<double>>> pattern;
+    for (const auto& [row, col_map] : mna_matrix) {
+        if (extra_map.count(row))
+            continue;
+        for (const auto& [col, value] : col_map)
+            if (value != 0.0 && !extra_map.count(col))
+                pattern[row][col] = 1.0;
+    }
+    auto touch = [&pattern](int row, int col) {
+        if (row != 0 && col != 0)
+            pattern[row][col] = 1.0;
+    };
+    for (const Branch& b : c.branches) {
+        if (b.type == 'V') {
+            touch(b.i, b.var); touch(b.var, b.i);
+            touch(b.j, b.var); touch(b.var, b.j);
+        } else if (b.type == 'C' || b.type == 'L') {
+            touch(b.i, b.i); touch(b.j, b.j);
+            touch(b.i, b.j); touch(b.j, b.i);
+        }
+    }
+    c.ac_matrix.assemble(pattern);
+    std::fill(c.ac_matrix.values.begin(), c.ac_matrix.values.end(), std::complex<double>(0.0, 0.0));
+    for (const auto& [row, col_map] : mna_matrix) {
+        if (extra_map.count(row))
+            continue;
+        for (const auto& [col, value] : col_map) {
+            int p = extra_map.count(col) ? -1 : c.ac_matrix.find(row, col);
+            if (p >= 0)
+                c.ac_matrix.values[p] += value;
+        }
+    }
+    std::unordered_map<int, std::complex<double>> ac_vector;
+    for (size_t k = 0; k < c.branches.size(); k++) {
+        const Branch& b = c.branches[k];
+        auto stamp = [&c](int row, int col, double sign) {
+            int p = c.ac_matrix.find(row, col);
+            if (p >= 0)
+                c.ac_matrix.values[p] += sign;
+        };
+        auto term = [&c, k](int row, int col, double sign) {
+            int p = c.ac_matrix.find(row, col);
+            if (p >= 0)
+                c.ac_terms.push_back({p, static_cast<int>(k), sign});
+        };
+        if (b.type == 'V') {
+            stamp(b.i, b.var, 1.0); stamp(b.var, b.i, 1.0);
+            stamp(b.j, b.var, -1.0); stamp(b.var, b.j, -1.0);
+            ac_vector[b.var] += b.signal;
+        } else if (b.type == 'C' || b.type == 'L') {
+            term(b.i, b.i, 1.0); term(b.j, b.j, 1.0);
+            term(b.i, b.j, -1.0); term(b.j, b.i, -1.0);
+        }
+    }
+    c.ac_matrix.gather(ac_vector, c.ac_rhs);
+    {
+        Sparse_lu<std::complex<double>> lu;
+        lu.analyze(c.ac_matrix);
+        c.ac_symbolic = lu.get_symbolic();
+    }
+    return compiled;
+}
+
+// ============================================================
+//  Analyses
+// ============================================================
+
+Dc_result Compiled_circuit::solve_dc(const Cancellation_token& token) const {
+    TRACE_SCOPE("compiled_dc");
+    token.throw_if_cancelled();
+    Sparse_lu<double> lu;
+    lu.set_symbolic(dc_symbolic);
+    lu.set_cancellation(token);
+    lu.factorize(dc_matrix);
+    std::vector<double> x = dc_rhs;
+    lu.solve(x);
+    std::vector<double> solution(num_variables, 0.0);
+    dc_matrix.scatter(x, solution);
+    return Dc_result(shared_from_this(), std::move(solution));
+}
+
+void Compiled_circuit::solve_ac_point(double frequency, const Cancellation_token& token, Ac_workspace& w) const {
+    token.throw_if_cancelled();
+    if (!w.ready) {
+        w.A = ac_matrix;
+        w.lu.set_symbolic(ac_symbolic);
+        w.lu.set_cancellation(token);
+        w.solution.resize(num_variables);
+        w.ready = true;
+    }
+    double omega = 2.0 * PI * frequency;
+    std::copy(ac_matrix.values.begin(), ac_matrix.values.end(), w.A.values.begin());
+    for (const Ac_term& t : ac_terms) {
+        const Branch& b = branches[t.branch];
+        std::complex<double> y = b.type == 'C' ? std::complex<double>(0.0, omega * b.value)
+                                               : std::complex<double>(0.0, -1.0 / (omega * b.value));
+        w.A.values[t.position] += t.sign * y;
+    }
+    w.lu.factorize(w.A);
+    w.x = ac_rhs;
+    w.lu.solve(w.x);
+    std::fill(w.solution.begin(), w.solution.end(), std::complex<double>(0.0, 0.0));
+    w.A.scatter(w.x, w.solution);
+    // Inductor currents are not AC unknowns; derive them from the terminal voltages
+    for (const Branch& b : branches)
+        if (b.type == 'L')
+            w.solution[b.var] = (w.solution[b.i] - w.solution[b.j]) / std::complex<double>(0.0, omega * b.value);
+}
+
+Ac_result Compiled_circuit::solve_ac(double freq1, double freq2, double step, bool log_scale,
+                                     const Cancellation_token& token, const Progress_callback& progress) const {
+    std::vector<double> frequencies = Frequency_sweep(freq1, freq2, step, log_scale).frequencies();
+    TRACE_SCOPE("compiled_ac");
+
+    // Points are independent: threads take them one at a time, each with its own factors
+    const size_t total = frequencies.size();
+    std::vector<std::complex<double>> phasors(total * num_variables);
+    Thread_pool pool(static_cast<int>(std::min<size_t>(total, Executor::global()->budget())));
+    std::vector<Ac_workspace> workspaces(pool.size());
+    std::atomic<size_t> next_point(0);
+    std::atomic<bool> failed(false);
+    std::exception_ptr error;
+    std::mutex mutex;                   // Guards error, done and the progress callback
+    size_t done = 0;
+    pool.run([&](int thread_id, int) {
+        Ac_workspace& w = workspaces[thread_id];
+        size_t point;
+        while (!failed.load(std::memory_order_relaxed) && (point = next_point.fetch_add(1)) < total) {
+            try {
+                solve_ac_point(frequencies[point], token, w);
+                std::copy(w.solution.begin(), w.solution.end(), phasors.begin() + point * num_variables);
+                if (progress) {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    // A callback that cancelled the sweep must not hear from the other threads
+                    token.throw_if_cancelled();
+                    progress(++done, total);
+                }
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (!error)
+                    error = std::current_exception();
+                failed.store(true, std::memory_order_relaxed);
+            }
+        }
+    });
+    if (error)
+        std::rethrow_exception(error);
+    return Ac_result(shared_from_this(), std::move(frequencies), std::move(phasors));
+}
+
+// ============================================================
+//  Lookups
+// ============================================================
+
+int Compiled_circuit::node_index(const std::string& node) const {
+    auto it = node_ids.find(node);
+    if (it == node_ids.end())
+        throw std::invalid_argument("Node " + node + " does not exist in circuit " + circuit_name + ".");
+    return it->second;
+}
+
+const Compiled_circuit::Branch& Compiled_circuit::branch(const std::string& id) const {
+    auto it = branch_ids.find(id);
+    if (it == branch_ids.end())
+        throw std::invalid_argument("Component " + id + " does not exist in circuit " + circuit_name + ".");
+    return branches[it->second];
+}
+
+void Compiled_circuit::print(std::ostream& os) const {
+    os << "Compiled Circuit: " << circuit_name << std::endl;
+    os << std::string(40, '-') << std::endl;
+    os << "  Variables: " << num_variables - 1 << std::endl;
+    os << "  Branches: " << branches.size() << std::endl;
+    os << "  DC system: " << dc_matrix.n << " x " << dc_matrix.n << ", " << dc_matrix.nnz() << " non-zeros" << std::endl;
+    os << "  AC system: " << ac_matrix.n << " x " << ac_matrix.n << ", " << ac_matrix.nnz() << " non-zeros, "
+       << ac_terms.size() << " frequency-dependent" << std::endl;
+    os << "  Topology: " << std::hex << std::setw(16) << std::setfill('0') << topology
+       << std::dec << std::setfill(' ') << std::endl;
+}
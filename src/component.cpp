@@ -2,10 +2,18 @@
 
 Component::Component(const std::string& id, Node* node_i, Node* node_j) : ni(node_i), nj(node_j), componentId(id) {}
 
-Component::Component(const Component& src) : ni(src.ni), nj(src.nj), componentId(src.componentId) {}
+Component::Component(const Component& src) : ni(src.ni), nj(src.nj), componentId(src.componentId), tolerance(src.tolerance) {}
 
-Component::Component(Component&& src) : ni(src.ni), nj(src.nj), componentId(src.componentId) {src.ni = src.nj = nullptr;}
+Component::Component(Component&& src) : ni(src.ni), nj(src.nj), componentId(src.componentId), tolerance(src.tolerance) {src.ni = src.nj = nullptr;}
 
 Component::~Component(){ni = nj = nullptr;}
 
+void Component::set_value(double){
+    throw std::runtime_error("Component " + componentId + " has no adjustable value.");
+}
+
+double Component::get_value() const {
+    throw std::runtime_error("Component " + componentId + " has no adjustable value.");
+}
+
 Ac_component::Ac_component(const std::string& id, Node* node_i, Node* node_j) : Component(id, node_i, node_j) {}
\ No newline at end of file
@@ -0,0 +1,203 @@
+#include "dense_lu.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+
+// ============================================================
+//  Fixed-size kernels
+// ============================================================
+
+template<typename T, int N>
+void Dense_lu<T, N>::clear(int n) {
+    this->n = n;
+    for (int i = 0; i < n; i++)
+        std::fill(a.begin() + i * N, a.begin() + i * N + n, T{});
+}
+
+template<typename T, int N>
+bool Dense_lu<T, N>::factorize() {
+    double scale = 0.0;
+    for (int i = 0; i < n; i++)
+        for (int j = 0; j < n; j++)
+            scale = std::max(scale, std::abs(a[i * N + j]));
+
+    for (int k = 0; k < n; k++) {
+        int p = k;
+        double max_abs = std::abs(a[k * N + k]);
+        for (int i = k + 1; i < n; i++)
+            if (std::abs(a[i * N + k]) > max_abs) {
+                max_abs = std::abs(a[i * N + k]);
+                p = i;
+            }
+        if (max_abs <= 1e-13 * scale)
+            return false;
+        perm[k] = p;
+        if (p != k)
+            std::swap_ranges(a.begin() + k * N, a.begin() + k * N + n, a.begin() + p * N);
+
+        T* a_k = &a[k * N];
+        T inv = T(1.0) / a_k[k];
+        for (int i = k + 1; i < n; i++) {
+            T* a_i = &a[i * N];
+            T m = a_i[k] *= inv;
+            if (m == T{})
+                continue;
+            for (int j = k + 1; j < n; j++)
+                a_i[j] -= m * a_k[j];
+        }
+    }
+    return true;
+}
+
+template<typename T, int N>
+void Dense_lu<T, N>::solve(T* b) const {
+    for (int k = 0; k < n; k++)
+        std::swap(b[k], b[perm[k]]);
+    for (int i = 1; i < n; i++) {
+        const T* a_i = &a[i * N];
+        T sum = b[i];
+        for (int k = 0; k < i; k++)
+            sum -= a_i[k] * b[k];
+        b[i] = sum;
+    }
+    for (int i = n - 1; i >= 0; i--) {
+        const T* a_i = &a[i * N];
+        T sum = b[i];
+        for (int j = i + 1; j < n; j++)
+            sum -= a_i[j] * b[j];
+        b[i] = sum / a_i[i];
+    }
+}
+
+// ============================================================
+//  Bucket dispatch
+// ============================================================
+
+template<typename T>
+Dense_solver<T>::Dense_solver(int max_size) : n(0), bucket(0) {
+    set_max_size(max_size);
+}
+
+template<typename T>
+void Dense_solver<T>::set_max_size(int size) {
+    if (size < 0 || size > max_bucket)
+        throw std::invalid_argument("Dense solver size limit must be between 0 and " +
+                                    std::to_string(max_bucket) + ", got " + std::to_string(size) + ".");
+    max_size = size;
+}
+
+template<typename T>
+template<int N>
+bool Dense_solver<T>::solve_bucket(const std::unordered_map<int, std::unordered_map<int, T>>& mna_matrix,
+                                   const std::unordered_map<int, T>& mna_vector,
+                                   const std::array<int, max_bucket>& vars,
+                                   std::vector<T>& solution) {
+    const int* first = vars.data();
+    const int* last = vars.data() + n;
+    auto index = [&](int var) {
+        const int* it = std::lower_bound(first, last, var);
+        return static_cast<int>(it - first);
+    };
+
+    Dense_lu<T, N> lu;
+    lu.clear(n);
+    for (const auto& [row, col_map] : mna_matrix) {
+        if (row <= 0)
+            continue;
+        int i = -1;
+        for (const auto& [col, value] : col_map) {
+            if (value == T{} || col <= 0)
+                continue;
+            if (i < 0)
+                i = index(row);
+            lu.at(i, index(col)) = value;
+        }
+    }
+    if (!lu.factorize())
+        return false;
+
+    std::array<T, N> x{};
+    for (const auto& [row, value] : mna_vector) {
+        if (row <= 0)
+            continue;
+        const int* it = std::lower_bound(first, last, row);
+        if (it != last && *it == row)
+            x[it - first] = value;
+    }
+    lu.solve(x.data());
+
+    if (solution.size() <= static_cast<size_t>(vars[n - 1]))
+        solution.resize(vars[n - 1] + 1, T{});
+    for (int k = 0; k < n; k++)
+        solution[vars[k]] = x[k];
+    bucket = N;
+    return true;
+}
+
+template<typename T>
+bool Dense_solver<T>::solve(const std::unordered_map<int, std::unordered_map<int, T>>& mna_matrix,
+                            const std::unordered_map<int, T>& mna_vector,
+                            std::vector<T>& solution) {
+    n = 0;
+    if (max_size == 0)
+        return false;
+
+    // Active variables: every row or column holding a non-zero (kept sorted, ground excluded)
+    std::array<int, max_bucket> vars;
+    int count = 0;
+    auto add = [&](int var) {
+        int* end = vars.data() + count;
+        int* it = std::lower_bound(vars.data(), end, var);
+        if (it != end && *it == var)
+            return true;
+        if (count == max_size)
+            return false;
+        std::copy_backward(it, end, end + 1);
+        *it = var;
+        count++;
+        return true;
+    };
+    for (const auto& [row, col_map] : mna_matrix) {
+        if (row <= 0)
+            continue;
+        for (const auto& [col, value] : col_map)
+            if (value != T{} && col > 0 && (!add(row) || !add(col)))
+                return false;
+    }
+    if (count == 0)
+        return false;
+
+    n = count;
+    bool solved = (n <= 4)  ? solve_bucket<4>(mna_matrix, mna_vector, vars, solution)
+                : (n <= 8)  ? solve_bucket<8>(mna_matrix, mna_vector, vars, solution)
+                : (n <= 16) ? solve_bucket<16>(mna_matrix, mna_vector, vars, solution)
+                            : solve_bucket<32>(mna_matrix, mna_vector, vars, solution);
+    if (!solved)
+        n = 0;
+    return solved;
+}
+
+template<typename T>
+void Dense_solver<T>::print(std::ostream& os) const {
+    os << "Dense LU Status:" << std::endl;
+    os << std::string(40, '-') << std::endl;
+    if (n == 0) {
+        os << "  Not used" << std::endl;
+        return;
+    }
+    os << "  Dimension: " << n << std::endl;
+    os << "  Bucket: " << bucket << " x " << bucket << std::endl;
+}
+
+// Explicit template instantiations
+template class Dense_lu<double, 4>;
+template class Dense_lu<double, 8>;
+template class Dense_lu<double, 16>;
+template class Dense_lu<double, 32>;
+template class Dense_lu<std::complex<double>, 4>;
+template class Dense_lu<std::complex<double>, 8>;
+template class Dense_lu<std::complex<double>, 16>;
+template class Dense_lu<std::complex<double>, 32>;
+template class Dense_solver<double>;
+template class Dense_solver<std::complex<double>>;
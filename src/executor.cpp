@@ -0,0 +1,272 @@
+#include "executor.h"
+#include "trace.h"
+#include <algorithm>
+#include <exception>
+#include <string>
+
+#if defined(_WIN32)
+#define NOMINMAX
+#include <windows.h>
+#elif defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace {
+
+// Worker identity of the current thread, so nested submissions stay local
+thread_local const Executor* current_executor = nullptr;
+thread_local int current_worker = -1;
+
+struct Global_runtime {
+    std::mutex mutex;
+    std::shared_ptr<Executor> executor;
+};
+
+// A worker cannot join itself: if one of its jobs drops the last reference, shut down from another thread
+void release_runtime(Executor* executor) {
+    if (current_executor == executor)
+        std::thread([executor]() { delete executor; }).detach();
+    else
+        delete executor;
+}
+
+Global_runtime& global_runtime() {
+    static Global_runtime runtime;
+    return runtime;
+}
+
+// Pins the calling thread to the logical CPU of a slot (0 = the caller's); best effort
+void pin_to_cpu(Executor::Affinity affinity, int slot) {
+    int num_cpus = static_cast<int>(std::thread::hardware_concurrency());
+    if (affinity == Executor::Affinity::none || num_cpus <= 1)
+        return;
+    int cpu = slot % num_cpus;
+    if (affinity == Executor::Affinity::scatter) {
+        // Hyper-threads are usually numbered after, or interleaved with, the physical cores
+        int evens = (num_cpus + 1) / 2;
+        cpu = cpu < evens ? 2 * cpu : 2 * (cpu - evens) + 1;
+    }
+#if defined(_WIN32)
+    if (cpu < 64)
+        SetThreadAffinityMask(GetCurrentThread(), static_cast<DWORD_PTR>(1) << cpu);
+#elif defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#endif
+}
+
+} // namespace
+
+// ============================================================
+//  Lifetime
+// ============================================================
+
+Executor::Executor(const Options& options)
+    : options(options), queued(0), idle(0), region_slots(0), open_regions(nullptr), stopping(false), next(0) {
+    if (this->options.threads <= 0)
+        this->options.threads = static_cast<int>(std::thread::hardware_concurrency());
+    if (this->options.threads <= 0)
+        this->options.threads = 1;
+    // The caller of a region is the budget's last thread; jobs need at least one worker
+    int num_workers = std::max(1, this->options.threads - 1);
+    deques.reset(new Job_deque[num_workers]);
+    workers.reserve(num_workers);
+    for (int w = 0; w < num_workers; w++)
+        workers.emplace_back(&Executor::worker_loop, this, w);
+    // Regions lease idle workers only: wait until all are, so the first region gets them
+    std::unique_lock<std::mutex> lock(sleep_mutex);
+    parked_cv.wait(lock, [&] { return idle == num_workers; });
+}
+
+Executor::Executor(int num_threads) : Executor(Options{num_threads, Affinity::none}) {}
+
+Executor::~Executor() {
+    {
+        std::lock_guard<std::mutex> lock(sleep_mutex);
+        stopping = true;
+    }
+    wake_cv.notify_all();
+    for (auto& worker : workers)
+        worker.join();
+}
+
+std::shared_ptr<Executor> Executor::global() {
+    Global_runtime& runtime = global_runtime();
+    std::lock_guard<std::mutex> lock(runtime.mutex);
+    if (!runtime.executor)
+        runtime.executor.reset(new Executor(Options()), release_runtime);
+    return runtime.executor;
+}
+
+void Executor::configure_global(const Options& options) {
+    Global_runtime& runtime = global_runtime();
+    std::shared_ptr<Executor> previous;
+    {
+        std::lock_guard<std::mutex> lock(runtime.mutex);
+        previous = std::move(runtime.executor);
+    }
+    // Outside the lock: draining jobs may use the global runtime. Holders of the
+    // previous runtime keep it alive; the last of them shuts it down.
+    previous.reset();
+    std::shared_ptr<Executor> executor(new Executor(options), release_runtime);
+    std::lock_guard<std::mutex> lock(runtime.mutex);
+    runtime.executor = std::move(executor);
+}
+
+// ============================================================
+//  Jobs
+// ============================================================
+
+void Executor::post(std::function<void()> job) {
+    int num_workers = size();
+    int target = current_executor == this ? current_worker
+                                          : static_cast<int>(next.fetch_add(1, std::memory_order_relaxed) % num_workers);
+    {
+        std::lock_guard<std::mutex> lock(deques[target].mutex);
+        deques[target].jobs.push_back(std::move(job));
+    }
+    {
+        std::lock_guard<std::mutex> lock(sleep_mutex);
+        queued++;
+    }
+    wake_cv.notify_one();
+}
+
+bool Executor::take(int worker_id, std::function<void()>& job) {
+    int num_workers = size();
+    {
+        Job_deque& own = deques[worker_id];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.jobs.empty()) {
+            job = std::move(own.jobs.back());
+            own.jobs.pop_back();
+            return true;
+        }
+    }
+    for (int v = 1; v < num_workers; v++) {
+        Job_deque& victim = deques[(worker_id + v) % num_workers];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.jobs.empty()) {
+            job = std::move(victim.jobs.front());
+            victim.jobs.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+void Executor::run_job(std::unique_lock<std::mutex>& lock, int worker_id) {
+    // Claiming under the lock guarantees a job is in some deque for us
+    queued--;
+    lock.unlock();
+    std::function<void()> job;
+    while (!take(worker_id, job))
+        std::this_thread::yield();
+    {
+        TRACE_SCOPE("executor_job");
+        job();
+    }
+    lock.lock();
+}
+
+bool Executor::run_pending_job() {
+    std::unique_lock<std::mutex> lock(sleep_mutex);
+    if (queued == 0)
+        return false;
+    run_job(lock, current_executor == this ? current_worker : 0);
+    return true;
+}
+
+// ============================================================
+//  Regions
+// ============================================================
+
+int Executor::run_region(int max_threads, const std::function<void(int, int)>& body,
+                         const std::function<void(int)>& prepare) {
+    TRACE_SCOPE("parallel_region");
+    Region region;
+    region.body = &body;
+    region.next_id = 1;
+    region.next = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(sleep_mutex);
+        int helpers = std::max(0, std::min(max_threads - 1, idle - region_slots));
+        region.num_threads = helpers + 1;
+        region.pending = helpers;
+        if (prepare)
+            prepare(region.num_threads);
+        if (helpers > 0) {
+            region.next = open_regions;
+            open_regions = &region;
+            region_slots += helpers;
+        }
+    }
+    if (region.num_threads == 1) {
+        body(0, 1);
+        return 1;
+    }
+    wake_cv.notify_all();
+
+    std::exception_ptr error;
+    try {
+        body(0, region.num_threads);
+    } catch (...) {
+        error = std::current_exception();
+    }
+    // The region lives on this stack: wait for the leased workers even when unwinding
+    std::unique_lock<std::mutex> lock(sleep_mutex);
+    region.done_cv.wait(lock, [&] { return region.pending == 0; });
+    if (!error)
+        error = region.error;
+    lock.unlock();
+    if (error)
+        std::rethrow_exception(error);
+    return region.num_threads;
+}
+
+void Executor::run_region_slot(std::unique_lock<std::mutex>& lock) {
+    Region* region = open_regions;
+    int thread_id = region->next_id++;
+    if (region->next_id == region->num_threads)
+        open_regions = region->next;
+    region_slots--;
+    lock.unlock();
+    std::exception_ptr error;
+    try {
+        TRACE_SCOPE("parallel_region");
+        (*region->body)(thread_id, region->num_threads);
+    } catch (...) {
+        error = std::current_exception();
+    }
+    lock.lock();
+    if (error && !region->error)
+        region->error = error;
+    if (--region->pending == 0)
+        region->done_cv.notify_one();
+}
+
+void Executor::worker_loop(int worker_id) {
+    Trace::set_thread_name("pool worker " + std::to_string(worker_id + 1));
+    pin_to_cpu(options.affinity, worker_id + 1);
+    current_executor = this;
+    current_worker = worker_id;
+    std::unique_lock<std::mutex> lock(sleep_mutex);
+    while (true) {
+        // Region slots first: their caller is already running and counted on us
+        if (region_slots > 0) {
+            run_region_slot(lock);
+        } else if (queued > 0) {
+            run_job(lock, worker_id);
+        } else if (stopping) {
+            return;
+        } else {
+            idle++;
+            parked_cv.notify_all();
+            wake_cv.wait(lock);
+            idle--;
+        }
+    }
+}
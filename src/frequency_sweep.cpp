@@ -0,0 +1,34 @@
+#include "frequency_sweep.h"
+#include <stdexcept>
+
+Frequency_sweep::Frequency_sweep(double freq1, double freq2, double step, bool log_scale)
+    : freq1(freq1), freq2(freq2), step(step), log_scale(log_scale) {
+    if (!std::isfinite(freq1) || !std::isfinite(freq2) || !std::isfinite(step))
+        throw std::invalid_argument("Invalid frequency sweep: bounds and step must be finite.");
+    if (freq1 <= 0)
+        throw std::invalid_argument("Invalid start frequency: freq1 must be positive.");
+    if (freq2 < freq1)
+        throw std::invalid_argument("Invalid end frequency: freq2 must be greater than or equal to freq1.");
+    if (step <= 0)
+        throw std::invalid_argument("Invalid frequency step: step must be positive.");
+    if (freq1 == freq2)
+        return;
+    if (log_scale && step <= 1.0)
+        throw std::invalid_argument("Invalid frequency step: step must be greater than 1 on a log scale.");
+    // A step below half an ulp of freq2 would stall before reaching it
+    if (!log_scale && freq2 + step == freq2)
+        throw std::invalid_argument("Invalid frequency step: step is too small to advance the sweep.");
+}
+
+double Frequency_sweep::estimated_points() const {
+    if (freq1 == freq2)
+        return 1.0;
+    return 1.0 + (log_scale ? std::log(freq2 / freq1) / std::log(step) : (freq2 - freq1) / step);
+}
+
+std::vector<double> Frequency_sweep::frequencies() const {
+    std::vector<double> points;
+    for (double freq = first(); contains(freq); freq = next(freq))
+        points.push_back(freq);
+    return points;
+}
@@ -1,23 +1,37 @@
 #include "gauss_seidel.h"
+#include "perf_counters.h"
+#include <algorithm>
+#include <chrono>
 #include <cmath>
 #include <iostream>
-#include <iomanip>
 #include <complex>
-
-// Set to true to enable debug output
-static constexpr bool DEBUG_SOLVER = false;
+#include <stdexcept>
+#include <type_traits>
 
 template<typename T>
 Gauss_seidel<T>::Gauss_seidel(int max_iter, double tolerance, double damping_factor)
     : max_iter(max_iter), tolerance(tolerance), damping_factor(damping_factor), 
-      converge_iters(0), converged(false) {}
+      converge_iters(0), converged(false), telemetry(nullptr) {}
+
+template<typename T>
+void Gauss_seidel<T>::configure(int max_iter, double tolerance, double damping_factor) {
+    if (max_iter < 2)
+        throw std::invalid_argument("Gauss-Seidel needs at least 2 iterations.");
+    if (!(tolerance > 0.0))
+        throw std::invalid_argument("Gauss-Seidel tolerance must be positive.");
+    if (!(damping_factor > 0.0 && damping_factor <= 1.0))
+        throw std::invalid_argument("Gauss-Seidel damping factor must be in (0, 1].");
+    this->max_iter = max_iter;
+    this->tolerance = tolerance;
+    this->damping_factor = damping_factor;
+}
 
 template<typename T>
 void Gauss_seidel<T>::initialize(size_t size) {
     lhs_values.assign(size, T{});
     targets.resize(size);
     var_to_target.resize(size);
-    independent_targets.clear();
+    independent_targets.assign(size, 0);
     for (size_t i = 0; i < size; i++){
         targets[i] = static_cast<int>(i);
         var_to_target[i] = static_cast<int>(i);
@@ -43,7 +57,7 @@ void Gauss_seidel<T>::handle_zero_diagonal(int row, const std::unordered_map<int
             continue;
         
         // skip independent variable cols - already used
-        if (independent_targets.find(col) != independent_targets.end())
+        if (independent_targets[col])
             continue;
         
         // If multiple non-independent variables found - not independent
@@ -65,7 +79,9 @@ void Gauss_seidel<T>::handle_zero_diagonal(int row, const std::unordered_map<int
     
     // Update independent variables
     if (independent)
-        independent_targets.insert(max_idx);
+        independent_targets[max_idx] = 1;
+    if (telemetry)
+        telemetry->record_pivot(converge_iters, row, targets[row], max_idx, independent);
     
     // swap targets targets[x]=max_idx and targets[row]
     int old_target = targets[row];
@@ -101,6 +117,16 @@ T Gauss_seidel<T>::compute_row_update(int row, const std::unordered_map<int, T>&
     return lhs_value;
 }
 
+template<typename T>
+double Gauss_seidel<T>::residual_norm(const std::unordered_map<int, T>& mna_vector, size_t size) const {
+    double norm = 0.0;
+    for (size_t i = 0; i < size; i++) {
+        auto it = mna_vector.find(static_cast<int>(i));
+        norm = std::max(norm, static_cast<double>(std::abs(lhs_values[i] - (it != mna_vector.end() ? it->second : T{}))));
+    }
+    return norm;
+}
+
 template<typename T>
 bool Gauss_seidel<T>::check_convergence(const std::unordered_map<int, T>& mna_vector, size_t size) {
     for (size_t i = 0; i < size; i++) {
@@ -114,77 +140,36 @@ bool Gauss_seidel<T>::check_convergence(const std::unordered_map<int, T>& mna_ve
 
 template<typename T>
 void Gauss_seidel<T>::solve(const std::unordered_map<int, std::unordered_map<int, T>>& mna_matrix, const std::unordered_map<int, T>& mna_vector, std::vector<T>& solution) {
-    
+    Perf_scope perf("gauss_seidel");
     initialize(solution.size());
+    constexpr bool is_complex = !std::is_same_v<T, double>;
+    if (telemetry)
+        telemetry->begin_solve(is_complex ? "ac" : "dc", solution.size(), damping_factor, tolerance);
+    auto solve_start = std::chrono::steady_clock::now();
+    double sweep_seconds = 0.0;
+    int sweeps = 0;
 
-    if (DEBUG_SOLVER) {
-        std::cout << "\n========== GAUSS-SEIDEL DEBUG ==========\n";
-        std::cout << "Solution size: " << solution.size() << "\n";
-        std::cout << "MNA Matrix rows: " << mna_matrix.size() << "\n";
-        std::cout << "\nMNA Matrix contents:\n";
-        for (const auto& [row, col_map] : mna_matrix) {
-            std::cout << "  Row " << row << ": ";
-            for (const auto& [col, val] : col_map) {
-                std::cout << "[" << col << "]=" << std::scientific << std::setprecision(6) << val << " ";
-            }
-            std::cout << "\n";
-        }
-        std::cout << "\nMNA Vector (RHS):\n";
-        for (const auto& [row, val] : mna_vector) {
-            std::cout << "  [" << row << "] = " << std::scientific << std::setprecision(6) << val << "\n";
-        }
-        std::cout << "\nInitial targets: ";
-        for (size_t i = 0; i < targets.size(); i++) {
-            std::cout << targets[i] << " ";
-        }
-        std::cout << "\n";
-    }
-    
     for (converge_iters = 1; converge_iters < max_iter; converge_iters++) {
-        if (DEBUG_SOLVER) {
-            std::cout << "\n--- Iteration " << converge_iters << " ---\n";
-        }
-        
+        cancellation.throw_if_cancelled();
+        auto sweep_start = telemetry ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point();
         for (const auto& [row, col_map] : mna_matrix) {
             // Handle zero diagonal through dynamic pivoting
-            int old_target = targets[row];
             handle_zero_diagonal(row, col_map);
             
-            if (DEBUG_SOLVER && old_target != targets[row]) {
-                std::cout << "  Row " << row << ": target changed from " << old_target << " to " << targets[row] << "\n";
-                std::cout << "  Targets now: ";
-                for (size_t i = 0; i < targets.size(); i++) {
-                    std::cout << targets[i] << " ";
-                }
-                std::cout << "\n";
-            }
-            
             // Skip rows that are all zeros
             if (col_map.find(targets[row]) == col_map.end() || std::abs(col_map.at(targets[row])) <= tolerance) {
-                if (DEBUG_SOLVER ) {
-                    std::cout << "  Row " << row << ": SKIPPED (all zero target at " << targets[row] << ")\n";
-                }
                 lhs_values[row] = T{};
                 continue;
             }
             
             // Compute and apply row update
-            T old_val = solution[targets[row]];
             lhs_values[row] = compute_row_update(row, col_map, mna_vector, solution);
-            
-            if (DEBUG_SOLVER) {
-                std::cout << "  Row " << row << " solving for x[" << targets[row] << "]: " 
-                          << std::scientific << std::setprecision(6) << old_val << " -> " << solution[targets[row]] 
-                          << " (LHS=" << lhs_values[row] << ")\n";
-            }
         }
-        
-        if (DEBUG_SOLVER) {
-            std::cout << "  Solution: ";
-            for (size_t i = 0; i < solution.size(); i++) {
-                std::cout << "x[" << i << "]=" << std::scientific << std::setprecision(6) << solution[i] << " ";
-            }
-            std::cout << "\n";
+        sweeps = converge_iters;
+        if (telemetry) {
+            sweep_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - sweep_start).count();
+            if (telemetry->sample(converge_iters))
+                telemetry->record_iteration(converge_iters, residual_norm(mna_vector, solution.size()), sweep_seconds);
         }
         
         // Check convergence every 5 iterations
@@ -192,15 +177,29 @@ void Gauss_seidel<T>::solve(const std::unordered_map<int, std::unordered_map<int
             continue;
         
         converged = check_convergence(mna_vector, solution.size());
-        if (DEBUG_SOLVER) {
-            std::cout << "  Convergence check: " << (converged ? "CONVERGED" : "not yet") << std::fixed << std::setprecision(4) << "\n";
-        }
         if (converged)
-            return;
+            break;
     }
-    
-    if (DEBUG_SOLVER) {
-        std::cout << "\n========== SOLVER FINISHED (max iter reached) ==========\n";
+
+    if (telemetry) {
+        // The last sweep is always recorded, sampled or not
+        if (sweeps > 0 && !telemetry->has_iteration(sweeps))
+            telemetry->record_iteration(sweeps, residual_norm(mna_vector, solution.size()), sweep_seconds);
+        telemetry->end_solve(sweeps, converged,
+                             std::chrono::duration<double>(std::chrono::steady_clock::now() - solve_start).count());
+    }
+
+    if (perf.active()) {
+        // Per sweep: one multiply-add per entry, a division and damping per row; hash nodes are
+        // read for every entry plus the target, diagonal and right-hand-side lookups of each row
+        double nnz = 0.0, rows = static_cast<double>(mna_matrix.size());
+        for (const auto& [row, col_map] : mna_matrix)
+            nnz += static_cast<double>(col_map.size());
+        double multiply_add = is_complex ? 8.0 : 2.0, division = is_complex ? 11.0 : 1.0;
+        double node = sizeof(void*) + sizeof(std::pair<const int, T>);
+        double iterations = static_cast<double>(converge_iters);
+        perf.set_work(iterations * ((nnz + 3.0 * rows) * multiply_add + rows * division),
+                      iterations * (nnz * node + rows * (3.0 * node + 2.0 * sizeof(T))));
     }
 }
 
@@ -1,4 +1,6 @@
 #include "inductor.h"
+#include <cmath>
+#include <stdexcept>
 
 Inductor::Inductor(const std::string& id, Node* ni, Node* nj, double l): Ac_component(id, ni, nj),vc_id(Node::node_count++), inductance(l), admittance(0), current(0.0) {}
 
@@ -26,18 +28,24 @@ Component_contribution<double> Inductor::get_contribution(){
 Component_contribution<std::complex<double>> Inductor::get_ac_contribution(double frequency){
     Component_contribution<std::complex<double>> contribution;
 
-    if (frequency == 0.0)
+    // Frequency 0 starts a sweep on a freshly initialized AC matrix
+    if (frequency == 0.0) {
+        admittance = 0.0;
         return contribution;
+    }
 
-    admittance = std::complex<double>(0, -1.0 / (2.0 * PI * frequency * inductance)) - admittance; // 1/jωL
+    // Stamp the change since the previous frequency; the matrix keeps the sum
+    std::complex<double> current_admittance = std::complex<double>(0, -1.0 / (2.0 * PI * frequency * inductance)); // 1/jωL
+    std::complex<double> delta = current_admittance - admittance;
+    admittance = current_admittance;
     if(ni->id != 0)
-        contribution.stampMatrix(ni->id, ni->id, admittance);
+        contribution.stampMatrix(ni->id, ni->id, delta);
     if(nj->id != 0)
-        contribution.stampMatrix(nj->id, nj->id, admittance);
+        contribution.stampMatrix(nj->id, nj->id, delta);
     if (ni->id != 0 && nj->id != 0)
     {
-        contribution.stampMatrix(ni->id, nj->id, -admittance);
-        contribution.stampMatrix(nj->id, ni->id, -admittance);
+        contribution.stampMatrix(ni->id, nj->id, -delta);
+        contribution.stampMatrix(nj->id, ni->id, -delta);
     }
     return contribution;
 }
@@ -48,4 +56,10 @@ void Inductor::print(std::ostream& os) const {
        << std::setw(6) << ni->name 
        << std::setw(6) << nj->name 
        << std::right << std::fixed << std::setprecision(4) << std::setw(12) << displayValue << " uH" << std::endl;
-}
\ No newline at end of file
+}
+
+void Inductor::set_value(double value) {
+    if (!(value > 0) || !std::isfinite(value))
+        throw std::runtime_error("Inductor with ID " + componentId + " has non-positive or non-finite inductance.");
+    inductance = value;
+}
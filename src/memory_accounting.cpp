@@ -0,0 +1,229 @@
+#include "memory_accounting.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+#if defined(_WIN32)
+#define PSAPI_VERSION 2
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+constexpr size_t tag_count = static_cast<size_t>(Memory_tag::count);
+
+// One cache line per subsystem so that threads charging different tags do not contend
+struct alignas(64) Counters {
+    std::atomic<int64_t> current{0};
+    std::atomic<int64_t> peak{0};
+    std::atomic<uint64_t> allocations{0};
+    std::atomic<uint64_t> releases{0};
+};
+
+// Constant-initialized: usable by allocations made before main()
+std::atomic<bool> accounting_enabled{false};
+std::atomic<bool> hooks_linked{false};
+Counters tag_counters[tag_count];
+Counters total_counters;
+thread_local Memory_tag thread_tag = Memory_tag::other;
+
+void raise_peak(std::atomic<int64_t>& peak, int64_t value) {
+    int64_t seen = peak.load(std::memory_order_relaxed);
+    while (value > seen && !peak.compare_exchange_weak(seen, value, std::memory_order_relaxed)) {}
+}
+
+void charge(Counters& counters, int64_t bytes) {
+    int64_t now = counters.current.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+    counters.allocations.fetch_add(1, std::memory_order_relaxed);
+    raise_peak(counters.peak, now);
+}
+
+void credit(Counters& counters, int64_t bytes) {
+    counters.current.fetch_sub(bytes, std::memory_order_relaxed);
+    counters.releases.fetch_add(1, std::memory_order_relaxed);
+}
+
+Memory_accounting::Usage read(const Counters& counters) {
+    Memory_accounting::Usage usage;
+    usage.current = counters.current.load(std::memory_order_relaxed);
+    usage.peak = counters.peak.load(std::memory_order_relaxed);
+    usage.allocations = counters.allocations.load(std::memory_order_relaxed);
+    usage.releases = counters.releases.load(std::memory_order_relaxed);
+    return usage;
+}
+
+std::string format_bytes(double bytes) {
+    const char* units[] = {"B", "KB", "MB", "GB", "TB"};
+    int unit = 0;
+    while (std::abs(bytes) >= 1024.0 && unit < 4) {
+        bytes /= 1024.0;
+        unit++;
+    }
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(unit == 0 ? 0 : 1) << bytes << " " << units[unit];
+    return oss.str();
+}
+
+} // namespace
+
+// ============================================================
+//  Memory_accounting
+// ============================================================
+
+void Memory_accounting::enable() {
+    if (!is_available())
+        throw std::runtime_error("Heap accounting is not linked into this build (build with MEMORY=1).");
+    reset_peaks();
+    accounting_enabled.store(true, std::memory_order_relaxed);
+}
+
+void Memory_accounting::disable() {
+    accounting_enabled.store(false, std::memory_order_relaxed);
+}
+
+bool Memory_accounting::is_enabled() {
+    return accounting_enabled.load(std::memory_order_relaxed);
+}
+
+bool Memory_accounting::is_available() {
+    return hooks_linked.load(std::memory_order_relaxed);
+}
+
+void Memory_accounting::register_hooks() {
+    hooks_linked.store(true, std::memory_order_relaxed);
+}
+
+uint8_t Memory_accounting::charge_allocation(size_t bytes) {
+    if (!accounting_enabled.load(std::memory_order_relaxed))
+        return untracked;
+    uint8_t tag = static_cast<uint8_t>(thread_tag);
+    charge(tag_counters[tag], static_cast<int64_t>(bytes));
+    charge(total_counters, static_cast<int64_t>(bytes));
+    return tag;
+}
+
+void Memory_accounting::credit_release(uint8_t tag, size_t bytes) {
+    if (tag == untracked)
+        return;
+    credit(tag_counters[tag], static_cast<int64_t>(bytes));
+    credit(total_counters, static_cast<int64_t>(bytes));
+}
+
+void Memory_accounting::reset_peaks() {
+    for (Counters& counters : tag_counters)
+        counters.peak.store(counters.current.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    total_counters.peak.store(total_counters.current.load(std::memory_order_relaxed), std::memory_order_relaxed);
+}
+
+Memory_accounting::Usage Memory_accounting::usage(Memory_tag tag) {
+    return read(tag_counters[static_cast<size_t>(tag)]);
+}
+
+Memory_accounting::Usage Memory_accounting::total() {
+    return read(total_counters);
+}
+
+Memory_tag Memory_accounting::current_tag() {
+    return thread_tag;
+}
+
+const char* Memory_accounting::tag_name(Memory_tag tag) {
+    switch (tag) {
+        case Memory_tag::other: return "other";
+        case Memory_tag::parse: return "parse";
+        case Memory_tag::nodes: return "nodes";
+        case Memory_tag::components: return "components";
+        case Memory_tag::mna: return "mna";
+        case Memory_tag::ac: return "ac";
+        case Memory_tag::solver: return "solver";
+        case Memory_tag::count: break;
+    }
+    return "unknown";
+}
+
+size_t Memory_accounting::peak_rss() {
+#if defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+        return counters.PeakWorkingSetSize;
+    return 0;
+#else
+    rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+        return 0;
+#if defined(__APPLE__)
+    size_t peak = static_cast<size_t>(usage.ru_maxrss);     // Bytes on macOS
+#else
+    size_t peak = static_cast<size_t>(usage.ru_maxrss) * 1024;  // Kilobytes on Linux
+#endif
+    // The kernel folds per-thread RSS counters into the high-water mark lazily
+    return std::max(peak, current_rss());
+#endif
+}
+
+size_t Memory_accounting::current_rss() {
+#if defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+        return counters.WorkingSetSize;
+    return 0;
+#elif defined(__linux__)
+    FILE* statm = std::fopen("/proc/self/statm", "r");
+    if (!statm)
+        return 0;
+    unsigned long size = 0, resident = 0;
+    int fields = std::fscanf(statm, "%lu %lu", &size, &resident);
+    std::fclose(statm);
+    return fields == 2 ? static_cast<size_t>(resident) * static_cast<size_t>(sysconf(_SC_PAGESIZE)) : 0;
+#else
+    return 0;
+#endif
+}
+
+void Memory_accounting::print(std::ostream& os) {
+    os << "\n========== Memory Usage ==========\n";
+    if (!is_available()) {
+        os << "Heap accounting not linked in (build with MEMORY=1)\n";
+        os << "Peak RSS: " << format_bytes(static_cast<double>(peak_rss()))
+           << ", current RSS: " << format_bytes(static_cast<double>(current_rss())) << "\n";
+        return;
+    }
+    os << std::left << std::setw(12) << "Subsystem" << std::right << std::setw(12) << "Current" << std::setw(12)
+       << "Peak" << std::setw(14) << "Allocations" << std::setw(12) << "Releases" << "\n";
+    os << std::string(62, '-') << "\n";
+    auto row = [&os](const char* name, const Usage& u) {
+        os << std::left << std::setw(12) << name << std::right << std::setw(12)
+           << format_bytes(static_cast<double>(u.current)) << std::setw(12) << format_bytes(static_cast<double>(u.peak))
+           << std::setw(14) << u.allocations << std::setw(12) << u.releases << "\n";
+    };
+    for (size_t t = 0; t < tag_count; t++) {
+        Usage u = usage(static_cast<Memory_tag>(t));
+        if (u.allocations > 0)
+            row(tag_name(static_cast<Memory_tag>(t)), u);
+    }
+    os << std::string(62, '-') << "\n";
+    row("total", total());
+    os << "Peak RSS: " << format_bytes(static_cast<double>(peak_rss()))
+       << ", current RSS: " << format_bytes(static_cast<double>(current_rss())) << "\n";
+}
+
+// ============================================================
+//  Memory_scope
+// ============================================================
+
+Memory_scope::Memory_scope(Memory_tag tag) : previous(thread_tag) {
+    thread_tag = tag;
+}
+
+Memory_scope::~Memory_scope() {
+    thread_tag = previous;
+}
@@ -0,0 +1,326 @@
+#include "monte_carlo.h"
+#include "sparse_matrix.h"
+#include "sparse_lu.h"
+#include "batch_lu.h"
+#include "trace.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <exception>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+
+namespace {
+
+constexpr double PI = 3.14159265358979323846;
+
+uint64_t mix64(uint64_t z) {
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+// SplitMix64 stream of one sample; state depends only on (seed, sample)
+struct Sample_stream {
+    uint64_t state;
+
+    Sample_stream(uint64_t seed, uint64_t sample) : state(mix64(seed) ^ mix64(sample + 0x9e3779b97f4a7c15ULL)) {}
+
+    double uniform() {
+        state += 0x9e3779b97f4a7c15ULL;
+        return static_cast<double>(mix64(state) >> 11) * 0x1.0p-53;
+    }
+};
+
+// Per-thread copies of everything a sample writes to
+struct Sample_worker {
+    std::vector<std::unique_ptr<Component>> parts;  // Clones of the varied components
+    Sparse_matrix<double> matrix;
+    Sparse_lu<double> lu;
+    std::vector<double> x;
+    Batch_lu<batch_lu_lanes> batch;                 // Small systems: samples in SIMD lanes
+    std::vector<double> batch_values, batch_x;
+};
+
+} // namespace
+
+// ============================================================
+//  Running_stats
+// ============================================================
+
+void Running_stats::add(double x) {
+    if (count == 0) {
+        min = max = x;
+    } else {
+        min = std::min(min, x);
+        max = std::max(max, x);
+    }
+    count++;
+    double delta = x - mean;
+    mean += delta / static_cast<double>(count);
+    m2 += delta * (x - mean);
+}
+
+void Running_stats::merge(const Running_stats& other) {
+    if (other.count == 0)
+        return;
+    if (count == 0) {
+        *this = other;
+        return;
+    }
+    long long total = count + other.count;
+    double delta = other.mean - mean;
+    mean += delta * static_cast<double>(other.count) / static_cast<double>(total);
+    m2 += other.m2 + delta * delta * static_cast<double>(count) * static_cast<double>(other.count) / static_cast<double>(total);
+    min = std::min(min, other.min);
+    max = std::max(max, other.max);
+    count = total;
+}
+
+double Running_stats::std_dev() const {
+    return std::sqrt(variance());
+}
+
+// ============================================================
+//  Monte_carlo
+// ============================================================
+
+Monte_carlo::Monte_carlo(int num_samples, uint64_t seed, int chunk_size)
+    : num_samples(num_samples), seed(seed), chunk_size(std::max(1, chunk_size)), num_varied(0), duration(0) {}
+
+double Monte_carlo::draw(const Tolerance& tolerance, double value, double u1, double u2) {
+    switch (tolerance.distribution) {
+        case Tolerance::Distribution::uniform:
+            return value * (1.0 + tolerance.spread * (2.0 * u1 - 1.0));
+        case Tolerance::Distribution::gaussian:
+            // Box-Muller; 1 - u1 lies in (0, 1]
+            return value * (1.0 + tolerance.spread * std::sqrt(-2.0 * std::log(1.0 - u1)) * std::cos(2.0 * PI * u2));
+        default:
+            return value;
+    }
+}
+
+void Monte_carlo::run(Circuit& circuit, Thread_pool* pool) {
+    TRACE_SCOPE("monte_carlo");
+    if (num_samples <= 0)
+        throw std::invalid_argument("Monte Carlo: number of samples must be positive.");
+    std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+
+    // Varied components in ID order (the draw order of every sample stream)
+    std::vector<Component*> varied;
+    for (const auto& [id, component] : circuit.get_components())
+        if (component->get_tolerance().distribution != Tolerance::Distribution::none)
+            varied.push_back(component);
+    std::sort(varied.begin(), varied.end(), [](const Component* a, const Component* b) {
+        return a->get_id() < b->get_id();
+    });
+    num_varied = static_cast<int>(varied.size());
+    std::vector<double> nominal_values(varied.size());
+    for (size_t c = 0; c < varied.size(); c++)
+        nominal_values[c] = varied[c]->get_value();
+
+    // Nominal solve; its symbolic analysis is shared by every sample
+    Sparse_matrix<double> A;
+    A.assemble(circuit.get_MNA_matrix());
+    std::vector<double> b;
+    A.gather(circuit.get_MNA_vector(), b);
+    Sparse_lu<double> nominal_lu;
+    nominal_lu.factorize(A);
+    nominal = b;
+    nominal_lu.solve(nominal);
+
+    int n = A.n;
+    names.assign(n, "");
+    for (int k = 0; k < n; k++) {
+        int var = A.var_index[k];
+        auto node = circuit.get_nodeId_map().find(var);
+        if (node != circuit.get_nodeId_map().end())
+            names[k] = "V(" + node->second + ")";
+        else
+            names[k] = "I(" + circuit.get_extraVarId_map().at(var).substr(1) + ")";
+    }
+
+    // Where each varied component's stamps land; the rest of the system is fixed
+    std::vector<int> matrix_ptr(1, 0), matrix_pos, vector_ptr(1, 0), vector_pos;
+    std::vector<double> base_values = A.values, base_b = b;
+    for (Component* component : varied) {
+        Component_contribution<double> contrib = component->get_contribution();
+        for (const auto& mc : contrib.matrixStamps) {
+            int p = A.find(mc.row, mc.col);
+            if (p < 0 && mc.row != 0 && mc.col != 0)
+                throw std::runtime_error("Monte Carlo: stamp of " + component->get_id() + " is outside the assembled system.");
+            matrix_pos.push_back(p);
+            if (p >= 0)
+                base_values[p] -= mc.value;
+        }
+        for (const auto& vc : contrib.vectorStamps) {
+            bool active = vc.row > 0 && vc.row < static_cast<int>(A.compact_index.size()) && A.compact_index[vc.row] >= 0;
+            vector_pos.push_back(active ? A.compact_index[vc.row] : -1);
+            if (active)
+                base_b[A.compact_index[vc.row]] -= vc.value;
+        }
+        matrix_ptr.push_back(static_cast<int>(matrix_pos.size()));
+        vector_ptr.push_back(static_cast<int>(vector_pos.size()));
+    }
+
+    // Small systems are solved batch_lu_lanes samples at a time (not for singular nominal systems)
+    Batch_lu<batch_lu_lanes> nominal_batch;
+    bool batched = n <= batch_lu_max_size;
+    if (batched) {
+        try {
+            nominal_batch.analyze(A);
+        } catch (const std::runtime_error&) {
+            batched = false;
+        }
+    }
+
+    int num_threads = pool ? pool->size() : 1;
+    std::vector<Sample_worker> workers(num_threads);
+    for (Sample_worker& worker : workers) {
+        for (Component* component : varied)
+            worker.parts.emplace_back(component->clone());
+        worker.matrix = A;
+        worker.lu.set_symbolic(nominal_lu.get_symbolic());
+        if (batched) {
+            worker.batch = nominal_batch;
+            worker.batch_values.resize(static_cast<size_t>(A.nnz()) * batch_lu_lanes);
+            worker.batch_x.resize(static_cast<size_t>(n) * batch_lu_lanes);
+        }
+    }
+
+    auto fill_sample = [&](Sample_worker& worker, int sample) {
+        Sample_stream stream(seed, static_cast<uint64_t>(sample));
+        std::copy(base_values.begin(), base_values.end(), worker.matrix.values.begin());
+        worker.x = base_b;
+        for (size_t c = 0; c < varied.size(); c++) {
+            Component* part = worker.parts[c].get();
+            double value;
+            do {
+                double u1 = stream.uniform();
+                double u2 = stream.uniform();
+                value = draw(part->get_tolerance(), nominal_values[c], u1, u2);
+            } while (value <= 0.0 && nominal_values[c] > 0.0);
+            part->set_value(value);
+
+            Component_contribution<double> contrib = part->get_contribution();
+            if (static_cast<int>(contrib.matrixStamps.size()) != matrix_ptr[c + 1] - matrix_ptr[c]
+                || static_cast<int>(contrib.vectorStamps.size()) != vector_ptr[c + 1] - vector_ptr[c])
+                throw std::runtime_error("Monte Carlo: stamp pattern of " + part->get_id() + " depends on its value.");
+            for (size_t s = 0; s < contrib.matrixStamps.size(); s++)
+                if (matrix_pos[matrix_ptr[c] + s] >= 0)
+                    worker.matrix.values[matrix_pos[matrix_ptr[c] + s]] += contrib.matrixStamps[s].value;
+            for (size_t s = 0; s < contrib.vectorStamps.size(); s++)
+                if (vector_pos[vector_ptr[c] + s] >= 0)
+                    worker.x[vector_pos[vector_ptr[c] + s]] += contrib.vectorStamps[s].value;
+        }
+    };
+
+    auto run_sample = [&](Sample_worker& worker, int sample, std::vector<Running_stats>& chunk) {
+        fill_sample(worker, sample);
+        worker.lu.factorize(worker.matrix);
+        worker.lu.solve(worker.x);
+        for (int k = 0; k < n; k++)
+            chunk[k].add(worker.x[k]);
+    };
+
+    // Samples [s0, s1) in groups of batch_lu_lanes; a short last group repeats its last sample
+    auto run_batch = [&](Sample_worker& worker, int s0, int s1, std::vector<Running_stats>& chunk) {
+        int count = s1 - s0;
+        for (int l = 0; l < batch_lu_lanes; l++) {
+            if (l < count)
+                fill_sample(worker, s0 + l);
+            for (int p = 0; p < A.nnz(); p++)
+                worker.batch_values[static_cast<size_t>(p) * batch_lu_lanes + l] = worker.matrix.values[p];
+            for (int k = 0; k < n; k++)
+                worker.batch_x[static_cast<size_t>(k) * batch_lu_lanes + l] = worker.x[k];
+        }
+        try {
+            worker.batch.factorize(worker.batch_values);
+        } catch (const std::runtime_error&) {
+            // A singular sample: the scalar solver regularizes it
+            for (int sample = s0; sample < s1; sample++)
+                run_sample(worker, sample, chunk);
+            return;
+        }
+        worker.batch.solve(worker.batch_x);
+        for (int l = 0; l < count; l++)
+            for (int k = 0; k < n; k++)
+                chunk[k].add(worker.batch_x[static_cast<size_t>(k) * batch_lu_lanes + l]);
+    };
+
+    // Waves of chunks: chunks run in any order, but merge in sample order
+    int num_chunks = (num_samples + chunk_size - 1) / chunk_size;
+    int wave = 4 * num_threads;
+    std::vector<std::vector<Running_stats>> chunk_stats(wave, std::vector<Running_stats>(n));
+    stats.assign(n, Running_stats());
+    for (int c0 = 0; c0 < num_chunks; c0 += wave) {
+        int c1 = std::min(num_chunks, c0 + wave);
+        std::atomic<int> next(c0);
+        std::exception_ptr error;
+        std::mutex error_mutex;
+
+        auto body = [&](int thread_id, int) {
+            for (int chunk = next.fetch_add(1); chunk < c1; chunk = next.fetch_add(1)) {
+                std::vector<Running_stats>& chunk_stat = chunk_stats[chunk - c0];
+                std::fill(chunk_stat.begin(), chunk_stat.end(), Running_stats());
+                try {
+                    int s1 = std::min(num_samples, (chunk + 1) * chunk_size);
+                    for (int sample = chunk * chunk_size; sample < s1; sample += batched ? batch_lu_lanes : 1) {
+                        if (batched)
+                            run_batch(workers[thread_id], sample, std::min(s1, sample + batch_lu_lanes), chunk_stat);
+                        else
+                            run_sample(workers[thread_id], sample, chunk_stat);
+                    }
+                } catch (...) {
+                    std::lock_guard<std::mutex> lock(error_mutex);
+                    if (!error)
+                        error = std::current_exception();
+                }
+            }
+        };
+        if (pool)
+            pool->run(body);
+        else
+            body(0, 1);
+        if (error)
+            std::rethrow_exception(error);
+
+        for (int chunk = c0; chunk < c1; chunk++)
+            for (int k = 0; k < n; k++)
+                stats[k].merge(chunk_stats[chunk - c0][k]);
+    }
+
+    std::chrono::high_resolution_clock::time_point end = std::chrono::high_resolution_clock::now();
+    duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
+}
+
+const Running_stats& Monte_carlo::get_stats(const std::string& name) const {
+    auto it = std::find(names.begin(), names.end(), name);
+    if (it == names.end())
+        throw std::invalid_argument("Monte Carlo: no variable named " + name + ".");
+    return stats[it - names.begin()];
+}
+
+void Monte_carlo::print(std::ostream& os) const {
+    os << "Monte Carlo Analysis:" << std::endl;
+    os << std::string(40, '-') << std::endl;
+    if (stats.empty()) {
+        os << "  Not run" << std::endl;
+        return;
+    }
+    os << "  Samples: " << num_samples << " (seed " << seed << ")" << std::endl;
+    os << "  Varied Components: " << num_varied << std::endl;
+    os << "  Time Taken: " << duration.count() << " microseconds" << std::endl;
+    os << std::left << std::setw(12) << "Variable" << std::right
+       << std::setw(14) << "Nominal" << std::setw(14) << "Mean" << std::setw(14) << "Std Dev"
+       << std::setw(14) << "Min" << std::setw(14) << "Max" << std::endl;
+    os << std::string(82, '-') << std::endl;
+    os << std::scientific << std::setprecision(5);
+    for (size_t k = 0; k < names.size(); k++)
+        os << std::left << std::setw(12) << names[k] << std::right
+           << std::setw(14) << nominal[k] << std::setw(14) << stats[k].mean << std::setw(14) << stats[k].std_dev()
+           << std::setw(14) << stats[k].min << std::setw(14) << stats[k].max << std::endl;
+    os << std::defaultfloat;
+}
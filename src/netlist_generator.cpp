@@ -0,0 +1,280 @@
+#include "netlist_generator.h"
+#include "circuit_builder.h"
+#include "trace.h"
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+constexpr double pi = 3.14159265358979323846;
+
+const char* topology_name(Netlist_generator::Topology topology) {
+    switch (topology) {
+        case Netlist_generator::Topology::ladder: return "ladder";
+        case Netlist_generator::Topology::grid: return "grid";
+        case Netlist_generator::Topology::tree: return "tree";
+        case Netlist_generator::Topology::random: return "random";
+        case Netlist_generator::Topology::rlc: return "rlc";
+    }
+    return "unknown";
+}
+
+// Largest side with side^dimensions <= size
+size_t grid_side(size_t size, int dimensions) {
+    size_t side = static_cast<size_t>(std::pow(static_cast<double>(size), 1.0 / dimensions));
+    auto volume = [dimensions](size_t s) {
+        double v = 1.0;
+        for (int d = 0; d < dimensions; d++)
+            v *= static_cast<double>(s);
+        return v;
+    };
+    while (side > 1 && volume(side) > static_cast<double>(size))
+        side--;
+    while (volume(side + 1) <= static_cast<double>(size))
+        side++;
+    return std::max<size_t>(side, 2);
+}
+
+void append_number(std::string& out, size_t value) {
+    char digits[24];
+    auto result = std::to_chars(digits, digits + sizeof(digits), value);
+    out.append(digits, result.ptr);
+}
+
+void append_number(std::string& out, double value) {
+    char digits[32];
+    int length = std::snprintf(digits, sizeof(digits), "%.17g", value);
+    out.append(digits, static_cast<size_t>(length));
+}
+
+} // namespace
+
+Netlist_generator::Netlist_generator(const Spec& spec) : spec(spec) {
+    if (spec.size < 2)
+        throw std::invalid_argument("Generated circuits need at least 2 nodes.");
+    if (spec.dimensions < 1 || spec.dimensions > 6)
+        throw std::invalid_argument("Grid dimensions must be between 1 and 6.");
+    if (spec.branching < 1)
+        throw std::invalid_argument("Tree branching factor must be positive.");
+    if (!(spec.degree > 0.0))
+        throw std::invalid_argument("Mean degree of random graphs must be positive.");
+}
+
+std::string Netlist_generator::name() const {
+    std::string text = topology_name(spec.topology);
+    if (spec.topology == Topology::grid)
+        text += "_" + std::to_string(spec.dimensions) + "d";
+    else if (spec.topology == Topology::tree)
+        text += "_k" + std::to_string(spec.branching);
+    return text + "_" + std::to_string(spec.size) + "_seed" + std::to_string(spec.seed);
+}
+
+void Netlist_generator::parse_topology(const std::string& text, Spec& spec) {
+    size_t colon = text.find(':');
+    std::string topology = text.substr(0, colon);
+    std::string parameter = colon == std::string::npos ? "" : text.substr(colon + 1);
+    if (topology == "ladder")
+        spec.topology = Topology::ladder;
+    else if (topology == "grid")
+        spec.topology = Topology::grid;
+    else if (topology == "tree")
+        spec.topology = Topology::tree;
+    else if (topology == "random")
+        spec.topology = Topology::random;
+    else if (topology == "rlc")
+        spec.topology = Topology::rlc;
+    else
+        throw std::invalid_argument("Unknown topology: " + topology + " (expected ladder, grid, tree, random or rlc).");
+
+    if (parameter.empty())
+        return;
+    try {
+        if (spec.topology == Topology::grid)
+            spec.dimensions = std::stoi(parameter);
+        else if (spec.topology == Topology::tree)
+            spec.branching = std::stoi(parameter);
+        else if (spec.topology == Topology::random)
+            spec.degree = std::stod(parameter);
+        else
+            throw std::invalid_argument("");
+    } catch (const std::exception&) {
+        throw std::invalid_argument("Invalid topology parameter: " + text);
+    }
+}
+
+template<typename Emit>
+void Netlist_generator::generate(Emit&& emit) const {
+    std::mt19937_64 rng(spec.seed);
+    std::uniform_real_distribution<double> jitter(0.5, 1.5);
+    const size_t n = spec.size;
+    const bool reactive = spec.reactive;
+    emit('V', "", 1, 1, 0, 10.0);
+
+    switch (spec.topology) {
+        case Topology::ladder:
+            for (size_t k = 1; k < n; k++) {
+                if (reactive && k % 16 == 0)
+                    emit('L', "s", k, k, k + 1, 1e-6 * jitter(rng));
+                else
+                    emit('R', "s", k, k, k + 1, 100.0 * jitter(rng));
+                emit('R', "p", k, k + 1, 0, 1000.0 * jitter(rng));
+                if (reactive && (k + 1) % 4 == 0)
+                    emit('C', "", k + 1, k + 1, 0, 1e-9 * jitter(rng));
+            }
+            break;
+
+        case Topology::grid: {
+            const int d = spec.dimensions;
+            const size_t side = grid_side(n, d);
+            size_t count = 1;
+            for (int k = 0; k < d; k++)
+                count *= side;
+            for (size_t i = 0; i < count; i++) {
+                size_t stride = 1;
+                for (int k = 0; k < d; k++, stride *= side)
+                    if ((i / stride) % side + 1 < side)
+                        emit('R', "g", i * d + k, i + 1, i + 1 + stride, 100.0 * jitter(rng));
+                if (reactive && (i + 1) % 8 == 0)
+                    emit('C', "", i + 1, i + 1, 0, 1e-9 * jitter(rng));
+            }
+            emit('R', "gnd", 0, count, 0, 50.0);
+            break;
+        }
+
+        case Topology::tree: {
+            const size_t b = static_cast<size_t>(spec.branching);
+            for (size_t k = 2; k <= n; k++) {
+                emit('R', "", k, (k - 2) / b + 1, k, 100.0 * jitter(rng));
+                if (reactive && k % 5 == 0)
+                    emit('C', "", k, k, 0, 1e-9 * jitter(rng));
+            }
+            for (size_t k = 1; k <= n; k++)
+                if (b * (k - 1) + 2 > n)
+                    emit('R', "l", k, k, 0, 1000.0 * jitter(rng));
+            break;
+        }
+
+        case Topology::random: {
+            // Random geometric graph: cell buckets of side >= radius make neighbour search O(n)
+            std::uniform_real_distribution<double> coordinate(0.0, 1.0);
+            std::vector<double> x(n + 1), y(n + 1);
+            for (size_t k = 1; k <= n; k++) {
+                x[k] = coordinate(rng);
+                y[k] = coordinate(rng);
+            }
+            const double radius = std::sqrt(spec.degree / (pi * static_cast<double>(n)));
+            const size_t cells = std::max<size_t>(1, static_cast<size_t>(1.0 / radius));
+            auto cell_of = [cells](double v) { return std::min(cells - 1, static_cast<size_t>(v * cells)); };
+            std::vector<size_t> start(cells * cells + 1, 0), members(n);
+            for (size_t k = 1; k <= n; k++)
+                start[cell_of(y[k]) * cells + cell_of(x[k]) + 1]++;
+            for (size_t c = 0; c < cells * cells; c++)
+                start[c + 1] += start[c];
+            std::vector<size_t> fill(start.begin(), start.end() - 1);
+            for (size_t k = 1; k <= n; k++)
+                members[fill[cell_of(y[k]) * cells + cell_of(x[k])]++] = k;
+
+            size_t edges = 0;
+            for (size_t i = 1; i <= n; i++) {
+                emit('R', "g", i, i, 0, 1e6);
+                if (reactive && i % 7 == 0)
+                    emit('C', "", i, i, 0, 1e-9 * jitter(rng));
+                size_t cx = cell_of(x[i]), cy = cell_of(y[i]);
+                for (size_t gy = (cy == 0 ? 0 : cy - 1); gy <= std::min(cells - 1, cy + 1); gy++) {
+                    for (size_t gx = (cx == 0 ? 0 : cx - 1); gx <= std::min(cells - 1, cx + 1); gx++) {
+                        size_t c = gy * cells + gx;
+                        for (size_t m = start[c]; m < start[c + 1]; m++) {
+                            size_t j = members[m];
+                            double dx = x[i] - x[j], dy = y[i] - y[j];
+                            if (j > i && dx * dx + dy * dy < radius * radius)
+                                emit('R', "b", edges++, i, j, 1000.0 * jitter(rng));
+                        }
+                    }
+                }
+            }
+            break;
+        }
+
+        case Topology::rlc: {
+            const size_t side = grid_side(n, 2);
+            const size_t count = side * side;
+            size_t internal = count;    // Internal nodes of the vertical R-L branches follow the mesh nodes
+            for (size_t i = 1; i <= count; i++) {
+                if ((i - 1) % side + 1 < side)
+                    emit('R', "h", i, i, i + 1, 10.0 * jitter(rng));
+                if (i + side <= count) {
+                    if (reactive) {
+                        internal++;
+                        emit('R', "v", i, i, internal, 10.0 * jitter(rng));
+                        emit('L', "v", i, internal, i + side, 1e-6 * jitter(rng));
+                    } else {
+                        emit('R', "v", i, i, i + side, 10.0 * jitter(rng));
+                    }
+                }
+                if (reactive)
+                    emit('C', "", i, i, 0, 1e-9 * jitter(rng));
+            }
+            emit('R', "gnd", 0, count, 0, 50.0);
+            break;
+        }
+    }
+}
+
+size_t Netlist_generator::write(std::ostream& os) const {
+    std::string buffer = "* " + name() + "\n";
+    buffer.reserve(1 << 16);
+    size_t elements = 0;
+    generate([&](char type, const char* prefix, size_t index, size_t node1, size_t node2, double value) {
+        buffer += type;
+        buffer += prefix;
+        append_number(buffer, index);
+        buffer += ' ';
+        append_number(buffer, node1);
+        buffer += ' ';
+        append_number(buffer, node2);
+        buffer += type == 'V' ? " DC " : " ";
+        append_number(buffer, value);
+        if (type == 'V' && spec.ac != 0.0) {
+            buffer += " AC ";
+            append_number(buffer, spec.ac);
+        }
+        buffer += '\n';
+        elements++;
+        if (buffer.size() > (1 << 16) - 128) {
+            os.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+            buffer.clear();
+        }
+    });
+    os.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    return elements;
+}
+
+size_t Netlist_generator::build(Circuit& circuit) const {
+    TRACE_SCOPE("build");
+    CircuitBuilder builder;
+    builder.reserve(circuit, spec.size + 2, 3 * spec.size);
+    size_t elements = 0;
+    std::string id, node1, node2;
+    generate([&](char type, const char* prefix, size_t index, size_t n1, size_t n2, double value) {
+        id.assign(1, type);
+        id += prefix;
+        append_number(id, index);
+        node1.clear();
+        append_number(node1, n1);
+        node2.clear();
+        append_number(node2, n2);
+        switch (type) {
+            case 'R': builder.add_resistor(circuit, id, node1, node2, value); break;
+            case 'C': builder.add_capacitor(circuit, id, node1, node2, value); break;
+            case 'L': builder.add_inductor(circuit, id, node1, node2, value); break;
+            case 'V': builder.add_voltage_source(circuit, id, node1, node2, value, spec.ac); break;
+        }
+        elements++;
+    });
+    return elements;
+}
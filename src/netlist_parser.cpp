@@ -9,24 +9,38 @@
 //  Header parsing
 // ============================================================
 
-std::string NetlistParser::parse_header(std::ifstream& file) {
-    if (!file.is_open()) return "";
+std::string NetlistParser::parse_header(std::istream& file, std::string* rest) {
+    if (!file) return "";
 
     std::streampos original_pos = file.tellg();
     std::string    first_line;
 
     if (!std::getline(file, first_line)) return "";
 
-    size_t start = first_line.find_first_not_of(" \t\r\n");
-    if (start == std::string::npos || first_line[start] != '*') {
-        file.seekg(original_pos);  // not a header — rewind
+    bool is_header = false;
+    std::string title = parse_title(first_line, is_header);
+    if (!is_header) {
+        // not a header — rewind, or hand the line back for unseekable streams
+        if (original_pos != std::streampos(-1)) {
+            file.clear();
+            file.seekg(original_pos);
+        } else if (rest) {
+            *rest = first_line;
+        }
         return "";
     }
+    return title;
+}
+
+std::string NetlistParser::parse_title(const std::string& line, bool& is_header) {
+    size_t start = line.find_first_not_of(" \t\r\n");
+    is_header = start != std::string::npos && line[start] == '*';
+    if (!is_header) return "";
 
-    size_t content_start = first_line.find_first_not_of(" \t*", start);
+    size_t content_start = line.find_first_not_of(" \t*", start);
     if (content_start == std::string::npos) return "";
 
-    std::string title = first_line.substr(content_start);
+    std::string title = line.substr(content_start);
     size_t end = title.find_last_not_of(" \t\r\n");
     return (end != std::string::npos) ? title.substr(0, end + 1) : title;
 }
@@ -127,7 +141,7 @@ void NetlistParser::parse_values(std::istringstream& iss,
 
         std::string upper = to_upper(token);
 
-        if (upper == "DC" || upper == "AC") {
+        if (upper == "DC" || upper == "AC" || upper == "TOL" || upper == "SIGMA") {
             std::string val_token;
             if (!(iss >> val_token)) {
                 throw std::runtime_error(
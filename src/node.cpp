@@ -5,6 +5,16 @@ int Node::node_count = 0;
 
 Node::Node(std::string nodeName) : name(nodeName),id(node_count++), voltage(0.0){}
 
+Node::Numbering_scope::Numbering_scope() : saved_count(node_count), saved_valid(valid) {
+    node_count = 0;
+    valid = false;
+}
+
+Node::Numbering_scope::~Numbering_scope() {
+    node_count = saved_count;
+    valid = saved_valid;
+}
+
 bool Node::operator==(const Node& other) const {return name == other.name;}
 
 bool Node::operator<(const Node& other) const {return name < other.name;}
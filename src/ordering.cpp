@@ -0,0 +1,339 @@
+#include "ordering.h"
+#include <algorithm>
+#include <queue>
+#include <functional>
+
+std::vector<std::vector<int>> Ordering::symmetric_adjacency(int n, const std::vector<int>& col_ptr, const std::vector<int>& row_idx) {
+    std::vector<std::vector<int>> adj(n);
+    for (int j = 0; j < n; j++) {
+        for (int p = col_ptr[j]; p < col_ptr[j + 1]; p++) {
+            int i = row_idx[p];
+            if (i == j)
+                continue;
+            adj[i].push_back(j);
+            adj[j].push_back(i);
+        }
+    }
+    for (auto& list : adj) {
+        std::sort(list.begin(), list.end());
+        list.erase(std::unique(list.begin(), list.end()), list.end());
+    }
+    return adj;
+}
+
+std::vector<int> Ordering::minimum_degree(int n, const std::vector<int>& col_ptr, const std::vector<int>& row_idx) {
+    std::vector<std::vector<int>> adj = symmetric_adjacency(n, col_ptr, row_idx);
+    std::vector<char> eliminated(n, 0);
+    std::vector<int> degree(n);
+    std::vector<int> perm;
+    perm.reserve(n);
+
+    using Entry = std::pair<int, int>;  // (degree, vertex)
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> queue;
+    for (int v = 0; v < n; v++) {
+        degree[v] = static_cast<int>(adj[v].size());
+        queue.emplace(degree[v], v);
+    }
+
+    std::vector<int> clique, merged;
+    while (!queue.empty()) {
+        auto [d, v] = queue.top();
+        queue.pop();
+        if (eliminated[v] || d != degree[v])
+            continue;   // Stale queue entry
+
+        eliminated[v] = 1;
+        perm.push_back(v);
+
+        // Live neighbours of v become a clique in the elimination graph
+        clique.clear();
+        for (int u : adj[v])
+            if (!eliminated[u])
+                clique.push_back(u);
+
+        for (int u : clique) {
+            merged.clear();
+            std::set_union(adj[u].begin(), adj[u].end(), clique.begin(), clique.end(),
+                           std::back_inserter(merged));
+            adj[u].clear();
+            for (int w : merged)
+                if (w != u && !eliminated[w])
+                    adj[u].push_back(w);
+            degree[u] = static_cast<int>(adj[u].size());
+            queue.emplace(degree[u], u);
+        }
+        std::vector<int>().swap(adj[v]);
+    }
+    return perm;
+}
+
+// ============================================================
+//  Nested dissection
+// ============================================================
+
+namespace {
+
+// Recursive bisection state: vertices of the subgraph being split share one label
+class Dissector {
+public:
+    Dissector(const std::vector<std::vector<int>>& adj, Dissection_tree* tree, int leaf_size)
+        : adj(adj), tree(tree), leaf_size(std::max(leaf_size, 1)),
+          label(adj.size(), 0), level(adj.size(), -1), local(adj.size(), -1), next_label(1) {
+        perm.reserve(adj.size());
+    }
+
+    std::vector<int> order() {
+        std::vector<int> all(adj.size());
+        for (size_t v = 0; v < adj.size(); v++)
+            all[v] = static_cast<int>(v);
+        if (!all.empty())
+            dissect(all, 0, -1);
+        return std::move(perm);
+    }
+
+private:
+    const std::vector<std::vector<int>>& adj;
+    Dissection_tree* tree;
+    int leaf_size;
+    std::vector<int> label;     // Subgraph label per vertex (-1 once ordered)
+    std::vector<int> level;     // BFS scratch
+    std::vector<int> local;     // Vertex -> index inside a leaf (scratch)
+    std::vector<int> perm;
+    int next_label;
+
+    int new_node(int parent) {
+        if (!tree)
+            return -1;
+        tree->parent.push_back(parent);
+        tree->own_begin.push_back(0);
+        tree->own_end.push_back(0);
+        return tree->num_nodes() - 1;
+    }
+
+    void set_own(int node, int begin) {
+        if (!tree)
+            return;
+        tree->own_begin[node] = begin;
+        tree->own_end[node] = static_cast<int>(perm.size());
+    }
+
+    // BFS restricted to label lab; fills level[] and returns vertices in visit order
+    void bfs(int root, int lab, std::vector<int>& visit) {
+        visit.clear();
+        visit.push_back(root);
+        level[root] = 0;
+        for (size_t h = 0; h < visit.size(); h++) {
+            int v = visit[h];
+            for (int u : adj[v]) {
+                if (label[u] != lab || level[u] >= 0)
+                    continue;
+                level[u] = level[v] + 1;
+                visit.push_back(u);
+            }
+        }
+    }
+
+    void clear_levels(const std::vector<int>& visit) {
+        for (int v : visit)
+            level[v] = -1;
+    }
+
+    void order_leaf(const std::vector<int>& part) {
+        int m = static_cast<int>(part.size());
+        for (int t = 0; t < m; t++)
+            local[part[t]] = t;
+        std::vector<int> col_ptr(1, 0), row_idx;
+        for (int v : part) {
+            for (int u : adj[v])
+                if (local[u] >= 0 && label[u] == label[v])
+                    row_idx.push_back(local[u]);
+            col_ptr.push_back(static_cast<int>(row_idx.size()));
+        }
+        std::vector<int> leaf_perm = Ordering::minimum_degree(m, col_ptr, row_idx);
+        for (int t : leaf_perm) {
+            perm.push_back(part[t]);
+            label[part[t]] = -1;
+        }
+        for (int v : part)
+            local[v] = -1;
+    }
+
+    void dissect(std::vector<int>& part, int lab, int parent) {
+        int node = new_node(parent);
+        int begin = static_cast<int>(perm.size());
+        if (static_cast<int>(part.size()) <= leaf_size) {
+            order_leaf(part);
+            set_own(node, begin);
+            return;
+        }
+
+        std::vector<int> visit;
+        bfs(part[0], lab, visit);
+        if (visit.size() < part.size()) {
+            // Disconnected: every component is an independent child
+            std::vector<std::vector<int>> components;
+            components.push_back(visit);
+            for (int v : part) {
+                if (level[v] >= 0)
+                    continue;
+                std::vector<int> more;
+                bfs(v, lab, more);
+                components.push_back(std::move(more));
+            }
+            clear_levels(part);
+            for (auto& component : components) {
+                int child = next_label++;
+                for (int v : component)
+                    label[v] = child;
+            }
+            for (auto& component : components)
+                dissect(component, label[component[0]], node);
+            set_own(node, static_cast<int>(perm.size()));
+            return;
+        }
+
+        // Pseudo-peripheral root: restart from the farthest vertex while the depth grows
+        int depth = level[visit.back()];
+        for (int pass = 0; pass < 4; pass++) {
+            int far = visit.back();
+            for (size_t h = visit.size(); h-- > 0 && level[visit[h]] == depth;)
+                if (adj[visit[h]].size() < adj[far].size())
+                    far = visit[h];
+            clear_levels(visit);
+            bfs(far, lab, visit);
+            int new_depth = level[visit.back()];
+            if (new_depth <= depth)
+                break;
+            depth = new_depth;
+        }
+
+        // Separator: the smallest level whose prefix holds 40-60% of the vertices
+        std::vector<int> level_size(depth + 1, 0);
+        for (int v : visit)
+            level_size[level[v]]++;
+        int n = static_cast<int>(visit.size());
+        int best = -1, prefix = 0;
+        for (int l = 0; l <= depth; l++) {
+            int before = prefix;
+            prefix += level_size[l];
+            if (l == 0 || l == depth || 5 * before < 2 * n || 5 * before > 3 * n)
+                continue;
+            if (best < 0 || level_size[l] < level_size[best])
+                best = l;
+        }
+        for (int l = 0, acc = 0; best < 0 && depth >= 2 && l < depth; l++) {
+            acc += level_size[l];
+            if (2 * acc >= n)
+                best = std::min(std::max(l, 1), depth - 1);
+        }
+        if (best < 0) {
+            // Too shallow to split (e.g. a star): order as a leaf
+            clear_levels(visit);
+            order_leaf(part);
+            set_own(node, begin);
+            return;
+        }
+
+        // Level vertices without a neighbour beyond the level join the first half
+        std::vector<int> first, second, separator;
+        for (int v : visit) {
+            bool splits = level[v] == best
+                && std::any_of(adj[v].begin(), adj[v].end(), [&](int u) { return level[u] == best + 1; });
+            if (level[v] > best)
+                second.push_back(v);
+            else if (splits)
+                separator.push_back(v);
+            else
+                first.push_back(v);
+        }
+        clear_levels(visit);
+        int first_label = next_label++, second_label = next_label++;
+        for (int v : first)
+            label[v] = first_label;
+        for (int v : second)
+            label[v] = second_label;
+        for (int v : separator)
+            label[v] = -1;
+
+        dissect(first, first_label, node);
+        dissect(second, second_label, node);
+        int sep_begin = static_cast<int>(perm.size());
+        perm.insert(perm.end(), separator.begin(), separator.end());
+        set_own(node, sep_begin);
+    }
+};
+
+} // namespace
+
+std::vector<int> Ordering::nested_dissection(int n, const std::vector<int>& col_ptr, const std::vector<int>& row_idx,
+                                             Dissection_tree* tree, int leaf_size) {
+    if (tree)
+        *tree = Dissection_tree();
+    std::vector<std::vector<int>> adj = symmetric_adjacency(n, col_ptr, row_idx);
+    return Dissector(adj, tree, leaf_size).order();
+}
+
+// ============================================================
+//  Elimination tree and symbolic fill
+// ============================================================
+
+std::vector<int> Ordering::elimination_tree(int n, const std::vector<int>& col_ptr, const std::vector<int>& row_idx) {
+    // Liu's algorithm with path compression on the lower triangle of A + A^T
+    std::vector<std::vector<int>> lower(n);
+    for (int j = 0; j < n; j++)
+        for (int p = col_ptr[j]; p < col_ptr[j + 1]; p++) {
+            int i = row_idx[p];
+            if (i != j)
+                lower[std::max(i, j)].push_back(std::min(i, j));
+        }
+
+    std::vector<int> parent(n, -1), ancestor(n, -1);
+    for (int k = 0; k < n; k++) {
+        for (int i : lower[k]) {
+            while (i != -1 && i < k) {
+                int next = ancestor[i];
+                ancestor[i] = k;
+                if (next == -1)
+                    parent[i] = k;
+                i = next;
+            }
+        }
+    }
+    return parent;
+}
+
+long long Ordering::factor_nnz(int n, const std::vector<int>& col_ptr, const std::vector<int>& row_idx,
+                               const std::vector<int>& perm, long long cap) {
+    std::vector<int> pos(n);
+    for (int k = 0; k < n; k++)
+        pos[perm[k]] = k;
+    std::vector<int> permuted_col_ptr(n + 1, 0), permuted_row_idx;
+    permuted_row_idx.reserve(row_idx.size());
+    for (int k = 0; k < n; k++) {
+        int j = perm[k];
+        for (int p = col_ptr[j]; p < col_ptr[j + 1]; p++)
+            permuted_row_idx.push_back(pos[row_idx[p]]);
+        permuted_col_ptr[k + 1] = static_cast<int>(permuted_row_idx.size());
+    }
+    std::vector<int> parent = elimination_tree(n, permuted_col_ptr, permuted_row_idx);
+
+    // Row k of the Cholesky factor is the union of etree paths from its lower entries up to k
+    std::vector<std::vector<int>> lower(n);
+    for (int j = 0; j < n; j++)
+        for (int p = permuted_col_ptr[j]; p < permuted_col_ptr[j + 1]; p++) {
+            int i = permuted_row_idx[p];
+            if (i != j)
+                lower[std::max(i, j)].push_back(std::min(i, j));
+        }
+    std::vector<int> mark(n, -1);
+    long long count = n;
+    for (int k = 0; k < n && count <= cap; k++) {
+        mark[k] = k;
+        for (int i : lower[k])
+            for (; i != -1 && mark[i] != k; i = parent[i]) {
+                mark[i] = k;
+                count++;
+            }
+    }
+    return count;
+}
@@ -0,0 +1,196 @@
+#include "output_writer.h"
+#include "trace.h"
+#include <chrono>
+#include <stdexcept>
+
+namespace {
+
+// Waits for the other side of the ring: spin briefly, then yield, then sleep
+void back_off(int& spins) {
+    if (++spins < 64)
+        return;
+    if (spins < 256)
+        std::this_thread::yield();
+    else
+        std::this_thread::sleep_for(std::chrono::microseconds(50));
+}
+
+} // namespace
+
+Output_writer::Output_writer(size_t capacity) : head(0), tail(0), sleeping(false), stopping(false) {
+    size_t size = 2;
+    while (size < capacity)
+        size <<= 1;
+    ring.resize(size);
+    mask = size - 1;
+}
+
+Output_writer::~Output_writer() {
+    if (thread.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake_cv.notify_one();
+        thread.join();
+    }
+    for (auto& stream : streams)
+        if (stream->is_open())
+            stream->close();
+}
+
+int Output_writer::open(const std::string& path) {
+    // Reuse the slot of a closed file, so a sweep repeated on one writer allocates the same each time
+    size_t sink = 0;
+    while (sink < streams.size() && streams[sink]->is_open())
+        sink++;
+    {
+        std::lock_guard<std::mutex> lock(mutex);    // write() reads the tables when reporting errors
+        if (sink == streams.size()) {
+            streams.emplace_back(new std::ofstream());
+            paths.emplace_back();
+            errors.emplace_back();
+        }
+        streams[sink]->clear();
+        streams[sink]->open(path, std::ios::trunc);
+        paths[sink] = path;
+        errors[sink].clear();
+        if (!streams[sink]->is_open()) {
+            streams[sink]->clear();     // Reported by the return value, not as a write failure
+            return -1;
+        }
+    }
+    if (!thread.joinable())
+        thread = std::thread(&Output_writer::writer_loop, this);
+    return static_cast<int>(sink);
+}
+
+// ============================================================
+//  Producer side
+// ============================================================
+
+Output_writer::Record& Output_writer::acquire(int sink) {
+    size_t t = tail.load(std::memory_order_relaxed);
+    for (int spins = 0; t - head.load(std::memory_order_acquire) == ring.size();)
+        back_off(spins);
+    Record& record = ring[t & mask];
+    record.kind = Record::Kind::row;
+    record.stream = streams[sink].get();
+    record.values.clear();
+    record.counts.clear();
+    return record;
+}
+
+void Output_writer::commit() {
+    // Sequentially consistent with the writer's sleeping flag: one of us sees the other
+    tail.fetch_add(1, std::memory_order_seq_cst);
+    if (sleeping.load(std::memory_order_seq_cst)) {
+        std::lock_guard<std::mutex> lock(mutex);
+        wake_cv.notify_one();
+    }
+}
+
+void Output_writer::write_text(int sink, const std::string& text) {
+    Record& record = acquire(sink);
+    record.kind = Record::Kind::text;
+    record.text = text;
+    commit();
+}
+
+void Output_writer::drain() {
+    size_t t = tail.load(std::memory_order_relaxed);
+    for (int spins = 0; head.load(std::memory_order_acquire) != t;)
+        back_off(spins);
+}
+
+void Output_writer::reserve(size_t num_values, size_t num_counts) {
+    drain();
+    for (Record& record : ring) {
+        record.values.reserve(num_values);
+        record.counts.reserve(num_counts);
+    }
+}
+
+void Output_writer::flush() {
+    drain();
+    // The writer thread is idle until the next commit(): the streams are ours
+    for (auto& stream : streams)
+        if (stream->is_open())
+            stream->flush();
+    std::string message;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        note_failures();
+        for (std::string& error : errors)
+            if (!error.empty()) {
+                message.swap(error);        // Reported once; later writes start clean
+                break;
+            }
+    }
+    if (!message.empty())
+        throw std::runtime_error(message);
+}
+
+void Output_writer::close(int sink) {
+    drain();
+    streams[sink]->close();
+    std::string message;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        note_failures();
+        message.swap(errors[sink]);
+    }
+    if (!message.empty())
+        throw std::runtime_error(message);
+}
+
+// ============================================================
+//  Writer thread
+// ============================================================
+
+void Output_writer::write(const Record& record) {
+    std::ofstream& out = *record.stream;
+    if (record.kind == Record::Kind::text) {
+        out << record.text;
+    } else {
+        out << record.key;
+        for (double value : record.values)
+            out << ", " << value;
+        for (long long count : record.counts)
+            out << ", " << count;
+        out << '\n';
+    }
+    if (!out) {
+        std::lock_guard<std::mutex> lock(mutex);
+        note_failures();
+    }
+}
+
+void Output_writer::note_failures() {
+    for (size_t s = 0; s < streams.size(); s++)
+        if (streams[s]->fail() && errors[s].empty()) {
+            errors[s] = "Failed to write output file: " + paths[s];
+            streams[s]->clear();    // Reported once; the file may still take later writes
+        }
+}
+
+void Output_writer::writer_loop() {
+    Trace::set_thread_name("output writer");
+    size_t h = head.load(std::memory_order_relaxed);
+    while (true) {
+        if (h == tail.load(std::memory_order_acquire)) {
+            sleeping.store(true, std::memory_order_seq_cst);
+            std::unique_lock<std::mutex> lock(mutex);
+            wake_cv.wait(lock, [&] { return stopping || h != tail.load(std::memory_order_seq_cst); });
+            sleeping.store(false, std::memory_order_relaxed);
+            if (h == tail.load(std::memory_order_acquire))
+                return;         // Stopping with nothing left to write
+            continue;
+        }
+        {
+            TRACE_SCOPE("output_write");
+            write(ring[h & mask]);
+        }
+        head.store(++h, std::memory_order_release);
+    }
+}
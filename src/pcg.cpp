@@ -0,0 +1,115 @@
+#include "pcg.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+// q = A p over the CSC pattern
+void multiply(const Sparse_matrix<double>& A, const std::vector<double>& p, std::vector<double>& q) {
+    std::fill(q.begin(), q.end(), 0.0);
+    for (int j = 0; j < A.n; j++) {
+        double pj = p[j];
+        if (pj == 0.0)
+            continue;
+        for (int k = A.col_ptr[j]; k < A.col_ptr[j + 1]; k++)
+            q[A.row_idx[k]] += A.values[k] * pj;
+    }
+}
+
+double dot(const std::vector<double>& a, const std::vector<double>& b) {
+    double sum = 0.0;
+    for (size_t i = 0; i < a.size(); i++)
+        sum += a[i] * b[i];
+    return sum;
+}
+
+} // namespace
+
+Pcg::Pcg(int max_iter, double tolerance)
+    : preconditioner(Preconditioner::jacobi), max_iter(max_iter), tolerance(tolerance), converge_iters(0),
+      converged(false), residual(0.0) {}
+
+bool Pcg::solve(const Sparse_matrix<double>& A, const std::vector<double>& b, std::vector<double>& x) {
+    int n = A.n;
+    x.resize(n, 0.0);
+    r.resize(n);
+    z.resize(n);
+    p.resize(n);
+    q.resize(n);
+    inv_diag.assign(n, 0.0);
+    converge_iters = 0;
+    converged = false;
+
+    for (int j = 0; j < n; j++) {
+        int k = A.find(A.var_index[j], A.var_index[j]);
+        if (k < 0 || !(A.values[k] > 0.0))
+            throw std::runtime_error("Conjugate gradient needs a positive diagonal (row " +
+                                     std::to_string(A.var_index[j]) + ").");
+        inv_diag[j] = preconditioner == Preconditioner::jacobi ? 1.0 / A.values[k] : 1.0;
+    }
+
+    double b_norm = std::sqrt(dot(b, b));
+    if (b_norm == 0.0) {
+        std::fill(x.begin(), x.end(), 0.0);
+        residual = 0.0;
+        converged = true;
+        return true;
+    }
+
+    // r = b - A x (x is the caller's initial guess)
+    multiply(A, x, q);
+    for (int i = 0; i < n; i++)
+        r[i] = b[i] - q[i];
+    residual = std::sqrt(dot(r, r)) / b_norm;
+    if (residual <= tolerance) {
+        converged = true;
+        return true;
+    }
+    for (int i = 0; i < n; i++)
+        p[i] = z[i] = inv_diag[i] * r[i];
+    double rz = dot(r, z);
+
+    while (converge_iters < max_iter) {
+        cancellation.throw_if_cancelled();
+        converge_iters++;
+        multiply(A, p, q);
+        double pq = dot(p, q);
+        if (!(pq > 0.0))
+            break;                      // Not positive definite (or breakdown)
+        double alpha = rz / pq;
+        for (int i = 0; i < n; i++) {
+            x[i] += alpha * p[i];
+            r[i] -= alpha * q[i];
+        }
+        residual = std::sqrt(dot(r, r)) / b_norm;
+        if (residual <= tolerance) {
+            converged = true;
+            break;
+        }
+        for (int i = 0; i < n; i++)
+            z[i] = inv_diag[i] * r[i];
+        double rz_next = dot(r, z);
+        double beta = rz_next / rz;
+        rz = rz_next;
+        for (int i = 0; i < n; i++)
+            p[i] = z[i] + beta * p[i];
+    }
+    return converged;
+}
+
+void Pcg::print(std::ostream& os) const {
+    os << "Conjugate Gradient Configuration:" << std::endl;
+    os << std::string(40, '-') << std::endl;
+    os << "  Preconditioner: " << (preconditioner == Preconditioner::jacobi ? "Jacobi" : "None") << std::endl;
+    os << "  Max Iterations: " << max_iter << std::endl;
+    os << "  Tolerance: " << std::scientific << tolerance << std::endl;
+    os << std::endl;
+    os << "Conjugate Gradient Status:" << std::endl;
+    os << std::string(40, '-') << std::endl;
+    os << "  Converged: " << (converged ? "Yes" : "No") << std::endl;
+    os << "  Iterations Taken: " << converge_iters << std::endl;
+    os << "  Relative Residual: " << residual << std::endl;
+    os.unsetf(std::ios::floatfield);
+}
@@ -0,0 +1,277 @@
+#include "perf_counters.h"
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <iomanip>
+#include <limits>
+#include <mutex>
+#include <sstream>
+
+#ifdef __linux__
+#include <cerrno>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+std::atomic<bool> Perf_profile::enabled(false);
+
+namespace {
+
+constexpr double nan_value = std::numeric_limits<double>::quiet_NaN();
+constexpr double cache_line = 64.0;
+
+const char* event_names[Perf_counts::num_events] = {"cycles", "instructions", "cache-references", "cache-misses",
+                                                    "branch-misses"};
+
+double now_seconds() {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+struct Profile_state {
+    std::mutex mutex;
+    std::vector<std::pair<std::string, Perf_counts>> phases;
+    std::string status;         // Hardware counter status of the first measuring thread
+};
+
+Profile_state& profile() {
+    static Profile_state s;
+    return s;
+}
+
+#ifdef __linux__
+int open_event(uint64_t config, int group) {
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.size = sizeof(attr);
+    attr.config = config;
+    attr.disabled = group < 0 ? 1 : 0;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, group, 0));
+}
+#endif
+
+std::string format(double value, int precision) {
+    if (std::isnan(value))
+        return "n/a";
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(precision) << value;
+    return oss.str();
+}
+
+} // namespace
+
+// ============================================================
+//  Perf_counts
+// ============================================================
+
+double Perf_counts::ipc() const {
+    if (!measured[cycles] || !measured[instructions] || events[cycles] <= 0.0)
+        return nan_value;
+    return events[instructions] / events[cycles];
+}
+
+double Perf_counts::gflops() const {
+    return (flops > 0.0 && seconds > 0.0) ? flops / seconds * 1e-9 : nan_value;
+}
+
+double Perf_counts::bandwidth() const {
+    return (bytes > 0.0 && seconds > 0.0) ? bytes / seconds * 1e-9 : nan_value;
+}
+
+double Perf_counts::miss_bandwidth() const {
+    return (measured[cache_misses] && seconds > 0.0) ? events[cache_misses] * cache_line / seconds * 1e-9 : nan_value;
+}
+
+void Perf_counts::merge(const Perf_counts& other) {
+    calls += other.calls;
+    seconds += other.seconds;
+    for (int e = 0; e < num_events; e++) {
+        events[e] += other.events[e];
+        measured[e] = measured[e] || other.measured[e];
+    }
+    flops += other.flops;
+    bytes += other.bytes;
+}
+
+// ============================================================
+//  Perf_counters
+// ============================================================
+
+Perf_counters::Perf_counters() : num_open(0), leader(-1) {
+    for (int e = 0; e < Perf_counts::num_events; e++)
+        fds[e] = -1;
+#ifdef __linux__
+    const uint64_t configs[Perf_counts::num_events] = {PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+                                                       PERF_COUNT_HW_CACHE_REFERENCES, PERF_COUNT_HW_CACHE_MISSES,
+                                                       PERF_COUNT_HW_BRANCH_MISSES};
+    for (int e = 0; e < Perf_counts::num_events; e++) {
+        int fd = open_event(configs[e], leader);
+        if (fd < 0) {
+            if (leader < 0 && status.empty())
+                status = std::string("perf_event_open(") + event_names[e] + "): " + std::strerror(errno);
+            continue;
+        }
+        if (leader < 0)
+            leader = fd;
+        fds[e] = fd;
+        order[num_open++] = e;
+    }
+    if (leader >= 0) {
+        status.clear();
+        ioctl(leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        ioctl(leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    }
+#else
+    status = "hardware counters need Linux perf_event_open";
+#endif
+}
+
+Perf_counters::~Perf_counters() {
+#ifdef __linux__
+    for (int e = 0; e < Perf_counts::num_events; e++)
+        if (fds[e] >= 0)
+            close(fds[e]);
+#endif
+}
+
+Perf_counters::Reading Perf_counters::read() const {
+    Reading reading;
+#ifdef __linux__
+    if (leader >= 0) {
+        // Group format: nr, time_enabled, time_running, one value per event
+        uint64_t buffer[3 + Perf_counts::num_events];
+        ssize_t expected = static_cast<ssize_t>((3 + num_open) * sizeof(uint64_t));
+        if (::read(leader, buffer, sizeof(buffer)) == expected) {
+            reading.time_enabled = buffer[1];
+            reading.time_running = buffer[2];
+            for (int k = 0; k < num_open; k++)
+                reading.values[order[k]] = buffer[3 + k];
+        }
+    }
+#endif
+    reading.seconds = now_seconds();
+    return reading;
+}
+
+Perf_counts Perf_counters::elapsed(const Reading& begin, const Reading& end) const {
+    Perf_counts counts;
+    counts.calls = 1;
+    counts.seconds = end.seconds - begin.seconds;
+    uint64_t enabled = end.time_enabled - begin.time_enabled;
+    uint64_t running = end.time_running - begin.time_running;
+    // The kernel multiplexes groups that do not fit the PMU; scale to the full interval
+    double scale = (running > 0 && running < enabled) ? static_cast<double>(enabled) / running : 1.0;
+    for (int e = 0; e < Perf_counts::num_events; e++) {
+        counts.measured[e] = fds[e] >= 0 && running > 0;
+        if (counts.measured[e])
+            counts.events[e] = static_cast<double>(end.values[e] - begin.values[e]) * scale;
+    }
+    return counts;
+}
+
+Perf_counters& Perf_counters::local() {
+    thread_local Perf_counters counters;
+    return counters;
+}
+
+// ============================================================
+//  Perf_profile
+// ============================================================
+
+void Perf_profile::enable() {
+    Profile_state& s = profile();
+    {
+        std::lock_guard<std::mutex> lock(s.mutex);
+        s.phases.clear();
+        s.status = Perf_counters::local().get_status();
+    }
+    enabled.store(true, std::memory_order_release);
+}
+
+void Perf_profile::disable() {
+    enabled.store(false, std::memory_order_release);
+}
+
+void Perf_profile::add(const std::string& phase, const Perf_counts& counts) {
+    Profile_state& s = profile();
+    std::lock_guard<std::mutex> lock(s.mutex);
+    for (auto& [name, totals] : s.phases) {
+        if (name == phase) {
+            totals.merge(counts);
+            return;
+        }
+    }
+    s.phases.emplace_back(phase, counts);
+}
+
+std::vector<std::pair<std::string, Perf_counts>> Perf_profile::phases() {
+    Profile_state& s = profile();
+    std::lock_guard<std::mutex> lock(s.mutex);
+    return s.phases;
+}
+
+Perf_counts Perf_profile::get(const std::string& phase) {
+    Profile_state& s = profile();
+    std::lock_guard<std::mutex> lock(s.mutex);
+    for (const auto& [name, totals] : s.phases)
+        if (name == phase)
+            return totals;
+    return Perf_counts();
+}
+
+void Perf_profile::print(std::ostream& os) {
+    std::vector<std::pair<std::string, Perf_counts>> rows = phases();
+    std::string status;
+    {
+        Profile_state& s = profile();
+        std::lock_guard<std::mutex> lock(s.mutex);
+        status = s.status;
+    }
+
+    os << "\n========== Performance Counters ==========\n";
+    if (!status.empty())
+        os << "Hardware counters unavailable (" << status << "); time and work model only\n";
+    os << std::left << std::setw(14) << "Phase" << std::right << std::setw(8) << "Calls" << std::setw(12) << "Time (ms)"
+       << std::setw(7) << "IPC" << std::setw(11) << "Cache miss" << std::setw(12) << "Br miss/ki" << std::setw(10)
+       << "GFLOP/s" << std::setw(9) << "GB/s" << std::setw(11) << "Miss GB/s" << "\n";
+    os << std::string(94, '-') << "\n";
+    for (const auto& [name, c] : rows) {
+        double miss_rate = (c.measured[Perf_counts::cache_misses] && c.measured[Perf_counts::cache_references] &&
+                            c.events[Perf_counts::cache_references] > 0.0)
+                               ? 100.0 * c.events[Perf_counts::cache_misses] / c.events[Perf_counts::cache_references]
+                               : nan_value;
+        double branch_rate = (c.measured[Perf_counts::branch_misses] && c.measured[Perf_counts::instructions] &&
+                              c.events[Perf_counts::instructions] > 0.0)
+                                 ? 1000.0 * c.events[Perf_counts::branch_misses] / c.events[Perf_counts::instructions]
+                                 : nan_value;
+        os << std::left << std::setw(14) << name << std::right << std::setw(8) << c.calls << std::setw(12)
+           << format(c.seconds * 1e3, 3) << std::setw(7) << format(c.ipc(), 2) << std::setw(10)
+           << format(miss_rate, 1) << (std::isnan(miss_rate) ? " " : "%") << std::setw(12) << format(branch_rate, 2)
+           << std::setw(10) << format(c.gflops(), 3) << std::setw(9) << format(c.bandwidth(), 2) << std::setw(11)
+           << format(c.miss_bandwidth(), 2) << "\n";
+    }
+}
+
+// ============================================================
+//  Perf_scope
+// ============================================================
+
+Perf_scope::Perf_scope(const char* phase)
+    : phase(phase), counters(Perf_profile::is_enabled() ? &Perf_counters::local() : nullptr), flops(0.0), bytes(0.0) {
+    if (counters)
+        begin = counters->read();
+}
+
+Perf_scope::~Perf_scope() {
+    if (!counters)
+        return;
+    Perf_counts counts = counters->elapsed(begin, counters->read());
+    counts.flops = flops;
+    counts.bytes = bytes;
+    Perf_profile::add(phase, counts);
+}
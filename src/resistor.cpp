@@ -1,4 +1,6 @@
 #include "resistor.h"
+#include <cmath>
+#include <stdexcept>
 
 Resistor::Resistor( const std::string& id, Node* ni, Node* nj, double r) : Component(id, ni, nj), resistance(r) {}
 
@@ -34,4 +36,9 @@ Component_contribution<double> Resistor::get_contribution(){
         contribution.stampMatrix(nj->id, ni->id, -conductance);
     }
     return contribution;
-}
\ No newline at end of file
+}
+void Resistor::set_value(double value) {
+    if (!(value > 0) || !std::isfinite(value))
+        throw std::runtime_error("Resistor with ID " + componentId + " has non-positive or non-finite resistance.");
+    resistance = value;
+}
@@ -0,0 +1,189 @@
+#include "result_cache.h"
+#include "fingerprint.h"
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace {
+
+constexpr const char* dc_magic = "circuit_cache 1 dc";
+constexpr const char* ac_magic = "circuit_cache 1 ac";
+
+std::string hex(uint64_t value) {
+    std::ostringstream oss;
+    oss << std::hex << std::setw(16) << std::setfill('0') << value;
+    return oss.str();
+}
+
+// Space-separated layout line; unused indices are written as "-"
+std::string layout_line(const std::vector<std::string>& names) {
+    std::string line = "layout";
+    for (const std::string& name : names)
+        line += " " + (name.empty() ? std::string("-") : name);
+    return line;
+}
+
+} // namespace
+
+Result_cache::Result_cache(const std::string& directory) : hits(0), misses(0) {
+    set_directory(directory);
+}
+
+void Result_cache::set_directory(const std::string& directory) {
+    if (!directory.empty()) {
+        std::error_code ec;
+        std::filesystem::create_directories(directory, ec);
+        if (ec || !std::filesystem::is_directory(directory))
+            throw std::runtime_error("Failed to create result cache directory: " + directory);
+    }
+    this->directory = directory;
+}
+
+std::string Result_cache::entry_path(const Circuit& circuit, uint64_t solver, const std::string& suffix) const {
+    return (std::filesystem::path(directory) /
+            (hex(circuit.topology_hash()) + "_" + hex(circuit.values_hash()) + "_" + hex(solver) + suffix)).string();
+}
+
+std::vector<std::string> Result_cache::variable_names(const Circuit& circuit) {
+    int size = 1;
+    for (const auto& [id, name] : circuit.get_nodeId_map())
+        size = std::max(size, id + 1);
+    for (const auto& [id, name] : circuit.get_extraVarId_map())
+        size = std::max(size, id + 1);
+    std::vector<std::string> names(size);
+    names[0] = "0";
+    for (const auto& [id, name] : circuit.get_nodeId_map())
+        names[id] = "V(" + name + ")";
+    for (const auto& [id, name] : circuit.get_extraVarId_map())
+        names[id] = name;
+    return names;
+}
+
+void Result_cache::write_entry(const std::string& path, const std::string& content) {
+    std::string tmp = path + ".tmp";
+    {
+        std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+        if (!out.is_open())
+            throw std::runtime_error("Failed to write result cache entry: " + path);
+        out << content;
+        if (!out)
+            throw std::runtime_error("Failed to write result cache entry: " + path);
+    }
+    std::error_code ec;
+    std::filesystem::rename(tmp, path, ec);
+    if (ec) {
+        std::filesystem::remove(tmp, ec);
+        throw std::runtime_error("Failed to write result cache entry: " + path);
+    }
+}
+
+// ============================================================
+//  DC solutions
+// ============================================================
+
+bool Result_cache::load_dc(const Circuit& circuit, uint64_t solver, std::vector<double>& solution) {
+    if (!enabled())
+        return false;
+    std::ifstream in(entry_path(circuit, solver, ".dc"));
+    std::string magic;
+    if (!in.is_open() || !std::getline(in, magic) || magic != dc_magic) {
+        misses++;
+        return false;
+    }
+
+    std::vector<std::string> names = variable_names(circuit);
+    std::unordered_map<std::string, int> index;
+    for (size_t i = 1; i < names.size(); i++)
+        if (!names[i].empty())
+            index[names[i]] = static_cast<int>(i);
+
+    std::vector<double> restored(names.size(), 0.0);
+    size_t count = 0;
+    std::string name;
+    double value;
+    while (in >> name >> value) {
+        auto it = index.find(name);
+        if (it == index.end()) {
+            misses++;
+            return false;
+        }
+        restored[it->second] = value;
+        count++;
+    }
+    if (!in.eof() || count != index.size()) {
+        misses++;
+        return false;
+    }
+    solution.swap(restored);
+    hits++;
+    return true;
+}
+
+void Result_cache::store_dc(const Circuit& circuit, uint64_t solver, const std::vector<double>& solution) {
+    if (!enabled())
+        return;
+    std::vector<std::string> names = variable_names(circuit);
+    std::ostringstream oss;
+    oss << dc_magic << "\n" << std::setprecision(17);
+    for (size_t i = 1; i < names.size() && i < solution.size(); i++)
+        if (!names[i].empty())
+            oss << names[i] << " " << solution[i] << "\n";
+    write_entry(entry_path(circuit, solver, ".dc"), oss.str());
+}
+
+// ============================================================
+//  AC sweeps
+// ============================================================
+
+uint64_t Result_cache::sweep_key(double freq1, double freq2, double step, bool log_scale) {
+    Fingerprint fp;
+    fp.add(freq1);
+    fp.add(freq2);
+    fp.add(step);
+    fp.add(static_cast<uint64_t>(log_scale));
+    return fp.value();
+}
+
+bool Result_cache::load_ac(const Circuit& circuit, uint64_t solver, uint64_t sweep, const std::string& output_file) {
+    if (!enabled())
+        return false;
+    std::ifstream in(entry_path(circuit, solver, "_" + hex(sweep) + ".ac"), std::ios::binary);
+    std::string magic, layout;
+    if (!in.is_open() || !std::getline(in, magic) || magic != ac_magic ||
+        !std::getline(in, layout) || layout != layout_line(variable_names(circuit))) {
+        misses++;
+        return false;
+    }
+    std::ofstream out(output_file, std::ios::binary | std::ios::trunc);
+    if (!out.is_open())
+        throw std::runtime_error("Failed to open AC analysis output file: " + output_file);
+    out << in.rdbuf();
+    hits++;
+    return true;
+}
+
+void Result_cache::store_ac(const Circuit& circuit, uint64_t solver, uint64_t sweep, const std::string& output_file) {
+    if (!enabled())
+        return;
+    std::ifstream in(output_file, std::ios::binary);
+    if (!in.is_open())
+        throw std::runtime_error("Failed to read AC analysis output file: " + output_file);
+    std::ostringstream oss;
+    oss << ac_magic << "\n" << layout_line(variable_names(circuit)) << "\n" << in.rdbuf();
+    write_entry(entry_path(circuit, solver, "_" + hex(sweep) + ".ac"), oss.str());
+}
+
+void Result_cache::print(std::ostream& os) const {
+    os << "Result Cache:" << std::endl;
+    os << std::string(40, '-') << std::endl;
+    if (!enabled()) {
+        os << "  Disabled" << std::endl;
+        return;
+    }
+    os << "  Directory: " << directory << std::endl;
+    os << "  Hits: " << hits << std::endl;
+    os << "  Misses: " << misses << std::endl;
+}
@@ -0,0 +1,307 @@
+#include "server.h"
+#include "circuit_builder.h"
+#include "circuit_image.h"
+#include "frequency_sweep.h"
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#ifndef _WIN32
+#include <csignal>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+// The whole token must be a number; the error names the argument instead of echoing "stod"
+double parse_number(const std::string& text, const char* what) {
+    size_t used = 0;
+    double value = 0.0;
+    try {
+        value = std::stod(text, &used);
+    } catch (const std::logic_error&) {
+        used = 0;
+    }
+    if (used == 0 || used != text.size())
+        throw std::invalid_argument(std::string("Invalid ") + what + " '" + text + "', expected a number.");
+    return value;
+}
+
+} // namespace
+
+Server::Server() : stopping(false) {}
+
+// Names become file names (<name>_ac.csv), so they may not contain separators or dots
+bool Server::valid_name(const std::string& name) {
+    return !name.empty() && std::all_of(name.begin(), name.end(), [](char c) {
+        return std::isalnum(static_cast<unsigned char>(c)) || c == '_' || c == '-';
+    });
+}
+
+// Frequency_sweep guarantees the sweep ends; the cap keeps one client line from occupying the server for long
+void Server::check_sweep(double freq1, double freq2, double step, bool log_scale) {
+    if (Frequency_sweep(freq1, freq2, step, log_scale).estimated_points() > static_cast<double>(max_ac_points))
+        throw std::invalid_argument("Frequency sweep too long: at most " + std::to_string(max_ac_points) +
+                                    " points per request.");
+}
+
+Server::Session& Server::session(const std::string& name) {
+    auto it = sessions.find(name);
+    if (it == sessions.end())
+        throw std::runtime_error("No circuit named " + name + " is loaded.");
+    return it->second;
+}
+
+void Server::ensure_solved(Session& s) {
+    if (!s.solved) {
+        s.simulator->run_dc_analysis(*s.circuit);
+        s.solved = true;
+    }
+}
+
+std::string Server::handle(const std::string& line) {
+    std::istringstream iss(line);
+    std::vector<std::string> args;
+    std::string token;
+    while (iss >> token)
+        args.push_back(token);
+    if (args.empty())
+        return "";
+
+    std::ostringstream response;
+    response << std::setprecision(15);
+    const std::string& command = args[0];
+    auto expect = [&](size_t min_args, size_t max_args, const char* usage) {
+        if (args.size() < min_args || args.size() > max_args)
+            throw std::invalid_argument(std::string("Usage: ") + usage);
+    };
+    try {
+        if (command == "load") {
+            expect(3, 3, "load <name> <file>");
+            if (!valid_name(args[1]))
+                throw std::invalid_argument("Invalid circuit name " + args[1] + ", use letters, digits, _ and -.");
+            Session s;
+            {
+                // Every resident circuit has its own MNA numbering starting at ground = 0
+                Node::Numbering_scope numbering;
+                s.circuit.reset(new Circuit(args[1]));
+                if (Circuit_image::is_image(args[2])) {
+                    Circuit_image::load(*s.circuit, args[2]);
+                } else {
+                    CircuitBuilder().build(*s.circuit, args[2]);
+                    s.circuit->assemble_MNA_system();
+                }
+            }
+            s.simulator.reset(new Simulator(args[1] + "_ac.csv"));
+            s.simulator->set_solver_method(Solver::Method::sparse_lu);
+            response << "OK " << s.circuit->get_nodes().size() - 1 << " " << s.circuit->get_components().size();
+            sessions[args[1]] = std::move(s);
+        } else if (command == "set") {
+            expect(4, 4, "set <name> <component> <value>");
+            Session& s = session(args[1]);
+            s.simulator->update_component(*s.circuit, args[2], parse_number(args[3], "value"));
+            s.solved = true;
+            response << "OK";
+        } else if (command == "dc") {
+            expect(2, 2, "dc <name>");
+            ensure_solved(session(args[1]));
+            response << "OK";
+        } else if (command == "ac") {
+            expect(5, 6, "ac <name> <f1> <f2> <step> [log]");
+            if (args.size() == 6 && args[5] != "log")
+                throw std::invalid_argument("Usage: ac <name> <f1> <f2> <step> [log]");
+            double freq1 = parse_number(args[2], "f1");
+            double freq2 = parse_number(args[3], "f2");
+            double step = parse_number(args[4], "step");
+            bool log_scale = args.size() == 6;
+            check_sweep(freq1, freq2, step, log_scale);
+            Session& s = session(args[1]);
+            ensure_solved(s);
+            s.simulator->run_ac_analysis(*s.circuit, freq1, freq2, step, log_scale);
+            response << "OK " << args[1] << "_ac.csv";
+        } else if (command == "probe") {
+            expect(3, static_cast<size_t>(-1), "probe <name> <V(node)|I(component)>...");
+            Session& s = session(args[1]);
+            ensure_solved(s);
+            response << "OK";
+            for (size_t k = 2; k < args.size(); k++) {
+                const std::string& probe = args[k];
+                if (probe.size() < 4 || probe[1] != '(' || probe.back() != ')')
+                    throw std::invalid_argument("Malformed probe " + probe + ", expected V(node) or I(component).");
+                std::string target = probe.substr(2, probe.size() - 3);
+                char kind = static_cast<char>(std::toupper(static_cast<unsigned char>(probe[0])));
+                if (kind == 'V') {
+                    auto it = s.circuit->get_nodes().find(target);
+                    if (it == s.circuit->get_nodes().end())
+                        throw std::runtime_error("Unknown node " + target + ".");
+                    response << " " << it->second->voltage;
+                } else if (kind == 'I') {
+                    auto it = s.circuit->get_components().find(target);
+                    if (it == s.circuit->get_components().end())
+                        throw std::runtime_error("Unknown component " + target + ".");
+                    response << " " << it->second->get_current();
+                } else {
+                    throw std::invalid_argument("Malformed probe " + probe + ", expected V(node) or I(component).");
+                }
+            }
+        } else if (command == "unload") {
+            expect(2, 2, "unload <name>");
+            session(args[1]);
+            sessions.erase(args[1]);
+            response << "OK";
+        } else if (command == "list") {
+            expect(1, 1, "list");
+            response << "OK";
+            for (const auto& [name, s] : sessions)
+                response << " " << name;
+        } else if (command == "quit") {
+            response << "OK";
+        } else if (command == "shutdown") {
+            stopping = true;
+            response << "OK";
+        } else {
+            throw std::invalid_argument("Unknown command " + command + ".");
+        }
+    } catch (const std::exception& e) {
+        return std::string("ERR ") + e.what();
+    }
+    return response.str();
+}
+
+void Server::serve(std::istream& in, std::ostream& out) {
+    std::string line;
+    while (!stopping && std::getline(in, line)) {
+        std::string response = handle(line);
+        if (response.empty())
+            continue;
+        out << response << std::endl;
+        std::istringstream iss(line);
+        std::string command;
+        iss >> command;
+        if (command == "quit")
+            break;
+    }
+}
+
+#ifdef _WIN32
+
+void Server::serve_socket(const std::string&) {
+    throw std::runtime_error("UNIX domain sockets are not supported on this platform; use the stdin/stdout server.");
+}
+
+#else
+
+namespace {
+
+#ifdef MSG_NOSIGNAL
+const int send_flags = MSG_NOSIGNAL;
+#else
+const int send_flags = 0;  // SIGPIPE is ignored in serve_socket instead
+#endif
+
+// A client that disconnects early fails the send (EPIPE) instead of raising SIGPIPE
+bool write_all(int fd, const std::string& data) {
+    size_t sent = 0;
+    while (sent < data.size()) {
+        ssize_t n = ::send(fd, data.data() + sent, data.size() - sent, send_flags);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            return false;
+        sent += static_cast<size_t>(n);
+    }
+    return true;
+}
+
+ssize_t read_some(int fd, char* buffer, size_t size) {
+    ssize_t n;
+    do {
+        n = ::read(fd, buffer, size);
+    } while (n < 0 && errno == EINTR);
+    return n;
+}
+
+// Out of descriptors or kernel memory: the condition clears as other processes release them
+bool transient_accept_error(int error) {
+    return error == EMFILE || error == ENFILE || error == ENOBUFS || error == ENOMEM;
+}
+
+} // namespace
+
+void Server::serve_socket(const std::string& path) {
+    sockaddr_un address{};
+    if (path.size() >= sizeof(address.sun_path))
+        throw std::runtime_error("Socket path is too long: " + path);
+    address.sun_family = AF_UNIX;
+    std::copy(path.begin(), path.end(), address.sun_path);
+#ifndef MSG_NOSIGNAL
+    std::signal(SIGPIPE, SIG_IGN);
+#endif
+
+    int listener = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listener < 0)
+        throw std::runtime_error("Could not create socket: " + path);
+    ::unlink(path.c_str());
+    // Only the owner may connect: the socket file is created with mode 0600
+    mode_t mask = ::umask(0177);
+    bool bound = ::bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0;
+    ::umask(mask);
+    if (!bound || ::chmod(path.c_str(), 0600) != 0 || ::listen(listener, 8) != 0) {
+        ::close(listener);
+        throw std::runtime_error("Could not listen on socket: " + path);
+    }
+
+    while (!stopping) {
+        int connection = ::accept(listener, nullptr, nullptr);
+        if (connection < 0) {
+            int error = errno;
+            if (error == EINTR || error == ECONNABORTED)
+                continue;
+            if (transient_accept_error(error)) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(100));
+                continue;
+            }
+            ::close(listener);
+            ::unlink(path.c_str());
+            throw std::runtime_error("Could not accept connections on socket: " + path);
+        }
+        std::string pending;
+        char buffer[4096];
+        bool open = true;
+        while (open && !stopping) {
+            ssize_t n = read_some(connection, buffer, sizeof(buffer));
+            if (n <= 0)
+                break;
+            pending.append(buffer, static_cast<size_t>(n));
+            size_t newline;
+            while (open && !stopping && (newline = pending.find('\n')) != std::string::npos) {
+                std::string line = pending.substr(0, newline);
+                pending.erase(0, newline + 1);
+                if (!line.empty() && line.back() == '\r')
+                    line.pop_back();
+                std::string response = handle(line);
+                if (!response.empty())
+                    open = write_all(connection, response + "\n");
+                std::istringstream iss(line);
+                std::string command;
+                iss >> command;
+                if (command == "quit")
+                    open = false;
+            }
+        }
+        ::close(connection);
+    }
+    ::close(listener);
+    ::unlink(path.c_str());
+}
+
+#endif
@@ -1,46 +1,190 @@
 #include "simulator.h"
+#include "batch_lu.h"
+#include "frequency_sweep.h"
+#include "trace.h"
+#include <algorithm>
 
-Simulator::Simulator(const std::string& ac_output_file) : solver(ac_output_file){}
+Simulator::Simulator(const std::string& ac_output_file) : solver(ac_output_file), dc_cached(false) {}
 
 void Simulator::run_dc_analysis(Circuit& circuit) {
     const auto& mna_matrix = circuit.get_MNA_matrix();
     const auto& mna_vector = circuit.get_MNA_vector();
     
-    solver.solve_MNA_system(mna_matrix, mna_vector, solution);
+    // The tuned configuration is part of the cache key, so it is applied first
+    tuner.prepare(circuit, solver);
+    dc_cached = result_cache.load_dc(circuit, solver.configuration_key(), solution);
+    if (!dc_cached) {
+        solver.solve_MNA_system(mna_matrix, mna_vector, solution);
+        if (solver.is_converged())
+            result_cache.store_dc(circuit, solver.configuration_key(), solution);
+    }
     circuit.deploy_dc_solution(solution);
 }
 
-void Simulator::run_ac_analysis(Circuit& circuit, double freq1, double freq2, double step, bool log_scale) {
-    if (freq1 <= 0)
-        throw std::invalid_argument("Invalid start frequency: freq1 must be positive.");
+int Simulator::run_batch(const std::vector<Circuit*>& circuits) {
+    TRACE_SCOPE("batch_dc");
+    constexpr int W = batch_lu_lanes;
+    struct Member {
+        Circuit* circuit;
+        std::vector<double> values, rhs;    // Matrix values (pattern order) and compact RHS
+    };
+    struct Group {
+        Sparse_matrix<double> pattern;      // First member's system, the pivoting representative
+        std::vector<Member> members;
+    };
 
-    if (freq2 < freq1)
-        throw std::invalid_argument("Invalid end frequency: freq2 must be greater than or equal to freq1.");
+    // Circuits sharing a small sparsity pattern are grouped in input order; the rest are solved one by one
+    std::vector<Group> groups;
+    std::vector<Circuit*> scalar;
+    Sparse_matrix<double> A;
+    for (Circuit* circuit : circuits) {
+        A.assemble(circuit->get_MNA_matrix());
+        if (A.n == 0 || A.n > batch_lu_max_size) {
+            scalar.push_back(circuit);
+            continue;
+        }
+        auto group = std::find_if(groups.begin(), groups.end(), [&](const Group& g) { return g.pattern.same_pattern(A); });
+        if (group == groups.end())
+            group = groups.insert(groups.end(), Group{A, {}});
+        Member member{circuit, A.values, {}};
+        A.gather(circuit->get_MNA_vector(), member.rhs);
+        group->members.push_back(std::move(member));
+    }
+
+    int batched = 0;
+    Batch_lu<W> batch;
+    std::vector<double> values, b, x;
+    for (Group& group : groups) {
+        const Sparse_matrix<double>& P = group.pattern;
+        bool analyzed = group.members.size() > 1;
+        if (analyzed) {
+            try {
+                batch.analyze(P);
+            } catch (const std::runtime_error&) {
+                analyzed = false;           // Singular representative: Sparse_lu regularizes it
+            }
+        }
+        if (!analyzed) {
+            for (const Member& member : group.members)
+                scalar.push_back(member.circuit);
+            continue;
+        }
+        values.resize(static_cast<size_t>(P.nnz()) * W);
+        b.resize(static_cast<size_t>(P.n) * W);
+        x.resize(P.n);
+        // Members [m0, m0 + count) in lanes; a short last group repeats its last member
+        for (size_t m0 = 0; m0 < group.members.size(); m0 += W) {
+            size_t count = std::min(group.members.size() - m0, static_cast<size_t>(W));
+            for (int l = 0; l < W; l++) {
+                const Member& member = group.members[m0 + std::min(static_cast<size_t>(l), count - 1)];
+                for (int p = 0; p < P.nnz(); p++)
+                    values[static_cast<size_t>(p) * W + l] = member.values[p];
+                for (int k = 0; k < P.n; k++)
+                    b[static_cast<size_t>(k) * W + l] = member.rhs[k];
+            }
+            try {
+                batch.factorize(values);
+            } catch (const std::runtime_error&) {
+                for (size_t m = m0; m < m0 + count; m++)
+                    scalar.push_back(group.members[m].circuit);
+                continue;
+            }
+            batch.solve(b);
+            for (size_t l = 0; l < count; l++) {
+                Circuit& circuit = *group.members[m0 + l].circuit;
+                for (int k = 0; k < P.n; k++)
+                    x[k] = b[k * W + l];
+                solution.assign(circuit.get_MNA_matrix().size() + 1, 0.0);
+                P.scatter(x, solution);
+                circuit.deploy_dc_solution(solution);
+                batched++;
+            }
+        }
+    }
+    dc_cached = false;
+    for (Circuit* circuit : scalar)
+        run_dc_analysis(*circuit);
+    return batched;
+}
+
+void Simulator::update_component(Circuit& circuit, const std::string& id, double value) {
+    Component_contribution<double> delta = circuit.set_component_value(id, value);
+    solver.update_MNA_system(circuit.get_MNA_matrix(), circuit.get_MNA_vector(), delta, solution);
+    dc_cached = false;
+    circuit.deploy_dc_solution(solution);
+}
+
+void Simulator::run_monte_carlo(Circuit& circuit, int num_samples, uint64_t seed) {
+    monte_carlo = Monte_carlo(num_samples, seed);
+    monte_carlo.run(circuit, solver.get_thread_pool());
+}
+
+void Simulator::run_ac_analysis(Circuit& circuit, double freq1, double freq2, double step, bool log_scale) {
+    Frequency_sweep(freq1, freq2, step, log_scale);     // Validates before the cache is consulted
 
-    if(step <= 0)
-        throw std::invalid_argument("Invalid frequency step: step must be positive.");
-    
     const auto& mna_matrix = circuit.get_MNA_matrix();
     const auto& extra_vars = circuit.get_extraVarId_map();
     const auto& ac_components = circuit.get_ac_components();
 
+    uint64_t sweep = Result_cache::sweep_key(freq1, freq2, step, log_scale);
+    if (result_cache.load_ac(circuit, solver.configuration_key(), sweep, solver.get_ac_output_file()))
+        return;
     solver.assemble_ac_system(mna_matrix, extra_vars, solution);
     solver.solve_ac_system(ac_components, freq1, freq2, step, log_scale);
+    if (solver.is_ac_converged())
+        result_cache.store_ac(circuit, solver.configuration_key(), sweep, solver.get_ac_output_file());
 }
 
 void Simulator::run_ac_analysis(Circuit& circuit, double frequency) {
     run_ac_analysis(circuit, frequency, frequency, 1.0);
 }
 
+// ============================================================
+//  Asynchronous analyses
+// ============================================================
+
+std::future<Dc_result> Simulator::run_dc_analysis_async(std::shared_ptr<const Compiled_circuit> circuit,
+                                                        const Cancellation_token& token) {
+    return Executor::global()->submit([circuit, token]() { return circuit->solve_dc(token); });
+}
+
+std::future<Dc_result> Simulator::run_dc_analysis_async(const Circuit& circuit, const Cancellation_token& token) {
+    return run_dc_analysis_async(Compiled_circuit::compile(circuit), token);
+}
+
+std::future<Ac_result> Simulator::run_ac_analysis_async(std::shared_ptr<const Compiled_circuit> circuit,
+                                                        double freq1, double freq2, double step, bool log_scale,
+                                                        const Cancellation_token& token, Progress_callback progress) {
+    return Executor::global()->submit([=, progress = std::move(progress)]() {
+        return circuit->solve_ac(freq1, freq2, step, log_scale, token, progress);
+    });
+}
+
+std::future<Ac_result> Simulator::run_ac_analysis_async(const Circuit& circuit,
+                                                        double freq1, double freq2, double step, bool log_scale,
+                                                        const Cancellation_token& token, Progress_callback progress) {
+    return run_ac_analysis_async(Compiled_circuit::compile(circuit), freq1, freq2, step, log_scale, token,
+                                 std::move(progress));
+}
+
 void Simulator::print(std::ostream& os) const {
     if(solution.empty()) {
         os << "No solution available. Please run DC analysis first." << std::endl;
         return;
     }
-    os << solver << std::endl;
+    if (dc_cached)
+        os << "DC solution loaded from the result cache." << std::endl << std::endl;
+    else
+        os << solver << std::endl;
+    if (result_cache.enabled())
+        os << result_cache << std::endl;
+    if (tuner.enabled())
+        os << tuner << std::endl;
     os << "DC Raw Solution:" << std::endl;
     os << std::string(40, '-') << std::endl;
     for (size_t i = 0; i < solution.size(); i++) {
         os << "x[ " << i << std::setw(2) << " ]" << std::setw(2) << " = " << solution[i] << std::endl;
     }
+    if (!monte_carlo.get_stats().empty())
+        os << std::endl << monte_carlo;
 }
\ No newline at end of file
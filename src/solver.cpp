@@ -1,18 +1,288 @@
 #include "solver.h"
+#include <algorithm>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include "fingerprint.h"
+#include "frequency_sweep.h"
+#include "memory_accounting.h"
+#include "trace.h"
 
 Solver::Solver(const std::string& ac_output_file, int max_iter, double tolerance, double damping_factor)
-    : gauss_seidel(max_iter, tolerance, damping_factor),
+    : method(Method::automatic),
+      dc_method(Method::automatic),
+      threads_set(false),
+      ordering_set(false),
+      gauss_seidel(max_iter, tolerance, damping_factor),
       gauss_seidel_ac(max_iter, tolerance, damping_factor),
-      ac_analyzer(ac_output_file),
+      dc_dense(false),
+      ac_converged(true),
+      telemetry(nullptr),
+      ac_analyzer(output_writer, ac_output_file),
       duration(0), ac_duration(0) {}
 
+void Solver::set_dense_max_size(int size) {
+    dense.set_max_size(size);
+    dense_ac.set_max_size(size);
+}
+
+const char* Solver::method_name(Method m) {
+    switch (m) {
+        case Method::gauss_seidel: return "Gauss-Seidel";
+        case Method::sparse_lu: return "Sparse LU";
+        case Method::pcg: return "Conjugate Gradient";
+        case Method::automatic: return "Automatic";
+    }
+    return "unknown";
+}
+
+void Solver::set_num_threads(int num_threads) {
+    threads_set = true;
+    apply_num_threads(num_threads);
+}
+
+void Solver::apply_num_threads(int num_threads) {
+    if ((thread_pool ? thread_pool->size() : 1) == num_threads && num_threads != 0)
+        return;
+    sparse_lu.set_thread_pool(nullptr);
+    sparse_lu_ac.set_thread_pool(nullptr);
+    thread_pool.reset(num_threads == 1 ? nullptr : new Thread_pool(num_threads));
+    sparse_lu.set_thread_pool(thread_pool.get());
+    sparse_lu_ac.set_thread_pool(thread_pool.get());
+}
+
+void Solver::set_ordering(Ordering::Method ordering) {
+    ordering_set = true;
+    sparse_lu.set_ordering(ordering);
+    sparse_lu_ac.set_ordering(ordering);
+}
+
+void Solver::set_gauss_seidel(int max_iter, double tolerance, double damping_factor) {
+    gauss_seidel.configure(max_iter, tolerance, damping_factor);
+    gauss_seidel_ac.configure(max_iter, tolerance, damping_factor);
+}
+
+void Solver::configure(const Configuration& config) {
+    if (config.method == Method::automatic)
+        throw std::invalid_argument("A solver configuration needs an explicit method.");
+    gauss_seidel.configure(gauss_seidel.max_iter, gauss_seidel.tolerance, config.damping);
+    gauss_seidel_ac.configure(gauss_seidel_ac.max_iter, gauss_seidel_ac.tolerance, config.damping);
+    set_method(config.method);
+    set_ordering(config.ordering);
+    int cores = static_cast<int>(std::thread::hardware_concurrency());
+    set_num_threads(cores > 0 ? std::max(1, std::min(config.threads, cores)) : std::max(1, config.threads));
+    pcg.set_preconditioner(config.preconditioner);
+}
+
+Solver::Settings Solver::settings() const {
+    Settings saved;
+    saved.config.method = method;
+    saved.config.ordering = sparse_lu.get_ordering();
+    saved.config.threads = thread_pool ? thread_pool->size() : 1;
+    saved.config.damping = gauss_seidel.damping_factor;
+    saved.config.preconditioner = pcg.get_preconditioner();
+    saved.ac_ordering = sparse_lu_ac.get_ordering();
+    saved.threads_set = threads_set;
+    saved.ordering_set = ordering_set;
+    return saved;
+}
+
+void Solver::restore(const Settings& saved) {
+    gauss_seidel.configure(gauss_seidel.max_iter, gauss_seidel.tolerance, saved.config.damping);
+    gauss_seidel_ac.configure(gauss_seidel_ac.max_iter, gauss_seidel_ac.tolerance, saved.config.damping);
+    set_method(saved.config.method);
+    sparse_lu.set_ordering(saved.config.ordering);
+    sparse_lu_ac.set_ordering(saved.ac_ordering);
+    ordering_set = saved.ordering_set;
+    apply_num_threads(saved.config.threads);
+    threads_set = saved.threads_set;
+    pcg.set_preconditioner(saved.config.preconditioner);
+}
+
+uint64_t Solver::configuration_key() const {
+    Fingerprint fp;
+    fp.add(static_cast<uint64_t>(method));
+    fp.add(static_cast<uint64_t>(gauss_seidel.max_iter));
+    fp.add(gauss_seidel.tolerance);
+    fp.add(gauss_seidel.damping_factor);
+    return fp.value();
+}
+
+void Solver::set_telemetry(Solver_telemetry* telemetry) {
+    this->telemetry = telemetry;
+    gauss_seidel.set_telemetry(telemetry);
+    gauss_seidel_ac.set_telemetry(telemetry);
+}
+
+void Solver::set_cancellation(const Cancellation_token& token) {
+    cancellation = token;
+    gauss_seidel.set_cancellation(token);
+    gauss_seidel_ac.set_cancellation(token);
+    sparse_lu.set_cancellation(token);
+    sparse_lu_ac.set_cancellation(token);
+    pcg.set_cancellation(token);
+}
+
+namespace {
+
+size_t stored_entries(const std::unordered_map<int,std::unordered_map<int,double>>& mna_matrix) {
+    size_t entries = 0;
+    for (const auto& row : mna_matrix)
+        entries += row.second.size();
+    return entries;
+}
+
+} // namespace
+
+const Solver::Selection& Solver::analyze(const std::unordered_map<int,std::unordered_map<int,double>>& mna_matrix) {
+    TRACE_SCOPE("solver_select");
+    Memory_scope memory(Memory_tag::solver);
+    dc_matrix.assemble(mna_matrix);
+    const System_structure s = System_structure::analyze(dc_matrix);
+
+    Selection chosen;
+    chosen.valid = true;
+    chosen.structure = s;
+    chosen.rows = mna_matrix.size();
+    chosen.entries = stored_entries(mna_matrix);
+    std::ostringstream reason;
+    if (method != Method::automatic) {
+        chosen.method = method;
+        reason << "selected explicitly";
+    } else if (s.dimension <= dense.get_max_size()) {
+        chosen.method = Method::sparse_lu;
+        reason << s.dimension << " unknowns: dense fast path (sparse LU if singular)";
+    } else if (s.forest) {
+        chosen.method = Method::sparse_lu;
+        chosen.ordering = Ordering::Method::minimum_degree;
+        reason << "tree-shaped system: sparse LU with minimum degree factors without fill";
+    } else if (s.zero_diagonals > 0) {
+        chosen.method = Method::sparse_lu;
+        reason << s.zero_diagonals << " zero diagonal(s) from voltage sources or inductors: sparse LU";
+    } else if (s.spd() && s.dimension >= pcg_min_size && s.mean_degree >= pcg_min_degree) {
+        chosen.method = Method::pcg;
+        reason << "symmetric positive definite mesh with " << s.mean_degree
+               << " neighbours per row: conjugate gradient avoids LU fill";
+    } else if (s.dominance == 1.0 && s.dominance_margin >= 2.0) {
+        chosen.method = Method::gauss_seidel;
+        reason << "every row diagonally dominant by a factor of " << s.dominance_margin << ": Gauss-Seidel";
+    } else {
+        chosen.method = Method::sparse_lu;
+        reason << (s.spd() ? "symmetric positive definite but sparse enough for LU"
+                           : "not diagonally dominant: sparse LU");
+    }
+
+    if (method == Method::automatic && chosen.method == Method::sparse_lu && s.dimension >= parallel_min_size)
+        chosen.threads = std::max(1, std::min(8, static_cast<int>(std::thread::hardware_concurrency())));
+    if (!threads_set && method == Method::automatic) {
+        apply_num_threads(chosen.threads);
+        if (chosen.threads > 1)
+            reason << ", " << chosen.threads << " threads";
+    } else {
+        chosen.threads = thread_pool ? thread_pool->size() : 1;
+    }
+    if (!ordering_set && method == Method::automatic)
+        sparse_lu.set_ordering(chosen.ordering);
+    else
+        chosen.ordering = sparse_lu.get_ordering();
+    chosen.reason = reason.str();
+    selection = std::move(chosen);
+    return selection;
+}
+
 // Dc solver
 void Solver::solve_MNA_system(const std::unordered_map<int,std::unordered_map<int,double>>& mna_matrix,
                               const std::unordered_map<int, double>& mna_vector,
                               std::vector<double>& solution) {
+    TRACE_SCOPE("dc_solve");
+    Memory_scope memory(Memory_tag::solver);
     solution.resize(mna_matrix.size()+1, 0.0);
     std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
-    gauss_seidel.solve(mna_matrix, mna_vector, solution);
+    // Under automatic selection tiny non-singular systems are solved on the stack; an explicit method always runs
+    dc_dense = false;
+    if (method == Method::automatic) {
+        TRACE_SCOPE("dense_lu");
+        dc_dense = dense.solve(mna_matrix, mna_vector, solution);
+    }
+    if (!dc_dense && method == Method::automatic &&
+        (!selection.valid || selection.rows != mna_matrix.size() || selection.entries != stored_entries(mna_matrix)))
+        analyze(mna_matrix);
+    dc_method = dc_dense ? Method::automatic : active_method();
+    if (dc_method == Method::pcg) {
+        TRACE_SCOPE("pcg");
+        dc_matrix.assemble(mna_matrix);
+        dc_matrix.gather(mna_vector, dc_rhs);
+        dc_x.resize(dc_matrix.n);
+        for (int i = 0; i < dc_matrix.n; i++)
+            dc_x[i] = solution[dc_matrix.var_index[i]];     // Warm start from the previous solution
+        if (pcg.solve(dc_matrix, dc_rhs, dc_x)) {
+            dc_matrix.scatter(dc_x, solution);
+        } else {
+            selection.method = dc_method = Method::sparse_lu;
+            selection.reason += "; conjugate gradient did not converge in " + std::to_string(pcg.get_iterations()) +
+                                " iterations, switched to sparse LU";
+        }
+    }
+    if (dc_method == Method::sparse_lu) {
+        dc_matrix.assemble(mna_matrix);
+        sparse_lu.factorize(dc_matrix);
+        dc_matrix.gather(mna_vector, dc_rhs);
+        sparse_lu.solve(dc_rhs);
+        dc_matrix.scatter(dc_rhs, solution);
+    } else if (dc_method == Method::gauss_seidel) {
+        TRACE_SCOPE("gauss_seidel");
+        if (telemetry)
+            telemetry->set_frequency(0.0);
+        gauss_seidel.solve(mna_matrix, mna_vector, solution);
+    }
+    std::chrono::high_resolution_clock::time_point end = std::chrono::high_resolution_clock::now();
+    duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
+}
+
+void Solver::update_MNA_system(const std::unordered_map<int,std::unordered_map<int,double>>& mna_matrix,
+                               const std::unordered_map<int, double>& mna_vector,
+                               const Component_contribution<double>& delta,
+                               std::vector<double>& solution) {
+    if (dc_method != Method::sparse_lu || dc_dense || !sparse_lu.is_factored()) {
+        solve_MNA_system(mna_matrix, mna_vector, solution);
+        return;
+    }
+    TRACE_SCOPE("dc_update");
+    Memory_scope memory(Memory_tag::solver);
+    std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+
+    // Every changed entry must already be stored in the factored matrix
+    std::vector<int>& positions = update_positions;
+    std::vector<int>& rows = update_rows;
+    std::vector<int>& cols = update_cols;
+    std::vector<double>& values = update_values;
+    positions.clear();
+    rows.clear();
+    cols.clear();
+    values.clear();
+    for (const auto& mc : delta.matrixStamps) {
+        if (mc.row == 0 || mc.col == 0 || mc.value == 0.0)
+            continue;
+        int p = dc_matrix.find(mc.row, mc.col);
+        if (p < 0) {
+            solve_MNA_system(mna_matrix, mna_vector, solution);
+            return;
+        }
+        positions.push_back(p);
+        rows.push_back(dc_matrix.compact_index[mc.row]);
+        cols.push_back(dc_matrix.compact_index[mc.col]);
+        values.push_back(mc.value);
+    }
+    for (size_t e = 0; e < positions.size(); e++)
+        dc_matrix.values[positions[e]] += values[e];
+
+    // Too many accumulated changes: refactor (the symbolic analysis is reused)
+    if (!positions.empty() && !sparse_lu.update(rows, cols, values))
+        sparse_lu.factorize(dc_matrix);
+    dc_matrix.gather(mna_vector, dc_rhs);
+    sparse_lu.solve(dc_rhs);
+    solution.resize(mna_matrix.size()+1, 0.0);
+    dc_matrix.scatter(dc_rhs, solution);
     std::chrono::high_resolution_clock::time_point end = std::chrono::high_resolution_clock::now();
     duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
 }
@@ -26,32 +296,82 @@ void Solver::assemble_ac_system(const std::unordered_map<int,std::unordered_map<
 
 void Solver::get_ac_response(const std::unordered_map<std::string, Component*>& ac_components,
                              double frequency) {
+    TRACE_SCOPE_ARG("ac_point", "frequency", frequency);
+    Memory_scope memory(Memory_tag::solver);
     std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
-    ac_analyzer.assemble_ac_mna_system(ac_components, frequency);
-    gauss_seidel_ac.solve(ac_analyzer.mna_matrix, ac_analyzer.mna_vector, ac_analyzer.solution);
+    {
+        TRACE_SCOPE("ac_assemble");
+        ac_analyzer.assemble_ac_mna_system(ac_components, frequency);
+    }
+    int converge_iters = 1;
+    bool ac_dense = false;
+    if (method == Method::automatic) {
+        TRACE_SCOPE("dense_lu");
+        ac_dense = dense_ac.solve(ac_analyzer.mna_matrix, ac_analyzer.mna_vector, ac_analyzer.solution);
+    }
+    if (!ac_dense && active_method() != Method::gauss_seidel) {
+        // Pattern is fixed after the first frequency, so only numeric refactorization repeats
+        ac_matrix.assemble(ac_analyzer.mna_matrix);
+        sparse_lu_ac.factorize(ac_matrix);
+        ac_matrix.gather(ac_analyzer.mna_vector, ac_rhs);
+        sparse_lu_ac.solve(ac_rhs);
+        ac_matrix.scatter(ac_rhs, ac_analyzer.solution);
+    } else if (!ac_dense) {
+        TRACE_SCOPE("gauss_seidel");
+        if (telemetry)
+            telemetry->set_frequency(frequency);
+        gauss_seidel_ac.solve(ac_analyzer.mna_matrix, ac_analyzer.mna_vector, ac_analyzer.solution);
+        converge_iters = gauss_seidel_ac.converge_iters;
+        ac_converged = ac_converged && gauss_seidel_ac.converged;
+    }
     std::chrono::high_resolution_clock::time_point end = std::chrono::high_resolution_clock::now();
     std::chrono::microseconds duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
-    ac_analyzer.log_ac_inst_solution(frequency, duration, gauss_seidel_ac.converge_iters);
+    TRACE_SCOPE("ac_write");
+    ac_analyzer.log_ac_inst_solution(frequency, duration, converge_iters);
 }
 
 void Solver::solve_ac_system(const std::unordered_map<std::string, Component*>& ac_components,
                              double freq1, double freq2, double step, bool log_scale) {
+    TRACE_SCOPE("ac_sweep");
     std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
     ac_analyzer.assemble_ac_mna_system(ac_components, 0.0); // Initial assembly at DC
-    for (double freq = freq1; freq <= freq2; freq = log_scale ? freq * step : freq + step) 
+    ac_converged = true;
+    Frequency_sweep sweep(freq1, freq2, step, log_scale);
+    int num_points = 0;
+    for (double freq = sweep.first(); sweep.contains(freq); freq = sweep.next(freq)) {
+        cancellation.throw_if_cancelled();
         get_ac_response(ac_components, freq);
+        num_points++;
+    }
+    ac_analyzer.flush();
     std::chrono::high_resolution_clock::time_point end = std::chrono::high_resolution_clock::now();
     ac_duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
-    int num_points = static_cast<int>((freq2 - freq1) / step) + 1;
     avg_ac_duration = static_cast<int>(ac_duration.count()) / num_points;
 }
 
 void Solver::print(std::ostream& os) const {
-    if(gauss_seidel.converge_iters == 0) {
+    bool solved = dc_dense || dc_method == Method::pcg ||
+                  (dc_method == Method::sparse_lu && sparse_lu.is_factored()) ||
+                  (dc_method == Method::gauss_seidel && gauss_seidel.converge_iters != 0);
+    if(!solved) {
         os << "No solution available. Please run DC analysis first." << std::endl;
         return;
     }
-    os << gauss_seidel;
+    if (method == Method::automatic && selection.valid) {
+        os << "Solver Selection:" << std::endl;
+        os << std::string(40, '-') << std::endl;
+        os << "  Method: " << method_name(selection.method) << std::endl;
+        os << "  Reason: " << selection.reason << std::endl;
+        os << std::endl << selection.structure << std::endl;
+    }
+    if (dc_dense)
+        os << dense;
+    else if (dc_method == Method::sparse_lu)
+        os << sparse_lu;
+    else if (dc_method == Method::pcg)
+        os << pcg;
+    else
+        os << gauss_seidel;
     os << "  DC Solve Time Taken: " << duration.count() << " microseconds\n" << std::endl;
 
     if (ac_duration.count() <= 0)
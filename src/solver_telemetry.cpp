@@ -0,0 +1,140 @@
+#include "solver_telemetry.h"
+#include <cmath>
+#include <fstream>
+#include <stdexcept>
+
+namespace {
+
+// Diverged solves produce inf/NaN residuals, which JSON cannot represent
+struct Json_number {
+    double value;
+};
+
+std::ostream& operator<<(std::ostream& os, Json_number number) {
+    if (std::isfinite(number.value))
+        return os << number.value;
+    return os << "null";
+}
+
+} // namespace
+
+Solver_telemetry::Solver_telemetry(int sample_every, size_t capacity)
+    : sample_every(sample_every), capacity(capacity), frequency(0.0), dropped(0) {
+    if (sample_every < 1)
+        throw std::invalid_argument("Telemetry sampling period must be at least 1 sweep.");
+}
+
+int Solver_telemetry::begin_solve(const char* system, size_t size, double damping, double tolerance) {
+    Solve solve;
+    solve.system = system;
+    solve.frequency = frequency;
+    solve.size = size;
+    solve.damping = damping;
+    solve.tolerance = tolerance;
+    solve_records.push_back(solve);
+    return static_cast<int>(solve_records.size()) - 1;
+}
+
+void Solver_telemetry::end_solve(int iterations, bool converged, double seconds) {
+    if (solve_records.empty())
+        return;
+    Solve& solve = solve_records.back();
+    solve.iterations = iterations;
+    solve.converged = converged;
+    solve.seconds = seconds;
+}
+
+void Solver_telemetry::record_iteration(int iteration, double residual, double seconds) {
+    if (iteration_records.size() >= capacity) {
+        dropped++;
+        return;
+    }
+    iteration_records.push_back({static_cast<int>(solve_records.size()) - 1, iteration, residual, seconds});
+}
+
+void Solver_telemetry::record_pivot(int iteration, int row, int from, int to, bool independent) {
+    if (pivot_records.size() >= capacity) {
+        dropped++;
+        return;
+    }
+    pivot_records.push_back({static_cast<int>(solve_records.size()) - 1, iteration, row, from, to, independent});
+}
+
+bool Solver_telemetry::has_iteration(int iteration) const {
+    return !iteration_records.empty() && iteration_records.back().solve == static_cast<int>(solve_records.size()) - 1 &&
+           iteration_records.back().iteration == iteration;
+}
+
+void Solver_telemetry::clear() {
+    solve_records.clear();
+    iteration_records.clear();
+    pivot_records.clear();
+    dropped = 0;
+}
+
+void Solver_telemetry::write_csv(std::ostream& os) const {
+    std::streamsize precision = os.precision(10);
+    os << "record,solve,system,frequency,size,damping,tolerance,iterations,converged,seconds,"
+          "iteration,residual,sweep_seconds,row,from,to,independent\n";
+    // Records of each solve follow its own row
+    size_t it = 0, pv = 0;
+    for (size_t s = 0; s < solve_records.size(); s++) {
+        const Solve& solve = solve_records[s];
+        os << "solve," << s << "," << solve.system << "," << solve.frequency << "," << solve.size << ","
+           << solve.damping << "," << solve.tolerance << "," << solve.iterations << ","
+           << (solve.converged ? 1 : 0) << "," << solve.seconds << ",,,,,,,\n";
+        for (; it < iteration_records.size() && iteration_records[it].solve == static_cast<int>(s); it++) {
+            const Iteration& i = iteration_records[it];
+            os << "iteration," << s << "," << solve.system << "," << solve.frequency << ",,,,,,," << i.iteration << ","
+               << i.residual << "," << i.seconds << ",,,,\n";
+        }
+        for (; pv < pivot_records.size() && pivot_records[pv].solve == static_cast<int>(s); pv++) {
+            const Pivot& p = pivot_records[pv];
+            os << "pivot," << s << "," << solve.system << "," << solve.frequency << ",,,,,,," << p.iteration << ",,,"
+               << p.row << "," << p.from << "," << p.to << "," << (p.independent ? 1 : 0) << "\n";
+        }
+    }
+    os.precision(precision);
+}
+
+void Solver_telemetry::write_json(std::ostream& os) const {
+    std::streamsize precision = os.precision(10);
+    os << "{\"solves\": [";
+    size_t it = 0, pv = 0;
+    for (size_t s = 0; s < solve_records.size(); s++) {
+        const Solve& solve = solve_records[s];
+        os << (s ? ",\n" : "\n") << "{\"system\": \"" << solve.system << "\", \"frequency\": " << solve.frequency
+           << ", \"size\": " << solve.size << ", \"damping\": " << solve.damping << ", \"tolerance\": "
+           << solve.tolerance << ", \"iterations\": " << solve.iterations << ", \"converged\": "
+           << (solve.converged ? "true" : "false") << ", \"seconds\": " << Json_number{solve.seconds} << ",\n \"residuals\": [";
+        for (bool first = true; it < iteration_records.size() && iteration_records[it].solve == static_cast<int>(s);
+             it++, first = false) {
+            const Iteration& i = iteration_records[it];
+            os << (first ? "" : ", ") << "[" << i.iteration << ", " << Json_number{i.residual} << ", " << Json_number{i.seconds} << "]";
+        }
+        os << "],\n \"pivots\": [";
+        for (bool first = true; pv < pivot_records.size() && pivot_records[pv].solve == static_cast<int>(s);
+             pv++, first = false) {
+            const Pivot& p = pivot_records[pv];
+            os << (first ? "" : ", ") << "{\"iteration\": " << p.iteration << ", \"row\": " << p.row
+               << ", \"from\": " << p.from << ", \"to\": " << p.to
+               << ", \"independent\": " << (p.independent ? "true" : "false") << "}";
+        }
+        os << "]}";
+    }
+    os << "\n], \"dropped\": " << dropped << "}\n";
+    os.precision(precision);
+}
+
+void Solver_telemetry::write_file(const std::string& filename) const {
+    std::ofstream file(filename);
+    if (!file.is_open())
+        throw std::runtime_error("Could not write telemetry file: " + filename);
+    const std::string json = ".json";
+    if (filename.size() >= json.size() && filename.compare(filename.size() - json.size(), json.size(), json) == 0)
+        write_json(file);
+    else
+        write_csv(file);
+    if (!file)
+        throw std::runtime_error("Could not write telemetry file: " + filename);
+}
@@ -0,0 +1,373 @@
+#include "solver_tuner.h"
+#include "fingerprint.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+namespace {
+
+constexpr const char* tuning_magic = "circuit_tuning 1";
+
+std::string hex(uint64_t value) {
+    std::ostringstream oss;
+    oss << std::hex << std::setw(16) << std::setfill('0') << value;
+    return oss.str();
+}
+
+const char* method_token(Solver::Method method) {
+    switch (method) {
+        case Solver::Method::gauss_seidel: return "gs";
+        case Solver::Method::sparse_lu: return "lu";
+        case Solver::Method::pcg: return "pcg";
+        case Solver::Method::automatic: break;
+    }
+    return "auto";
+}
+
+const char* ordering_token(Ordering::Method ordering) {
+    switch (ordering) {
+        case Ordering::Method::minimum_degree: return "minimum_degree";
+        case Ordering::Method::nested_dissection: return "nested_dissection";
+        case Ordering::Method::automatic: break;
+    }
+    return "automatic";
+}
+
+// ||Ax - b||_inf over the MNA system
+double residual(const std::unordered_map<int, std::unordered_map<int, double>>& A,
+                const std::unordered_map<int, double>& b, const std::vector<double>& x) {
+    double worst = 0.0;
+    for (const auto& [row, col_map] : A) {
+        double sum = 0.0;
+        for (const auto& [col, value] : col_map)
+            sum += value * (static_cast<size_t>(col) < x.size() ? x[col] : 0.0);
+        auto it = b.find(row);
+        worst = std::max(worst, std::abs(sum - (it != b.end() ? it->second : 0.0)));
+    }
+    return worst;
+}
+
+// Residual a candidate's solution may leave: 1e-6 × max(1, ||b||_inf)
+double residual_limit(const std::unordered_map<int, double>& b) {
+    double scale = 1.0;
+    for (const auto& [row, value] : b)
+        scale = std::max(scale, std::abs(value));
+    return 1e-6 * scale;
+}
+
+// Solves the DC system on a fresh solver with the configuration
+double timed_solve(const Circuit& circuit, const Solver::Configuration& config, double& residual_out) {
+    Solver solver;
+    solver.configure(config);
+    std::vector<double> solution;
+    auto start = std::chrono::steady_clock::now();
+    solver.solve_MNA_system(circuit.get_MNA_matrix(), circuit.get_MNA_vector(), solution);
+    auto end = std::chrono::steady_clock::now();
+    residual_out = residual(circuit.get_MNA_matrix(), circuit.get_MNA_vector(), solution);
+    return std::chrono::duration<double>(end - start).count();
+}
+
+} // namespace
+
+Solver_tuner::Solver_tuner(const std::string& directory, bool tune_on_miss, int repeats)
+    : tune_on_miss(tune_on_miss), repeats(repeats), hits(0), misses(0), prepared_topology(0), source(Source::none),
+      overriding(false) {
+    if (repeats < 1)
+        throw std::invalid_argument("Tuning needs at least one timed solve per candidate.");
+    set_directory(directory, tune_on_miss);
+}
+
+void Solver_tuner::set_directory(const std::string& directory, bool tune_on_miss) {
+    if (!directory.empty()) {
+        std::error_code ec;
+        std::filesystem::create_directories(directory, ec);
+        if (ec || !std::filesystem::is_directory(directory))
+            throw std::runtime_error("Failed to create solver tuning directory: " + directory);
+    }
+    this->directory = directory;
+    this->tune_on_miss = tune_on_miss;
+    source = Source::none;
+}
+
+std::string Solver_tuner::entry_path(const std::string& key) const {
+    return (std::filesystem::path(directory) / (key + ".tune")).string();
+}
+
+uint64_t Solver_tuner::similarity_key(const System_structure& structure) {
+    Fingerprint fp;
+    fp.add(static_cast<uint64_t>(structure.dimension > 0 ? std::ilogb(static_cast<double>(structure.dimension)) : 0));
+    fp.add(static_cast<uint64_t>(std::llround(2.0 * structure.mean_degree)));
+    fp.add(static_cast<uint64_t>(structure.forest));
+    fp.add(static_cast<uint64_t>(structure.symmetric));
+    fp.add(static_cast<uint64_t>(structure.zero_diagonals > 0));
+    fp.add(static_cast<uint64_t>(structure.spd()));
+    return fp.value();
+}
+
+// ============================================================
+//  Entries
+// ============================================================
+
+bool Solver_tuner::load(const std::string& path, Solver::Configuration& config) const {
+    std::ifstream in(path);
+    std::string magic;
+    if (!in.is_open() || !std::getline(in, magic) || magic != tuning_magic)
+        return false;
+    Solver::Configuration loaded;
+    bool has_method = false;
+    std::string key, value;
+    while (in >> key >> value) {
+        if (key == "method") {
+            if (value == "gs")
+                loaded.method = Solver::Method::gauss_seidel;
+            else if (value == "lu")
+                loaded.method = Solver::Method::sparse_lu;
+            else if (value == "pcg")
+                loaded.method = Solver::Method::pcg;
+            else
+                return false;
+            has_method = true;
+        } else if (key == "ordering") {
+            if (value == "minimum_degree")
+                loaded.ordering = Ordering::Method::minimum_degree;
+            else if (value == "nested_dissection")
+                loaded.ordering = Ordering::Method::nested_dissection;
+            else if (value == "automatic")
+                loaded.ordering = Ordering::Method::automatic;
+            else
+                return false;
+        } else if (key == "preconditioner") {
+            if (value != "jacobi" && value != "none")
+                return false;
+            loaded.preconditioner = value == "jacobi" ? Pcg::Preconditioner::jacobi : Pcg::Preconditioner::none;
+        } else {
+            try {
+                if (key == "threads")
+                    loaded.threads = std::stoi(value);
+                else if (key == "damping")
+                    loaded.damping = std::stod(value);
+            } catch (const std::exception&) {
+                return false;
+            }
+        }
+    }
+    if (!has_method || loaded.threads < 1 || !(loaded.damping > 0.0 && loaded.damping <= 1.0))
+        return false;
+    config = loaded;
+    return true;
+}
+
+void Solver_tuner::store(const std::string& path, const Solver::Configuration& config, double seconds) const {
+    std::string tmp = path + ".tmp";
+    {
+        std::ofstream out(tmp, std::ios::trunc);
+        if (!out.is_open())
+            throw std::runtime_error("Failed to write solver tuning entry: " + path);
+        out << tuning_magic << "\n"
+            << "method " << method_token(config.method) << "\n"
+            << "ordering " << ordering_token(config.ordering) << "\n"
+            << "threads " << config.threads << "\n"
+            << "damping " << config.damping << "\n"
+            << "preconditioner " << (config.preconditioner == Pcg::Preconditioner::jacobi ? "jacobi" : "none") << "\n"
+            << "seconds " << seconds << "\n";
+        if (!out)
+            throw std::runtime_error("Failed to write solver tuning entry: " + path);
+    }
+    std::error_code ec;
+    std::filesystem::rename(tmp, path, ec);
+    if (ec) {
+        std::filesystem::remove(tmp, ec);
+        throw std::runtime_error("Failed to write solver tuning entry: " + path);
+    }
+}
+
+// ============================================================
+//  Trials
+// ============================================================
+
+std::vector<Solver_tuner::Trial> Solver_tuner::tune(const Circuit& circuit) const {
+    const auto& mna_vector = circuit.get_MNA_vector();
+    Sparse_matrix<double> A;
+    A.assemble(circuit.get_MNA_matrix());
+    const System_structure structure = System_structure::analyze(A);
+
+    std::vector<Solver::Configuration> candidates;
+    std::vector<int> thread_counts = {1};
+    int parallel = std::min(8, static_cast<int>(std::thread::hardware_concurrency()));
+    if (parallel > 1)
+        thread_counts.push_back(parallel);
+    for (Ordering::Method ordering : {Ordering::Method::minimum_degree, Ordering::Method::nested_dissection}) {
+        for (int threads : thread_counts) {
+            Solver::Configuration config;
+            config.ordering = ordering;
+            config.threads = threads;
+            candidates.push_back(config);
+        }
+    }
+    for (double damping : {0.5, 0.8, 1.0}) {
+        Solver::Configuration config;
+        config.method = Solver::Method::gauss_seidel;
+        config.damping = damping;
+        candidates.push_back(config);
+    }
+    if (structure.spd()) {
+        for (Pcg::Preconditioner preconditioner : {Pcg::Preconditioner::jacobi, Pcg::Preconditioner::none}) {
+            Solver::Configuration config;
+            config.method = Solver::Method::pcg;
+            config.preconditioner = preconditioner;
+            candidates.push_back(config);
+        }
+    }
+
+    const double limit = residual_limit(mna_vector);
+    double best = HUGE_VAL;                 // Fastest accepted candidate so far
+    std::vector<Trial> results;
+    for (const Solver::Configuration& config : candidates) {
+        Trial trial;
+        trial.config = config;
+        trial.seconds = HUGE_VAL;
+        try {
+            // A candidate already slower than the best one cannot win, so its remaining repeats are skipped
+            for (int r = 0; r < repeats && (r == 0 || trial.seconds <= best); r++)
+                trial.seconds = std::min(trial.seconds, timed_solve(circuit, config, trial.residual));
+            trial.accepted = trial.residual <= limit;
+        } catch (const std::exception&) {
+            trial.accepted = false;
+        }
+        if (trial.accepted)
+            best = std::min(best, trial.seconds);
+        results.push_back(trial);
+    }
+    std::stable_sort(results.begin(), results.end(), [](const Trial& a, const Trial& b) {
+        if (a.accepted != b.accepted)
+            return a.accepted;
+        return a.seconds < b.seconds;
+    });
+    return results;
+}
+
+void Solver_tuner::release(Solver& solver) {
+    if (overriding)
+        solver.restore(saved);
+    overriding = false;
+    source = Source::none;
+}
+
+bool Solver_tuner::prepare(const Circuit& circuit, Solver& solver) {
+    if (!enabled()) {
+        release(solver);
+        return false;
+    }
+    // Automatic selection solves these on the dense LU, which a tuned explicit configuration would give up
+    if (circuit.get_MNA_matrix().size() <= static_cast<size_t>(solver.get_dense_max_size())) {
+        release(solver);
+        trials.clear();
+        return false;
+    }
+    uint64_t topology = circuit.topology_hash();
+    if (source != Source::none && topology == prepared_topology)
+        return true;
+
+    Solver::Configuration config;
+    const std::string exact = entry_path(hex(topology));
+    // Values may differ from the circuit the entry was tuned on, so every entry must pass one solve here
+    if (load(exact, config) && verify(circuit, config)) {
+        source = Source::exact;
+        hits++;
+        trials.clear();
+    } else {
+        Sparse_matrix<double> A;
+        A.assemble(circuit.get_MNA_matrix());
+        const std::string similar = entry_path("similar_" + hex(similarity_key(System_structure::analyze(A))));
+        if (load(similar, config) && verify(circuit, config)) {
+            source = Source::similar;
+            hits++;
+            trials.clear();
+        } else {
+            misses++;
+            release(solver);
+            if (!tune_on_miss)
+                return false;
+            trials = tune(circuit);
+            if (trials.empty() || !trials.front().accepted)
+                return false;
+            config = trials.front().config;
+            store(exact, config, trials.front().seconds);
+            store(similar, config, trials.front().seconds);
+            source = Source::tuned;
+        }
+    }
+    if (!overriding)
+        saved = solver.settings();
+    overriding = true;
+    solver.configure(config);
+    applied = config;
+    prepared_topology = topology;
+    return true;
+}
+
+bool Solver_tuner::verify(const Circuit& circuit, const Solver::Configuration& config) const {
+    try {
+        double r;
+        timed_solve(circuit, config, r);
+        return r <= residual_limit(circuit.get_MNA_vector());
+    } catch (const std::exception&) {
+        return false;
+    }
+}
+
+std::string Solver_tuner::describe(const Solver::Configuration& config) {
+    std::ostringstream oss;
+    oss << Solver::method_name(config.method);
+    switch (config.method) {
+        case Solver::Method::sparse_lu:
+            oss << ", " << (config.ordering == Ordering::Method::nested_dissection ? "nested dissection"
+                            : config.ordering == Ordering::Method::minimum_degree ? "minimum degree" : "automatic ordering")
+                << ", " << config.threads << (config.threads == 1 ? " thread" : " threads");
+            break;
+        case Solver::Method::gauss_seidel:
+            oss << ", damping " << config.damping;
+            break;
+        case Solver::Method::pcg:
+            oss << (config.preconditioner == Pcg::Preconditioner::jacobi ? ", Jacobi" : ", unpreconditioned");
+            break;
+        case Solver::Method::automatic:
+            break;
+    }
+    return oss.str();
+}
+
+void Solver_tuner::print(std::ostream& os) const {
+    os << "Solver Tuning:" << std::endl;
+    os << std::string(40, '-') << std::endl;
+    if (!enabled()) {
+        os << "  Disabled" << std::endl;
+        return;
+    }
+    os << "  Directory: " << directory << std::endl;
+    os << "  Hits: " << hits << std::endl;
+    os << "  Misses: " << misses << std::endl;
+    const char* origin = source == Source::exact ? "cached for this topology"
+                       : source == Source::similar ? "cached for a similar circuit"
+                       : source == Source::tuned ? "tuned now" : nullptr;
+    if (origin)
+        os << "  Applied: " << describe(applied) << " (" << origin << ")" << std::endl;
+    if (trials.empty())
+        return;
+    os << "  Trials:" << std::endl;
+    for (const Trial& trial : trials) {
+        os << "    " << std::left << std::setw(44) << describe(trial.config) << std::right;
+        if (trial.accepted)
+            os << std::fixed << std::setprecision(3) << std::setw(10) << 1e3 * trial.seconds << " ms";
+        else
+            os << std::setw(13) << "rejected";
+        os << std::endl;
+    }
+    os.unsetf(std::ios::floatfield);
+}
@@ -0,0 +1,969 @@
+#include "sparse_lu.h"
+#include "ordering.h"
+#include "task_tree.h"
+#include "perf_counters.h"
+#include "trace.h"
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+namespace {
+
+// Real flops of one multiply-add and one division in T
+template<typename T>
+constexpr double multiply_add_flops = std::is_same_v<T, double> ? 2.0 : 8.0;
+template<typename T>
+constexpr double division_flops = std::is_same_v<T, double> ? 1.0 : 11.0;
+
+// Work of a left-looking factorization producing these L/U patterns:
+// every U(j,k) above the diagonal applies column L(:,j) to column k, then L(:,k) is scaled by the pivot.
+template<typename T>
+void factor_work(const std::vector<int>& l_col_ptr, const std::vector<int>& u_col_ptr,
+                 const std::vector<int>& u_row_idx, double& flops, double& bytes) {
+    int n = static_cast<int>(l_col_ptr.size()) - 1;
+    double multiply_adds = 0.0, divisions = 0.0;
+    for (int k = 0; k < n; k++) {
+        for (int p = u_col_ptr[k]; p < u_col_ptr[k + 1]; p++) {
+            int j = u_row_idx[p];
+            if (j != k)
+                multiply_adds += l_col_ptr[j + 1] - l_col_ptr[j] - 1;
+        }
+        divisions += l_col_ptr[k + 1] - l_col_ptr[k] - 1;
+    }
+    double entry = sizeof(T) + sizeof(int);
+    flops = multiply_adds * multiply_add_flops<T> + divisions * division_flops<T>;
+    bytes = (multiply_adds + l_col_ptr[n] + u_col_ptr[n]) * entry;
+}
+
+} // namespace
+
+template<typename T>
+Sparse_lu<T>::Sparse_lu(double pivot_tolerance, double dependency_tolerance)
+    : pivot_tolerance(pivot_tolerance), dependency_tolerance(dependency_tolerance),
+      ordering(Ordering::Method::automatic), factored(false), num_free(0),
+      pool(nullptr), parallel_min_block(2000), max_update_rank(16) {}
+
+template<typename T>
+void Sparse_lu<T>::set_thread_pool(Thread_pool* thread_pool, int min_block_size) {
+    pool = thread_pool;
+    parallel_min_block = min_block_size;
+    l_schedule.clear();
+    u_schedule.clear();
+    if (factored)
+        update_schedules();
+}
+
+// ============================================================
+//  Symbolic analysis
+// ============================================================
+
+template<typename T>
+int Sparse_lu<T>::nested_dissection_min_block() const {
+    if (ordering == Ordering::Method::nested_dissection)
+        return 3;
+    if (ordering == Ordering::Method::automatic && pool && pool->size() > 1)
+        return parallel_min_block;
+    return INT_MAX;
+}
+
+template<typename T>
+int Sparse_lu<T>::parallel_factor_min_block() const {
+    return (pool && pool->size() > 1) ? parallel_min_block : INT_MAX;
+}
+
+template<typename T>
+bool Sparse_lu<T>::analyze(const Sparse_matrix<T>& A) {
+    if (symbolic && symbolic->matches(A) && symbolic->nested_min_block == nested_dissection_min_block()
+        && symbolic->task_min_block == parallel_factor_min_block())
+        return true;
+    analyze_pattern(A, false);
+    return false;
+}
+
+template<typename T>
+void Sparse_lu<T>::set_symbolic(std::shared_ptr<const Lu_symbolic> shared) {
+    factored = false;
+    l_schedule.clear();
+    u_schedule.clear();
+    symbolic = std::move(shared);
+}
+
+template<typename T>
+void Sparse_lu<T>::analyze_pattern(const Sparse_matrix<T>& A, bool single_block) {
+    TRACE_SCOPE("reorder");
+    factored = false;
+    l_schedule.clear();
+    u_schedule.clear();
+    auto sym = std::make_shared<Lu_symbolic>();
+    int n = A.n;
+    sym->n = n;
+    sym->var_index = A.var_index;
+    sym->src_col_ptr = A.col_ptr;
+    sym->src_row_idx = A.row_idx;
+    sym->btf = Btf::decompose(n, A.col_ptr, A.row_idx);
+
+    // Pattern actually factored: A itself, or A with redundant rows replaced by unit entries
+    std::vector<int> col_ptr = A.col_ptr, row_idx = A.row_idx, src(A.nnz());
+    for (int p = 0; p < A.nnz(); p++)
+        src[p] = p;
+
+    if (sym->btf.structural_rank < n) {
+        std::vector<int> free_row_of(n, -1);
+        std::vector<char> dropped(n, 0);
+        for (size_t k = 0; k < sym->btf.unmatched_rows.size(); k++) {
+            free_row_of[sym->btf.unmatched_cols[k]] = sym->btf.unmatched_rows[k];
+            dropped[sym->btf.unmatched_rows[k]] = 1;
+        }
+        sym->dropped_rows = sym->btf.unmatched_rows;
+
+        col_ptr.assign(1, 0);
+        row_idx.clear();
+        src.clear();
+        for (int j = 0; j < n; j++) {
+            for (int p = A.col_ptr[j]; p < A.col_ptr[j + 1]; p++) {
+                if (dropped[A.row_idx[p]])
+                    continue;
+                row_idx.push_back(A.row_idx[p]);
+                src.push_back(p);
+            }
+            if (free_row_of[j] >= 0) {
+                row_idx.push_back(free_row_of[j]);
+                src.push_back(-1);
+            }
+            col_ptr.push_back(static_cast<int>(row_idx.size()));
+        }
+        sym->btf = Btf::decompose(n, col_ptr, row_idx);
+    }
+
+    if (sym->btf.structural_rank < n)
+        throw std::runtime_error("Sparse LU: matrix is structurally singular (rank "
+                                 + std::to_string(sym->btf.structural_rank) + " of " + std::to_string(n) + ").");
+
+    Btf_decomposition& btf = sym->btf;
+    if (single_block && btf.num_blocks() > 1) {
+        btf.block_ptr = {0, n};
+        btf.num_singletons = (n == 1) ? 1 : 0;
+        btf.max_block_size = n;
+    }
+    std::vector<int> row_pos(n);
+    for (int k = 0; k < n; k++)
+        row_pos[btf.row_perm[k]] = k;
+
+    // Fill-reducing symmetric ordering inside each non-trivial diagonal block
+    sym->nested_min_block = nested_dissection_min_block();
+    sym->task_min_block = parallel_factor_min_block();
+    sym->tasks.assign(btf.num_blocks(), Factor_tasks());
+    std::vector<int> block_col_ptr, block_row_idx, old_cols, old_rows;
+    for (int b = 0; b < btf.num_blocks(); b++) {
+        int k0 = btf.block_ptr[b], k1 = btf.block_ptr[b + 1], size = k1 - k0;
+        if (size <= 2)
+            continue;
+
+        block_col_ptr.assign(1, 0);
+        block_row_idx.clear();
+        for (int t = 0; t < size; t++) {
+            int col = btf.col_perm[k0 + t];
+            for (int p = col_ptr[col]; p < col_ptr[col + 1]; p++) {
+                int i = row_pos[row_idx[p]];
+                if (i >= k0 && i < k1)
+                    block_row_idx.push_back(i - k0);
+            }
+            block_col_ptr.push_back(static_cast<int>(block_row_idx.size()));
+        }
+
+        std::vector<int> perm = Ordering::minimum_degree(size, block_col_ptr, block_row_idx);
+        if (size >= sym->nested_min_block) {
+            std::vector<int> nested = Ordering::nested_dissection(size, block_col_ptr, block_row_idx);
+            if (ordering == Ordering::Method::nested_dissection) {
+                perm.swap(nested);
+            } else {
+                // Shorter elimination tree is worth a little fill, not a blow-up (e.g. on trees)
+                long long md_fill = Ordering::factor_nnz(size, block_col_ptr, block_row_idx, perm, LLONG_MAX);
+                long long cap = md_fill + md_fill / 4;
+                if (Ordering::factor_nnz(size, block_col_ptr, block_row_idx, nested, cap) <= cap)
+                    perm.swap(nested);
+            }
+        }
+        old_cols.assign(btf.col_perm.begin() + k0, btf.col_perm.begin() + k1);
+        old_rows.assign(btf.row_perm.begin() + k0, btf.row_perm.begin() + k1);
+        for (int t = 0; t < size; t++) {
+            btf.col_perm[k0 + t] = old_cols[perm[t]];
+            btf.row_perm[k0 + t] = old_rows[perm[t]];
+            row_pos[btf.row_perm[k0 + t]] = k0 + t;
+        }
+
+        if (size >= sym->task_min_block) {
+            std::vector<int> pos(size);
+            for (int t = 0; t < size; t++)
+                pos[perm[t]] = t;
+            std::vector<int> ordered_col_ptr(1, 0), ordered_row_idx;
+            ordered_row_idx.reserve(block_row_idx.size());
+            for (int t = 0; t < size; t++) {
+                for (int p = block_col_ptr[perm[t]]; p < block_col_ptr[perm[t] + 1]; p++)
+                    ordered_row_idx.push_back(pos[block_row_idx[p]]);
+                ordered_col_ptr.push_back(static_cast<int>(ordered_row_idx.size()));
+            }
+            sym->tasks[b] = build_tasks(size, ordered_col_ptr, ordered_row_idx);
+        }
+    }
+
+    // Gather map for B = A(row_perm, col_perm): in-block entries first, then off-block
+    std::vector<int> block_start(n);
+    for (int b = 0; b < btf.num_blocks(); b++)
+        for (int k = btf.block_ptr[b]; k < btf.block_ptr[b + 1]; k++)
+            block_start[k] = btf.block_ptr[b];
+
+    sym->perm_col_ptr.assign(n + 1, 0);
+    sym->diag_end.assign(n, 0);
+    sym->perm_row_idx.reserve(static_cast<int>(row_idx.size()));
+    sym->perm_src.reserve(static_cast<int>(row_idx.size()));
+    for (int k = 0; k < n; k++) {
+        int col = btf.col_perm[k];
+        for (int pass = 0; pass < 2; pass++) {
+            for (int p = col_ptr[col]; p < col_ptr[col + 1]; p++) {
+                int i = row_pos[row_idx[p]];
+                bool in_block = i >= block_start[k];
+                if (in_block != (pass == 0))
+                    continue;
+                sym->perm_row_idx.push_back(i);
+                sym->perm_src.push_back(src[p]);
+            }
+            if (pass == 0)
+                sym->diag_end[k] = static_cast<int>(sym->perm_row_idx.size());
+        }
+        sym->perm_col_ptr[k + 1] = static_cast<int>(sym->perm_row_idx.size());
+    }
+
+    symbolic = sym;
+}
+
+// ============================================================
+//  Numeric factorization
+// ============================================================
+
+template<typename T>
+int Sparse_lu<T>::reach(int k0, int size, int k) {
+    // work_stack[0, size) is the DFS stack, work_stack[size, 2*size) the edge pointers.
+    // The reach is written backwards into work_stack[top, size) in topological order.
+    const Lu_symbolic& sym = *symbolic;
+    int* stack = work_stack.data();
+    int* ptr_stack = work_stack.data() + size;
+    int top = size;
+    int stamp = k + 1;
+
+    for (int q = sym.perm_col_ptr[k]; q < sym.diag_end[k]; q++) {
+        int start = sym.perm_row_idx[q] - k0;
+        if (work_mark[start] == stamp)
+            continue;
+
+        int head = 0;
+        stack[0] = start;
+        while (head >= 0) {
+            int j = stack[head];
+            int jcol = work_pinv[j];
+            if (work_mark[j] != stamp) {
+                work_mark[j] = stamp;
+                ptr_stack[head] = (jcol < 0) ? 0 : l_col_ptr[k0 + jcol] + 1;
+            }
+
+            bool done = true;
+            int end = (jcol < 0) ? 0 : l_col_ptr[k0 + jcol + 1];
+            for (int p = ptr_stack[head]; p < end; p++) {
+                int i = l_row_idx[p];
+                if (work_mark[i] == stamp)
+                    continue;
+                ptr_stack[head] = p + 1;
+                stack[++head] = i;
+                done = false;
+                break;
+            }
+            if (done) {
+                head--;
+                stack[--top] = j;
+            }
+        }
+    }
+    return top;
+}
+
+template<typename T>
+void Sparse_lu<T>::mark_free_column(int k, int size, int top) {
+    // U(:, k) becomes the unit column; the pivot row is assigned once the block is done
+    u_row_idx.resize(u_col_ptr[k]);
+    u_values.resize(u_col_ptr[k]);
+    u_row_idx.push_back(k);
+    u_values.push_back(T(1));
+    l_row_idx.push_back(-1);
+    l_values.push_back(T(1));
+    free_column[k] = 1;
+    num_free++;
+
+    for (int p = top; p < size; p++)
+        work_x[work_stack[p]] = T{};
+}
+
+template<typename T>
+void Sparse_lu<T>::factorize_block(int block) {
+    const Lu_symbolic& sym = *symbolic;
+    int k0 = sym.btf.block_ptr[block];
+    int size = sym.btf.block_ptr[block + 1] - k0;
+    int l_block_start = static_cast<int>(l_row_idx.size());
+    int free_before = num_free;
+
+    for (int t = 0; t < size; t++)
+        work_pinv[t] = -1;
+
+    for (int t = 0; t < size; t++) {
+        if ((t & 255) == 255)
+            cancellation.throw_if_cancelled();
+        int k = k0 + t;
+        l_col_ptr[k] = static_cast<int>(l_row_idx.size());
+        u_col_ptr[k] = static_cast<int>(u_row_idx.size());
+
+        // x = L \ B(:, k) restricted to the block (Gilbert-Peierls)
+        int top = reach(k0, size, k);
+        for (int p = top; p < size; p++)
+            work_x[work_stack[p]] = T{};
+        for (int q = sym.perm_col_ptr[k]; q < sym.diag_end[k]; q++)
+            work_x[sym.perm_row_idx[q] - k0] = perm_values[q];
+
+        for (int p = top; p < size; p++) {
+            int j = work_stack[p];
+            int jcol = work_pinv[j];
+            if (jcol < 0)
+                continue;
+            T xj = work_x[j];
+            for (int q = l_col_ptr[k0 + jcol] + 1; q < l_col_ptr[k0 + jcol + 1]; q++)
+                work_x[l_row_idx[q]] -= l_values[q] * xj;
+        }
+
+        // Pivot search: U entries for pivotal rows, largest candidate otherwise
+        int ipiv = -1;
+        double max_abs = -1.0;
+        for (int p = top; p < size; p++) {
+            int i = work_stack[p];
+            if (work_pinv[i] < 0) {
+                double a = std::abs(work_x[i]);
+                if (a > max_abs) {
+                    max_abs = a;
+                    ipiv = i;
+                }
+            } else {
+                u_row_idx.push_back(k0 + work_pinv[i]);
+                u_values.push_back(work_x[i]);
+            }
+        }
+        double col_abs = 0.0;
+        for (int q = sym.perm_col_ptr[k]; q < sym.diag_end[k]; q++)
+            col_abs = std::max(col_abs, std::abs(perm_values[q]));
+
+        if (ipiv < 0 || max_abs <= dependency_tolerance * col_abs) {
+            // Column k depends on the previous ones: make its variable free (x_k = 0)
+            // and let the remaining equation it would pivot on go unused
+            if (max_abs != 0.0 && col_abs == 0.0)
+                throw std::runtime_error("Sparse LU: matrix is numerically singular at column "
+                                         + std::to_string(k) + ".");
+            mark_free_column(k, size, top);
+            continue;
+        }
+
+        // Prefer the diagonal (keeps the fill-reducing ordering intact)
+        if (work_pinv[t] < 0 && work_mark[t] == k + 1 && std::abs(work_x[t]) >= pivot_tolerance * max_abs)
+            ipiv = t;
+
+        T pivot = work_x[ipiv];
+        u_row_idx.push_back(k);
+        u_values.push_back(pivot);
+        work_pinv[ipiv] = t;
+        pivot_row[k] = k0 + ipiv;
+
+        l_row_idx.push_back(ipiv);
+        l_values.push_back(T(1));
+        for (int p = top; p < size; p++) {
+            int i = work_stack[p];
+            if (work_pinv[i] < 0) {
+                l_row_idx.push_back(i);
+                l_values.push_back(work_x[i] / pivot);
+            }
+            work_x[i] = T{};
+        }
+    }
+
+    if (num_free == free_before) {
+        // Rows of L become pivot positions now that the block's pivot order is known
+        for (size_t p = l_block_start; p < l_row_idx.size(); p++)
+            l_row_idx[p] = k0 + work_pinv[l_row_idx[p]];
+        return;
+    }
+
+    // Rows never pivoted on are the redundant equations: pair them with the
+    // dependent columns and drop their L entries (those equations go unused)
+    std::vector<char> slack(size, 0);
+    for (int t = 0, i = 0; t < size; t++) {
+        if (!free_column[k0 + t])
+            continue;
+        while (work_pinv[i] >= 0)
+            i++;
+        work_pinv[i] = t;
+        slack[i] = 1;
+        pivot_row[k0 + t] = k0 + i;
+    }
+    int write = l_block_start;
+    for (int t = 0; t < size; t++) {
+        int k = k0 + t;
+        int first = l_col_ptr[k], last = (t + 1 < size) ? l_col_ptr[k + 1] : static_cast<int>(l_row_idx.size());
+        l_col_ptr[k] = write;
+        for (int p = first; p < last; p++) {
+            if (p == first) {
+                l_row_idx[write] = k;
+            } else if (slack[l_row_idx[p]]) {
+                continue;
+            } else {
+                l_row_idx[write] = k0 + work_pinv[l_row_idx[p]];
+            }
+            l_values[write++] = l_values[p];
+        }
+    }
+    l_row_idx.resize(write);
+    l_values.resize(write);
+}
+
+template<typename T>
+Factor_tasks Sparse_lu<T>::build_tasks(int size, const std::vector<int>& col_ptr, const std::vector<int>& row_idx) {
+    std::vector<int> parent = Ordering::elimination_tree(size, col_ptr, row_idx);
+    std::vector<int> subtree(size, 1), num_children(size, 0);
+    for (int c = 0; c < size; c++)
+        if (parent[c] >= 0) {
+            subtree[parent[c]] += subtree[c];
+            num_children[parent[c]]++;
+        }
+
+    // Subtrees up to grain columns run as one task; larger nodes form the upper tree
+    int grain = std::max(64, size / 256);
+    Factor_tasks tasks;
+    std::vector<int> task_of(size, -1);
+    for (int c = size - 1; c >= 0; c--) {
+        int p = parent[c];
+        bool upper = subtree[c] > grain;
+        bool join = p >= 0 && (upper ? num_children[p] == 1 : subtree[p] <= grain);
+        if (join) {
+            task_of[c] = task_of[p];
+        } else {
+            task_of[c] = tasks.num_tasks();
+            tasks.parent.push_back(p >= 0 ? task_of[p] : -1);
+        }
+    }
+
+    tasks.col_ptr.assign(tasks.num_tasks() + 1, 0);
+    for (int c = 0; c < size; c++)
+        tasks.col_ptr[task_of[c] + 1]++;
+    for (int t = 0; t < tasks.num_tasks(); t++)
+        tasks.col_ptr[t + 1] += tasks.col_ptr[t];
+    tasks.cols.resize(size);
+    std::vector<int> next(tasks.col_ptr.begin(), tasks.col_ptr.end() - 1);
+    for (int c = 0; c < size; c++)
+        tasks.cols[next[task_of[c]]++] = c;
+    return tasks;
+}
+
+template<typename T>
+bool Sparse_lu<T>::factorize_block_parallel(int block) {
+    const Lu_symbolic& sym = *symbolic;
+    const Factor_tasks& tasks = sym.tasks[block];
+    int k0 = sym.btf.block_ptr[block];
+    int size = sym.btf.block_ptr[block + 1] - k0;
+    int num_threads = pool->size();
+
+    // Columns are produced out of order, so each keeps its own storage until the block is done
+    std::vector<std::vector<int>> l_rows(size), u_rows(size);
+    std::vector<std::vector<T>> l_vals(size), u_vals(size);
+    std::vector<std::vector<T>> thread_x(num_threads);
+    std::vector<std::vector<int>> thread_mark(num_threads), thread_stack(num_threads);
+    std::atomic<bool> rejected(false);
+
+    Task_tree::run(pool, tasks.parent, [&](int task, int thread_id) {
+        if (rejected.load(std::memory_order_relaxed))
+            return;
+        cancellation.throw_if_cancelled();
+        std::vector<T>& x = thread_x[thread_id];
+        std::vector<int>& mark = thread_mark[thread_id];
+        std::vector<int>& stack = thread_stack[thread_id];
+        if (x.empty()) {
+            x.assign(size, T{});
+            mark.assign(size, -1);
+            stack.resize(2 * static_cast<size_t>(size));
+        }
+        int* ptr_stack = stack.data() + size;
+
+        for (int c = tasks.col_ptr[task]; c < tasks.col_ptr[task + 1]; c++) {
+            int t = tasks.cols[c];
+            int k = k0 + t;
+
+            // Reach of B(:, k) through finished L columns (all in this column's etree subtree)
+            int top = size;
+            for (int q = sym.perm_col_ptr[k]; q < sym.diag_end[k]; q++) {
+                int start = sym.perm_row_idx[q] - k0;
+                if (mark[start] == t)
+                    continue;
+                int head = 0;
+                stack[0] = start;
+                mark[start] = t;
+                ptr_stack[0] = 1;
+                while (head >= 0) {
+                    int j = stack[head];
+                    bool done = true;
+                    if (j < t) {
+                        const std::vector<int>& rows = l_rows[j];
+                        for (int p = ptr_stack[head]; p < static_cast<int>(rows.size()); p++) {
+                            int i = rows[p];
+                            if (mark[i] == t)
+                                continue;
+                            ptr_stack[head] = p + 1;
+                            mark[i] = t;
+                            stack[++head] = i;
+                            ptr_stack[head] = 1;
+                            done = false;
+                            break;
+                        }
+                    }
+                    if (done) {
+                        head--;
+                        stack[--top] = j;
+                    }
+                }
+            }
+
+            for (int q = sym.perm_col_ptr[k]; q < sym.diag_end[k]; q++)
+                x[sym.perm_row_idx[q] - k0] = perm_values[q];
+            for (int p = top; p < size; p++) {
+                int j = stack[p];
+                if (j >= t)
+                    continue;
+                T xj = x[j];
+                const std::vector<int>& rows = l_rows[j];
+                const std::vector<T>& vals = l_vals[j];
+                for (size_t q = 1; q < rows.size(); q++)
+                    x[rows[q]] -= vals[q] * xj;
+            }
+
+            // Static pivot: the diagonal must pass the same threshold test as in factorize_block()
+            double max_abs = 0.0;
+            for (int p = top; p < size; p++)
+                if (stack[p] > t)
+                    max_abs = std::max(max_abs, static_cast<double>(std::abs(x[stack[p]])));
+            T pivot = (mark[t] == t) ? x[t] : T{};
+            if (std::abs(pivot) == 0.0 || std::abs(pivot) < pivot_tolerance * max_abs) {
+                rejected.store(true, std::memory_order_relaxed);
+                for (int p = top; p < size; p++)
+                    x[stack[p]] = T{};
+                return;
+            }
+
+            l_rows[t].push_back(t);
+            l_vals[t].push_back(T(1));
+            for (int p = top; p < size; p++) {
+                int i = stack[p];
+                if (i < t) {
+                    u_rows[t].push_back(i);
+                    u_vals[t].push_back(x[i]);
+                } else if (i > t) {
+                    l_rows[t].push_back(i);
+                    l_vals[t].push_back(x[i] / pivot);
+                }
+                x[i] = T{};
+            }
+            u_rows[t].push_back(t);
+            u_vals[t].push_back(pivot);
+        }
+    });
+
+    if (rejected.load())
+        return false;
+
+    for (int t = 0; t < size; t++) {
+        int k = k0 + t;
+        l_col_ptr[k] = static_cast<int>(l_row_idx.size());
+        u_col_ptr[k] = static_cast<int>(u_row_idx.size());
+        for (size_t q = 0; q < l_rows[t].size(); q++) {
+            l_row_idx.push_back(k0 + l_rows[t][q]);
+            l_values.push_back(l_vals[t][q]);
+        }
+        for (size_t q = 0; q < u_rows[t].size(); q++) {
+            u_row_idx.push_back(k0 + u_rows[t][q]);
+            u_values.push_back(u_vals[t][q]);
+        }
+        pivot_row[k] = k;
+    }
+    return true;
+}
+
+template<typename T>
+void Sparse_lu<T>::factorize(const Sparse_matrix<T>& A) {
+    analyze(A);
+    factorize_numeric(A);
+
+    // A dependent column inside one block of a singular matrix is not necessarily
+    // free globally (the null space may couple blocks); redo it as one block.
+    if (num_free > 0 && symbolic->btf.num_blocks() > 1) {
+        analyze_pattern(A, true);
+        factorize_numeric(A);
+    }
+}
+
+template<typename T>
+void Sparse_lu<T>::factorize_numeric(const Sparse_matrix<T>& A) {
+    TRACE_SCOPE("factor");
+    Perf_scope perf("lu_factor");
+    factored = false;
+    update_z.clear();
+    update_v.clear();
+    update_lu.clear();
+
+    const Lu_symbolic& sym = *symbolic;
+    int n = sym.n;
+    perm_values.resize(sym.perm_src.size());
+    for (size_t p = 0; p < sym.perm_src.size(); p++)
+        perm_values[p] = (sym.perm_src[p] < 0) ? T(1) : A.values[sym.perm_src[p]];
+
+    l_col_ptr.assign(n + 1, 0);
+    u_col_ptr.assign(n + 1, 0);
+    l_row_idx.clear();
+    l_values.clear();
+    u_row_idx.clear();
+    u_values.clear();
+    pivot_row.resize(n);
+    free_column.assign(n, 0);
+    num_free = 0;
+    work_x.assign(n, T{});
+    work_stack.resize(2 * static_cast<size_t>(n));
+    work_mark.assign(n, 0);
+    work_pinv.resize(n);
+
+    for (int b = 0; b < sym.btf.num_blocks(); b++) {
+        int k0 = sym.btf.block_ptr[b];
+        int size = sym.btf.block_ptr[b + 1] - k0;
+        if (size > 1) {
+            cancellation.throw_if_cancelled();
+            bool parallel = pool && pool->size() > 1 && sym.tasks[b].num_tasks() > 1;
+            if (!parallel || !factorize_block_parallel(b))
+                factorize_block(b);
+            continue;
+        }
+
+        // Singleton: the only in-block entry of the column is the diagonal
+        l_col_ptr[k0] = static_cast<int>(l_row_idx.size());
+        u_col_ptr[k0] = static_cast<int>(u_row_idx.size());
+        bool empty = sym.diag_end[k0] == sym.perm_col_ptr[k0] || perm_values[sym.perm_col_ptr[k0]] == T{};
+        l_row_idx.push_back(k0);
+        l_values.push_back(T(1));
+        u_row_idx.push_back(k0);
+        u_values.push_back(empty ? T(1) : perm_values[sym.perm_col_ptr[k0]]);
+        pivot_row[k0] = k0;
+        if (empty) {
+            free_column[k0] = 1;
+            num_free++;
+        }
+    }
+    l_col_ptr[n] = static_cast<int>(l_row_idx.size());
+    u_col_ptr[n] = static_cast<int>(u_row_idx.size());
+    factored = true;
+    if (perf.active()) {
+        double flops, bytes;
+        factor_work<T>(l_col_ptr, u_col_ptr, u_row_idx, flops, bytes);
+        perf.set_work(flops, bytes);
+    }
+    update_schedules();
+}
+
+template<typename T>
+void Sparse_lu<T>::update_schedules() {
+    const Btf_decomposition& btf = symbolic->btf;
+    if (!pool || pool->size() == 1 || btf.max_block_size < parallel_min_block) {
+        l_schedule.clear();
+        u_schedule.clear();
+        return;
+    }
+    if (static_cast<int>(l_schedule.size()) != btf.num_blocks()) {
+        l_schedule.assign(btf.num_blocks(), Triangular_schedule<T>());
+        u_schedule.assign(btf.num_blocks(), Triangular_schedule<T>());
+    }
+    for (int b = 0; b < btf.num_blocks(); b++) {
+        int k0 = btf.block_ptr[b], k1 = btf.block_ptr[b + 1];
+        if (k1 - k0 < parallel_min_block)
+            continue;
+        // Pivoting usually repeats the previous choices, so the schedule structure is reused
+        if (!l_schedule[b].is_built() || !l_schedule[b].refresh(l_col_ptr, l_row_idx, l_values))
+            l_schedule[b].build(k0, k1, l_col_ptr, l_row_idx, l_values, true);
+        if (!u_schedule[b].is_built() || !u_schedule[b].refresh(u_col_ptr, u_row_idx, u_values))
+            u_schedule[b].build(k0, k1, u_col_ptr, u_row_idx, u_values, false);
+    }
+}
+
+// ============================================================
+//  Solve
+// ============================================================
+
+template<typename T>
+void Sparse_lu<T>::solve(std::vector<T>& b) const {
+    TRACE_SCOPE("solve");
+    Perf_scope perf("lu_solve");
+    int k = get_update_rank();
+    if (perf.active()) {
+        // One multiply-add per stored off-diagonal L/U entry, one division per U diagonal, plus the Woodbury terms
+        double n = static_cast<double>(b.size());
+        double multiply_adds = nnz_l() + nnz_u() - 2.0 * n + 2.0 * k * n + 2.0 * k * k;
+        perf.set_work(multiply_adds * multiply_add_flops<T> + n * division_flops<T>,
+                      (nnz_l() + nnz_u()) * (sizeof(T) + sizeof(int)) + (2.0 + k) * n * sizeof(T));
+    }
+    solve_factored(b);
+    if (k == 0)
+        return;
+
+    // Woodbury correction: x = y - Z S^{-1} V^T y with y = A^{-1} b
+    std::vector<T>& t = work_update;
+    t.assign(k, T{});
+    for (int j = 0; j < k; j++)
+        for (const auto& [r, v] : update_v[j])
+            t[j] += v * b[r];
+    for (int c = 0; c < k; c++)
+        std::swap(t[c], t[update_pivot[c]]);
+    for (int i = 0; i < k; i++)
+        for (int c = 0; c < i; c++)
+            t[i] -= update_lu[i * k + c] * t[c];
+    for (int i = k - 1; i >= 0; i--) {
+        for (int c = i + 1; c < k; c++)
+            t[i] -= update_lu[i * k + c] * t[c];
+        t[i] /= update_lu[i * k + i];
+    }
+    for (int j = 0; j < k; j++) {
+        if (t[j] == T{})
+            continue;
+        const std::vector<T>& z = update_z[j];
+        for (size_t r = 0; r < b.size(); r++)
+            b[r] -= z[r] * t[j];
+    }
+}
+
+template<typename T>
+void Sparse_lu<T>::solve_factored(std::vector<T>& b) const {
+    if (!factored)
+        throw std::runtime_error("Sparse LU: solve called without a valid factorization.");
+
+    const Lu_symbolic& sym = *symbolic;
+    const Btf_decomposition& btf = sym.btf;
+    int n = sym.n;
+
+    // w holds B-row-ordered RHS values; solved blocks are overwritten by B-column-ordered x
+    std::vector<T>& w = work_solve;
+    w.resize(2 * static_cast<size_t>(n));
+    T* y = w.data() + n;
+    for (int r : sym.dropped_rows)
+        b[r] = T{};
+    for (int k = 0; k < n; k++)
+        w[k] = b[btf.row_perm[k]];
+
+    for (int blk = btf.num_blocks() - 1; blk >= 0; blk--) {
+        int k0 = btf.block_ptr[blk], k1 = btf.block_ptr[blk + 1];
+
+        if (k1 - k0 == 1) {
+            w[k0] = free_column[k0] ? T{} : w[k0] / u_values[u_col_ptr[k0]];
+        } else if (!l_schedule.empty() && l_schedule[blk].is_built()) {
+            for (int k = k0; k < k1; k++)
+                y[k] = w[pivot_row[k]];
+            l_schedule[blk].solve(y, pool);
+            u_schedule[blk].solve(y, pool);
+            for (int k = k0; k < k1; k++)
+                w[k] = free_column[k] ? T{} : y[k];
+        } else {
+            for (int k = k0; k < k1; k++)
+                y[k] = w[pivot_row[k]];
+            // Forward substitution with unit lower L
+            for (int k = k0; k < k1; k++)
+                for (int p = l_col_ptr[k] + 1; p < l_col_ptr[k + 1]; p++)
+                    y[l_row_idx[p]] -= l_values[p] * y[k];
+            // Back substitution with U (diagonal stored last)
+            for (int k = k1 - 1; k >= k0; k--) {
+                if (free_column[k]) {
+                    y[k] = T{};
+                    continue;
+                }
+                y[k] /= u_values[u_col_ptr[k + 1] - 1];
+                for (int p = u_col_ptr[k]; p < u_col_ptr[k + 1] - 1; p++)
+                    y[u_row_idx[p]] -= u_values[p] * y[k];
+            }
+            for (int k = k0; k < k1; k++)
+                w[k] = y[k];
+        }
+
+        // Move the solved block's contribution to the right-hand side of earlier blocks
+        for (int k = k0; k < k1; k++)
+            for (int p = sym.diag_end[k]; p < sym.perm_col_ptr[k + 1]; p++)
+                w[sym.perm_row_idx[p]] -= perm_values[p] * w[k];
+    }
+
+    for (int k = 0; k < n; k++)
+        b[btf.col_perm[k]] = w[k];
+}
+
+// ============================================================
+//  Low-rank updates
+// ============================================================
+
+template<typename T>
+bool Sparse_lu<T>::update(const std::vector<int>& rows, const std::vector<int>& cols, const std::vector<T>& values) {
+    if (!factored)
+        throw std::runtime_error("Sparse LU: update called without a valid factorization.");
+    if (rows.size() != cols.size() || rows.size() != values.size())
+        throw std::invalid_argument("Sparse LU: update rows, cols and values differ in length.");
+    int n = symbolic->n;
+    for (size_t e = 0; e < rows.size(); e++)
+        if (rows[e] < 0 || rows[e] >= n || cols[e] < 0 || cols[e] >= n)
+            throw std::invalid_argument("Sparse LU: update entry outside the matrix.");
+
+    // Regularized factors solve a modified system, so A^{-1} w would be wrong
+    if (num_free > 0 || !symbolic->dropped_rows.empty())
+        return false;
+
+    // Merge the change into rows of (col, value), sorted and without zeros
+    std::vector<int> order(rows.size());
+    for (size_t e = 0; e < order.size(); e++)
+        order[e] = static_cast<int>(e);
+    std::sort(order.begin(), order.end(), [&](int a, int b) {
+        return rows[a] != rows[b] ? rows[a] < rows[b] : cols[a] < cols[b];
+    });
+    std::vector<int> delta_row;
+    std::vector<std::vector<std::pair<int, T>>> delta;
+    for (int e : order) {
+        if (delta_row.empty() || delta_row.back() != rows[e]) {
+            delta_row.push_back(rows[e]);
+            delta.emplace_back();
+        }
+        auto& entries = delta.back();
+        if (!entries.empty() && entries.back().first == cols[e])
+            entries.back().second += values[e];
+        else
+            entries.emplace_back(cols[e], values[e]);
+    }
+
+    // Rows that are multiples of an earlier row share its rank-1 term
+    std::vector<std::vector<std::pair<int, T>>> new_w, new_v;
+    for (size_t i = 0; i < delta.size(); i++) {
+        auto& d = delta[i];
+        d.erase(std::remove_if(d.begin(), d.end(), [](const std::pair<int, T>& e) { return e.second == T{}; }), d.end());
+        if (d.empty())
+            continue;
+        bool merged = false;
+        for (size_t t = 0; t < new_v.size() && !merged; t++) {
+            const auto& v = new_v[t];
+            if (v.size() != d.size())
+                continue;
+            T ratio = d[0].second / v[0].second;
+            bool proportional = true;
+            for (size_t q = 0; q < d.size() && proportional; q++)
+                proportional = d[q].first == v[q].first
+                    && std::abs(d[q].second - ratio * v[q].second) <= 1e-12 * std::abs(d[q].second);
+            if (proportional) {
+                new_w[t].emplace_back(delta_row[i], ratio);
+                merged = true;
+            }
+        }
+        if (!merged) {
+            new_w.push_back({{delta_row[i], T(1)}});
+            new_v.push_back(std::move(d));
+        }
+    }
+    if (new_v.empty())
+        return true;
+    if (get_update_rank() + static_cast<int>(new_v.size()) > max_update_rank)
+        return false;
+
+    size_t old_rank = update_v.size();
+    for (size_t t = 0; t < new_v.size(); t++) {
+        std::vector<T> z(n, T{});
+        for (const auto& [r, c] : new_w[t])
+            z[r] += c;
+        solve_factored(z);
+        update_z.push_back(std::move(z));
+        update_v.push_back(std::move(new_v[t]));
+    }
+    if (!factor_capacitance()) {
+        update_z.resize(old_rank);
+        update_v.resize(old_rank);
+        factor_capacitance();
+        return false;
+    }
+    return true;
+}
+
+template<typename T>
+bool Sparse_lu<T>::factor_capacitance() {
+    int k = get_update_rank();
+    update_lu.assign(static_cast<size_t>(k) * k, T{});
+    update_pivot.resize(k);
+    double scale = 0.0;
+    for (int i = 0; i < k; i++) {
+        for (int j = 0; j < k; j++) {
+            T sum = (i == j) ? T(1) : T{};
+            for (const auto& [r, v] : update_v[i])
+                sum += v * update_z[j][r];
+            update_lu[i * k + j] = sum;
+            scale = std::max(scale, std::abs(sum));
+        }
+    }
+
+    // Dense LU with partial pivoting (k is small)
+    for (int c = 0; c < k; c++) {
+        int p = c;
+        for (int r = c + 1; r < k; r++)
+            if (std::abs(update_lu[r * k + c]) > std::abs(update_lu[p * k + c]))
+                p = r;
+        if (std::abs(update_lu[p * k + c]) <= dependency_tolerance * scale)
+            return false;
+        update_pivot[c] = p;
+        if (p != c)
+            for (int j = 0; j < k; j++)
+                std::swap(update_lu[c * k + j], update_lu[p * k + j]);
+        for (int r = c + 1; r < k; r++) {
+            T factor = update_lu[r * k + c] /= update_lu[c * k + c];
+            for (int j = c + 1; j < k; j++)
+                update_lu[r * k + j] -= factor * update_lu[c * k + j];
+        }
+    }
+    return true;
+}
+
+// ============================================================
+//  Printing
+// ============================================================
+
+template<typename T>
+void Sparse_lu<T>::print(std::ostream& os) const {
+    os << "Sparse LU (BTF) Status:" << std::endl;
+    os << std::string(40, '-') << std::endl;
+    if (!symbolic) {
+        os << "  Not analyzed" << std::endl;
+        return;
+    }
+    const Btf_decomposition& btf = symbolic->btf;
+    os << "  Dimension: " << symbolic->n << std::endl;
+    os << "  Diagonal Blocks: " << btf.num_blocks()
+       << " (" << btf.num_singletons << " singletons)" << std::endl;
+    os << "  Largest Block: " << btf.max_block_size << std::endl;
+    if (!symbolic->dropped_rows.empty())
+        os << "  Redundant Equations: " << symbolic->dropped_rows.size() << std::endl;
+    if (num_free > 0)
+        os << "  Dependent Columns: " << num_free << std::endl;
+    if (get_update_rank() > 0)
+        os << "  Low-rank Updates: rank " << get_update_rank() << std::endl;
+    os << "  nnz(A): " << symbolic->perm_src.size() << std::endl;
+    os << "  nnz(L): " << nnz_l() << std::endl;
+    os << "  nnz(U): " << nnz_u() << std::endl;
+}
+
+// Explicit template instantiations
+template class Sparse_lu<double>;
+template class Sparse_lu<std::complex<double>>;
@@ -0,0 +1,120 @@
+#include "sparse_matrix.h"
+#include <algorithm>
+
+template<typename T>
+Sparse_matrix<T>::Sparse_matrix() : n(0), col_ptr(1, 0) {}
+
+template<typename T>
+void Sparse_matrix<T>::assemble(const std::unordered_map<int, std::unordered_map<int, T>>& mna_matrix) {
+    // Find the active variables (rows/cols holding at least one non-zero)
+    int max_var = 0;
+    for (const auto& [row, col_map] : mna_matrix)
+        for (const auto& [col, value] : col_map)
+            if (value != T{})
+                max_var = std::max(max_var, std::max(row, col));
+
+    compact_index.assign(max_var + 1, -1);
+    for (const auto& [row, col_map] : mna_matrix)
+        for (const auto& [col, value] : col_map)
+            if (value != T{})
+                compact_index[row] = compact_index[col] = 0;
+
+    // Ground (index 0) is never part of the system
+    compact_index[0] = -1;
+    var_index.clear();
+    for (int var = 1; var <= max_var; var++) {
+        if (compact_index[var] < 0)
+            continue;
+        compact_index[var] = static_cast<int>(var_index.size());
+        var_index.push_back(var);
+    }
+    n = static_cast<int>(var_index.size());
+
+    // Count entries per column, then fill
+    col_ptr.assign(n + 1, 0);
+    for (const auto& [row, col_map] : mna_matrix) {
+        if (row <= 0 || row > max_var || compact_index[row] < 0)
+            continue;
+        for (const auto& [col, value] : col_map)
+            if (value != T{} && col > 0 && col <= max_var)
+                col_ptr[compact_index[col] + 1]++;
+    }
+    for (int j = 0; j < n; j++)
+        col_ptr[j + 1] += col_ptr[j];
+
+    row_idx.resize(col_ptr[n]);
+    values.resize(col_ptr[n]);
+    std::vector<int>& next = fill_next;
+    next.assign(col_ptr.begin(), col_ptr.end() - 1);
+    for (const auto& [row, col_map] : mna_matrix) {
+        if (row <= 0 || row > max_var || compact_index[row] < 0)
+            continue;
+        for (const auto& [col, value] : col_map) {
+            if (value == T{} || col <= 0 || col > max_var)
+                continue;
+            int p = next[compact_index[col]]++;
+            row_idx[p] = compact_index[row];
+            values[p] = value;
+        }
+    }
+
+    // Sort rows within each column (insertion sort: columns are short)
+    for (int j = 0; j < n; j++) {
+        for (int p = col_ptr[j] + 1; p < col_ptr[j + 1]; p++) {
+            int r = row_idx[p];
+            T v = values[p];
+            int q = p - 1;
+            for (; q >= col_ptr[j] && row_idx[q] > r; q--) {
+                row_idx[q + 1] = row_idx[q];
+                values[q + 1] = values[q];
+            }
+            row_idx[q + 1] = r;
+            values[q + 1] = v;
+        }
+    }
+}
+
+template<typename T>
+bool Sparse_matrix<T>::same_pattern(const Sparse_matrix& other) const {
+    return n == other.n && var_index == other.var_index
+        && col_ptr == other.col_ptr && row_idx == other.row_idx;
+}
+
+template<typename T>
+int Sparse_matrix<T>::find(int row, int col) const {
+    int size = static_cast<int>(compact_index.size());
+    if (row <= 0 || col <= 0 || row >= size || col >= size || compact_index[row] < 0 || compact_index[col] < 0)
+        return -1;
+    int r = compact_index[row], j = compact_index[col];
+    auto first = row_idx.begin() + col_ptr[j], last = row_idx.begin() + col_ptr[j + 1];
+    auto it = std::lower_bound(first, last, r);
+    return (it != last && *it == r) ? static_cast<int>(it - row_idx.begin()) : -1;
+}
+
+template<typename T>
+void Sparse_matrix<T>::gather(const std::unordered_map<int, T>& mna_vector, std::vector<T>& b) const {
+    b.assign(n, T{});
+    for (const auto& [row, value] : mna_vector)
+        if (row > 0 && row < static_cast<int>(compact_index.size()) && compact_index[row] >= 0)
+            b[compact_index[row]] = value;
+}
+
+template<typename T>
+void Sparse_matrix<T>::scatter(const std::vector<T>& x, std::vector<T>& solution) const {
+    if (n > 0 && solution.size() <= static_cast<size_t>(var_index[n - 1]))
+        solution.resize(var_index[n - 1] + 1, T{});
+    for (int k = 0; k < n; k++)
+        solution[var_index[k]] = x[k];
+}
+
+template<typename T>
+void Sparse_matrix<T>::print(std::ostream& os) const {
+    os << "Sparse Matrix (CSC):" << std::endl;
+    os << std::string(40, '-') << std::endl;
+    os << "  Dimension: " << n << std::endl;
+    os << "  Non-zeros: " << nnz() << std::endl;
+}
+
+// Explicit template instantiations
+template class Sparse_matrix<double>;
+template class Sparse_matrix<std::complex<double>>;
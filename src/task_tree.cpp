@@ -0,0 +1,113 @@
+#include "task_tree.h"
+#include "trace.h"
+#include <atomic>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+
+namespace {
+
+struct Task_deque {
+    std::mutex mutex;
+    std::deque<int> tasks;
+};
+
+} // namespace
+
+void Task_tree::run(Thread_pool* pool, const std::vector<int>& parent,
+                    const std::function<void(int, int)>& body) {
+    int n = static_cast<int>(parent.size());
+    if (n == 0)
+        return;
+
+    std::vector<int> num_children(n, 0);
+    for (int t = 0; t < n; t++)
+        if (parent[t] >= 0)
+            num_children[parent[t]]++;
+
+    if (!pool || pool->size() == 1) {
+        std::vector<int> ready;
+        for (int t = n - 1; t >= 0; t--)
+            if (num_children[t] == 0)
+                ready.push_back(t);
+        while (!ready.empty()) {
+            int t = ready.back();
+            ready.pop_back();
+            body(t, 0);
+            if (parent[t] >= 0 && --num_children[parent[t]] == 0)
+                ready.push_back(parent[t]);
+        }
+        return;
+    }
+
+    int num_threads = pool->size();
+    std::unique_ptr<std::atomic<int>[]> waiting(new std::atomic<int>[n]);
+    std::unique_ptr<Task_deque[]> deques(new Task_deque[num_threads]);
+    std::vector<int> leaves;
+    for (int t = 0; t < n; t++) {
+        waiting[t].store(num_children[t], std::memory_order_relaxed);
+        if (num_children[t] == 0)
+            leaves.push_back(t);
+    }
+    // Contiguous runs of leaves per thread: neighbouring leaves usually share a parent
+    int num_leaves = static_cast<int>(leaves.size());
+    for (int i = 0; i < num_leaves; i++)
+        deques[static_cast<long long>(i) * num_threads / num_leaves].tasks.push_back(leaves[i]);
+
+    std::atomic<int> remaining(n);
+    std::atomic<bool> failed(false);
+    std::exception_ptr error;
+    std::mutex error_mutex;
+
+    pool->run([&](int thread_id, int) {
+        Task_deque& own = deques[thread_id];
+        int spins = 0;
+        while (remaining.load(std::memory_order_acquire) > 0) {
+            int task = -1;
+            {
+                std::lock_guard<std::mutex> lock(own.mutex);
+                if (!own.tasks.empty()) {
+                    task = own.tasks.back();
+                    own.tasks.pop_back();
+                }
+            }
+            for (int v = 1; task < 0 && v < num_threads; v++) {
+                Task_deque& victim = deques[(thread_id + v) % num_threads];
+                std::lock_guard<std::mutex> lock(victim.mutex);
+                if (!victim.tasks.empty()) {
+                    task = victim.tasks.front();
+                    victim.tasks.pop_front();
+                }
+            }
+            if (task < 0) {
+                if (++spins > 64)
+                    std::this_thread::yield();
+                continue;
+            }
+            spins = 0;
+
+            if (!failed.load(std::memory_order_relaxed)) {
+                try {
+                    TRACE_SCOPE_ARG("tree_task", "task", task);
+                    body(task, thread_id);
+                } catch (...) {
+                    std::lock_guard<std::mutex> lock(error_mutex);
+                    if (!error)
+                        error = std::current_exception();
+                    failed.store(true, std::memory_order_relaxed);
+                }
+            }
+
+            int p = parent[task];
+            if (p >= 0 && waiting[p].fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                std::lock_guard<std::mutex> lock(own.mutex);
+                own.tasks.push_back(p);
+            }
+            remaining.fetch_sub(1, std::memory_order_acq_rel);
+        }
+    });
+
+    if (error)
+        std::rethrow_exception(error);
+}
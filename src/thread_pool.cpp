@@ -0,0 +1,39 @@
+#include "thread_pool.h"
+#include "executor.h"
+#include <algorithm>
+
+// ============================================================
+//  Spin_barrier
+// ============================================================
+
+Spin_barrier::Spin_barrier(int num_threads) : num_threads(num_threads), waiting(0), phase(0) {}
+
+void Spin_barrier::reset(int num_threads) {
+    this->num_threads = num_threads;
+    waiting.store(0, std::memory_order_relaxed);
+}
+
+void Spin_barrier::wait() {
+    int current = phase.load(std::memory_order_acquire);
+    if (waiting.fetch_add(1, std::memory_order_acq_rel) == num_threads - 1) {
+        waiting.store(0, std::memory_order_relaxed);
+        phase.fetch_add(1, std::memory_order_release);
+        return;
+    }
+    for (int spins = 0; phase.load(std::memory_order_acquire) == current; spins++)
+        if (spins > 1024)
+            std::this_thread::yield();
+}
+
+// ============================================================
+//  Thread_pool
+// ============================================================
+
+Thread_pool::Thread_pool(int num_threads) : num_threads(1), region_barrier(1) {
+    int budget = Executor::global()->budget();
+    this->num_threads = num_threads <= 0 ? budget : std::min(num_threads, budget);
+}
+
+int Thread_pool::run(const std::function<void(int, int)>& body) {
+    return Executor::global()->run_region(num_threads, body, [this](int threads) { region_barrier.reset(threads); });
+}
@@ -0,0 +1,172 @@
+#include "trace.h"
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+std::atomic<bool> Trace::enabled(false);
+
+namespace {
+
+struct Trace_event {
+    const char* name;
+    const char* arg_name;
+    double arg;
+    int64_t start_ns;
+    int64_t duration_ns;
+};
+
+// Ring buffer of one thread; only its thread writes, export reads it when quiescent
+struct Thread_buffer {
+    std::vector<Trace_event> events;
+    uint64_t written = 0;       // Events ever recorded (the ring keeps the last events.size())
+    int tid = 0;
+    std::string name;
+};
+
+struct Trace_state {
+    std::mutex mutex;                               // Guards the registry, not the buffers
+    std::vector<std::shared_ptr<Thread_buffer>> buffers;
+    std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+    size_t capacity = 1 << 16;
+    std::atomic<uint64_t> generation{1};           // Bumped by enable(): threads re-register
+};
+
+Trace_state& state() {
+    static Trace_state s;
+    return s;
+}
+
+struct Local_buffer {
+    std::shared_ptr<Thread_buffer> buffer;
+    uint64_t generation = 0;
+    std::string pending_name;   // Name set before the thread's first event
+};
+
+thread_local Local_buffer local;
+
+Thread_buffer& local_buffer() {
+    Trace_state& s = state();
+    uint64_t generation = s.generation.load(std::memory_order_acquire);
+    if (!local.buffer || local.generation != generation) {
+        auto buffer = std::make_shared<Thread_buffer>();
+        std::lock_guard<std::mutex> lock(s.mutex);
+        buffer->events.resize(s.capacity);
+        buffer->tid = static_cast<int>(s.buffers.size());
+        buffer->name = local.pending_name.empty() ? "thread " + std::to_string(buffer->tid) : local.pending_name;
+        s.buffers.push_back(buffer);
+        local.buffer = buffer;
+        local.generation = generation;
+    }
+    return *local.buffer;
+}
+
+std::string escape(const std::string& text) {
+    std::string out;
+    for (char c : text) {
+        if (c == '"' || c == '\\')
+            out += '\\';
+        if (static_cast<unsigned char>(c) >= 0x20)
+            out += c;
+    }
+    return out;
+}
+
+} // namespace
+
+void Trace::enable(size_t capacity_per_thread) {
+    Trace_state& s = state();
+    {
+        std::lock_guard<std::mutex> lock(s.mutex);
+        s.buffers.clear();
+        s.capacity = std::max<size_t>(1, capacity_per_thread);
+        s.epoch = std::chrono::steady_clock::now();
+    }
+    s.generation.fetch_add(1, std::memory_order_acq_rel);
+    enabled.store(true, std::memory_order_release);
+}
+
+void Trace::disable() {
+    enabled.store(false, std::memory_order_release);
+}
+
+void Trace::set_thread_name(const std::string& name) {
+    local.pending_name = name;
+    if (is_enabled())
+        local_buffer().name = name;
+}
+
+int64_t Trace::now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - state().epoch)
+        .count();
+}
+
+void Trace::record(const char* name, int64_t start_ns, int64_t end_ns, const char* arg_name, double arg) {
+    Thread_buffer& buffer = local_buffer();
+    buffer.events[buffer.written % buffer.events.size()] = {name, arg_name, arg, start_ns, end_ns - start_ns};
+    buffer.written++;
+}
+
+size_t Trace::event_count() {
+    Trace_state& s = state();
+    std::lock_guard<std::mutex> lock(s.mutex);
+    size_t count = 0;
+    for (const auto& buffer : s.buffers)
+        count += static_cast<size_t>(std::min<uint64_t>(buffer->written, buffer->events.size()));
+    return count;
+}
+
+size_t Trace::dropped_count() {
+    Trace_state& s = state();
+    std::lock_guard<std::mutex> lock(s.mutex);
+    size_t dropped = 0;
+    for (const auto& buffer : s.buffers)
+        if (buffer->written > buffer->events.size())
+            dropped += static_cast<size_t>(buffer->written - buffer->events.size());
+    return dropped;
+}
+
+void Trace::write_chrome_json(std::ostream& os) {
+    Trace_state& s = state();
+    std::lock_guard<std::mutex> lock(s.mutex);
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(3);
+    out << "{\"displayTimeUnit\": \"ns\", \"traceEvents\": [\n";
+    bool first = true;
+    uint64_t dropped = 0;
+    for (const auto& buffer : s.buffers) {
+        out << (first ? "" : ",\n") << "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": " << buffer->tid
+            << ", \"args\": {\"name\": \"" << escape(buffer->name) << "\"}}";
+        first = false;
+
+        // Oldest retained event first
+        uint64_t size = buffer->events.size();
+        uint64_t count = std::min<uint64_t>(buffer->written, size);
+        dropped += buffer->written - count;
+        for (uint64_t k = buffer->written - count; k < buffer->written; k++) {
+            const Trace_event& e = buffer->events[k % size];
+            out << ",\n{\"name\": \"" << escape(e.name) << "\", \"ph\": \"X\", \"pid\": 1, \"tid\": " << buffer->tid
+                << ", \"ts\": " << e.start_ns / 1000.0 << ", \"dur\": " << e.duration_ns / 1000.0;
+            if (e.arg_name)
+                out << ", \"args\": {\"" << escape(e.arg_name) << "\": " << std::setprecision(6) << e.arg
+                    << std::setprecision(3) << "}";
+            out << "}";
+        }
+    }
+    out << "\n], \"otherData\": {\"dropped_events\": " << dropped << "}}\n";
+    os << out.str();
+}
+
+void Trace::write_chrome_json_file(const std::string& filename) {
+    std::ofstream file(filename);
+    if (!file.is_open())
+        throw std::runtime_error("Could not write trace file: " + filename);
+    write_chrome_json(file);
+    if (!file)
+        throw std::runtime_error("Could not write trace file: " + filename);
+}
@@ -0,0 +1,156 @@
+#include "triangular_schedule.h"
+#include <algorithm>
+
+template<typename T>
+Triangular_schedule<T>::Triangular_schedule() : k0(0), size(0), lower(true), num_levels(0) {}
+
+// ============================================================
+//  Schedule construction
+// ============================================================
+
+template<typename T>
+void Triangular_schedule<T>::build(int k0, int k1, const std::vector<int>& col_ptr,
+                                   const std::vector<int>& row_idx, const std::vector<T>& val,
+                                   bool is_lower, int min_parallel_width) {
+    this->k0 = k0;
+    size = k1 - k0;
+    lower = is_lower;
+
+    int base = col_ptr[k0];
+    pattern_col_ptr.resize(size + 1);
+    for (int c = 0; c <= size; c++)
+        pattern_col_ptr[c] = col_ptr[k0 + c] - base;
+    pattern_row_idx.assign(row_idx.begin() + base, row_idx.begin() + col_ptr[k1]);
+
+    // Transpose the off-diagonal entries to rows
+    row_ptr.assign(size + 1, 0);
+    diag_src.assign(lower ? 0 : size, 0);
+    for (int c = 0; c < size; c++) {
+        int first = col_ptr[k0 + c] + (lower ? 1 : 0);
+        int last = col_ptr[k0 + c + 1] - (lower ? 0 : 1);
+        for (int p = first; p < last; p++)
+            row_ptr[row_idx[p] - k0 + 1]++;
+        if (!lower)
+            diag_src[c] = last;
+    }
+    for (int r = 0; r < size; r++)
+        row_ptr[r + 1] += row_ptr[r];
+
+    col_idx.resize(row_ptr[size]);
+    value_src.resize(row_ptr[size]);
+    std::vector<int> next(row_ptr.begin(), row_ptr.end() - 1);
+    for (int c = 0; c < size; c++) {
+        int first = col_ptr[k0 + c] + (lower ? 1 : 0);
+        int last = col_ptr[k0 + c + 1] - (lower ? 0 : 1);
+        for (int p = first; p < last; p++) {
+            int q = next[row_idx[p] - k0]++;
+            col_idx[q] = c;
+            value_src[q] = p;
+        }
+    }
+
+    // Level of a row = 1 + deepest level it depends on
+    std::vector<int> level(size, 0);
+    num_levels = 0;
+    for (int t = 0; t < size; t++) {
+        int r = lower ? t : size - 1 - t;
+        int lv = 0;
+        for (int q = row_ptr[r]; q < row_ptr[r + 1]; q++)
+            lv = std::max(lv, level[col_idx[q]] + 1);
+        level[r] = lv;
+        num_levels = std::max(num_levels, lv + 1);
+    }
+
+    // Counting sort of rows by level
+    std::vector<int> level_ptr(num_levels + 1, 0);
+    for (int r = 0; r < size; r++)
+        level_ptr[level[r] + 1]++;
+    for (int l = 0; l < num_levels; l++)
+        level_ptr[l + 1] += level_ptr[l];
+    order.resize(size);
+    next.assign(level_ptr.begin(), level_ptr.end() - 1);
+    for (int r = 0; r < size; r++)
+        order[next[level[r]]++] = r;
+
+    // Wide levels become parallel stages, runs of narrow levels one sequential stage
+    stage_ptr.assign(1, 0);
+    stage_parallel.clear();
+    for (int l = 0; l < num_levels; l++) {
+        bool wide = level_ptr[l + 1] - level_ptr[l] >= min_parallel_width;
+        if (wide || stage_parallel.empty() || stage_parallel.back()) {
+            stage_ptr.push_back(level_ptr[l + 1]);
+            stage_parallel.push_back(wide);
+        } else {
+            stage_ptr.back() = level_ptr[l + 1];
+        }
+    }
+
+    refresh(col_ptr, row_idx, val);
+}
+
+template<typename T>
+bool Triangular_schedule<T>::refresh(const std::vector<int>& col_ptr, const std::vector<int>& row_idx,
+                                     const std::vector<T>& val) {
+    int base = col_ptr[k0];
+    if (col_ptr[k0 + size] - base != static_cast<int>(pattern_row_idx.size()))
+        return false;
+    for (int c = 0; c <= size; c++)
+        if (col_ptr[k0 + c] - base != pattern_col_ptr[c])
+            return false;
+    if (!std::equal(pattern_row_idx.begin(), pattern_row_idx.end(), row_idx.begin() + base))
+        return false;
+
+    values.resize(value_src.size());
+    for (size_t q = 0; q < value_src.size(); q++)
+        values[q] = val[value_src[q]];
+    diag.resize(diag_src.size());
+    for (size_t c = 0; c < diag_src.size(); c++)
+        diag[c] = val[diag_src[c]];
+    return true;
+}
+
+// ============================================================
+//  Solve
+// ============================================================
+
+template<typename T>
+void Triangular_schedule<T>::solve_rows(T* x, int begin, int end) const {
+    for (int t = begin; t < end; t++) {
+        int r = order[t];
+        T sum = x[r];
+        for (int q = row_ptr[r]; q < row_ptr[r + 1]; q++)
+            sum -= values[q] * x[col_idx[q]];
+        x[r] = lower ? sum : sum / diag[r];
+    }
+}
+
+template<typename T>
+void Triangular_schedule<T>::solve(T* x, Thread_pool* pool) const {
+    T* xb = x + k0;
+    int num_stages = get_num_stages();
+    bool any_parallel = std::find(stage_parallel.begin(), stage_parallel.end(), 1) != stage_parallel.end();
+    if (!pool || pool->size() == 1 || !any_parallel) {
+        solve_rows(xb, 0, size);
+        return;
+    }
+
+    Spin_barrier& barrier = pool->barrier();
+    pool->run([&](int thread_id, int num_threads) {
+        for (int s = 0; s < num_stages; s++) {
+            int begin = stage_ptr[s], end = stage_ptr[s + 1];
+            if (stage_parallel[s]) {
+                long long width = end - begin;
+                solve_rows(xb, begin + static_cast<int>(width * thread_id / num_threads),
+                           begin + static_cast<int>(width * (thread_id + 1) / num_threads));
+            } else if (thread_id == 0) {
+                solve_rows(xb, begin, end);
+            }
+            if (s + 1 < num_stages)
+                barrier.wait();
+        }
+    });
+}
+
+// Explicit template instantiations
+template class Triangular_schedule<double>;
+template class Triangular_schedule<std::complex<double>>;
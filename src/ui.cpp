@@ -1,6 +1,10 @@
 #include "ui.h"
+#include "netlist_generator.h"
+#include "output_writer.h"
+#include <sstream>
+#include <stdexcept>
 
-UI::UI() : input_file(""), output_file("output.log"), verbose(false), pause(false), program_name("circuit_simulator") {}
+UI::UI() : input_file(""), output_file("output.log"), solver_method("auto"), num_threads(1), thread_budget(0), affinity("none"), mc_samples(0), mc_seed(1), server(false), generate_size(0), perf(false), memory(false), telemetry_every(1), gs_max_iter(1000), gs_tolerance(1e-9), gs_damping(0.5), verbose(false), pause(false), program_name("circuit_simulator") {}
 
 bool UI::parse_arguments(int argc, char* argv[]) {
     program_name = argv[0];
@@ -13,6 +17,117 @@ bool UI::parse_arguments(int argc, char* argv[]) {
             output_file = argv[++i];
         } else if(arg == "-ac_csv" && i + 1 < argc) {
             ac_output_file = argv[++i];
+        } else if(arg == "-solver" && i + 1 < argc) {
+            solver_method = argv[++i];
+            if(solver_method != "auto" && solver_method != "gs" && solver_method != "lu" && solver_method != "pcg") {
+                std::cerr << "Unknown solver: " << solver_method << std::endl;
+                print_usage();
+                return false;
+            }
+        } else if((arg == "-threads" || arg == "-budget") && i + 1 < argc) {
+            int value = -1;
+            try {
+                value = std::stoi(argv[++i]);
+            } catch (const std::exception&) {
+                value = -1;
+            }
+            if(value < 0) {
+                std::cerr << "Invalid thread count: " << argv[i] << std::endl;
+                print_usage();
+                return false;
+            }
+            (arg == "-threads" ? num_threads : thread_budget) = value;
+        } else if(arg == "-affinity" && i + 1 < argc) {
+            affinity = argv[++i];
+            if(affinity != "none" && affinity != "compact" && affinity != "scatter") {
+                std::cerr << "Unknown affinity: " << affinity << std::endl;
+                print_usage();
+                return false;
+            }
+        } else if((arg == "-mc" || arg == "-seed") && i + 1 < argc) {
+            long long value = -1;
+            try {
+                value = std::stoll(argv[++i]);
+            } catch (const std::exception&) {
+                value = -1;
+            }
+            if(value < 0 || (arg == "-mc" && value > 2147483647LL)) {
+                std::cerr << "Invalid " << (arg == "-mc" ? "sample count" : "seed") << ": " << argv[i] << std::endl;
+                print_usage();
+                return false;
+            }
+            if(arg == "-mc")
+                mc_samples = static_cast<int>(value);
+            else
+                mc_seed = static_cast<uint64_t>(value);
+        } else if(arg == "-cache" && i + 1 < argc) {
+            cache_dir = argv[++i];
+        } else if(arg == "-tune" && i + 1 < argc) {
+            tune_dir = argv[++i];
+        } else if(arg == "-compile" && i + 1 < argc) {
+            image_file = argv[++i];
+        } else if(arg == "-server") {
+            server = true;
+        } else if(arg == "-socket" && i + 1 < argc) {
+            socket_path = argv[++i];
+        } else if(arg == "-generate" && i + 2 < argc) {
+            generate_topology = argv[++i];
+            try {
+                Netlist_generator::Spec spec;
+                Netlist_generator::parse_topology(generate_topology, spec);
+            } catch (const std::invalid_argument& e) {
+                std::cerr << e.what() << std::endl;
+                print_usage();
+                return false;
+            }
+            long long value = -1;
+            try {
+                value = std::stoll(argv[++i]);
+            } catch (const std::exception&) {
+                value = -1;
+            }
+            if(value < 2) {
+                std::cerr << "Invalid generated circuit size: " << argv[i] << std::endl;
+                print_usage();
+                return false;
+            }
+            generate_size = static_cast<size_t>(value);
+        } else if(arg == "-write_netlist" && i + 1 < argc) {
+            netlist_output = argv[++i];
+        } else if(arg == "-trace" && i + 1 < argc) {
+            trace_file = argv[++i];
+        } else if(arg == "-perf") {
+            perf = true;
+        } else if(arg == "-mem") {
+            memory = true;
+        } else if(arg == "-telemetry" && i + 1 < argc) {
+            telemetry_file = argv[++i];
+        } else if((arg == "-telemetry_every" || arg == "-gs_iter") && i + 1 < argc) {
+            int value = 0;
+            try {
+                value = std::stoi(argv[++i]);
+            } catch (const std::exception&) {
+                value = 0;
+            }
+            if(value < (arg == "-gs_iter" ? 2 : 1)) {
+                std::cerr << "Invalid " << (arg == "-gs_iter" ? "iteration limit" : "sampling period") << ": " << argv[i] << std::endl;
+                print_usage();
+                return false;
+            }
+            (arg == "-gs_iter" ? gs_max_iter : telemetry_every) = value;
+        } else if((arg == "-gs_tol" || arg == "-gs_damping") && i + 1 < argc) {
+            double value = 0.0;
+            try {
+                value = std::stod(argv[++i]);
+            } catch (const std::exception&) {
+                value = 0.0;
+            }
+            if(!(value > 0.0) || (arg == "-gs_damping" && value > 1.0)) {
+                std::cerr << "Invalid " << (arg == "-gs_tol" ? "tolerance" : "damping factor") << ": " << argv[i] << std::endl;
+                print_usage();
+                return false;
+            }
+            (arg == "-gs_tol" ? gs_tolerance : gs_damping) = value;
         } else if(arg == "-h") {
             print_usage();
             return false;
@@ -27,8 +142,8 @@ bool UI::parse_arguments(int argc, char* argv[]) {
         }
     }
     
-    // Check if input file was provided
-    if(input_file.empty()) {
+    // Check if input file was provided (servers load circuits on request)
+    if(input_file.empty() && generate_topology.empty() && !server && socket_path.empty()) {
         std::cerr << "Error: Input file is required. Use -i <filename>" << std::endl;
         print_usage();
         return false;
@@ -38,10 +153,33 @@ bool UI::parse_arguments(int argc, char* argv[]) {
 }
 
 void UI::print_usage() const {
-    std::cout << "Usage: " << program_name << " -i input_file [-o output.log] [-ac_csv ac_analysis_results.csv] [-v]" << std::endl;
-    std::cout << "  -i <file>       Input netlist file (required)" << std::endl;
+    std::cout << "Usage: " << program_name << " -i input_file [-o output.log] [-ac_csv ac_analysis_results.csv] [-solver auto|gs|lu|pcg] [-threads n] [-budget n] [-affinity none|compact|scatter] [-mc samples [-seed n]] [-cache dir] [-tune dir] [-compile image] [-generate topology size [-write_netlist file]] [-trace trace.json] [-perf] [-mem] [-telemetry gs.csv [-telemetry_every n]] [-gs_iter n] [-gs_tol t] [-gs_damping w] [-server | -socket path] [-v]" << std::endl;
+    std::cout << "  -i <file>       Input netlist file or compiled circuit image (required)" << std::endl;
     std::cout << "  -o <file>       Output results file (default: output.log)" << std::endl;
     std::cout << "  -ac_csv <file>  AC analysis results CSV file (default: ac_analysis_results.csv)" << std::endl;
+    std::cout << "  -solver <auto|gs|lu|pcg> Linear solver: from the system structure, Gauss-Seidel, sparse LU or conjugate gradient (default: auto)" << std::endl;
+    std::cout << "  -threads <n>    Threads for sparse LU triangular solves, 0 = whole budget (default: 1)" << std::endl;
+    std::cout << "  -budget <n>     Threads shared by all parallel stages incl. the main thread, 0 = all cores (default: 0)" << std::endl;
+    std::cout << "  -affinity <none|compact|scatter> Pin worker threads to neighbouring or spread-out CPUs (default: none)" << std::endl;
+    std::cout << "  -mc <samples>   Monte Carlo tolerance analysis with the given sample count (default: off)" << std::endl;
+    std::cout << "  -seed <n>       Monte Carlo base seed and generator seed (default: 1)" << std::endl;
+    std::cout << "  -cache <dir>    Reuse DC/AC results of identical circuits stored in dir (default: off)" << std::endl;
+    std::cout << "  -tune <dir>     Apply the solver configuration tuned for this circuit in dir, tuning it first if missing (default: off)" << std::endl;
+    std::cout << "  -compile <file> Write the built circuit as a binary image to file and exit" << std::endl;
+    std::cout << "  -generate <topology> <size>" << std::endl;
+    std::cout << "                  Simulate a generated circuit instead of -i: ladder, grid[:dims], tree[:branching]," << std::endl;
+    std::cout << "                  random[:degree] or rlc with size nodes" << std::endl;
+    std::cout << "  -write_netlist <file> Write the generated netlist to file and exit" << std::endl;
+    std::cout << "  -trace <file>   Write phase timings of all threads as Chrome trace JSON (chrome://tracing, Perfetto)" << std::endl;
+    std::cout << "  -perf           Report cycles, IPC, cache/branch misses, GFLOP/s and GB/s per solver phase (Linux)" << std::endl;
+    std::cout << "  -mem            Report heap bytes, allocations and peaks per subsystem (MEMORY=1 builds), and peak RSS" << std::endl;
+    std::cout << "  -telemetry <file> Write Gauss-Seidel residuals, sweep times and pivots (CSV, JSON if *.json)" << std::endl;
+    std::cout << "  -telemetry_every <n> Sample the residual every n sweeps (default: 1)" << std::endl;
+    std::cout << "  -gs_iter <n>    Gauss-Seidel iteration limit (default: 1000)" << std::endl;
+    std::cout << "  -gs_tol <t>     Gauss-Seidel convergence tolerance (default: 1e-9)" << std::endl;
+    std::cout << "  -gs_damping <w> Gauss-Seidel damping factor in (0, 1] (default: 0.5)" << std::endl;
+    std::cout << "  -server         Serve load/set/dc/ac/probe requests on stdin/stdout (no -i needed)" << std::endl;
+    std::cout << "  -socket <path>  Serve the same requests on a UNIX domain socket" << std::endl;
     std::cout << "  -v              Verbose mode" << std::endl;
     std::cout << "  -h              Show help" << std::endl;
 }
@@ -53,20 +191,41 @@ void UI::print_banner(std::ostream& os) const {
        << "╚════════════════════════════════════╝\n\n";
 }
 
-void UI::output_results(const std::string& circuit_output) {
-    // Write to file
-    std::ofstream out(output_file);
-    if(!out) {
-        std::cerr << "Error: Could not open output file: " << output_file << std::endl;
-        return;
-    }
+void UI::output_results(const std::string& circuit_output, Output_writer* writer) {
+    if(writer) {
+        // Queued: the writer thread writes the file while the run finishes
+        int sink = writer->open(output_file);
+        if(sink < 0) {
+            std::cerr << "Error: Could not open output file: " << output_file << std::endl;
+            return;
+        }
+        std::ostringstream banner;
+        print_banner(banner);
+        writer->write_text(sink, banner.str() + circuit_output);
+        if(verbose) {
+            std::cout << circuit_output;
+        }
+        try {
+            writer->close(sink);    // The report is on disk before it is announced
+        } catch(const std::exception& e) {
+            std::cerr << "Error: " << e.what() << std::endl;
+            return;
+        }
+    } else {
+        // Write to file
+        std::ofstream out(output_file);
+        if(!out) {
+            std::cerr << "Error: Could not open output file: " << output_file << std::endl;
+            return;
+        }
 
-    print_banner(out);
-    out << circuit_output;
-    out.close();
-    
-    if(verbose) {
-        std::cout << circuit_output;
+        print_banner(out);
+        out << circuit_output;
+        out.close();
+
+        if(verbose) {
+            std::cout << circuit_output;
+        }
     }
     
     std::cout << "Circuit analysis complete. Results written to: " << output_file << std::endl;
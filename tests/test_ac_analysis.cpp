@@ -33,6 +33,7 @@
 
 #include "simulator.h"
 #include "circuit_builder.h"
+#include "memory_accounting.h"
 
 // ============================================================================
 // CONSTANTS AND CONFIGURATION
@@ -51,6 +52,8 @@ struct ACTestCase {
     std::string description;
     std::string netlist_content;
     double test_frequency;  // Frequency to test at (Hz)
+    double sweep_start;     // First frequency of the sweep ending at test_frequency (Hz)
+    double sweep_step;      // Linear sweep increment (Hz)
     
     // Expected values: node_id -> (real, imaginary)
     std::map<std::string, std::pair<double, double>> expected_voltages;
@@ -66,6 +69,8 @@ struct ACTestCase {
           description(desc), 
           netlist_content(netlist),
           test_frequency(freq),
+          sweep_start(freq),
+          sweep_step(1.0),
           tolerance(tol) {}
 };
 
@@ -93,6 +98,19 @@ struct ACTestResult {
 // UTILITY FUNCTIONS
 // ============================================================================
 
+/**
+ * @brief Counts the heap allocations made by a callable.
+ */
+template<typename F>
+uint64_t count_allocations(F&& run) {
+    Memory_accounting::enable();
+    uint64_t before = Memory_accounting::total().allocations;
+    run();
+    uint64_t allocations = Memory_accounting::total().allocations - before;
+    Memory_accounting::disable();
+    return allocations;
+}
+
 /**
  * @brief Compares two complex values (real and imaginary parts).
  */
@@ -296,7 +314,7 @@ private:
 
             Simulator simulator(csv_file);
             simulator.run_dc_analysis(circuit);
-            simulator.run_ac_analysis(circuit, test.test_frequency);
+            simulator.run_ac_analysis(circuit, test.sweep_start, test.test_frequency, test.sweep_step);
 
             auto csv_data = parse_ac_csv(csv_file);
 
@@ -311,6 +329,16 @@ private:
             } else {
                 validate_voltages(test, var_index_map, csv_data, result);
             }
+
+            // Frequency points must not allocate: once warm, a 5-point sweep costs
+            // exactly the per-sweep setup of a 1-point one
+            double f = test.test_frequency;
+            simulator.run_ac_analysis(circuit, f, 16 * f, 2.0, true);
+            uint64_t single = count_allocations([&] { simulator.run_ac_analysis(circuit, f); });
+            uint64_t sweep = count_allocations([&] { simulator.run_ac_analysis(circuit, f, 16 * f, 2.0, true); });
+            if (sweep != single)
+                result.add_error("4 extra frequency points made " + std::to_string(static_cast<long long>(sweep - single)) +
+                                 " heap allocation(s)");
             
             std::remove(netlist_file.c_str());
             std::remove(csv_file.c_str());
@@ -961,6 +989,65 @@ void setup_complex_rlc_test(ACTestRunner& runner) {
     runner.add_test_case(test);
 }
 
+/**
+ * @brief Test 16: RC Low-Pass Filter @ 3kHz, third point of a 1-3kHz sweep
+ * 
+ * Same circuit as Test 1. Each frequency re-stamps the capacitor into the
+ * AC matrix; from the third point on, a wrong re-stamp shows up here.
+ * 
+ * Calculations:
+ * ωRC = 2π × 3000 × 1000 × 0.000001 = 18.8496
+ * H(jω) = 1 / (1 + j18.8496) = (1 - j18.8496) / 356.307
+ *       = 0.0028066 - j0.052903
+ * V(2) = 20 × (0.0028066 - j0.052903) = 0.05613 - j1.05806 V
+ */
+void setup_rc_sweep_test(ACTestRunner& runner) {
+    ACTestCase test("AC_RC_Sweep_3kHz",
+                   "RC low-pass filter, third point of a sweep",
+                   "* RC Low-Pass Filter\n"
+                   "V1 1 0 AC 20\n"
+                   "R1 1 2 1000\n"
+                   "C1 2 0 0.000001\n",
+                   3000.0);
+    test.sweep_start = 1000.0;
+    test.sweep_step = 1000.0;
+    
+    test.expected_voltages["0"] = {0.0, 0.0};
+    test.expected_voltages["1"] = {20.0, 0.0};
+    test.expected_voltages["2"] = {0.05613, -1.05806};
+    
+    runner.add_test_case(test);
+}
+
+/**
+ * @brief Test 17: RL High-Pass Filter @ 30kHz, third point of a 10-30kHz sweep
+ * 
+ * Same circuit as Test 2; checks the re-stamping of the inductor.
+ * 
+ * Calculations:
+ * ωL = 2π × 30000 × 0.001 = 188.496 Ω
+ * H(jω) = 100 / (100 + j188.496) = (10000 - j18849.6) / 45530.7
+ *       = 0.219632 - j0.414001
+ * V(2) = 10 × (0.219632 - j0.414001) = 2.19632 - j4.14001 V
+ */
+void setup_rl_sweep_test(ACTestRunner& runner) {
+    ACTestCase test("AC_RL_Sweep_30kHz",
+                   "RL high-pass filter, third point of a sweep",
+                   "* RL High-Pass Filter\n"
+                   "V1 1 0 AC 10\n"
+                   "L1 1 2 0.001\n"
+                   "R1 2 0 100\n",
+                   30000.0);
+    test.sweep_start = 10000.0;
+    test.sweep_step = 10000.0;
+    
+    test.expected_voltages["0"] = {0.0, 0.0};
+    test.expected_voltages["1"] = {10.0, 0.0};
+    test.expected_voltages["2"] = {2.19632, -4.14001};
+    
+    runner.add_test_case(test);
+}
+
 // ============================================================================
 // MAIN FUNCTION
 // ============================================================================
@@ -989,6 +1076,8 @@ int main() {
     setup_rc_highfreq_test(runner);
     setup_bridge_test(runner);
     setup_ind_divider_test(runner);
+    setup_rc_sweep_test(runner);
+    setup_rl_sweep_test(runner);
     
     bool all_passed = runner.run_all_tests();
     runner.print_summary();
@@ -0,0 +1,166 @@
+/**
+ * @file test_async_analysis.cpp
+ * @brief Asynchronous Analysis Test Suite
+ *
+ * Verifies executor jobs, asynchronous DC/AC analyses, progress reports and
+ * cancellation.
+ */
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cmath>
+#include <iomanip>
+#include <algorithm>
+#include <memory>
+#include <atomic>
+#include <future>
+#include <stdexcept>
+
+#include "simulator.h"
+#include "netlist_generator.h"
+#include "compiled_circuit.h"
+#include "executor.h"
+#include "test_runner.h"
+
+// ============================================================================
+// HELPER FUNCTIONS
+// ============================================================================
+
+// Infinity norm of A x - b over the assembled MNA system
+double mna_residual(const Circuit& circuit, const std::vector<double>& x) {
+    double worst = 0.0;
+    for (const auto& [row, col_map] : circuit.get_MNA_matrix()) {
+        double sum = 0.0;
+        for (const auto& [col, value] : col_map)
+            sum += value * x[col];
+        auto it = circuit.get_MNA_vector().find(row);
+        double rhs = (it != circuit.get_MNA_vector().end()) ? it->second : 0.0;
+        worst = std::max(worst, std::abs(sum - rhs));
+    }
+    return worst;
+}
+
+// ============================================================================
+// TEST CASES
+// ============================================================================
+
+// TEST 1: Asynchronous analyses with progress and cancellation
+void test_async_analysis(TestRunner& runner) {
+    runner.start_test("TEST 1: Asynchronous analyses and cancellation");
+
+    auto build = [](Netlist_generator::Topology topology, size_t size, const std::string& name) {
+        Node::valid = false;
+        Node::node_count = 0;
+        std::unique_ptr<Circuit> circuit(new Circuit(name));
+        Netlist_generator::Spec spec;
+        spec.topology = topology;
+        spec.size = size;
+        Netlist_generator(spec).build(*circuit);
+        circuit->assemble_MNA_system();
+        return circuit;
+    };
+    std::unique_ptr<Circuit> grid = build(Netlist_generator::Topology::grid, 900, "async_grid");
+    std::unique_ptr<Circuit> rlc = build(Netlist_generator::Topology::rlc, 200, "async_rlc");
+
+    // Executor: results, exceptions and jobs submitted from inside jobs
+    {
+        Executor executor(3);
+        std::future<int> nested = executor.submit([&executor]() {
+            return executor.submit([]() { return 20; }).get() + 1;
+        });
+        std::future<int> failing = executor.submit([]() -> int { throw std::runtime_error("job failed"); });
+        bool rethrown = false;
+        try {
+            failing.get();
+        } catch (const std::runtime_error&) {
+            rethrown = true;
+        }
+        runner.assert_true(nested.get() == 21 && rethrown, "Executor returns results and rethrows job errors");
+    }
+
+    // Overlapping DC and AC jobs match the blocking analyses
+    Simulator simulator("temp_lu_async.csv");
+    std::atomic<size_t> calls(0), last_done(0), total(0);
+    bool ordered = true;
+    std::future<Ac_result> sweep = simulator.run_ac_analysis_async(*rlc, 100.0, 1e5, 1.5, true, Cancellation_token(),
+        [&](size_t done, size_t points) {
+            ordered = ordered && done == last_done.load() + 1;
+            last_done = done;
+            total = points;
+            calls++;
+        });
+    std::future<Dc_result> op = simulator.run_dc_analysis_async(*grid);
+    Simulator blocking;
+    blocking.run_dc_analysis(*grid);
+    const Dc_result dc = op.get();
+    double worst = 0.0;
+    for (size_t k = 1; k < blocking.get_solution().size(); k++)
+        worst = std::max(worst, std::abs(dc.value(static_cast<int>(k)) - blocking.get_solution()[k]));
+    runner.assert_near(worst, 0.0, 1e-9, "Asynchronous DC matches the blocking analysis");
+    const Ac_result ac = sweep.get();
+    runner.assert_true(ordered && calls == ac.points() && total == ac.points() && ac.points() > 10,
+                       "Progress reported once per point (" + std::to_string(calls.load()) + " points)");
+
+    // A cancelled token aborts a queued job before it solves
+    Cancellation_token stale = Cancellation_token::create();
+    stale.cancel();
+    std::future<Dc_result> aborted = simulator.run_dc_analysis_async(*grid, stale);
+    bool cancelled = false;
+    try {
+        aborted.get();
+    } catch (const Analysis_cancelled&) {
+        cancelled = true;
+    }
+    runner.assert_true(cancelled, "Cancelled job throws Analysis_cancelled");
+
+    // Cancelling mid-sweep stops at the next frequency point
+    Cancellation_token token = Cancellation_token::create();
+    std::atomic<size_t> reached(0);
+    std::future<Ac_result> stopped = simulator.run_ac_analysis_async(*rlc, 100.0, 1e5, 1.01, true, token,
+        [&](size_t done, size_t) {
+            reached = done;
+            if (done == 3)
+                token.cancel();
+        });
+    cancelled = false;
+    try {
+        stopped.get();
+    } catch (const Analysis_cancelled&) {
+        cancelled = true;
+    }
+    runner.assert_true(cancelled && reached == 3, "Sweep cancelled after 3 points");
+
+    // The blocking analyses poll the same tokens inside the factorization
+    Simulator sync;
+    sync.set_solver_method(Solver::Method::sparse_lu);
+    sync.set_cancellation(stale);
+    cancelled = false;
+    try {
+        sync.run_dc_analysis(*grid);
+    } catch (const Analysis_cancelled&) {
+        cancelled = true;
+    }
+    sync.set_cancellation(Cancellation_token());
+    sync.run_dc_analysis(*grid);
+    runner.assert_true(cancelled && mna_residual(*grid, sync.get_solution()) < 1e-9,
+                       "Blocking analysis cancelled, then re-run with an inert token");
+}
+
+// ============================================================================
+// MAIN
+// ============================================================================
+
+int main() {
+    std::cout << std::string(70, '=') << std::endl;
+    std::cout << "                   ASYNCHRONOUS ANALYSIS TEST SUITE" << std::endl;
+    std::cout << std::string(70, '=') << std::endl;
+
+    TestRunner runner;
+    // Parallel tests ask for up to 4 threads; size the shared runtime to match
+    Executor::configure_global(Executor::Options{4, Executor::Affinity::none});
+
+    test_async_analysis(runner);
+
+    return runner.print_summary() ? 0 : 1;
+}
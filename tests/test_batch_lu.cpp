@@ -0,0 +1,190 @@
+/**
+ * @file test_batch_lu.cpp
+ * @brief Batched LU Test Suite
+ *
+ * Verifies lane-batched solves of same-pattern systems, including lanes that
+ * fall back to a factorization of their own.
+ */
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+#include <cstdint>
+#include <algorithm>
+#include <memory>
+
+#include "simulator.h"
+#include "circuit_builder.h"
+#include "sparse_lu.h"
+#include "batch_lu.h"
+#include "memory_accounting.h"
+#include "test_runner.h"
+
+// ============================================================================
+// HELPER FUNCTIONS
+// ============================================================================
+
+void build_from_text(Circuit& circuit, const std::string& content) {
+    CircuitBuilder().build_from_text(circuit, content);
+    circuit.assemble_MNA_system();
+}
+
+// Solves W perturbed copies of A in lanes and compares each lane with Sparse_lu
+template<int W>
+double batch_lane_error(const Sparse_matrix<double>& A, const std::vector<double>& b) {
+    Batch_lu<W> batch;
+    batch.analyze(A);
+    std::vector<double> values(static_cast<size_t>(A.nnz()) * W), x(static_cast<size_t>(A.n) * W);
+    for (int l = 0; l < W; l++) {
+        for (int p = 0; p < A.nnz(); p++)
+            values[p * W + l] = A.values[p] * (1.0 + 0.01 * l * std::sin(1.0 + p));
+        for (int i = 0; i < A.n; i++)
+            x[i * W + l] = b[i];
+    }
+    batch.factorize(values);
+    batch.solve(x);
+
+    double worst = 0.0;
+    for (int l = 0; l < W; l++) {
+        Sparse_matrix<double> lane = A;
+        for (int p = 0; p < A.nnz(); p++)
+            lane.values[p] = values[p * W + l];
+        Sparse_lu<double> lu;
+        lu.factorize(lane);
+        std::vector<double> ref = b;
+        lu.solve(ref);
+        double diff = 0.0, scale = 0.0;
+        for (int i = 0; i < A.n; i++) {
+            diff = std::max(diff, std::abs(x[i * W + l] - ref[i]));
+            scale = std::max(scale, std::abs(ref[i]));
+        }
+        worst = std::max(worst, diff / scale);
+    }
+    return worst;
+}
+
+// ============================================================================
+// TEST CASES
+// ============================================================================
+
+// TEST 1: Lane-batched solves of same-pattern systems
+void test_batch_lu(TestRunner& runner) {
+    runner.start_test("TEST 1: Batched SIMD-lane LU");
+
+    std::ostringstream grid;
+    grid << "* 12x12 grid\nV1 n0_0 0 5\nI1 0 n11_11 0.002\n";
+    for (int r = 0; r < 12; r++)
+        for (int c = 0; c < 12; c++) {
+            std::string node = "n" + std::to_string(r) + "_" + std::to_string(c);
+            if (c + 1 < 12)
+                grid << "Rh" << r << "_" << c << " " << node << " n" << r << "_" << c + 1 << " " << 100 + 7 * c << "\n";
+            if (r + 1 < 12)
+                grid << "Rv" << r << "_" << c << " " << node << " n" << r + 1 << "_" << c << " " << 150 + 5 * r << "\n";
+        }
+    grid << "Rg n6_6 0 1000\n";
+
+    const char* paths[] = {"tests/test_netlists/voltage_divider.net", nullptr};
+    for (const char* path : paths) {
+        Node::valid = false;
+        Node::node_count = 0;
+        Circuit circuit(path ? path : "grid");
+        if (path) {
+            CircuitBuilder().build(circuit, path);
+            circuit.assemble_MNA_system();
+        } else {
+            build_from_text(circuit, grid.str());
+        }
+        Sparse_matrix<double> A;
+        A.assemble(circuit.get_MNA_matrix());
+        std::vector<double> b;
+        A.gather(circuit.get_MNA_vector(), b);
+        std::string label = path ? "voltage_divider" : "12x12 grid";
+        runner.assert_true(batch_lane_error<4>(A, b) < 1e-12, label + ": 4 lanes match Sparse_lu");
+        runner.assert_true(batch_lane_error<8>(A, b) < 1e-12, label + ": 8 lanes match Sparse_lu");
+        runner.assert_true(batch_lane_error<16>(A, b) < 1e-12, label + ": 16 lanes match Sparse_lu");
+    }
+
+    // Lane 1 has a zero where lane 0 pivots: it must be redone with its own pivots
+    Sparse_matrix<double> A;
+    A.n = 2;
+    A.col_ptr = {0, 2, 4};
+    A.row_idx = {0, 1, 0, 1};
+    A.values = {1.0, 1.0, 1.0, 0.0};
+    Batch_lu<4> batch;
+    batch.analyze(A);
+    std::vector<double> values = {1.0, 0.0, 2.0, 1.0,   1.0, 1.0, 1.0, 1.0,   1.0, 1.0, 1.0, 1.0,   0.0, 0.0, 0.0, 0.0};
+    std::vector<double> x = {1.0, 1.0, 1.0, 1.0,   2.0, 2.0, 2.0, 2.0};
+    batch.factorize(values);
+    batch.solve(x);
+    runner.assert_true(batch.num_fallback_lanes() == 1, "Rejected pivot detected in one lane");
+    // [[a, 1], [1, 0]] x = [1, 2]  =>  x0 = 2, x1 = 1 - 2a
+    bool all_lanes = true;
+    for (int l = 0; l < 4; l++)
+        all_lanes = all_lanes && std::abs(x[l] - 2.0) < 1e-14 && std::abs(x[4 + l] - (1.0 - 2.0 * values[l])) < 1e-14;
+    runner.assert_true(all_lanes, "Every lane solved, including the fallback lane");
+
+    // Warm solves with a fallback lane reuse the scratch sized by analyze()
+    Memory_accounting::enable();
+    uint64_t before = Memory_accounting::total().allocations;
+    for (int repeat = 0; repeat < 10; repeat++)
+        batch.solve(x);
+    uint64_t allocations = Memory_accounting::total().allocations - before;
+    Memory_accounting::disable();
+    runner.assert_true(allocations == 0, "Warm solves allocate nothing (" + std::to_string(allocations) + " allocations)");
+}
+
+// TEST 2: Batch runs of small same-topology netlists through the Simulator
+void test_simulator_batch(TestRunner& runner) {
+    runner.start_test("TEST 2: Simulator batch of small circuits");
+
+    // 19 voltage dividers (two full lane groups and a short one) and one circuit of another pattern
+    std::vector<std::unique_ptr<Circuit>> circuits;
+    std::vector<Circuit*> batch;
+    for (int k = 0; k < 20; k++) {
+        Node::valid = false;
+        Node::node_count = 0;
+        circuits.emplace_back(new Circuit("divider_" + std::to_string(k)));
+        std::ostringstream netlist;
+        if (k == 7)
+            netlist << "* Ladder\nV1 1 0 10.0\nR1 1 2 1000\nR2 2 3 1000\nR3 3 0 2000\n";
+        else
+            netlist << "* Voltage divider\nV1 1 0 10.0\nR1 1 2 1000\nR2 2 0 " << 100 * (k + 1) << "\n";
+        build_from_text(*circuits.back(), netlist.str());
+        batch.push_back(circuits.back().get());
+    }
+
+    Simulator simulator;
+    int lanes = simulator.run_batch(batch);
+    runner.assert_true(lanes == 19, "Same-pattern circuits solved in lanes (" + std::to_string(lanes) + " of 20)");
+
+    double worst = 0.0;
+    for (int k = 0; k < 20; k++) {
+        if (k == 7)
+            continue;
+        double r2 = 100.0 * (k + 1);
+        worst = std::max(worst, std::abs(circuits[k]->get_nodes().at("2")->voltage - 10.0 * r2 / (1000.0 + r2)));
+        worst = std::max(worst, std::abs(circuits[k]->get_components().at("V1")->get_current() + 10.0 / (1000.0 + r2)));
+    }
+    runner.assert_near(worst, 0.0, 1e-12, "Every divider matches V1 * R2 / (R1 + R2)");
+    runner.assert_near(circuits[7]->get_nodes().at("3")->voltage, 5.0, 1e-12, "Other pattern solved by the scalar path");
+}
+
+// ============================================================================
+// MAIN
+// ============================================================================
+
+int main() {
+    std::cout << std::string(70, '=') << std::endl;
+    std::cout << "                        BATCHED LU TEST SUITE" << std::endl;
+    std::cout << std::string(70, '=') << std::endl;
+
+    TestRunner runner;
+
+    test_batch_lu(runner);
+    test_simulator_batch(runner);
+
+    return runner.print_summary() ? 0 : 1;
+}
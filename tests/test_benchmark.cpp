@@ -0,0 +1,81 @@
+/**
+ * @file test_benchmark.cpp
+ * @brief Phase Benchmark Test Suite
+ *
+ * Verifies the benchmark statistics, the JSON report round trip and the
+ * baseline regression check.
+ */
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+
+#include "simulator.h"
+#include "benchmark.h"
+#include "test_runner.h"
+
+// ============================================================================
+// TEST CASES
+// ============================================================================
+
+// TEST 1: Benchmark statistics, JSON reports and baseline comparison
+void test_benchmark_report(TestRunner& runner) {
+    runner.start_test("TEST 1: Benchmark reports and regression detection");
+
+    Benchmark_stats stats = Benchmark_stats::from_samples({40.0, 10.0, 30.0, 20.0});
+    runner.assert_true(stats.repetitions == 4 && stats.min == 10.0 && stats.max == 40.0, "Sample range");
+    runner.assert_near(stats.median, 25.0, 1e-12, "Median of an even sample count");
+    runner.assert_near(stats.stddev, std::sqrt(500.0 / 3.0), 1e-12, "Sample standard deviation");
+
+    Benchmark_report baseline;
+    baseline.set_metadata("solver", "lu \"sparse\"");
+    baseline.add({"ladder", 1000, 1063, 3125, "parse", Benchmark_stats::from_samples({1000.0})});
+    baseline.add({"ladder", 1000, 1063, 3125, "dc_solve", Benchmark_stats::from_samples({1000.0})});
+    baseline.add({"grid", 1000, 962, 4663, "dc_solve", Benchmark_stats::from_samples({2.0})});
+    std::stringstream json;
+    baseline.write_json(json);
+    Benchmark_report loaded = Benchmark_report::read_json(json);
+    runner.assert_true(loaded.get_results().size() == 3 && loaded.get_results()[1].key() == "ladder/1000/dc_solve" &&
+                       loaded.get_results()[0].nonzeros == 3125 && loaded.get_metadata().at("solver") == "lu \"sparse\"",
+                       "JSON round trip");
+
+    Benchmark_report current;
+    current.add({"ladder", 1000, 1063, 3125, "parse", Benchmark_stats::from_samples({700.0})});
+    current.add({"ladder", 1000, 1063, 3125, "dc_solve", Benchmark_stats::from_samples({1300.0})});
+    current.add({"grid", 1000, 962, 4663, "dc_solve", Benchmark_stats::from_samples({4.0})});
+    current.add({"tree", 1000, 1001, 3001, "dc_solve", Benchmark_stats::from_samples({500.0})});
+    std::vector<Benchmark_change> changes = current.compare(loaded, 0.10, 5.0);
+    runner.assert_true(changes.size() == 3, "Only measurements present in both reports are compared");
+    runner.assert_true(changes[0].improvement && changes[1].regression && !changes[1].improvement,
+                       "Slowdown flagged, speedup reported");
+    runner.assert_true(!changes[2].regression, "Changes below the absolute floor ignored");
+
+    bool rejected = false;
+    try {
+        std::istringstream foreign("{\"format\": \"other\", \"results\": []}");
+        Benchmark_report::read_json(foreign);
+    } catch (const std::runtime_error&) {
+        rejected = true;
+    }
+    runner.assert_true(rejected, "Foreign JSON rejected");
+}
+
+// ============================================================================
+// MAIN
+// ============================================================================
+
+int main() {
+    std::cout << std::string(70, '=') << std::endl;
+    std::cout << "                      PHASE BENCHMARK TEST SUITE" << std::endl;
+    std::cout << std::string(70, '=') << std::endl;
+
+    TestRunner runner;
+
+    test_benchmark_report(runner);
+
+    return runner.print_summary() ? 0 : 1;
+}
@@ -0,0 +1,198 @@
+/**
+ * @file test_compiled_circuit.cpp
+ * @brief Compiled Circuit Test Suite
+ *
+ * Verifies immutable compiled circuits shared by concurrent DC and AC jobs
+ * against the Simulator.
+ */
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+#include <fstream>
+#include <thread>
+#include <algorithm>
+#include <memory>
+#include <complex>
+#include <stdexcept>
+#include <cstdio>
+#include <limits>
+
+#include "simulator.h"
+#include "circuit_builder.h"
+#include "compiled_circuit.h"
+#include "executor.h"
+#include "test_runner.h"
+
+constexpr double PI = 3.14159265358979323846;
+
+// ============================================================================
+// HELPER FUNCTIONS
+// ============================================================================
+
+void build_from_text(Circuit& circuit, const std::string& content) {
+    CircuitBuilder().build_from_text(circuit, content);
+    circuit.assemble_MNA_system();
+}
+
+// ============================================================================
+// TEST CASES
+// ============================================================================
+
+// TEST 1: Compiled circuits shared by concurrent DC and AC jobs
+void test_compiled_circuit(TestRunner& runner) {
+    runner.start_test("TEST 1: Compiled circuit with concurrent analyses");
+
+    Node::valid = false;
+    Node::node_count = 0;
+    Circuit circuit("compiled");
+    build_from_text(circuit,
+        "* RLC network with DC and AC excitation\n"
+        "V1 1 0 DC 5 AC 1\n"
+        "R1 1 2 1000\n"
+        "C1 2 0 0.000001\n"
+        "L1 2 3 0.01\n"
+        "R2 3 0 2000\n"
+        "I1 0 3 0.001\n");
+    std::shared_ptr<const Compiled_circuit> compiled = Compiled_circuit::compile(circuit);
+
+    // Eight threads share one compiled circuit; even ones run DC, odd ones AC sweeps
+    const int jobs = 8;
+    std::vector<std::unique_ptr<Dc_result>> dc(jobs);
+    std::vector<std::unique_ptr<Ac_result>> ac(jobs);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < jobs; t++) {
+        threads.emplace_back([&, t]() {
+            if (t % 2 == 0)
+                dc[t].reset(new Dc_result(compiled->solve_dc()));
+            else
+                ac[t].reset(new Ac_result(compiled->solve_ac(10.0, 1e5, 10.0, true)));
+        });
+    }
+    for (std::thread& thread : threads)
+        thread.join();
+
+    bool untouched = !Node::valid;
+    for (const auto& [name, node] : circuit.get_nodes())
+        untouched = untouched && node->voltage == 0.0;
+    runner.assert_true(untouched, "Analyses leave the source circuit untouched");
+    bool identical = true;
+    for (int t = 2; t < jobs; t++) {
+        if (t % 2 == 0)
+            identical = identical && dc[t]->get_solution() == dc[0]->get_solution();
+        else
+            for (size_t k = 0; k < ac[t]->points(); k++)
+                for (int i = 0; i < compiled->get_num_variables(); i++)
+                    identical = identical && ac[t]->value(k, i) == ac[1]->value(k, i);
+    }
+    runner.assert_true(identical && ac[1]->points() == 5, "Concurrent jobs agree");
+
+    // Same results as the legacy Simulator path
+    std::string csv = "temp_lu_compiled.csv";
+    Simulator simulator(csv);
+    simulator.set_solver_method(Solver::Method::sparse_lu);
+    simulator.run_dc_analysis(circuit);
+    const Dc_result& op = *dc[0];
+    double worst = 0.0;
+    for (const auto& [name, node] : circuit.get_nodes())
+        worst = std::max(worst, std::abs(op.voltage(name) - node->voltage));
+    for (const std::string id : {"V1", "L1", "R1", "R2", "I1"})
+        worst = std::max(worst, std::abs(op.current(id) - circuit.get_components().at(id)->get_current()));
+    runner.assert_near(worst, 0.0, 1e-9, "DC voltages and currents match the Simulator");
+
+    simulator.run_ac_analysis(circuit, 10.0, 1e5, 10.0, true);
+    std::ifstream in(csv);
+    std::string line;
+    std::getline(in, line);                 // Header
+    std::getline(in, line);                 // DC operating point
+    const Ac_result& sweep = *ac[1];
+    int inductor = circuit.get_components().at("L1")->get_vc_id();
+    size_t point = 0;
+    worst = 0.0;
+    while (std::getline(in, line) && point < sweep.points()) {
+        std::vector<double> fields;
+        std::istringstream iss(line);
+        std::string token;
+        while (std::getline(iss, token, ','))
+            fields.push_back(std::stod(token));
+        worst = std::max(worst, std::abs(fields[0] - sweep.frequency(point)));
+        for (int i = 1; i < compiled->get_num_variables(); i++)
+            if (i != inductor)
+                worst = std::max(worst, std::abs(std::complex<double>(fields[1 + 2 * i], fields[2 + 2 * i]) - sweep.value(point, i)));
+        point++;
+    }
+    in.close();
+    std::remove(csv.c_str());
+    runner.assert_true(point == sweep.points(), "Every sweep point compared");
+    runner.assert_near(worst, 0.0, 1e-6, "AC phasors match the Simulator (CSV precision)");
+
+    // Inductor current from its terminals: (V2 - V3) / jwL
+    double w = 2.0 * PI * sweep.frequency(2);
+    std::complex<double> il = (sweep.voltage(2, "2") - sweep.voltage(2, "3")) / std::complex<double>(0.0, w * 0.01);
+    runner.assert_near(std::abs(sweep.current(2, "L1") - il), 0.0, 1e-12, "Inductor AC current derived");
+
+    // Equal bounds are one point even where the step could never advance (log scale, step <= 1)
+    Ac_result single = compiled->solve_ac(1e3, 1e3, 0.5, true);
+    runner.assert_true(single.points() == 1 && single.frequency(0) == 1e3, "Equal bounds solve exactly one point");
+
+    int rejected = 0;
+    const double inf = std::numeric_limits<double>::infinity();
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    const double sweeps[][3] = {{10.0, inf, 10.0}, {inf, inf, 10.0}, {nan, 1e3, 10.0}, {10.0, 1e3, inf}, {10.0, 1e3, nan}};
+    for (const auto& s : sweeps) {
+        try {
+            compiled->solve_ac(s[0], s[1], s[2], true);
+        } catch (const std::invalid_argument&) {
+            rejected++;
+        }
+    }
+    runner.assert_true(rejected == 5, "Non-finite bounds and steps rejected");
+
+    // The Simulator path shares the same checks instead of looping forever
+    rejected = 0;
+    const double stalls[][3] = {{10.0, 1e3, 1.0}, {10.0, 1e3, 0.5}, {10.0, inf, 10.0}, {10.0, 1e3, inf}};
+    for (const auto& s : stalls) {
+        try {
+            simulator.run_ac_analysis(circuit, s[0], s[1], s[2], true);
+        } catch (const std::invalid_argument&) {
+            rejected++;
+        }
+    }
+    simulator.run_ac_analysis(circuit, 1e3, 1e3, 0.5, true);
+    in.open(csv);
+    int rows = 0;
+    while (std::getline(in, line))
+        rows++;
+    in.close();
+    std::remove(csv.c_str());
+    runner.assert_true(rejected == 4 && rows == 3, "Simulator rejects stalling sweeps and solves equal bounds once");
+
+    bool thrown = false;
+    try {
+        op.voltage("missing");
+    } catch (const std::invalid_argument&) {
+        thrown = true;
+    }
+    runner.assert_true(thrown, "Unknown node rejected");
+}
+
+// ============================================================================
+// MAIN
+// ============================================================================
+
+int main() {
+    std::cout << std::string(70, '=') << std::endl;
+    std::cout << "                     COMPILED CIRCUIT TEST SUITE" << std::endl;
+    std::cout << std::string(70, '=') << std::endl;
+
+    TestRunner runner;
+    // Parallel tests ask for up to 4 threads; size the shared runtime to match
+    Executor::configure_global(Executor::Options{4, Executor::Affinity::none});
+
+    test_compiled_circuit(runner);
+
+    return runner.print_summary() ? 0 : 1;
+}
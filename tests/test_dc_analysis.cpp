@@ -7,7 +7,6 @@
  */
 
 #include <iostream>
-#include <fstream>
 #include <sstream>
 #include <string>
 #include <vector>
@@ -20,6 +19,7 @@
 
 #include "simulator.h"
 #include "circuit_builder.h"
+#include "memory_accounting.h"
 
 // ============================================================================
 // TEST CASE STRUCTURE
@@ -83,18 +83,6 @@ private:
         return std::abs(a - b) <= tolerance;
     }
     
-    std::string create_temp_netlist(const std::string& content, 
-                                   const std::string& test_name) {
-        std::string filename = "temp_" + test_name + ".net";
-        std::ofstream file(filename);
-        if (!file.is_open()) {
-            throw std::runtime_error("Cannot create temporary netlist file");
-        }
-        file << content;
-        file.close();
-        return filename;
-    }
-    
     void validate_voltages(const TestCase& test,
                           const Circuit& circuit,
                           TestResult& result) {
@@ -125,38 +113,37 @@ private:
     
     TestResult execute_test(const TestCase& test) {
         TestResult result(test.name);
-        std::string netlist_file;
         
         auto start_time = std::chrono::high_resolution_clock::now();
         
         try {
-            netlist_file = create_temp_netlist(test.netlist_content, test.name);
-
             Node::valid = false;
             Node::node_count = 0;
 
             Circuit circuit(test.name);
             CircuitBuilder builder;
-            builder.build(circuit, netlist_file);
+            builder.build_from_text(circuit, test.netlist_content);
             circuit.assemble_MNA_system();
 
             Simulator simulator;
             simulator.run_dc_analysis(circuit);
 
             validate_voltages(test, circuit, result);
-            
-            std::remove(netlist_file.c_str());
+
+            // Warm re-assembly and re-solve of the same circuit must not touch the heap
+            Memory_accounting::enable();
+            uint64_t before = Memory_accounting::total().allocations;
+            circuit.assemble_MNA_system();
+            simulator.run_dc_analysis(circuit);
+            uint64_t allocations = Memory_accounting::total().allocations - before;
+            Memory_accounting::disable();
+            if (allocations != 0)
+                result.add_error("Re-assembly and re-solve made " + std::to_string(allocations) + " heap allocation(s)");
             
         } catch (const std::exception& e) {
             result.add_error(std::string("Exception: ") + e.what());
-            if (!netlist_file.empty()) {
-                std::remove(netlist_file.c_str());
-            }
         } catch (...) {
             result.add_error("Unknown exception occurred");
-            if (!netlist_file.empty()) {
-                std::remove(netlist_file.c_str());
-            }
         }
         
         auto end_time = std::chrono::high_resolution_clock::now();
@@ -0,0 +1,186 @@
+/**
+ * @file test_dense_lu.cpp
+ * @brief Dense LU Test Suite
+ *
+ * Verifies the stack-allocated dense LU fast path for tiny systems and its
+ * fallback on singular ones.
+ */
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+#include <fstream>
+#include <chrono>
+#include <algorithm>
+#include <complex>
+#include <cstdio>
+
+#include "simulator.h"
+#include "circuit_builder.h"
+#include "dense_lu.h"
+#include "test_runner.h"
+
+constexpr double PI = 3.14159265358979323846;
+
+// ============================================================================
+// HELPER FUNCTIONS
+// ============================================================================
+
+void build_from_text(Circuit& circuit, const std::string& content) {
+    CircuitBuilder().build_from_text(circuit, content);
+    circuit.assemble_MNA_system();
+}
+
+// Infinity norm of A x - b over the assembled MNA system
+double mna_residual(const Circuit& circuit, const std::vector<double>& x) {
+    double worst = 0.0;
+    for (const auto& [row, col_map] : circuit.get_MNA_matrix()) {
+        double sum = 0.0;
+        for (const auto& [col, value] : col_map)
+            sum += value * x[col];
+        auto it = circuit.get_MNA_vector().find(row);
+        double rhs = (it != circuit.get_MNA_vector().end()) ? it->second : 0.0;
+        worst = std::max(worst, std::abs(sum - rhs));
+    }
+    return worst;
+}
+
+// ============================================================================
+// TEST CASES
+// ============================================================================
+
+// TEST 1: Dense fast path for tiny systems
+void test_dense_fast_path(TestRunner& runner) {
+    runner.start_test("TEST 1: Stack-allocated dense LU for tiny systems");
+
+    // Every bucket against the sparse backend
+    const char* paths[] = {"tests/test_netlists/voltage_divider.net", "tests/test_netlists/series_resistors.net",
+                           "tests/test_netlists/parallel_resistors.net", "tests/test_netlists/multiple_vsources.net"};
+    double worst = 0.0;
+    bool all_dense = true;
+    for (const char* path : paths) {
+        Node::valid = false;
+        Node::node_count = 0;
+        Circuit circuit(path);
+        CircuitBuilder().build(circuit, path);
+        circuit.assemble_MNA_system();
+        Simulator dense, sparse;
+        sparse.set_solver_method(Solver::Method::sparse_lu);
+        dense.run_dc_analysis(circuit);
+        std::vector<double> x = dense.get_solution();
+        sparse.run_dc_analysis(circuit);
+        for (size_t i = 1; i < x.size(); i++)
+            worst = std::max(worst, std::abs(x[i] - sparse.get_solution()[i]));
+        std::ostringstream oss;
+        oss << dense;
+        all_dense = all_dense && oss.str().find("Dense LU") != std::string::npos;
+    }
+    runner.assert_true(all_dense, "Reference netlists take the dense path");
+    runner.assert_true(worst < 1e-12, "Dense solutions match sparse LU");
+
+    // 20-node ladder (bucket 32) and a 33-unknown one that must be declined
+    for (int stages : {19, 32}) {
+        Node::valid = false;
+        Node::node_count = 0;
+        std::ostringstream net;
+        net << "* Ladder\nV1 1 0 10\n";
+        for (int k = 1; k <= stages; k++)
+            net << "Rs" << k << " " << k << " " << k + 1 << " 100\nRp" << k << " " << k + 1 << " 0 1000\n";
+        Circuit circuit("Ladder");
+        build_from_text(circuit, net.str());
+        Dense_solver<double> dense;
+        std::vector<double> x;
+        bool solved = dense.solve(circuit.get_MNA_matrix(), circuit.get_MNA_vector(), x);
+        if (stages == 19) {
+            runner.assert_true(solved && dense.size() == 21, "21 unknowns solved in the 32 bucket");
+            runner.assert_true(mna_residual(circuit, x) < 1e-12, "Residual ||Ax - b|| < 1e-12");
+        } else {
+            runner.assert_true(!solved && x.empty(), "34 unknowns left to the backend");
+        }
+    }
+
+    // Complex AC system (same RC filter as TEST 5, now on the fast path)
+    Node::valid = false;
+    Node::node_count = 0;
+    Circuit rc("RC");
+    build_from_text(rc,
+        "* RC low-pass\n"
+        "V1 1 0 AC 1\n"
+        "R1 1 2 1000\n"
+        "C1 2 0 0.000001\n"
+        "L1 2 3 0.01\n"
+        "R2 3 0 100000\n");
+    std::string csv = "temp_lu_dense_rc.csv";
+    Simulator ac(csv);
+    ac.run_dc_analysis(rc);
+    ac.run_ac_analysis(rc, 159.15494309189535);
+    std::ifstream in(csv);
+    std::string line, last;
+    while (std::getline(in, line))
+        if (!line.empty())
+            last = line;
+    in.close();
+    std::remove(csv.c_str());
+    std::vector<double> fields;
+    std::istringstream iss(last);
+    std::string token;
+    while (std::getline(iss, token, ','))
+        fields.push_back(std::stod(token));
+    double w = 2.0 * PI * 159.15494309189535;
+    std::complex<double> z(100000.0, w * 0.01);
+    std::complex<double> v2 = 1.0 / (1.0 + 1000.0 * (std::complex<double>(0.0, w * 1e-6) + 1.0 / z));
+    int node2 = rc.get_nodes().at("2")->id;
+    runner.assert_near(fields[1 + 2 * node2], v2.real(), 1e-5, "Re(V(2)) on the dense path");
+    runner.assert_near(fields[2 + 2 * node2], v2.imag(), 1e-5, "Im(V(2)) on the dense path");
+
+    // Singular systems are declined and regularized by the backend
+    Node::valid = false;
+    Node::node_count = 0;
+    Circuit loop("Loop");
+    build_from_text(loop,
+        "* Parallel inductors at DC\n"
+        "V1 1 0 12\n"
+        "R1 1 2 600\n"
+        "L1 2 3 0.001\n"
+        "L2 2 3 0.002\n"
+        "R2 3 0 600\n");
+    Dense_solver<double> declined;
+    std::vector<double> x_loop;
+    runner.assert_true(!declined.solve(loop.get_MNA_matrix(), loop.get_MNA_vector(), x_loop) && x_loop.empty(),
+                       "Inductor loop declined");
+
+    // Timing of the bare kernel on the voltage divider
+    Node::valid = false;
+    Node::node_count = 0;
+    Circuit divider("Divider");
+    CircuitBuilder().build(divider, "tests/test_netlists/voltage_divider.net");
+    divider.assemble_MNA_system();
+    Dense_solver<double> kernel;
+    std::vector<double> x_div;
+    const int reps = 10000;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int r = 0; r < reps; r++)
+        kernel.solve(divider.get_MNA_matrix(), divider.get_MNA_vector(), x_div);
+    auto end = std::chrono::high_resolution_clock::now();
+    std::cout << "  Dense solve (voltage divider): "
+              << std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count() / reps << " ns" << std::endl;
+}
+
+// ============================================================================
+// MAIN
+// ============================================================================
+
+int main() {
+    std::cout << std::string(70, '=') << std::endl;
+    std::cout << "                         DENSE LU TEST SUITE" << std::endl;
+    std::cout << std::string(70, '=') << std::endl;
+
+    TestRunner runner;
+
+    test_dense_fast_path(runner);
+
+    return runner.print_summary() ? 0 : 1;
+}
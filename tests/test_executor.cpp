@@ -0,0 +1,145 @@
+/**
+ * @file test_executor.cpp
+ * @brief Shared Runtime Test Suite
+ *
+ * Verifies the thread budget, nested parallel regions and affinity of the
+ * shared work-stealing runtime.
+ */
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cmath>
+#include <iomanip>
+#include <chrono>
+#include <thread>
+#include <algorithm>
+#include <memory>
+#include <atomic>
+#include <future>
+#include <stdexcept>
+
+#include "simulator.h"
+#include "thread_pool.h"
+#include "netlist_generator.h"
+#include "compiled_circuit.h"
+#include "executor.h"
+#include "test_runner.h"
+
+// ============================================================================
+// TEST CASES
+// ============================================================================
+
+// TEST 1: Shared runtime: thread budget, nested regions and parallel sweeps
+void test_shared_runtime(TestRunner& runner) {
+    runner.start_test("TEST 1: Shared work-stealing runtime");
+
+    Executor::configure_global(Executor::Options{3, Executor::Affinity::compact});
+    std::shared_ptr<Executor> runtime = Executor::global();
+    Thread_pool capped(8);
+    runner.assert_true(runtime->budget() == 3 && runtime->size() == 2 && capped.size() == 3 &&
+                       runtime->get_affinity() == Executor::Affinity::compact,
+                       "Pools are capped by the global budget of 3 threads");
+
+    // Regions nested in regions lease only idle workers: never more than the budget at once
+    std::atomic<int> active(0), peak(0), inner_threads(0);
+    std::vector<int> covered(300, 0);
+    int outer = capped.run([&](int thread_id, int) {
+        Thread_pool inner(3);
+        inner_threads += inner.run([&](int inner_id, int inner_count) {
+            int now = ++active;
+            for (int seen = peak.load(); now > seen && !peak.compare_exchange_weak(seen, now);) {}
+            for (int i = thread_id * 100 + inner_id; i < (thread_id + 1) * 100; i += inner_count)
+                covered[i]++;
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+            --active;
+        });
+    });
+    bool complete = std::count(covered.begin(), covered.begin() + 100 * outer, 1) == 100 * outer;
+    runner.assert_true(outer == 3 && complete && peak.load() <= 3 && inner_threads.load() >= 3,
+                       "Nested regions stay within the budget (peak " + std::to_string(peak.load()) + " threads)");
+
+    // A worker's exception reaches the caller after the whole region finished
+    bool rethrown = false;
+    try {
+        capped.run([](int thread_id, int num_threads) {
+            if (num_threads > 1 && thread_id == num_threads - 1)
+                throw std::runtime_error("region failed");
+        });
+    } catch (const std::runtime_error&) {
+        rethrown = true;
+    }
+    runner.assert_true(rethrown, "Region rethrows a worker's exception");
+
+    // Jobs run regions and wait for nested jobs without idling their worker
+    std::future<int> job = runtime->submit([&runtime]() {
+        std::future<int> nested = runtime->submit([]() {
+            std::atomic<int> sum(0);
+            Thread_pool(0).run([&](int thread_id, int) { sum += thread_id + 1; });
+            return sum.load() > 0 ? 20 : 0;
+        });
+        return runtime->wait(nested) + 1;
+    });
+    runner.assert_true(runtime->wait(job) == 21, "Job waits for a nested job running a region");
+
+    // Reconfiguring does not pull a runtime away from the code holding it
+    std::future<int> pending = runtime->submit([]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        return 7;
+    });
+    Executor::configure_global(Executor::Options{2, Executor::Affinity::none});
+    bool replaced = Executor::global() != runtime && Executor::global()->budget() == 2;
+    runner.assert_true(replaced && runtime->wait(pending) == 7 && runtime->budget() == 3,
+                       "A runtime held across configure_global stays usable");
+
+    // The last holder may be one of the runtime's own jobs, which cannot join its own worker
+    std::promise<void> released;
+    std::shared_future<void> go = released.get_future().share();
+    std::weak_ptr<Executor> watch = runtime;
+    runtime->post([keep = runtime, go]() { go.wait(); });
+    runtime.reset();
+    released.set_value();
+    for (int k = 0; k < 500 && !watch.expired(); k++)
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    runner.assert_true(watch.expired(), "A runtime released by its own job shuts down");
+
+    // Sweep points solved in parallel match a single-threaded sweep
+    Node::valid = false;
+    Node::node_count = 0;
+    Circuit circuit("runtime_rlc");
+    Netlist_generator::Spec spec;
+    spec.topology = Netlist_generator::Topology::rlc;
+    spec.size = 200;
+    Netlist_generator(spec).build(circuit);
+    circuit.assemble_MNA_system();
+    std::shared_ptr<const Compiled_circuit> compiled = Compiled_circuit::compile(circuit);
+    Executor::configure_global(Executor::Options{1, Executor::Affinity::none});
+    const Ac_result serial = compiled->solve_ac(100.0, 1e5, 1.2, true);
+    Executor::configure_global(Executor::Options{4, Executor::Affinity::scatter});
+    const Ac_result parallel = compiled->solve_ac(100.0, 1e5, 1.2, true);
+    double worst = 0.0;
+    for (size_t k = 0; k < parallel.points(); k++)
+        for (int i = 1; i < compiled->get_num_variables(); i++)
+            worst = std::max(worst, std::abs(parallel.value(k, i) - serial.value(k, i)));
+    runner.assert_true(parallel.points() == serial.points() && worst == 0.0,
+                       "Parallel sweep of " + std::to_string(parallel.points()) + " points matches the serial one");
+    Executor::configure_global(Executor::Options{4, Executor::Affinity::none});
+}
+
+// ============================================================================
+// MAIN
+// ============================================================================
+
+int main() {
+    std::cout << std::string(70, '=') << std::endl;
+    std::cout << "                      SHARED RUNTIME TEST SUITE" << std::endl;
+    std::cout << std::string(70, '=') << std::endl;
+
+    TestRunner runner;
+    // Parallel tests ask for up to 4 threads; size the shared runtime to match
+    Executor::configure_global(Executor::Options{4, Executor::Affinity::none});
+
+    test_shared_runtime(runner);
+
+    return runner.print_summary() ? 0 : 1;
+}
@@ -0,0 +1,168 @@
+/**
+ * @file test_low_rank_update.cpp
+ * @brief Low-Rank Update Test Suite
+ *
+ * Verifies low-rank (Sherman-Morrison-Woodbury) re-solves after component
+ * value edits against fresh factorizations.
+ */
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cmath>
+#include <iomanip>
+#include <chrono>
+#include <algorithm>
+#include <stdexcept>
+
+#include "simulator.h"
+#include "circuit_builder.h"
+#include "sparse_lu.h"
+#include "test_runner.h"
+
+// ============================================================================
+// HELPER FUNCTIONS
+// ============================================================================
+
+// Infinity norm of A x - b over the assembled MNA system
+double mna_residual(const Circuit& circuit, const std::vector<double>& x) {
+    double worst = 0.0;
+    for (const auto& [row, col_map] : circuit.get_MNA_matrix()) {
+        double sum = 0.0;
+        for (const auto& [col, value] : col_map)
+            sum += value * x[col];
+        auto it = circuit.get_MNA_vector().find(row);
+        double rhs = (it != circuit.get_MNA_vector().end()) ? it->second : 0.0;
+        worst = std::max(worst, std::abs(sum - rhs));
+    }
+    return worst;
+}
+
+// ============================================================================
+// TEST CASES
+// ============================================================================
+
+// TEST 1: Low-rank (Sherman-Morrison-Woodbury) re-solve after value edits
+void test_low_rank_update(TestRunner& runner, const std::string& path) {
+    runner.start_test("TEST 1: Low-rank updates on " + path);
+
+    Node::valid = false;
+    Node::node_count = 0;
+    Circuit circuit(path);
+    CircuitBuilder().build(circuit, path);
+    circuit.assemble_MNA_system();
+
+    // A two-terminal conductance change is a single rank-1 term
+    Sparse_matrix<double> A;
+    A.assemble(circuit.get_MNA_matrix());
+    Sparse_lu<double> lu;
+    lu.factorize(A);
+    Component_contribution<double> delta = circuit.set_component_value("Rh4_10", 250.0);
+    std::vector<int> rows, cols;
+    std::vector<double> values;
+    for (const auto& mc : delta.matrixStamps) {
+        rows.push_back(A.compact_index[mc.row]);
+        cols.push_back(A.compact_index[mc.col]);
+        values.push_back(mc.value);
+    }
+    runner.assert_true(lu.update(rows, cols, values) && lu.get_update_rank() == 1, "Resistor edit absorbed as rank 1");
+
+    std::vector<double> x_update, x_full;
+    A.gather(circuit.get_MNA_vector(), x_update);
+    lu.solve(x_update);
+    Sparse_matrix<double> A_new;
+    A_new.assemble(circuit.get_MNA_matrix());
+    Sparse_lu<double> fresh;
+    fresh.factorize(A_new);
+    A_new.gather(circuit.get_MNA_vector(), x_full);
+    fresh.solve(x_full);
+    double diff = 0.0, scale = 0.0;
+    for (size_t i = 0; i < x_full.size(); i++) {
+        diff = std::max(diff, std::abs(x_update[i] - x_full[i]));
+        scale = std::max(scale, std::abs(x_full[i]));
+    }
+    runner.assert_true(diff <= 1e-10 * scale, "Updated solution matches refactorization");
+
+    // End to end: more edits than the default rank limit, so a refactorization happens on the way
+    Simulator simulator;
+    simulator.set_solver_method(Solver::Method::sparse_lu);
+    simulator.run_dc_analysis(circuit);
+    Simulator reference;
+    reference.set_solver_method(Solver::Method::sparse_lu);
+
+    const char* edits[] = {"Rh7_20", "Rh11_1", "Rh14_11", "Rh17_21", "Rh21_2", "Rh24_12", "Rh27_22",
+                           "Rv3_1", "Rv13_4", "Rv23_7", "Rv4_11", "Rv14_14", "Rv24_17", "Rv5_21",
+                           "Rv15_24", "Rv25_27", "Rh4_10", "Rh7_20", "V1", "Rh11_1"};
+    double worst = 0.0;
+    long long update_us = 0;
+    int count = 0;
+    for (const char* id : edits) {
+        double value = (id[0] == 'V') ? 80.0 : 50.0 + 25.0 * (count % 7);
+        auto start = std::chrono::high_resolution_clock::now();
+        simulator.update_component(circuit, id, value);
+        auto end = std::chrono::high_resolution_clock::now();
+        update_us += std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+        std::vector<double> x = simulator.get_solution();
+
+        reference.run_dc_analysis(circuit);
+        const std::vector<double>& x_ref = reference.get_solution();
+        double edit_diff = 0.0, edit_scale = 0.0;
+        for (size_t i = 0; i < x_ref.size(); i++) {
+            edit_diff = std::max(edit_diff, std::abs(x[i] - x_ref[i]));
+            edit_scale = std::max(edit_scale, std::abs(x_ref[i]));
+        }
+        worst = std::max(worst, edit_diff / edit_scale);
+        count++;
+    }
+    std::cout << "  Average update + solve time: " << update_us / count << " us" << std::endl;
+    runner.assert_true(worst <= 1e-10, "20 incremental edits match full re-solves");
+    runner.assert_true(mna_residual(circuit, simulator.get_solution()) < 1e-9, "Residual ||Ax - b|| < 1e-9");
+
+    // Values the factory would refuse are refused here too, before any stamp changes
+    const auto matrix_before = circuit.get_MNA_matrix();
+    const double resistance = circuit.get_components().at("Rh4_10")->get_value();
+    int refused = 0;
+    for (double value : {0.0, -100.0, std::nan(""), HUGE_VAL}) {
+        try {
+            circuit.set_component_value("Rh4_10", value);
+        } catch (const std::runtime_error&) {
+            refused++;
+        }
+    }
+    runner.assert_true(refused == 4 && circuit.get_MNA_matrix() == matrix_before &&
+                       circuit.get_components().at("Rh4_10")->get_value() == resistance,
+                       "Non-positive and non-finite resistances rejected, MNA system untouched");
+
+    Node::valid = false;
+    Node::node_count = 0;
+    Circuit reactive("Reactive");
+    CircuitBuilder().build_from_text(reactive, "* RLC\nV1 1 0 5\nR1 1 2 100\nL1 2 3 0.01\nC1 3 0 1e-6\n");
+    reactive.assemble_MNA_system();
+    refused = 0;
+    for (const char* id : {"L1", "C1"}) {
+        for (double value : {0.0, -1e-3, HUGE_VAL}) {
+            try {
+                reactive.set_component_value(id, value);
+            } catch (const std::runtime_error&) {
+                refused++;
+            }
+        }
+    }
+    runner.assert_true(refused == 6, "Non-positive and non-finite inductances and capacitances rejected");
+}
+
+// ============================================================================
+// MAIN
+// ============================================================================
+
+int main() {
+    std::cout << std::string(70, '=') << std::endl;
+    std::cout << "                      LOW-RANK UPDATE TEST SUITE" << std::endl;
+    std::cout << std::string(70, '=') << std::endl;
+
+    TestRunner runner;
+
+    test_low_rank_update(runner, "tests/test_netlists/large_grid.net");
+
+    return runner.print_summary() ? 0 : 1;
+}
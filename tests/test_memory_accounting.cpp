@@ -0,0 +1,129 @@
+/**
+ * @file test_memory_accounting.cpp
+ * @brief Heap Accounting Test Suite
+ *
+ * Verifies per-subsystem heap accounting and the peak RSS report.
+ */
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+#include <thread>
+#include <cstdint>
+
+#include "simulator.h"
+#include "circuit_builder.h"
+#include "netlist_generator.h"
+#include "memory_accounting.h"
+#include "executor.h"
+#include "test_runner.h"
+
+// ============================================================================
+// HELPER FUNCTIONS
+// ============================================================================
+
+void build_from_text(Circuit& circuit, const std::string& content) {
+    CircuitBuilder().build_from_text(circuit, content);
+    circuit.assemble_MNA_system();
+}
+
+// ============================================================================
+// TEST CASES
+// ============================================================================
+
+// TEST 1: Heap accounting per subsystem
+void test_memory_accounting(TestRunner& runner) {
+    runner.start_test("TEST 1: Memory accounting");
+
+    Memory_accounting::enable();
+    auto mna = Memory_accounting::usage(Memory_tag::mna);
+    auto components = Memory_accounting::usage(Memory_tag::components);
+    auto nodes = Memory_accounting::usage(Memory_tag::nodes);
+    auto solver = Memory_accounting::usage(Memory_tag::solver);
+    {
+        Node::valid = false;
+        Node::node_count = 0;
+        Circuit circuit;
+        Netlist_generator::Spec spec;
+        spec.topology = Netlist_generator::Topology::ladder;
+        spec.size = 2000;
+        std::ostringstream text;
+        Netlist_generator(spec).write(text);
+        CircuitBuilder().build_from_text(circuit, text.str());
+        circuit.assemble_MNA_system();
+        Simulator simulator;
+        simulator.set_solver_method(Solver::Method::sparse_lu);
+        simulator.run_dc_analysis(circuit);
+
+        auto grown = [](const Memory_accounting::Usage& before, Memory_tag tag, int64_t bytes) {
+            auto now = Memory_accounting::usage(tag);
+            return now.current - before.current >= bytes && now.allocations > before.allocations;
+        };
+        // At least one hash node per stamp, one object per component, one Node per node
+        runner.assert_true(grown(mna, Memory_tag::mna, 5000 * 16) && grown(components, Memory_tag::components, 4000 * 32) &&
+                           grown(nodes, Memory_tag::nodes, 2000 * 32) && grown(solver, Memory_tag::solver, 6000 * 8),
+                           "MNA, component, node and solver memory charged to their subsystems");
+        runner.assert_true(Memory_accounting::usage(Memory_tag::parse).peak > 0, "Parsing memory tagged");
+    }
+    auto after = Memory_accounting::usage(Memory_tag::mna);
+    runner.assert_true(after.current == mna.current && after.peak > mna.current && after.releases > mna.releases,
+                       "Releases credited back, peak retained");
+
+    {
+        // Over-aligned types go through the align_val_t operators and are counted like the rest
+        struct alignas(64) Cache_line { double lanes[8]; };
+        Memory_scope scope(Memory_tag::solver);
+        auto before = Memory_accounting::usage(Memory_tag::solver);
+        std::vector<Cache_line> lines(100);
+        auto held = Memory_accounting::usage(Memory_tag::solver);
+        bool aligned = reinterpret_cast<uintptr_t>(lines.data()) % 64 == 0;
+        std::vector<Cache_line>().swap(lines);
+        auto released = Memory_accounting::usage(Memory_tag::solver);
+        runner.assert_true(aligned && held.current - before.current >= 6400 && held.allocations > before.allocations &&
+                           released.current == before.current && released.releases > before.releases,
+                           "Over-aligned allocations charged and credited back");
+    }
+
+    {
+        Memory_scope scope(Memory_tag::ac);
+        int64_t other = Memory_accounting::usage(Memory_tag::other).current;
+        std::vector<double> block;
+        std::thread([&block]() { block.resize(1000); }).join();
+        runner.assert_true(Memory_accounting::current_tag() == Memory_tag::ac &&
+                           Memory_accounting::usage(Memory_tag::other).current - other >= 8000,
+                           "Tags are per thread");
+        int64_t ac = Memory_accounting::usage(Memory_tag::ac).current;
+        Memory_accounting::disable();
+        std::vector<double> untracked(1000);
+        runner.assert_true(Memory_accounting::usage(Memory_tag::ac).current == ac, "Disabled allocations uncounted");
+    }
+    Memory_accounting::disable();
+    runner.assert_true(Memory_accounting::current_tag() == Memory_tag::other, "Scope restores the previous tag");
+
+    std::ostringstream report;
+    Memory_accounting::print(report);
+    runner.assert_true(report.str().find("mna") != std::string::npos && Memory_accounting::peak_rss() > 0 &&
+                       Memory_accounting::peak_rss() >= Memory_accounting::current_rss(),
+                       "Report with process peak RSS");
+}
+
+// ============================================================================
+// MAIN
+// ============================================================================
+
+int main() {
+    std::cout << std::string(70, '=') << std::endl;
+    std::cout << "                      HEAP ACCOUNTING TEST SUITE" << std::endl;
+    std::cout << std::string(70, '=') << std::endl;
+
+    TestRunner runner;
+    // Parallel tests ask for up to 4 threads; size the shared runtime to match
+    Executor::configure_global(Executor::Options{4, Executor::Affinity::none});
+
+    test_memory_accounting(runner);
+
+    return runner.print_summary() ? 0 : 1;
+}
@@ -8,8 +8,12 @@
 #include <iomanip>
 #include <chrono>
 #include <set>
+#include <cstdint>
+#include <iterator>
 #include "circuit.h"
 #include "circuit_builder.h"
+#include "circuit_image.h"
+#include "component.h"
 
 // Constants
 const double TOLERANCE = 1e-8;
@@ -693,6 +697,197 @@ void test_tree_d10_b3_performance(MNATestRunner& runner) {
     runner.assert_true(duration.count() < 1000, "Assembly completes in < 1000ms");
 }
 
+// TEST 12: Compiled binary circuit image round trip
+void test_circuit_image(MNATestRunner& runner) {
+    runner.start_test("TEST 12: Binary Circuit Image (compile + mapped reload)");
+
+    // Every component type, AC amplitude and tolerance survive the round trip
+    std::ofstream netlist("test12.net");
+    netlist << "* Image Circuit\n";
+    netlist << "V1 in 0 DC 5 AC 1\n";
+    netlist << "R1 in mid 1000 TOL 0.05\n";
+    netlist << "C1 mid 0 1e-6\n";
+    netlist << "L1 mid out 0.01\n";
+    netlist << "I1 0 out 0.002 SIGMA 0.02\n";
+    netlist.close();
+    Circuit small("ImageCircuit");
+    CircuitBuilder().build(small, "test12.net");
+    small.assemble_MNA_system();
+    Circuit_image::write(small, "test12.cktimg");
+    Circuit small_loaded("Loaded");
+    Circuit_image::load(small_loaded, "test12.cktimg");
+    runner.assert_true(Circuit_image::is_image("test12.cktimg") && !Circuit_image::is_image("test12.net"),
+                       "Image detected by magic");
+    runner.assert_true(small_loaded.topology_hash() == small.topology_hash() &&
+                       small_loaded.values_hash() == small.values_hash(), "Topology and values preserved");
+    runner.assert_true(small_loaded.get_MNA_matrix() == small.get_MNA_matrix() &&
+                       small_loaded.get_MNA_vector() == small.get_MNA_vector(), "Assembled MNA system identical");
+    runner.assert_true(small_loaded.get_extraVarId_map() == small.get_extraVarId_map() &&
+                       small_loaded.get_ac_components().size() == 3, "Extra variables and AC components registered");
+
+    // Large netlist: text build vs mapped image load
+    auto start = std::chrono::high_resolution_clock::now();
+    Circuit ladder("Ladder10000");
+    CircuitBuilder().build(ladder, "tests/test_netlists/ladder_10000.net");
+    ladder.assemble_MNA_system();
+    auto mid = std::chrono::high_resolution_clock::now();
+    Circuit_image::write(ladder, "test12_ladder.cktimg");
+    auto loaded_start = std::chrono::high_resolution_clock::now();
+    Circuit ladder_loaded("Loaded");
+    Circuit_image::load(ladder_loaded, "test12_ladder.cktimg");
+    auto end = std::chrono::high_resolution_clock::now();
+    std::cout << "  Text build + assembly: "
+              << std::chrono::duration_cast<std::chrono::microseconds>(mid - start).count() << " us" << std::endl;
+    std::cout << "  Image load:            "
+              << std::chrono::duration_cast<std::chrono::microseconds>(end - loaded_start).count() << " us" << std::endl;
+    runner.assert_true(ladder_loaded.get_MNA_matrix() == ladder.get_MNA_matrix() &&
+                       ladder_loaded.get_MNA_vector() == ladder.get_MNA_vector(), "Ladder MNA system identical");
+    runner.assert_true(ladder_loaded.get_nodes().size() == ladder.get_nodes().size() &&
+                       ladder_loaded.get_components().size() == ladder.get_components().size(), "Ladder nodes and components");
+
+    // Corrupt and foreign files are rejected
+    std::ofstream truncated("test12_bad.cktimg", std::ios::binary);
+    truncated << "CKTIMAGE";
+    truncated.close();
+    bool rejected = false;
+    try {
+        Circuit bad("Bad");
+        Circuit_image::load(bad, "test12_bad.cktimg");
+    } catch (const std::runtime_error&) {
+        rejected = true;
+    }
+    runner.assert_true(rejected, "Truncated image rejected");
+
+    // Damaged records are rejected instead of indexing past the solvers' vectors
+    std::string image;
+    {
+        std::ifstream in("test12.cktimg", std::ios::binary);
+        image.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+    auto bytes = [](auto value) { return std::string(reinterpret_cast<const char*>(&value), sizeof(value)); };
+    auto rejects = [&image](const std::string& record, const std::string& replacement) {
+        size_t at = image.find(record);
+        if (at == std::string::npos)
+            return false;
+        std::string damaged = image;
+        damaged.replace(at, replacement.size(), replacement);
+        std::ofstream out("test12_bad.cktimg", std::ios::binary);
+        out << damaged;
+        out.close();
+        try {
+            Circuit bad("Bad");
+            Circuit_image::load(bad, "test12_bad.cktimg");
+        } catch (const std::runtime_error&) {
+            return true;
+        }
+        return false;
+    };
+    const auto& row = *small.get_MNA_matrix().begin();
+    const auto& entry = *row.second.begin();
+    std::string matrix_record = bytes(int32_t(row.first)) + bytes(int32_t(entry.first)) + bytes(entry.second);
+    const auto& rhs = *small.get_MNA_vector().begin();
+    std::string vector_record = bytes(int32_t(rhs.first)) + bytes(uint32_t(0)) + bytes(rhs.second);
+    runner.assert_true(rejects(matrix_record, bytes(int32_t(1 << 20))) &&
+                       rejects(matrix_record, bytes(int32_t(row.first)) + bytes(int32_t(-3))) &&
+                       rejects(vector_record, bytes(int32_t(0))), "Out-of-range MNA indices rejected");
+    runner.assert_true(rejects("mid", "out"), "Duplicate node name rejected");
+    runner.assert_true(rejects(bytes(uint32_t(Tolerance::Distribution::uniform)) + bytes(0.05), bytes(uint32_t(7))),
+                       "Unknown tolerance distribution rejected");
+
+    std::remove("test12.net");
+    std::remove("test12.cktimg");
+    std::remove("test12_ladder.cktimg");
+    std::remove("test12_bad.cktimg");
+}
+
+// TEST 13: In-memory circuit construction (no netlist files)
+void test_programmatic_builder(MNATestRunner& runner) {
+    runner.start_test("TEST 13: In-Memory Construction (string, stream, API vs file)");
+
+    const std::string text =
+        "* Builder Circuit\n"
+        "V1 in 0 DC 5 AC 1\n"
+        "R1 in mid 1000\n"
+        "C1 mid 0 1e-6\n"
+        "L1 mid out 0.01\n"
+        "R2 out 0 2000\n"
+        "I1 0 out 0.002\n";
+    // MNA system keyed by variable names, so circuits with different numbering compare equal
+    auto mna_of = [](Circuit& circuit) {
+        circuit.assemble_MNA_system();
+        std::ostringstream output;
+        circuit.print_MNA_system(output);
+        return std::make_pair(parse_mna_matrix(output.str()), parse_mna_vector(output.str()));
+    };
+
+    std::ofstream netlist("test13.net");
+    netlist << text;
+    netlist.close();
+    Circuit from_file;
+    CircuitBuilder().build(from_file, "test13.net");
+    std::remove("test13.net");
+
+    Circuit from_text;
+    CircuitBuilder().build_from_text(from_text, text);
+
+    std::istringstream stream(text);
+    Circuit from_stream;
+    CircuitBuilder().build(from_stream, stream);
+
+    Circuit from_api("Builder Circuit");
+    CircuitBuilder builder;
+    builder.reserve(from_api, 4, 6);
+    builder.add_voltage_source(from_api, "V1", "in", "0", 5.0, 1.0);
+    builder.add_resistor(from_api, "R1", "in", "mid", 1000.0);
+    builder.add_capacitor(from_api, "C1", "mid", "0", 1e-6);
+    builder.add_inductor(from_api, "L1", "mid", "out", 0.01);
+    builder.add_resistor(from_api, "R2", "out", "0", 2000.0);
+    builder.add_current_source(from_api, "I1", "0", "out", 0.002);
+
+    auto reference = mna_of(from_file);
+    auto named = [](const Circuit& circuit) {
+        std::ostringstream summary;
+        circuit.print(summary);
+        return summary.str().find("Circuit Name: Builder Circuit") != std::string::npos;
+    };
+    runner.assert_true(named(from_text) && named(from_stream), "Header name taken from in-memory text and streams");
+    runner.assert_true(mna_of(from_text) == reference, "string_view build matches file build");
+    runner.assert_true(mna_of(from_stream) == reference, "istream build matches file build");
+    runner.assert_true(mna_of(from_api) == reference && from_api.values_hash() == from_file.values_hash(),
+                       "Programmatic build matches file build");
+    runner.assert_true(from_api.get_ac_components().size() == 3, "AC components registered");
+
+    // Bulk descriptors and input validation
+    std::vector<ComponentDescriptor> ladder;
+    for (int k = 1; k <= 100; k++) {
+        ComponentDescriptor series;
+        series.type = 'R';
+        series.id = "Rs" + std::to_string(k);
+        series.node1 = std::to_string(k);
+        series.node2 = std::to_string(k + 1);
+        series.positional.push_back(100.0);
+        ladder.push_back(series);
+    }
+    Circuit bulk("Bulk");
+    builder.reserve(bulk, 102, 100);
+    builder.add_components(bulk, ladder);
+    runner.assert_true(bulk.get_nodes().size() == 102 && bulk.get_components().size() == 100,
+                       "Bulk descriptors add nodes and components");
+
+    bool wrong_prefix = false, duplicate = false;
+    try {
+        builder.add_resistor(bulk, "C9", "1", "0", 10.0);
+    } catch (const std::invalid_argument&) {
+        wrong_prefix = true;
+    }
+    try {
+        builder.add_resistor(bulk, "Rs1", "1", "0", 10.0);
+    } catch (const std::runtime_error&) {
+        duplicate = true;
+    }
+    runner.assert_true(wrong_prefix && duplicate, "Mismatched ID prefix and duplicate ID rejected");
+}
+
 // ============================================================================
 // MAIN
 // ============================================================================
@@ -716,6 +911,8 @@ int main() {
     test_original_circuit(runner);
     test_ladder_10000_performance(runner);
     test_tree_d10_b3_performance(runner);
+    test_circuit_image(runner);
+    test_programmatic_builder(runner);
     
     runner.print_summary();
     
@@ -0,0 +1,118 @@
+/**
+ * @file test_monte_carlo.cpp
+ * @brief Monte Carlo Test Suite
+ *
+ * Verifies the parallel Monte Carlo tolerance analysis on shared symbolic
+ * structure.
+ */
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cmath>
+#include <iomanip>
+#include <algorithm>
+#include <sstream>
+#include <stdexcept>
+
+#include "simulator.h"
+#include "circuit_builder.h"
+#include "thread_pool.h"
+#include "monte_carlo.h"
+#include "executor.h"
+#include "test_runner.h"
+
+// ============================================================================
+// HELPER FUNCTIONS
+// ============================================================================
+
+void build_from_text(Circuit& circuit, const std::string& content) {
+    CircuitBuilder().build_from_text(circuit, content);
+    circuit.assemble_MNA_system();
+}
+
+// ============================================================================
+// TEST CASES
+// ============================================================================
+
+// TEST 1: Monte Carlo tolerance analysis on shared symbolic structure
+void test_monte_carlo(TestRunner& runner) {
+    runner.start_test("TEST 1: Monte Carlo tolerance analysis");
+
+    Node::valid = false;
+    Node::node_count = 0;
+    Circuit circuit("Divider");
+    build_from_text(circuit,
+        "* Toleranced divider\n"
+        "V1 1 0 10\n"
+        "R1 1 2 1000 TOL 0.1\n"
+        "R2 2 0 1000 TOL 0.1\n"
+        "R3 2 3 500 SIGMA 0.02\n"
+        "R4 3 0 500\n");
+
+    Monte_carlo sequential(2000, 7);
+    sequential.run(circuit);
+    Thread_pool pool(4);
+    Monte_carlo parallel(2000, 7);
+    parallel.run(circuit, &pool);
+
+    runner.assert_true(sequential.get_num_varied() == 3, "Three components carry tolerances");
+    const Running_stats& v2 = sequential.get_stats("V(2)");
+    const Running_stats& v2_par = parallel.get_stats("V(2)");
+    runner.assert_true(v2.count == 2000, "Every sample accumulated");
+    runner.assert_true(v2.mean == v2_par.mean && v2.m2 == v2_par.m2 && v2.min == v2_par.min,
+                       "Statistics independent of thread count");
+    // Nominal V(2) = 10 * 500 / 1500; the spread stays within the tolerance bounds
+    const auto& names = sequential.get_names();
+    size_t v2_index = std::find(names.begin(), names.end(), "V(2)") - names.begin();
+    runner.assert_near(sequential.get_nominal()[v2_index], 10.0 / 3.0, 1e-12, "Nominal V(2)");
+    runner.assert_near(v2.mean, 10.0 / 3.0, 0.05, "Mean V(2) near nominal");
+    runner.assert_true(v2.std_dev() > 0.05 && v2.min > 2.7 && v2.max < 4.0, "V(2) spread within tolerance bounds");
+
+    Monte_carlo other_seed(2000, 8);
+    other_seed.run(circuit);
+    runner.assert_true(other_seed.get_stats("V(2)").mean != v2.mean, "Different seed draws different samples");
+
+    // Capacitor and inductor tolerances cannot change a DC sample, so the parser refuses them
+    int refused = 0;
+    for (const char* part : {"L1 2 3 0.01 TOL 0.2\n", "C1 3 0 0.000001 SIGMA 0.05\n"}) {
+        Node::valid = false;
+        Node::node_count = 0;
+        Circuit reactive("Reactive divider");
+        try {
+            build_from_text(reactive, std::string("* Toleranced reactive part\nV1 1 0 10\nR1 1 2 1000 TOL 0.1\n") + part);
+        } catch (const std::runtime_error&) {
+            refused++;
+        }
+    }
+    runner.assert_true(refused == 2, "Capacitor and inductor tolerances rejected at parse");
+
+    // Streaming merge equals sequential accumulation
+    Running_stats all, left, right;
+    for (int i = 0; i < 1000; i++) {
+        double x = std::sin(0.1 * i) + 0.001 * i;
+        all.add(x);
+        (i < 377 ? left : right).add(x);
+    }
+    left.merge(right);
+    runner.assert_near(left.mean, all.mean, 1e-12, "Merged mean");
+    runner.assert_near(left.variance(), all.variance(), 1e-12, "Merged variance");
+}
+
+// ============================================================================
+// MAIN
+// ============================================================================
+
+int main() {
+    std::cout << std::string(70, '=') << std::endl;
+    std::cout << "                        MONTE CARLO TEST SUITE" << std::endl;
+    std::cout << std::string(70, '=') << std::endl;
+
+    TestRunner runner;
+    // Parallel tests ask for up to 4 threads; size the shared runtime to match
+    Executor::configure_global(Executor::Options{4, Executor::Affinity::none});
+
+    test_monte_carlo(runner);
+
+    return runner.print_summary() ? 0 : 1;
+}
@@ -0,0 +1,155 @@
+/**
+ * @file test_output_writer.cpp
+ * @brief Output Writer Test Suite
+ *
+ * Verifies the background output writer: ordering, flushes, write errors and
+ * the queued reports of the UI.
+ */
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+#include <fstream>
+#include <algorithm>
+#include <stdexcept>
+#include <cstdio>
+
+#include "simulator.h"
+#include "netlist_generator.h"
+#include "output_writer.h"
+#include "ui.h"
+#include "test_runner.h"
+
+// ============================================================================
+// TEST CASES
+// ============================================================================
+
+// TEST 1: Background output writer fed through the SPSC ring
+void test_output_writer(TestRunner& runner) {
+    runner.start_test("TEST 1: Background output writer");
+
+    auto read_file = [](const std::string& path) {
+        std::ifstream in(path);
+        std::stringstream text;
+        text << in.rdbuf();
+        return text.str();
+    };
+
+    // Rows wrap the ring many times and come out in order, formatted like an ostream would
+    const std::string path = "temp_lu_writer.csv";
+    std::ostringstream expected;
+    {
+        Output_writer writer(5);
+        int sink = writer.open(path);
+        writer.write_text(sink, "t, x, y, n\n");
+        expected << "t, x, y, n\n";
+        for (int k = 0; k < 1000; k++) {
+            Output_writer::Record& row = writer.acquire(sink);
+            row.key = k * 0.001;
+            row.values.push_back(std::sin(k * 0.1));
+            row.values.push_back(1.0 / (k + 1));
+            row.counts.push_back(1000000LL + k);
+            writer.commit();
+            expected << k * 0.001 << ", " << std::sin(k * 0.1) << ", " << 1.0 / (k + 1) << ", " << 1000000LL + k << '\n';
+        }
+        writer.close(sink);
+        runner.assert_true(writer.capacity() == 8 && read_file(path) == expected.str(),
+                           "1000 rows through an 8-record ring match direct formatting");
+        runner.assert_true(writer.open("missing_dir/out.csv") < 0, "Unopenable file returns -1");
+    }
+    std::remove(path.c_str());
+
+#ifdef __linux__
+    // A failure is reported once, for its own file only
+    bool failed = false, reported_once = true, other_file_ok = true;
+    {
+        Output_writer writer;
+        int sink = writer.open("/dev/full");
+        writer.write_text(sink, std::string(1 << 16, 'x'));
+        try {
+            writer.flush();
+        } catch (const std::runtime_error&) {
+            failed = true;
+        }
+        int other = writer.open(path);
+        writer.write_text(other, "ok\n");
+        try {
+            writer.flush();
+            writer.close(other);
+        } catch (const std::runtime_error&) {
+            reported_once = false;
+        }
+        other_file_ok = read_file(path) == "ok\n";
+        writer.write_text(sink, "x");
+        try {
+            writer.close(sink);         // The buffered byte cannot be written either
+            failed = false;
+        } catch (const std::runtime_error&) {
+        }
+    }
+    std::remove(path.c_str());
+    runner.assert_true(failed, "Write failures reported by flush() and close()");
+    runner.assert_true(reported_once && other_file_ok, "Reported failure does not affect later writes");
+#endif
+
+    // AC sweeps queue their rows; a second sweep to the same file replaces the first
+    Node::valid = false;
+    Node::node_count = 0;
+    Circuit circuit("writer_rlc");
+    Netlist_generator::Spec spec;
+    spec.topology = Netlist_generator::Topology::rlc;
+    spec.size = 50;
+    Netlist_generator(spec).build(circuit);
+    circuit.assemble_MNA_system();
+    const std::string csv = "temp_lu_writer_ac.csv";
+    Simulator simulator(csv);
+    simulator.run_dc_analysis(circuit);
+    simulator.run_ac_analysis(circuit, 10.0, 1e5, 10.0, true);
+    simulator.run_ac_analysis(circuit, 10.0, 1e3, 10.0, true);
+    std::ifstream in(csv);
+    std::string line;
+    size_t rows = 0;
+    bool same_width = true;
+    size_t width = 0;
+    while (std::getline(in, line)) {
+        size_t fields = std::count(line.begin(), line.end(), ',') + 1;
+        same_width = same_width && (width == 0 || fields == width);
+        width = fields;
+        rows++;
+    }
+    in.close();
+    std::remove(csv.c_str());
+    runner.assert_true(rows == 2 + 3 && same_width,
+                       "Second sweep's CSV has header, DC row and 3 points (" + std::to_string(rows) + " lines)");
+
+    // The run report shares the simulator's writer
+    UI ui;
+    char* argv[] = {const_cast<char*>("sim"), const_cast<char*>("-generate"), const_cast<char*>("ladder"),
+                    const_cast<char*>("10"), const_cast<char*>("-o"), const_cast<char*>("temp_lu_report.log")};
+    ui.parse_arguments(6, argv);
+    ui.output_results("report body\n", &simulator.get_output_writer());
+    std::string report = read_file("temp_lu_report.log");
+    std::remove("temp_lu_report.log");
+    runner.assert_true(report.find("Circuit Simulator") != std::string::npos &&
+                       report.size() > 12 && report.compare(report.size() - 12, 12, "report body\n") == 0,
+                       "Report written through the writer thread");
+}
+
+// ============================================================================
+// MAIN
+// ============================================================================
+
+int main() {
+    std::cout << std::string(70, '=') << std::endl;
+    std::cout << "                       OUTPUT WRITER TEST SUITE" << std::endl;
+    std::cout << std::string(70, '=') << std::endl;
+
+    TestRunner runner;
+
+    test_output_writer(runner);
+
+    return runner.print_summary() ? 0 : 1;
+}
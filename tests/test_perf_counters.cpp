@@ -0,0 +1,85 @@
+/**
+ * @file test_perf_counters.cpp
+ * @brief Performance Counter Test Suite
+ *
+ * Verifies per-phase counters and the work models of the solver phases.
+ */
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+
+#include "simulator.h"
+#include "netlist_generator.h"
+#include "perf_counters.h"
+#include "test_runner.h"
+
+// ============================================================================
+// TEST CASES
+// ============================================================================
+
+// TEST 1: Per-phase performance counters and work models
+void test_perf_counters(TestRunner& runner) {
+    runner.start_test("TEST 1: Performance counters");
+
+    Perf_profile::enable();
+    Node::valid = false;
+    Node::node_count = 0;
+    Circuit circuit;
+    Netlist_generator::Spec spec;
+    spec.topology = Netlist_generator::Topology::grid;
+    spec.size = 900;
+    Netlist_generator(spec).build(circuit);
+    circuit.assemble_MNA_system();
+    Simulator lu;
+    lu.set_solver_method(Solver::Method::sparse_lu);
+    lu.run_dc_analysis(circuit);
+    Simulator gs;
+    gs.set_solver_method(Solver::Method::gauss_seidel);
+    gs.run_dc_analysis(circuit);
+    Perf_profile::disable();
+    lu.run_dc_analysis(circuit);
+
+    Perf_counts factor = Perf_profile::get("lu_factor");
+    Perf_counts solve = Perf_profile::get("lu_solve");
+    Perf_counts sweep = Perf_profile::get("gauss_seidel");
+    runner.assert_true(Perf_profile::get("assemble").calls == 1 && factor.calls == 1 && solve.calls == 1 &&
+                       sweep.calls == 1, "Each phase measured once, nothing while disabled");
+    runner.assert_true(factor.flops > 0.0 && solve.flops > 0.0 && sweep.flops > solve.flops &&
+                       std::isfinite(factor.gflops()) && std::isfinite(sweep.bandwidth()),
+                       "Work models give flop and bandwidth rates");
+    runner.assert_true(std::isnan(Perf_profile::get("assemble").gflops()), "Phases without a work model report n/a");
+
+    bool hardware = Perf_counters::local().available();
+    std::cout << "  Hardware counters: " << (hardware ? "available" : Perf_counters::local().get_status())
+              << std::endl;
+    runner.assert_true(hardware ? (factor.measured[Perf_counts::cycles] && factor.ipc() > 0.0)
+                                : (std::isnan(factor.ipc()) && !factor.measured[Perf_counts::instructions]),
+                       "IPC measured when counters are permitted, n/a otherwise");
+
+    std::ostringstream report;
+    Perf_profile::print(report);
+    runner.assert_true(report.str().find("lu_factor") != std::string::npos &&
+                       report.str().find("gauss_seidel") != std::string::npos &&
+                       (hardware || report.str().find("unavailable") != std::string::npos),
+                       "Report lists the phases");
+}
+
+// ============================================================================
+// MAIN
+// ============================================================================
+
+int main() {
+    std::cout << std::string(70, '=') << std::endl;
+    std::cout << "                    PERFORMANCE COUNTER TEST SUITE" << std::endl;
+    std::cout << std::string(70, '=') << std::endl;
+
+    TestRunner runner;
+
+    test_perf_counters(runner);
+
+    return runner.print_summary() ? 0 : 1;
+}
@@ -0,0 +1,139 @@
+/**
+ * @file test_result_cache.cpp
+ * @brief Result Cache Test Suite
+ *
+ * Verifies circuit fingerprints and the on-disk DC/AC result cache.
+ */
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+#include <fstream>
+#include <memory>
+#include <filesystem>
+#include <cstdio>
+
+#include "simulator.h"
+#include "circuit_builder.h"
+#include "test_runner.h"
+
+// ============================================================================
+// HELPER FUNCTIONS
+// ============================================================================
+
+void build_from_text(Circuit& circuit, const std::string& content) {
+    CircuitBuilder().build_from_text(circuit, content);
+    circuit.assemble_MNA_system();
+}
+
+// ============================================================================
+// TEST CASES
+// ============================================================================
+
+// TEST 1: Circuit fingerprints and the on-disk result cache
+void test_result_cache(TestRunner& runner) {
+    runner.start_test("TEST 1: Topology/value fingerprints and result memoization");
+
+    const std::string lines[] = {"V1 in 0 10 AC 1\n", "R1 in mid 1000\n", "C1 mid 0 0.000001\n", "R2 mid out 2200\n",
+                                 "L1 out 0 0.01\n"};
+    std::string forward, backward;
+    for (int k = 0; k < 5; k++) {
+        forward += lines[k];
+        backward += lines[4 - k];
+    }
+    std::string edited = forward;
+    edited.replace(edited.find("2200"), 4, "4700");
+    auto build = [](const std::string& body, const std::string& name) {
+        Node::valid = false;
+        Node::node_count = 0;
+        std::unique_ptr<Circuit> circuit(new Circuit(name));
+        build_from_text(*circuit, "* Cached\n" + body);
+        return circuit;
+    };
+
+    std::unique_ptr<Circuit> a = build(forward, "cache_a");
+    std::unique_ptr<Circuit> b = build(backward, "cache_b");
+    std::unique_ptr<Circuit> c = build(forward + "R3 out 0 10000\n", "cache_c");
+    std::unique_ptr<Circuit> d = build(edited, "cache_d");
+    runner.assert_true(a->topology_hash() == b->topology_hash() && a->values_hash() == b->values_hash(),
+                       "Hashes independent of netlist line order");
+    runner.assert_true(a->topology_hash() != c->topology_hash(), "Added component changes the topology hash");
+    runner.assert_true(a->topology_hash() == d->topology_hash() && a->values_hash() != d->values_hash(),
+                       "Value edit changes only the values hash");
+
+    std::string dir = "temp_lu_cache";
+    std::filesystem::remove_all(dir);
+    std::string csv1 = "temp_lu_cache1.csv", csv2 = "temp_lu_cache2.csv";
+    std::unique_ptr<Circuit> a1 = build(forward, "cache_a1");
+    Simulator first(csv1);
+    first.set_result_cache(dir);
+    first.run_dc_analysis(*a1);
+    first.run_ac_analysis(*a1, 10.0, 1000.0, 10.0, true);
+    runner.assert_true(first.get_result_cache().get_misses() == 2, "First run misses and stores DC + AC");
+
+    std::unique_ptr<Circuit> a2 = build(forward, "cache_a2");
+    Simulator second(csv2);
+    second.set_result_cache(dir);
+    second.run_dc_analysis(*a2);
+    second.run_ac_analysis(*a2, 10.0, 1000.0, 10.0, true);
+    runner.assert_true(second.get_result_cache().get_hits() == 2, "Rerun answered from the cache");
+    std::ifstream in1(csv1), in2(csv2);
+    std::stringstream s1, s2;
+    s1 << in1.rdbuf();
+    s2 << in2.rdbuf();
+    runner.assert_true(!s1.str().empty() && s1.str() == s2.str(), "Cached AC results identical");
+    std::ostringstream oss;
+    oss << second;
+    runner.assert_true(oss.str().find("loaded from the result cache") != std::string::npos, "Cache hit reported");
+
+    // Reordered netlist: different numbering, same node voltages restored by name
+    std::unique_ptr<Circuit> b2 = build(backward, "cache_b2");
+    Simulator third;
+    third.set_result_cache(dir);
+    third.run_dc_analysis(*b2);
+    bool same = third.get_result_cache().get_hits() == 1;
+    for (const char* node : {"in", "mid", "out"})
+        same = same && b2->get_nodes().at(node)->voltage == a2->get_nodes().at(node)->voltage;
+    runner.assert_true(same, "Reordered netlist hits and restores by name");
+
+    // Edited value misses
+    std::unique_ptr<Circuit> d2 = build(edited, "cache_d2");
+    Simulator fourth;
+    fourth.set_result_cache(dir);
+    fourth.run_dc_analysis(*d2);
+    runner.assert_true(fourth.get_result_cache().get_misses() == 1, "Edited circuit re-solved");
+
+    // Other solver settings miss; a Gauss-Seidel solve stopped at its iteration limit is not stored
+    std::unique_ptr<Circuit> a3 = build(forward, "cache_a3");
+    Simulator fifth;
+    fifth.set_result_cache(dir);
+    fifth.set_solver_method(Solver::Method::gauss_seidel);
+    fifth.set_gauss_seidel(2, 1e-12, 0.5);
+    fifth.run_dc_analysis(*a3);
+    fifth.run_dc_analysis(*a3);
+    runner.assert_true(fifth.get_result_cache().get_misses() == 2 && fifth.get_result_cache().get_hits() == 0,
+                       "Unconverged solve under other settings neither hits nor is stored");
+
+    std::filesystem::remove_all(dir);
+    std::remove(csv1.c_str());
+    std::remove(csv2.c_str());
+}
+
+// ============================================================================
+// MAIN
+// ============================================================================
+
+int main() {
+    std::cout << std::string(70, '=') << std::endl;
+    std::cout << "                       RESULT CACHE TEST SUITE" << std::endl;
+    std::cout << std::string(70, '=') << std::endl;
+
+    TestRunner runner;
+
+    test_result_cache(runner);
+
+    return runner.print_summary() ? 0 : 1;
+}
@@ -0,0 +1,82 @@
+/**
+ * @file test_runner.h
+ * @brief Assertion counter shared by the solver and runtime test suites.
+ *
+ * Prints every assertion with its PASS/FAIL verdict and a summary of the
+ * failed ones at the end of the run.
+ */
+
+#ifndef TEST_RUNNER_H
+#define TEST_RUNNER_H
+
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+/**
+ * @class TestRunner
+ * @brief Counts the assertions of each test case and prints a final summary.
+ */
+class TestRunner {
+private:
+    int passed = 0;
+    int failed = 0;
+    int total_tests = 0;
+    std::string current_test;
+    std::vector<std::string> failed_tests;
+
+public:
+    void start_test(const std::string& name) {
+        current_test = name;
+        total_tests++;
+        std::cout << "\n" << std::string(70, '=') << std::endl;
+        std::cout << "  " << name << std::endl;
+        std::cout << std::string(70, '=') << std::endl;
+    }
+
+    void assert_true(bool condition, const std::string& message) {
+        std::cout << "  " << message << ": ";
+        if (condition) {
+            passed++;
+            std::cout << "[PASS]" << std::endl;
+        } else {
+            failed++;
+            std::cout << "[FAIL]" << std::endl;
+            failed_tests.push_back(current_test + " - " + message);
+        }
+    }
+
+    void assert_near(double actual, double expected, double tolerance, const std::string& message) {
+        std::cout << std::scientific << std::setprecision(6)
+                  << "  " << message << " = " << actual << " (expected " << expected << "): ";
+        if (std::abs(actual - expected) <= tolerance) {
+            passed++;
+            std::cout << "[PASS]" << std::endl;
+        } else {
+            failed++;
+            std::cout << "[FAIL]" << std::endl;
+            failed_tests.push_back(current_test + " - " + message);
+        }
+    }
+
+    bool print_summary() {
+        std::cout << "\n" << std::string(70, '=') << std::endl;
+        std::cout << "                         TEST SUMMARY" << std::endl;
+        std::cout << std::string(70, '=') << std::endl;
+        std::cout << "  Total Tests:       " << total_tests << std::endl;
+        std::cout << "  Assertions Passed: " << passed << std::endl;
+        std::cout << "  Assertions Failed: " << failed << std::endl;
+        if (failed > 0) {
+            std::cout << "\n  Failed Assertions:" << std::endl;
+            for (const auto& fail : failed_tests)
+                std::cout << "    [X] " << fail << std::endl;
+        }
+        std::cout << std::string(70, '=') << std::endl;
+        std::cout << (failed == 0 ? "\n  ALL TESTS PASSED!\n" : "\n  SOME TESTS FAILED\n") << std::endl;
+        return failed == 0;
+    }
+};
+
+#endif
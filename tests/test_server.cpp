@@ -0,0 +1,197 @@
+/**
+ * @file test_server.cpp
+ * @brief Resident-Circuit Server Test Suite
+ *
+ * Drives the line protocol of the server and checks resident edits against
+ * one-shot solves.
+ */
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+#include <chrono>
+#include <thread>
+#include <algorithm>
+#include <fstream>
+#include <cstdio>
+#ifndef _WIN32
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+#include "simulator.h"
+#include "circuit_builder.h"
+#include "server.h"
+#include "executor.h"
+#include "test_runner.h"
+
+// ============================================================================
+// TEST CASES
+// ============================================================================
+
+// TEST 1: Resident-circuit server protocol
+#ifndef _WIN32
+// Connects to a UNIX socket, retrying while the server starts; -1 on failure
+int connect_client(const std::string& path) {
+    int client = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    std::copy(path.begin(), path.end(), address.sun_path);
+    for (int k = 0; k < 500; k++) {
+        if (::connect(client, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0)
+            return client;
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    ::close(client);
+    return -1;
+}
+#endif
+
+void test_server(TestRunner& runner) {
+    runner.start_test("TEST 1: Server mode with resident circuits");
+
+    Server server;
+    std::string path = "tests/test_netlists/large_grid.net";
+    runner.assert_true(server.handle("load grid " + path).rfind("OK ", 0) == 0, "Load netlist");
+    Node::node_count = 7;
+    Node::valid = true;
+    runner.assert_true(server.handle("load divider tests/test_netlists/voltage_divider.net") == "OK 2 3",
+                       "Second resident circuit");
+    runner.assert_true(Node::node_count == 7 && Node::valid, "Loading leaves the caller's node numbering alone");
+    runner.assert_true(server.handle("list") == "OK divider grid", "Both circuits listed");
+
+    // Many small edits against the resident factorization match a fresh one-shot solve
+    const char* edits[] = {"Rh4_10 250", "Rv13_4 75", "Rh21_2 120", "Rv5_21 300", "Rh4_10 90"};
+    bool all_ok = server.handle("dc grid") == "OK";
+    auto start = std::chrono::high_resolution_clock::now();
+    for (const char* edit : edits)
+        all_ok = all_ok && server.handle(std::string("set grid ") + edit) == "OK";
+    auto end = std::chrono::high_resolution_clock::now();
+    std::cout << "  Average set request: "
+              << std::chrono::duration_cast<std::chrono::microseconds>(end - start).count() / 5 << " us" << std::endl;
+    runner.assert_true(all_ok, "Edits accepted");
+
+    Node::valid = false;
+    Node::node_count = 0;
+    Circuit reference(path);
+    CircuitBuilder().build(reference, path);
+    reference.assemble_MNA_system();
+    for (const char* edit : edits) {
+        std::istringstream iss(edit);
+        std::string id;
+        double value;
+        iss >> id >> value;
+        reference.set_component_value(id, value);
+    }
+    Simulator simulator;
+    simulator.set_solver_method(Solver::Method::sparse_lu);
+    simulator.run_dc_analysis(reference);
+    std::string probe = server.handle("probe grid V(515) V(1220) I(V1)");
+    std::istringstream values(probe.substr(3));
+    double v1, v2, i1;
+    values >> v1 >> v2 >> i1;
+    runner.assert_true(probe.rfind("OK ", 0) == 0 && std::abs(v1 - reference.get_nodes().at("515")->voltage) < 1e-9 &&
+                       std::abs(v2 - reference.get_nodes().at("1220")->voltage) < 1e-9 &&
+                       std::abs(i1 - reference.get_components().at("V1")->get_current()) < 1e-12,
+                       "Probes match a one-shot solve");
+
+    // Stream front end, errors and unload
+    std::istringstream in("probe divider V(2)\nset divider R9 1\nset divider R1 0\nbogus\nunload grid\nlist\nquit\nlist\n");
+    std::ostringstream out;
+    server.serve(in, out);
+    std::istringstream lines(out.str());
+    std::vector<std::string> responses;
+    std::string line;
+    while (std::getline(lines, line))
+        responses.push_back(line);
+    runner.assert_true(responses.size() == 7 && responses[0] == "OK 5", "Probe over the stream");
+    runner.assert_true(responses[1].rfind("ERR ", 0) == 0 && responses[3].rfind("ERR ", 0) == 0,
+                       "Errors reported without ending the session");
+    runner.assert_true(responses[2] == "ERR Resistor with ID R1 has non-positive or non-finite resistance.",
+                       "Non-positive value refused by set");
+    runner.assert_true(responses[5] == "OK divider" && responses[6] == "OK", "Unload, then quit stops reading");
+
+    // Sweeps that would never finish are refused before they reach the simulator
+    bool refused = true;
+    for (const char* sweep : {"10 1000 1 log", "10 1000 0.5 log", "10 inf 10", "inf inf 10", "nan 100 1",
+                              "10 100 inf", "10 1e9 1e-3", "1e-3 1e300 1.0001 log"})
+        refused = refused && server.handle(std::string("ac divider ") + sweep).rfind("ERR ", 0) == 0;
+    runner.assert_true(refused, "Non-finite, non-advancing and oversized sweeps rejected");
+
+    runner.assert_true(server.handle("set divider R1 1k") == "ERR Invalid value '1k', expected a number." &&
+                       server.handle("ac divider 10 1e999 10") == "ERR Invalid f2 '1e999', expected a number." &&
+                       server.handle("ac divider 10 1000 x log") == "ERR Invalid step 'x', expected a number.",
+                       "Malformed numbers named in the error");
+
+    bool single = server.handle("ac divider 100 100 1 log") == "OK divider_ac.csv";
+    std::ifstream csv("divider_ac.csv");
+    int rows = 0;
+    while (std::getline(csv, line))
+        rows++;
+    csv.close();
+    std::remove("divider_ac.csv");
+    runner.assert_true(single && rows == 3, "Equal bounds solve one point (header, DC, 100 Hz)");
+
+    // Names end up in output paths, so anything beyond [A-Za-z0-9_-] is refused
+    runner.assert_true(server.handle("load ../escape tests/test_netlists/voltage_divider.net").rfind("ERR ", 0) == 0 &&
+                       server.handle("load a.b tests/test_netlists/voltage_divider.net").rfind("ERR ", 0) == 0 &&
+                       server.handle("load amp_2-b tests/test_netlists/voltage_divider.net") == "OK 2 3" &&
+                       server.handle("list") == "OK amp_2-b divider",
+                       "Circuit names restricted to letters, digits, _ and -");
+
+#ifndef _WIN32
+    // The socket is private to its owner
+    std::string socket_path = "temp_server.sock";
+    std::thread serving([&] { server.serve_socket(socket_path); });
+    struct stat info{};
+    for (int k = 0; k < 500 && ::stat(socket_path.c_str(), &info) != 0; k++)
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+
+    // A client that hangs up without reading its replies must not take the server down
+    int early = connect_client(socket_path);
+    std::string burst;
+    for (int k = 0; k < 2000; k++)
+        burst += "list\n";
+    bool burst_sent = early >= 0 && ::write(early, burst.data(), burst.size()) == static_cast<ssize_t>(burst.size());
+    if (early >= 0)
+        ::close(early);
+
+    int client = connect_client(socket_path);
+    bool connected = client >= 0;
+    std::string reply;
+    if (connected && ::write(client, "shutdown\n", 9) == 9) {
+        char buffer[16];
+        ssize_t n = ::read(client, buffer, sizeof(buffer));
+        reply.assign(buffer, n > 0 ? static_cast<size_t>(n) : 0);
+    }
+    if (connected)
+        ::close(client);
+    serving.join();
+    runner.assert_true(connected && (info.st_mode & 0777) == 0600 && reply == "OK\n",
+                       "Socket created with mode 0600");
+    runner.assert_true(burst_sent && reply == "OK\n", "Server survives a client that disconnects before reading");
+#endif
+}
+
+// ============================================================================
+// MAIN
+// ============================================================================
+
+int main() {
+    std::cout << std::string(70, '=') << std::endl;
+    std::cout << "                  RESIDENT-CIRCUIT SERVER TEST SUITE" << std::endl;
+    std::cout << std::string(70, '=') << std::endl;
+
+    TestRunner runner;
+    // Parallel tests ask for up to 4 threads; size the shared runtime to match
+    Executor::configure_global(Executor::Options{4, Executor::Affinity::none});
+
+    test_server(runner);
+
+    return runner.print_summary() ? 0 : 1;
+}
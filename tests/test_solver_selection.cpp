@@ -0,0 +1,187 @@
+/**
+ * @file test_solver_selection.cpp
+ * @brief Solver Selection Test Suite
+ *
+ * Verifies the backend chosen from the structure of the assembled system and
+ * that every choice solves the circuit.
+ */
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+#include <algorithm>
+
+#include "simulator.h"
+#include "circuit_builder.h"
+#include "netlist_generator.h"
+#include "test_runner.h"
+
+// ============================================================================
+// HELPER FUNCTIONS
+// ============================================================================
+
+void build_from_text(Circuit& circuit, const std::string& content) {
+    CircuitBuilder().build_from_text(circuit, content);
+    circuit.assemble_MNA_system();
+}
+
+// Infinity norm of A x - b over the assembled MNA system
+double mna_residual(const Circuit& circuit, const std::vector<double>& x) {
+    double worst = 0.0;
+    for (const auto& [row, col_map] : circuit.get_MNA_matrix()) {
+        double sum = 0.0;
+        for (const auto& [col, value] : col_map)
+            sum += value * x[col];
+        auto it = circuit.get_MNA_vector().find(row);
+        double rhs = (it != circuit.get_MNA_vector().end()) ? it->second : 0.0;
+        worst = std::max(worst, std::abs(sum - rhs));
+    }
+    return worst;
+}
+
+// ============================================================================
+// TEST CASES
+// ============================================================================
+
+// TEST 1: Automatic solver selection from the system structure
+void test_solver_selection(TestRunner& runner) {
+    runner.start_test("TEST 1: Automatic solver selection");
+
+    // Ladder: tree-shaped, factors without fill
+    Node::valid = false;
+    Node::node_count = 0;
+    Circuit ladder("Ladder");
+    Netlist_generator::Spec spec;
+    spec.topology = Netlist_generator::Topology::ladder;
+    spec.size = 200;
+    Netlist_generator(spec).build(ladder);
+    ladder.assemble_MNA_system();
+    Simulator simulator;
+    simulator.run_dc_analysis(ladder);
+    const Solver::Selection& selection = simulator.get_solver_selection();
+    runner.assert_true(selection.valid && selection.structure.forest && selection.method == Solver::Method::sparse_lu &&
+                       selection.ordering == Ordering::Method::minimum_degree &&
+                       selection.reason.find("tree") != std::string::npos,
+                       "Ladder: sparse LU with minimum degree (" + selection.reason + ")");
+    runner.assert_true(mna_residual(ladder, simulator.get_solution()) < 1e-9, "Ladder residual < 1e-9");
+
+    // 3-D resistive mesh driven by a current source: SPD, six neighbours per interior node
+    const int side = 13;
+    auto node = [side](int x, int y, int z) { return std::to_string(1 + x + side * (y + side * z)); };
+    std::ostringstream mesh;
+    mesh << "I1 0 1 0.001\n";
+    int r = 0;
+    for (int z = 0; z < side; z++)
+        for (int y = 0; y < side; y++)
+            for (int x = 0; x < side; x++) {
+                if (x + 1 < side) mesh << "R" << r++ << " " << node(x, y, z) << " " << node(x + 1, y, z) << " 100\n";
+                if (y + 1 < side) mesh << "R" << r++ << " " << node(x, y, z) << " " << node(x, y + 1, z) << " 100\n";
+                if (z + 1 < side) mesh << "R" << r++ << " " << node(x, y, z) << " " << node(x, y, z + 1) << " 100\n";
+                if ((x + y + z) % 7 == 0) mesh << "R" << r++ << " " << node(x, y, z) << " 0 10000\n";
+            }
+    Node::valid = false;
+    Node::node_count = 0;
+    Circuit grid("Mesh");
+    build_from_text(grid, mesh.str());
+    simulator.run_dc_analysis(grid);
+    runner.assert_true(selection.structure.spd() && selection.structure.dimension == side * side * side &&
+                       selection.method == Solver::Method::pcg,
+                       "Re-analyzed for a new system: SPD mesh gets conjugate gradient (" + selection.reason + ")");
+    std::vector<double> cg = simulator.get_solution();
+    Simulator direct;
+    direct.set_solver_method(Solver::Method::sparse_lu);
+    direct.run_dc_analysis(grid);
+    double diff = 0.0;
+    for (size_t i = 0; i < cg.size(); i++)
+        diff = std::max(diff, std::abs(cg[i] - direct.get_solution()[i]));
+    runner.assert_true(diff < 1e-8,
+                       "Conjugate gradient matches sparse LU (max diff " + std::to_string(diff) + ")");
+    std::ostringstream report;
+    simulator.print(report);
+    runner.assert_true(report.str().find("Reason: symmetric positive definite") != std::string::npos &&
+                       report.str().find("Conjugate Gradient Status") != std::string::npos,
+                       "Selection reason reported");
+
+    // Explicit method overrides the selection
+    simulator.set_solver_method(Solver::Method::sparse_lu);
+    simulator.run_dc_analysis(grid);
+    std::ostringstream explicit_report;
+    simulator.print(explicit_report);
+    runner.assert_true(!selection.valid && explicit_report.str().find("Sparse LU (BTF) Status") != std::string::npos &&
+                       explicit_report.str().find("Solver Selection") == std::string::npos,
+                       "Explicit method respected");
+
+    // Ring with strong leakage to ground: every row dominant by a factor of 5
+    std::ostringstream ring;
+    ring << "I1 0 1 0.001\n";
+    for (int k = 1; k <= 40; k++)
+        ring << "R" << k << " " << k << " " << (k % 40 + 1) << " 1000\nRg" << k << " " << k << " 0 100\n";
+    Node::valid = false;
+    Node::node_count = 0;
+    Circuit dominant("Ring");
+    build_from_text(dominant, ring.str());
+    Simulator auto_ring;
+    auto_ring.run_dc_analysis(dominant);
+    runner.assert_true(auto_ring.get_solver_selection().method == Solver::Method::gauss_seidel &&
+                       mna_residual(dominant, auto_ring.get_solution()) < 1e-8,
+                       "Strongly dominant ring: Gauss-Seidel (" + auto_ring.get_solver_selection().reason + ")");
+
+    // Voltage source puts a zero on the diagonal
+    Node::valid = false;
+    Node::node_count = 0;
+    Circuit sourced("Grid");
+    spec.topology = Netlist_generator::Topology::grid;
+    spec.size = 400;
+    Netlist_generator(spec).build(sourced);
+    sourced.assemble_MNA_system();
+    Simulator auto_grid;
+    auto_grid.run_dc_analysis(sourced);
+    runner.assert_true(auto_grid.get_solver_selection().method == Solver::Method::sparse_lu &&
+                       auto_grid.get_solver_selection().structure.zero_diagonals == 1 &&
+                       !auto_grid.get_solver_selection().structure.forest &&
+                       mna_residual(sourced, auto_grid.get_solution()) < 1e-9,
+                       "Grid with a voltage source: sparse LU (" + auto_grid.get_solver_selection().reason + ")");
+
+    // Tiny systems: only automatic selection takes the dense fast path, an explicit method runs its own backend
+    const std::string small = "tests/test_netlists/basic.net";
+    auto report_of = [&](bool automatic, Solver::Method method) {
+        Node::valid = false;
+        Node::node_count = 0;
+        Circuit circuit(small);
+        CircuitBuilder().build(circuit, small);
+        circuit.assemble_MNA_system();
+        Simulator tiny;
+        if (!automatic)
+            tiny.set_solver_method(method);
+        tiny.run_dc_analysis(circuit);
+        std::ostringstream report;
+        tiny.print(report);
+        return report.str();
+    };
+    std::string automatic = report_of(true, Solver::Method::automatic);
+    std::string gs = report_of(false, Solver::Method::gauss_seidel);
+    std::string lu = report_of(false, Solver::Method::sparse_lu);
+    runner.assert_true(automatic.find("Dense LU") != std::string::npos, "Automatic: tiny system on the dense fast path");
+    runner.assert_true(gs.find("Dense LU") == std::string::npos && gs.find("Gauss-Seidel Status") != std::string::npos &&
+                       lu.find("Dense LU") == std::string::npos && lu.find("Sparse LU (BTF) Status") != std::string::npos,
+                       "Explicit Gauss-Seidel and sparse LU run their own backend on a tiny system");
+}
+
+// ============================================================================
+// MAIN
+// ============================================================================
+
+int main() {
+    std::cout << std::string(70, '=') << std::endl;
+    std::cout << "                     SOLVER SELECTION TEST SUITE" << std::endl;
+    std::cout << std::string(70, '=') << std::endl;
+
+    TestRunner runner;
+
+    test_solver_selection(runner);
+
+    return runner.print_summary() ? 0 : 1;
+}
@@ -0,0 +1,136 @@
+/**
+ * @file test_solver_telemetry.cpp
+ * @brief Solver Telemetry Test Suite
+ *
+ * Verifies the Gauss-Seidel convergence records and their CSV/JSON export.
+ */
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+#include <algorithm>
+#include <stdexcept>
+#include <cstdio>
+
+#include "simulator.h"
+#include "circuit_builder.h"
+#include "netlist_generator.h"
+#include "solver_telemetry.h"
+#include "test_runner.h"
+
+// ============================================================================
+// TEST CASES
+// ============================================================================
+
+// TEST 1: Gauss-Seidel convergence telemetry
+void test_solver_telemetry(TestRunner& runner) {
+    runner.start_test("TEST 1: Solver convergence telemetry");
+
+    Node::valid = false;
+    Node::node_count = 0;
+    Circuit circuit;
+    Netlist_generator::Spec spec;
+    spec.topology = Netlist_generator::Topology::ladder;
+    spec.size = 100;
+    Netlist_generator(spec).build(circuit);
+    circuit.assemble_MNA_system();
+
+    const char* csv = "temp_telemetry_ac.csv";
+    Solver_telemetry telemetry(10);
+    Simulator simulator(csv);
+    simulator.set_solver_method(Solver::Method::gauss_seidel);
+    simulator.set_telemetry(&telemetry);
+    simulator.run_dc_analysis(circuit);
+    simulator.run_ac_analysis(circuit, 10.0, 1000.0, 10.0, true);
+    std::remove(csv);
+
+    const auto& solves = telemetry.solves();
+    runner.assert_true(solves.size() == 4 && std::string(solves[0].system) == "dc" &&
+                       std::string(solves[1].system) == "ac" && solves[3].frequency == 1000.0,
+                       "One record per DC solve and AC frequency point");
+    runner.assert_true(solves[0].converged && solves[0].iterations > 10 && solves[0].seconds > 0.0,
+                       "Outcome and wall time recorded");
+
+    std::vector<Solver_telemetry::Iteration> dc;
+    for (const auto& it : telemetry.iterations())
+        if (it.solve == 0)
+            dc.push_back(it);
+    bool sampled = !dc.empty() && dc.front().iteration == 1 && dc.back().iteration == solves[0].iterations;
+    for (size_t k = 1; k + 1 < dc.size(); k++)
+        sampled = sampled && dc[k].iteration % 10 == 0;
+    runner.assert_true(sampled && dc.size() == static_cast<size_t>(solves[0].iterations / 10 + 2) - (solves[0].iterations % 10 == 0),
+                       "First, every 10th and last sweep sampled (" + std::to_string(dc.size()) + ")");
+    runner.assert_true(dc.back().residual < dc.front().residual && dc.back().residual <= solves[0].tolerance &&
+                       dc.front().seconds > 0.0,
+                       "Residual falls below the tolerance, sweeps timed");
+    // The source's current variable has a zero diagonal: its row must be re-targeted in the first sweep
+    runner.assert_true(!telemetry.pivots().empty() && telemetry.pivots()[0].solve == 0 &&
+                       telemetry.pivots()[0].iteration == 1,
+                       "Zero-diagonal pivots recorded (" + std::to_string(telemetry.pivots().size()) + ")");
+
+    std::ostringstream csv_text, json_text;
+    telemetry.write_csv(csv_text);
+    telemetry.write_json(json_text);
+    std::string csv_rows = csv_text.str();
+    size_t rows = std::count(csv_rows.begin(), csv_rows.end(), '\n');
+    runner.assert_true(rows == 1 + solves.size() + telemetry.iterations().size() + telemetry.pivots().size() &&
+                       json_text.str().find("\"residuals\": [[1, ") != std::string::npos,
+                       "CSV and JSON export");
+
+    // Damping and tolerance are run-time settings (fresh simulator: no warm start)
+    int default_sweeps = solves[0].iterations;
+    telemetry.clear();
+    Simulator tuned(csv);
+    tuned.set_solver_method(Solver::Method::gauss_seidel);
+    tuned.set_telemetry(&telemetry);
+    tuned.set_gauss_seidel(1000, 1e-6, 0.9);
+    tuned.run_dc_analysis(circuit);
+    runner.assert_true(telemetry.solves().size() == 1 && telemetry.solves()[0].damping == 0.9 &&
+                       telemetry.solves()[0].tolerance == 1e-6 && telemetry.solves()[0].iterations < default_sweeps,
+                       "Looser tolerance and less damping converge in fewer sweeps (" +
+                       std::to_string(telemetry.solves().empty() ? 0 : telemetry.solves()[0].iterations) + " vs " +
+                       std::to_string(default_sweeps) + ")");
+    bool rejected = false;
+    try {
+        simulator.set_gauss_seidel(1000, 1e-9, 1.5);
+    } catch (const std::invalid_argument&) {
+        rejected = true;
+    }
+    runner.assert_true(rejected, "Damping outside (0, 1] rejected");
+
+    // A small netlist through a default simulator (as "-solver gs -telemetry"): the dense fast path must not bypass GS
+    const std::string small = "tests/test_netlists/basic.net";
+    Node::valid = false;
+    Node::node_count = 0;
+    Circuit tiny(small);
+    CircuitBuilder().build(tiny, small);
+    tiny.assemble_MNA_system();
+    telemetry.clear();
+    Simulator gs;
+    gs.set_solver_method(Solver::Method::gauss_seidel);
+    gs.set_telemetry(&telemetry);
+    gs.run_dc_analysis(tiny);
+    runner.assert_true(telemetry.solves().size() == 1 && telemetry.solves()[0].converged &&
+                       !telemetry.iterations().empty(),
+                       "Explicit GS on a small netlist records its sweeps (" +
+                       std::to_string(telemetry.iterations().size()) + " rows)");
+}
+
+// ============================================================================
+// MAIN
+// ============================================================================
+
+int main() {
+    std::cout << std::string(70, '=') << std::endl;
+    std::cout << "                     SOLVER TELEMETRY TEST SUITE" << std::endl;
+    std::cout << std::string(70, '=') << std::endl;
+
+    TestRunner runner;
+
+    test_solver_telemetry(runner);
+
+    return runner.print_summary() ? 0 : 1;
+}
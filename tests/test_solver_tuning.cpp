@@ -0,0 +1,200 @@
+/**
+ * @file test_solver_tuning.cpp
+ * @brief Solver Tuning Test Suite
+ *
+ * Verifies the trial runs of the solver tuner and its per-topology and
+ * structure-class entries.
+ */
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+#include <fstream>
+#include <algorithm>
+#include <memory>
+#include <filesystem>
+
+#include "simulator.h"
+#include "netlist_generator.h"
+#include "test_runner.h"
+
+// ============================================================================
+// HELPER FUNCTIONS
+// ============================================================================
+
+// Infinity norm of A x - b over the assembled MNA system
+double mna_residual(const Circuit& circuit, const std::vector<double>& x) {
+    double worst = 0.0;
+    for (const auto& [row, col_map] : circuit.get_MNA_matrix()) {
+        double sum = 0.0;
+        for (const auto& [col, value] : col_map)
+            sum += value * x[col];
+        auto it = circuit.get_MNA_vector().find(row);
+        double rhs = (it != circuit.get_MNA_vector().end()) ? it->second : 0.0;
+        worst = std::max(worst, std::abs(sum - rhs));
+    }
+    return worst;
+}
+
+// ============================================================================
+// TEST CASES
+// ============================================================================
+
+// TEST 1: Trial-based tuning and the per-topology tuning cache
+void test_solver_tuning(TestRunner& runner) {
+    runner.start_test("TEST 1: Solver tuning cache");
+
+    auto build_grid = [](size_t size, const std::string& name) {
+        Node::valid = false;
+        Node::node_count = 0;
+        std::unique_ptr<Circuit> circuit(new Circuit(name));
+        Netlist_generator::Spec spec;
+        spec.topology = Netlist_generator::Topology::grid;
+        spec.size = size;
+        Netlist_generator(spec).build(*circuit);
+        circuit->assemble_MNA_system();
+        return circuit;
+    };
+
+    std::string dir = "temp_lu_tuning";
+    std::filesystem::remove_all(dir);
+    std::unique_ptr<Circuit> a = build_grid(400, "tune_a");
+    Simulator first;
+    first.set_tuning(dir);
+    first.run_dc_analysis(*a);
+    const auto& trials = first.get_tuner().get_trials();
+    bool sorted = !trials.empty() && trials.front().accepted;
+    for (size_t k = 1; k < trials.size(); k++)
+        sorted = sorted && (!trials[k].accepted || (trials[k - 1].accepted && trials[k - 1].seconds <= trials[k].seconds));
+    runner.assert_true(first.get_tuner().get_source() == Solver_tuner::Source::tuned && trials.size() >= 5 && sorted,
+                       "Miss: " + std::to_string(trials.size()) + " candidates timed, fastest accepted first");
+    runner.assert_true(mna_residual(*a, first.get_solution()) < 1e-6, "Tuned configuration solves the circuit");
+    size_t entries = 0;
+    for (const auto& entry : std::filesystem::directory_iterator(dir))
+        entries += entry.path().extension() == ".tune";
+    runner.assert_true(entries == 2, "Topology and structure-class entries stored");
+
+    // Same circuit, new process: applied directly, no trials
+    std::unique_ptr<Circuit> a2 = build_grid(400, "tune_a2");
+    Simulator second;
+    second.set_tuning(dir);
+    second.run_dc_analysis(*a2);
+    const Solver_tuner& tuner = second.get_tuner();
+    runner.assert_true(tuner.get_source() == Solver_tuner::Source::exact && tuner.get_trials().empty() &&
+                       tuner.get_hits() == 1 &&
+                       Solver_tuner::describe(tuner.get_applied()) == Solver_tuner::describe(trials.front().config),
+                       "Rerun applies the stored winner (" + Solver_tuner::describe(tuner.get_applied()) + ")");
+    std::ostringstream report;
+    second.print(report);
+    runner.assert_true(report.str().find("cached for this topology") != std::string::npos, "Tuning source reported");
+
+    // A slightly larger grid of the same structure class uses the class entry
+    std::unique_ptr<Circuit> b = build_grid(441, "tune_b");
+    Simulator third;
+    third.set_tuning(dir, false);
+    third.run_dc_analysis(*b);
+    runner.assert_true(third.get_tuner().get_source() == Solver_tuner::Source::similar &&
+                       mna_residual(*b, third.get_solution()) < 1e-6,
+                       "Similar circuit uses the structure-class entry");
+
+    // A ladder is structurally different: no entry, and without tuning the solver keeps its settings
+    Node::valid = false;
+    Node::node_count = 0;
+    Circuit ladder("tune_ladder");
+    Netlist_generator::Spec spec;
+    spec.topology = Netlist_generator::Topology::ladder;
+    spec.size = 300;
+    Netlist_generator(spec).build(ladder);
+    ladder.assemble_MNA_system();
+    Simulator fourth;
+    fourth.set_tuning(dir, false);
+    fourth.run_dc_analysis(ladder);
+    runner.assert_true(fourth.get_tuner().get_source() == Solver_tuner::Source::none &&
+                       fourth.get_tuner().get_misses() == 1 &&
+                       fourth.get_solver_selection().method == Solver::Method::sparse_lu,
+                       "Different structure misses and falls back to automatic selection");
+
+    // A class entry that does not satisfy the new circuit is rejected by the residual check
+    for (const auto& entry : std::filesystem::directory_iterator(dir)) {
+        if (entry.path().filename().string().rfind("similar_", 0) == 0) {
+            std::ofstream out(entry.path(), std::ios::trunc);
+            out << "circuit_tuning 1\nmethod gs\ndamping 0.05\n";
+        }
+    }
+    std::unique_ptr<Circuit> c = build_grid(484, "tune_c");
+    Simulator fifth;
+    fifth.set_tuning(dir, false);
+    fifth.run_dc_analysis(*c);
+    runner.assert_true(fifth.get_tuner().get_source() == Solver_tuner::Source::none &&
+                       fifth.get_tuner().get_hits() == 0 && fifth.get_tuner().get_misses() == 1 &&
+                       fifth.get_solver_selection().method == Solver::Method::sparse_lu &&
+                       mna_residual(*c, fifth.get_solution()) < 1e-6,
+                       "Failing class entry counts as a miss, automatic selection solves");
+
+    // The same check guards topology entries: values may have changed since the entry was tuned
+    for (const auto& entry : std::filesystem::directory_iterator(dir)) {
+        if (entry.path().filename().string().rfind("similar_", 0) != 0) {
+            std::ofstream out(entry.path(), std::ios::trunc);
+            out << "circuit_tuning 1\nmethod gs\ndamping 0.05\n";
+        }
+    }
+    Simulator seventh;
+    seventh.set_tuning(dir, false);
+    seventh.run_dc_analysis(*a2);
+    runner.assert_true(seventh.get_tuner().get_source() == Solver_tuner::Source::none &&
+                       seventh.get_tuner().get_hits() == 0 && seventh.get_tuner().get_misses() == 1 &&
+                       mna_residual(*a2, seventh.get_solution()) < 1e-6,
+                       "Failing topology entry counts as a miss, automatic selection solves");
+
+    // A reused simulator drops the previous circuit's configuration on a miss
+    third.run_dc_analysis(ladder);
+    std::ostringstream restored;
+    third.print(restored);
+    runner.assert_true(third.get_tuner().get_source() == Solver_tuner::Source::none &&
+                       restored.str().find("Solver Selection:") != std::string::npos &&
+                       mna_residual(ladder, third.get_solution()) < 1e-6,
+                       "Miss restores automatic selection on a reused simulator");
+
+    // Systems taken by the dense fast path are not tuned
+    std::unique_ptr<Circuit> tiny = build_grid(9, "tune_tiny");
+    std::string tiny_dir = dir + "_tiny";
+    std::filesystem::remove_all(tiny_dir);
+    Simulator sixth;
+    sixth.set_tuning(tiny_dir);
+    sixth.run_dc_analysis(*tiny);
+    runner.assert_true(sixth.get_tuner().get_source() == Solver_tuner::Source::none &&
+                       sixth.get_tuner().get_trials().empty() && sixth.get_tuner().get_misses() == 0 &&
+                       std::filesystem::is_empty(tiny_dir),
+                       "Dense-sized system skips tuning");
+
+    // ... and get the dense fast path back on a simulator that applied a configuration before
+    second.run_dc_analysis(*tiny);
+    std::ostringstream dense;
+    second.print(dense);
+    runner.assert_true(second.get_tuner().get_source() == Solver_tuner::Source::none &&
+                       dense.str().find("Dense LU Status:") != std::string::npos &&
+                       mna_residual(*tiny, second.get_solution()) < 1e-9,
+                       "Dense-sized system restores the settings from before tuning");
+
+    std::filesystem::remove_all(dir);
+    std::filesystem::remove_all(tiny_dir);
+}
+
+// ============================================================================
+// MAIN
+// ============================================================================
+
+int main() {
+    std::cout << std::string(70, '=') << std::endl;
+    std::cout << "                       SOLVER TUNING TEST SUITE" << std::endl;
+    std::cout << std::string(70, '=') << std::endl;
+
+    TestRunner runner;
+
+    test_solver_tuning(runner);
+
+    return runner.print_summary() ? 0 : 1;
+}
@@ -0,0 +1,276 @@
+/**
+ * @file test_sparse_lu.cpp
+ * @brief Sparse Direct Solver Test Suite
+ *
+ * Verifies the block triangular decomposition and the BTF-ordered sparse LU
+ * against known DC/AC solutions and against the MNA residual on the large
+ * reference netlists.
+ */
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <cmath>
+#include <complex>
+#include <iomanip>
+#include <chrono>
+
+#include "simulator.h"
+#include "circuit_builder.h"
+#include "btf.h"
+#include "sparse_lu.h"
+#include "test_runner.h"
+
+constexpr double PI = 3.14159265358979323846;
+
+// ============================================================================
+// HELPER FUNCTIONS
+// ============================================================================
+
+void build_from_text(Circuit& circuit, const std::string& content) {
+    CircuitBuilder().build_from_text(circuit, content);
+    circuit.assemble_MNA_system();
+}
+
+// Infinity norm of A x - b over the assembled MNA system
+double mna_residual(const Circuit& circuit, const std::vector<double>& x) {
+    double worst = 0.0;
+    for (const auto& [row, col_map] : circuit.get_MNA_matrix()) {
+        double sum = 0.0;
+        for (const auto& [col, value] : col_map)
+            sum += value * x[col];
+        auto it = circuit.get_MNA_vector().find(row);
+        double rhs = (it != circuit.get_MNA_vector().end()) ? it->second : 0.0;
+        worst = std::max(worst, std::abs(sum - rhs));
+    }
+    return worst;
+}
+
+// ============================================================================
+// TEST CASES
+// ============================================================================
+
+// TEST 1: BTF of a reducible pattern
+void test_btf_structure(TestRunner& runner) {
+    runner.start_test("TEST 1: BTF of a reducible 5x5 pattern");
+
+    /*
+     * Columns 0-1 form a coupled pair and 2 depends on them one-way.
+     * Rows 3-4 have a zero diagonal at (4,4); after the row swap chosen by
+     * the maximum transversal they become two singletons feeding 2.
+     *
+     *      0 1 2 3 4
+     *   0 [x x . . .]
+     *   1 [x x . . .]
+     *   2 [x . x x .]
+     *   3 [. . . x x]
+     *   4 [. . . x .]
+     */
+    std::vector<int> col_ptr = {0, 3, 5, 6, 9, 10};
+    std::vector<int> row_idx = {0, 1, 2,  0, 1,  2,  2, 3, 4,  3};
+    Btf_decomposition btf = Btf::decompose(5, col_ptr, row_idx);
+
+    runner.assert_true(btf.structural_rank == 5, "Structurally non-singular");
+    runner.assert_true(btf.num_blocks() == 4, "Four diagonal blocks");
+    runner.assert_true(btf.num_singletons == 3, "Three singleton blocks");
+    runner.assert_true(btf.max_block_size == 2, "Largest block has size 2");
+
+    // Every entry must lie on or above its diagonal block
+    std::vector<int> row_pos(5), col_pos(5), block_of(5);
+    for (int k = 0; k < 5; k++) {
+        row_pos[btf.row_perm[k]] = k;
+        col_pos[btf.col_perm[k]] = k;
+    }
+    for (int b = 0; b < btf.num_blocks(); b++)
+        for (int k = btf.block_ptr[b]; k < btf.block_ptr[b + 1]; k++)
+            block_of[k] = b;
+    bool upper = true, zero_free = true;
+    for (int j = 0; j < 5; j++) {
+        bool has_diag = false;
+        for (int p = col_ptr[j]; p < col_ptr[j + 1]; p++) {
+            upper = upper && block_of[row_pos[row_idx[p]]] <= block_of[col_pos[j]];
+            has_diag = has_diag || row_pos[row_idx[p]] == col_pos[j];
+        }
+        zero_free = zero_free && has_diag;
+    }
+    runner.assert_true(upper, "Permuted matrix is block upper triangular");
+    runner.assert_true(zero_free, "Permuted matrix has a zero-free diagonal");
+}
+
+// TEST 2: Direct DC solve of small circuits with zero diagonals
+void test_dc_small(TestRunner& runner) {
+    runner.start_test("TEST 2: DC solve with voltage sources and inductors");
+
+    Node::valid = false;
+    Node::node_count = 0;
+    Circuit circuit("Bridge");
+    build_from_text(circuit,
+        "* Bridge with inductor\n"
+        "V1 1 0 10\n"
+        "R1 1 2 1000\n"
+        "R2 2 0 1000\n"
+        "R3 1 3 2000\n"
+        "L1 3 4 0.001\n"
+        "R4 4 0 2000\n"
+        "R5 2 4 500\n"
+        "I1 0 2 0.001\n");
+
+    Simulator simulator;
+    simulator.set_solver_method(Solver::Method::sparse_lu);
+    simulator.run_dc_analysis(circuit);
+
+    const auto& nodes = circuit.get_nodes();
+    runner.assert_near(nodes.at("1")->voltage, 10.0, 1e-9, "V(1)");
+    runner.assert_near(nodes.at("3")->voltage, nodes.at("4")->voltage, 1e-9, "Inductor shorts V(3) to V(4)");
+    runner.assert_true(mna_residual(circuit, simulator.get_solution()) < 1e-9, "Residual ||Ax - b|| < 1e-9");
+}
+
+// TEST 3: Reducible circuit (isolated source-driven sections)
+void test_dc_reducible(TestRunner& runner) {
+    runner.start_test("TEST 3: Reducible circuit with many singleton blocks");
+
+    Node::valid = false;
+    Node::node_count = 0;
+    Circuit circuit("Sources");
+    build_from_text(circuit,
+        "* Independent sources\n"
+        "V1 1 0 5\n"
+        "V2 2 0 3\n"
+        "R1 1 2 100\n"
+        "I1 0 3 0.002\n"
+        "R2 3 0 1000\n");
+
+    Simulator simulator;
+    simulator.set_solver_method(Solver::Method::sparse_lu);
+    simulator.run_dc_analysis(circuit);
+
+    const auto& nodes = circuit.get_nodes();
+    runner.assert_near(nodes.at("1")->voltage, 5.0, 1e-12, "V(1)");
+    runner.assert_near(nodes.at("2")->voltage, 3.0, 1e-12, "V(2)");
+    runner.assert_near(nodes.at("3")->voltage, 2.0, 1e-12, "V(3)");
+
+    std::ostringstream oss;
+    oss << simulator;
+    runner.assert_true(oss.str().find("singletons") != std::string::npos, "Solver reports BTF block statistics");
+}
+
+// TEST 4: Structurally singular but consistent system (inductor loop)
+void test_dc_inductor_loop(TestRunner& runner) {
+    runner.start_test("TEST 4: Parallel inductors (redundant KVL equation)");
+
+    Node::valid = false;
+    Node::node_count = 0;
+    Circuit circuit("Loop");
+    build_from_text(circuit,
+        "* Parallel inductors at DC\n"
+        "V1 1 0 12\n"
+        "R1 1 2 600\n"
+        "L1 2 3 0.001\n"
+        "L2 2 3 0.002\n"
+        "R2 3 0 600\n");
+
+    Simulator simulator;
+    simulator.set_solver_method(Solver::Method::sparse_lu);
+    simulator.run_dc_analysis(circuit);
+
+    const auto& nodes = circuit.get_nodes();
+    runner.assert_near(nodes.at("2")->voltage, 6.0, 1e-9, "V(2)");
+    runner.assert_near(nodes.at("3")->voltage, 6.0, 1e-9, "V(3)");
+    runner.assert_true(mna_residual(circuit, simulator.get_solution()) < 1e-9, "Residual ||Ax - b|| < 1e-9");
+
+    std::ostringstream oss;
+    oss << simulator;
+    runner.assert_true(oss.str().find("Dependent Columns: 1") != std::string::npos, "One loop current fixed");
+}
+
+// TEST 5: AC solve of an RC low-pass filter
+void test_ac_rc(TestRunner& runner) {
+    runner.start_test("TEST 5: AC RC low-pass with sparse LU");
+
+    Node::valid = false;
+    Node::node_count = 0;
+    Circuit circuit("RC");
+    build_from_text(circuit,
+        "* RC low-pass\n"
+        "V1 1 0 AC 1\n"
+        "R1 1 2 1000\n"
+        "C1 2 0 0.000001\n"
+        "L1 2 3 0.01\n"
+        "R2 3 0 100000\n");
+
+    std::string csv = "temp_lu_rc.csv";
+    Simulator simulator(csv);
+    simulator.set_solver_method(Solver::Method::sparse_lu);
+    simulator.run_dc_analysis(circuit);
+    simulator.run_ac_analysis(circuit, 159.15494309189535);
+
+    // Read the last CSV row (the requested frequency)
+    std::ifstream in(csv);
+    std::string line, last;
+    while (std::getline(in, line))
+        if (!line.empty())
+            last = line;
+    in.close();
+    std::remove(csv.c_str());
+
+    std::vector<double> fields;
+    std::istringstream iss(last);
+    std::string token;
+    while (std::getline(iss, token, ','))
+        fields.push_back(std::stod(token));
+
+    // Exact: Z = R2 + jwL, Y2 = jwC + 1/Z, V2 = 1 / (1 + R1*Y2)
+    double w = 2.0 * PI * 159.15494309189535;
+    std::complex<double> z(100000.0, w * 0.01);
+    std::complex<double> y2 = std::complex<double>(0.0, w * 1e-6) + 1.0 / z;
+    std::complex<double> v2 = 1.0 / (1.0 + 1000.0 * y2);
+    int node2 = circuit.get_nodes().at("2")->id;
+    runner.assert_near(fields[1 + 2 * node2], v2.real(), 1e-5, "Re(V(2))");
+    runner.assert_near(fields[2 + 2 * node2], v2.imag(), 1e-5, "Im(V(2))");
+}
+
+// TEST 6: Large reference netlists
+void test_large_netlist(TestRunner& runner, const std::string& path) {
+    runner.start_test("TEST 6: Sparse LU on " + path);
+
+    Node::valid = false;
+    Node::node_count = 0;
+    Circuit circuit(path);
+    CircuitBuilder().build(circuit, path);
+    circuit.assemble_MNA_system();
+
+    Simulator simulator;
+    simulator.set_solver_method(Solver::Method::sparse_lu);
+    auto start = std::chrono::high_resolution_clock::now();
+    simulator.run_dc_analysis(circuit);
+    auto end = std::chrono::high_resolution_clock::now();
+    std::cout << "  Solve time: " << std::chrono::duration_cast<std::chrono::microseconds>(end - start).count()
+              << " us" << std::endl;
+
+    runner.assert_true(mna_residual(circuit, simulator.get_solution()) < 1e-9, "Residual ||Ax - b|| < 1e-9");
+}
+
+// ============================================================================
+// MAIN
+// ============================================================================
+
+int main() {
+    std::cout << std::string(70, '=') << std::endl;
+    std::cout << "           SPARSE DIRECT SOLVER (BTF + LU) TEST SUITE" << std::endl;
+    std::cout << std::string(70, '=') << std::endl;
+
+    TestRunner runner;
+
+    test_btf_structure(runner);
+    test_dc_small(runner);
+    test_dc_reducible(runner);
+    test_dc_inductor_loop(runner);
+    test_ac_rc(runner);
+    test_large_netlist(runner, "tests/test_netlists/ladder_10000.net");
+    test_large_netlist(runner, "tests/test_netlists/large_grid.net");
+    test_large_netlist(runner, "tests/test_netlists/tree_d10_b3.net");
+
+    return runner.print_summary() ? 0 : 1;
+}
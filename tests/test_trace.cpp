@@ -0,0 +1,124 @@
+/**
+ * @file test_trace.cpp
+ * @brief Tracing Test Suite
+ *
+ * Verifies scoped trace events recorded across pool threads and the Chrome
+ * trace JSON export.
+ */
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+
+#include "simulator.h"
+#include "circuit_builder.h"
+#include "thread_pool.h"
+#include "netlist_generator.h"
+#include "trace.h"
+#include "executor.h"
+#include "test_runner.h"
+
+// ============================================================================
+// HELPER FUNCTIONS
+// ============================================================================
+
+void build_from_text(Circuit& circuit, const std::string& content) {
+    CircuitBuilder().build_from_text(circuit, content);
+    circuit.assemble_MNA_system();
+}
+
+// ============================================================================
+// TEST CASES
+// ============================================================================
+
+// TEST 1: Scoped tracing across pool threads and Chrome trace export
+void test_trace(TestRunner& runner) {
+    runner.start_test("TEST 1: Chrome trace export");
+
+    auto count = [](const std::string& text, const std::string& pattern) {
+        size_t n = 0;
+        for (size_t pos = text.find(pattern); pos != std::string::npos; pos = text.find(pattern, pos + 1))
+            n++;
+        return n;
+    };
+
+    // Budget of exactly three threads, so the region below runs on both workers
+    Executor::configure_global(Executor::Options{3, Executor::Affinity::none});
+    Trace::enable();
+    Trace::set_thread_name("test main");
+    Node::valid = false;
+    Node::node_count = 0;
+    Circuit circuit;
+    {
+        Netlist_generator::Spec spec;
+        spec.topology = Netlist_generator::Topology::grid;
+        spec.size = 400;
+        std::ostringstream text;
+        Netlist_generator(spec).write(text);
+        CircuitBuilder().build_from_text(circuit, text.str());
+        circuit.assemble_MNA_system();
+    }
+    Simulator simulator;
+    simulator.set_solver_method(Solver::Method::sparse_lu);
+    simulator.run_dc_analysis(circuit);
+    {
+        Thread_pool pool(3);
+        pool.run([&pool](int, int) {
+            TRACE_SCOPE("test_work");
+            pool.barrier().wait();      // Holds every thread until all three arrived
+        });
+    }
+    Trace::disable();
+    Executor::configure_global(Executor::Options{4, Executor::Affinity::none});
+    size_t recorded = Trace::event_count();
+    { TRACE_SCOPE("ignored"); }
+
+    std::ostringstream json;
+    Trace::write_chrome_json(json);
+    std::string trace = json.str();
+    bool phases = true;
+    for (const char* name : {"\"parse\"", "\"build\"", "\"assemble\"", "\"dc_solve\"", "\"reorder\"",
+                             "\"factor\"", "\"solve\""})
+        phases = phases && trace.find(name) != std::string::npos;
+    runner.assert_true(phases, "Parse, build, assemble, reorder, factor and solve spans recorded");
+    runner.assert_true(count(trace, "\"test_work\"") == 3 && count(trace, "\"thread_name\"") == 3 &&
+                       trace.find("\"test main\"") != std::string::npos &&
+                       trace.find("\"pool worker 2\"") != std::string::npos,
+                       "Worker spans on their own named threads");
+    runner.assert_true(Trace::event_count() == recorded && trace.find("ignored") == std::string::npos,
+                       "Nothing recorded while disabled");
+    runner.assert_true(trace.front() == '{' && count(trace, "{") == count(trace, "}") &&
+                       count(trace, "\"ph\": \"X\"") == recorded, "Well-formed trace event JSON");
+
+    Trace::enable(4);
+    for (int k = 0; k < 10; k++)
+        TRACE_SCOPE_ARG("span", "k", k);
+    Trace::disable();
+    std::ostringstream ring;
+    Trace::write_chrome_json(ring);
+    runner.assert_true(Trace::event_count() == 4 && Trace::dropped_count() == 6 &&
+                       ring.str().find("{\"k\": 6.000000}") != std::string::npos &&
+                       ring.str().find("{\"k\": 5.000000}") == std::string::npos,
+                       "Full ring buffer keeps the newest events");
+}
+
+// ============================================================================
+// MAIN
+// ============================================================================
+
+int main() {
+    std::cout << std::string(70, '=') << std::endl;
+    std::cout << "                          TRACING TEST SUITE" << std::endl;
+    std::cout << std::string(70, '=') << std::endl;
+
+    TestRunner runner;
+    // Parallel tests ask for up to 4 threads; size the shared runtime to match
+    Executor::configure_global(Executor::Options{4, Executor::Affinity::none});
+
+    test_trace(runner);
+
+    return runner.print_summary() ? 0 : 1;
+}
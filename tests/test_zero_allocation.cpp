@@ -0,0 +1,94 @@
+/**
+ * @file test_zero_allocation.cpp
+ * @brief Zero-Allocation Test Suite
+ *
+ * Verifies that warm DC and AC solver loops do not touch the heap.
+ */
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cmath>
+#include <iomanip>
+#include <cstdint>
+#include <cstdio>
+
+#include "simulator.h"
+#include "netlist_generator.h"
+#include "memory_accounting.h"
+#include "test_runner.h"
+
+// ============================================================================
+// TEST CASES
+// ============================================================================
+
+// TEST 1: Warm solver loops do not touch the heap
+void test_zero_allocation(TestRunner& runner) {
+    runner.start_test("TEST 1: Zero-allocation hot loops");
+
+    auto count_allocations = [](auto&& run) {
+        Memory_accounting::enable();
+        uint64_t before = Memory_accounting::total().allocations;
+        run();
+        uint64_t allocations = Memory_accounting::total().allocations - before;
+        Memory_accounting::disable();
+        return allocations;
+    };
+
+    const char* csv = "temp_zero_alloc_ac.csv";
+    for (Solver::Method method : {Solver::Method::gauss_seidel, Solver::Method::sparse_lu}) {
+        std::string name = method == Solver::Method::sparse_lu ? "Sparse LU" : "Gauss-Seidel";
+        Node::valid = false;
+        Node::node_count = 0;
+        Circuit circuit;
+        Netlist_generator::Spec spec;
+        spec.topology = Netlist_generator::Topology::ladder;
+        spec.size = 200;
+        Netlist_generator(spec).build(circuit);
+        circuit.assemble_MNA_system();
+        Simulator simulator(csv);
+        simulator.set_solver_method(method);
+        simulator.run_dc_analysis(circuit);
+        simulator.run_ac_analysis(circuit, 10.0, 160.0, 2.0, true);
+
+        uint64_t assembly = count_allocations([&] { circuit.assemble_MNA_system(); });
+        runner.assert_true(assembly == 0, name + ": re-assembly allocates nothing (" + std::to_string(assembly) + ")");
+        uint64_t dc = count_allocations([&] { simulator.run_dc_analysis(circuit); });
+        runner.assert_true(dc == 0, name + ": DC re-solve allocates nothing (" + std::to_string(dc) + ")");
+
+        // Sweeps pay a fixed setup (output file, complex copy of the system); points pay nothing
+        uint64_t single = count_allocations([&] { simulator.run_ac_analysis(circuit, 10.0); });
+        uint64_t sweep = count_allocations([&] { simulator.run_ac_analysis(circuit, 10.0, 160.0, 2.0, true); });
+        runner.assert_true(sweep == single, name + ": AC frequency points allocate nothing (" +
+                           std::to_string(static_cast<long long>(sweep - single)) + " for 4 points)");
+    }
+    std::remove(csv);
+
+    Component_contribution<double> full;
+    for (size_t k = 0; k < Component_contribution<double>::max_matrix_stamps; k++)
+        full.stampMatrix(1, 1, 1.0);
+    bool rejected = false;
+    try {
+        full.stampMatrix(1, 1, 1.0);
+    } catch (const std::length_error&) {
+        rejected = true;
+    }
+    runner.assert_true(rejected && full.matrixStamps.size() == Component_contribution<double>::max_matrix_stamps,
+                       "Stamp overflow rejected");
+}
+
+// ============================================================================
+// MAIN
+// ============================================================================
+
+int main() {
+    std::cout << std::string(70, '=') << std::endl;
+    std::cout << "                      ZERO-ALLOCATION TEST SUITE" << std::endl;
+    std::cout << std::string(70, '=') << std::endl;
+
+    TestRunner runner;
+
+    test_zero_allocation(runner);
+
+    return runner.print_summary() ? 0 : 1;
+}